@@ -13,3 +13,9 @@ DEFINE_string(protection_scheme,
               "Specify a protection scheme, 'cenc' or 'cbc1' or pattern-based "
               "protection schemes 'cens' or 'cbcs'.");
 DEFINE_bool(vp9_subsample_encryption, true, "Enable VP9 subsample encryption.");
+DEFINE_bool(derive_iv,
+            false,
+            "Derive the IVs from the key, the stream and the sample "
+            "timestamps instead of generating random IVs, so that the same "
+            "IVs are used when a stream is packaged again. Cannot be used "
+            "with --iv.");
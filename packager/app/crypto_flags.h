@@ -14,5 +14,6 @@
 
 DECLARE_string(protection_scheme);
 DECLARE_bool(vp9_subsample_encryption);
+DECLARE_bool(derive_iv);
 
 #endif  // PACKAGER_APP_CRYPTO_FLAGS_H_
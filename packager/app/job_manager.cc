@@ -6,15 +6,52 @@
 
 #include "packager/app/job_manager.h"
 
+#include <set>
+
 #include "packager/app/libcrypto_threading.h"
 #include "packager/media/chunking/sync_point_queue.h"
 #include "packager/media/origin/origin_handler.h"
+#include "packager/memory_tracker.h"
 
 namespace shaka {
 namespace media {
+namespace {
+
+// Initializes the handler graph of a job, on another thread if started.
+class JobInitializer : public base::DelegateSimpleThread::Delegate {
+ public:
+  JobInitializer(const std::string& job_name,
+                 MemoryAccounting* memory_accounting,
+                 std::shared_ptr<OriginHandler> work)
+      : job_name_(job_name),
+        memory_accounting_(memory_accounting),
+        work_(std::move(work)) {}
+
+  void Run() override {
+    MemoryAccounting::ScopedJob scoped_job(memory_accounting_, job_name_);
+    status_ = work_->Initialize();
+  }
+
+  const Status& status() const { return status_; }
+
+ private:
+  JobInitializer(const JobInitializer&) = delete;
+  JobInitializer& operator=(const JobInitializer&) = delete;
+
+  const std::string job_name_;
+  MemoryAccounting* const memory_accounting_;
+  std::shared_ptr<OriginHandler> work_;
+  Status status_;
+};
 
-Job::Job(const std::string& name, std::shared_ptr<OriginHandler> work)
+}  // namespace
+
+Job::Job(const std::string& name,
+         MemoryAccounting* memory_accounting,
+         std::shared_ptr<OriginHandler> work)
     : SimpleThread(name),
+      job_name_(name),
+      memory_accounting_(memory_accounting),
       work_(std::move(work)),
       wait_(base::WaitableEvent::ResetPolicy::MANUAL,
             base::WaitableEvent::InitialState::NOT_SIGNALED) {
@@ -26,12 +63,15 @@ void Job::Cancel() {
 }
 
 void Job::Run() {
+  MemoryAccounting::ScopedJob scoped_job(memory_accounting_, job_name_);
   status_ = work_->Run();
   wait_.Signal();
 }
 
-JobManager::JobManager(std::unique_ptr<SyncPointQueue> sync_points)
-    : sync_points_(std::move(sync_points)) {}
+JobManager::JobManager(std::unique_ptr<SyncPointQueue> sync_points,
+                       MemoryAccounting* memory_accounting)
+    : sync_points_(std::move(sync_points)),
+      memory_accounting_(memory_accounting) {}
 
 void JobManager::Add(const std::string& name,
                      std::shared_ptr<OriginHandler> handler) {
@@ -42,15 +82,38 @@ void JobManager::Add(const std::string& name,
 }
 
 Status JobManager::InitializeJobs() {
+  std::vector<std::unique_ptr<JobInitializer>> initializers;
+  for (const JobEntry& job_entry : job_entries_) {
+    initializers.emplace_back(
+        new JobInitializer(job_entry.name, memory_accounting_,
+                           job_entry.worker));
+  }
+
+  // The handler graphs of the jobs do not share handlers, so they are
+  // initialized in parallel. A single job is initialized on this thread.
+  if (initializers.size() == 1) {
+    initializers.front()->Run();
+  } else {
+    std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+    for (size_t i = 0; i < initializers.size(); ++i) {
+      threads.emplace_back(new base::DelegateSimpleThread(
+          initializers[i].get(), "Initialize " + job_entries_[i].name));
+      threads.back()->Start();
+    }
+    for (auto& thread : threads)
+      thread->Join();
+  }
+
   Status status;
-  for (const JobEntry& job_entry : job_entries_)
-    status.Update(job_entry.worker->Initialize());
+  for (const auto& initializer : initializers)
+    status.Update(initializer->status());
   if (!status.ok())
     return status;
 
   // Create Job objects after successfully initialized all workers.
   for (const JobEntry& job_entry : job_entries_)
-    jobs_.emplace_back(new Job(job_entry.name, std::move(job_entry.worker)));
+    jobs_.emplace_back(new Job(job_entry.name, memory_accounting_,
+                               std::move(job_entry.worker)));
   return status;
 }
 
@@ -104,6 +167,21 @@ Status JobManager::RunJobs() {
   return status;
 }
 
+void JobManager::EnableHandlerStats() {
+  for (const JobEntry& job_entry : job_entries_)
+    job_entry.worker->EnableStats();
+}
+
+void JobManager::GetHandlerStats(std::vector<HandlerStreamStats>* stats) const {
+  std::set<const MediaHandler*> visited;
+  for (const JobEntry& job_entry : job_entries_) {
+    const size_t first_new_entry = stats->size();
+    job_entry.worker->GetStats(&visited, stats);
+    for (size_t i = first_new_entry; i < stats->size(); ++i)
+      (*stats)[i].job_name = job_entry.name;
+  }
+}
+
 void JobManager::CancelJobs() {
   if (sync_points_)
     sync_points_->Cancel();
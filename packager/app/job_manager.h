@@ -14,16 +14,24 @@
 #include "packager/status.h"
 
 namespace shaka {
+
+class MemoryAccounting;
+
 namespace media {
 
 class OriginHandler;
+struct HandlerStreamStats;
 class SyncPointQueue;
 
 // A job is a single line of work that is expected to run in parallel with
 // other jobs.
 class Job : public base::SimpleThread {
  public:
-  Job(const std::string& name, std::shared_ptr<OriginHandler> work);
+  // @param memory_accounting accounts the memory allocated by the job. Null
+  //        means the default accounting.
+  Job(const std::string& name,
+      MemoryAccounting* memory_accounting,
+      std::shared_ptr<OriginHandler> work);
 
   // Request that the job stops executing. This is only a request and
   // will not block. If you want to wait for the job to complete, use
@@ -44,6 +52,9 @@ class Job : public base::SimpleThread {
 
   void Run() override;
 
+  // The memory allocated by the job is attributed to this name.
+  const std::string job_name_;
+  MemoryAccounting* const memory_accounting_;
   std::shared_ptr<OriginHandler> work_;
   Status status_;
 
@@ -58,16 +69,19 @@ class JobManager {
   // @param sync_points is an optional SyncPointQueue used to synchronize and
   //        align cue points. JobManager cancels @a sync_points when any job
   //        fails or is cancelled. It can be NULL.
-  explicit JobManager(std::unique_ptr<SyncPointQueue> sync_points);
+  // @param memory_accounting accounts the memory allocated by the jobs. It can
+  //        be NULL, for the default accounting.
+  JobManager(std::unique_ptr<SyncPointQueue> sync_points,
+             MemoryAccounting* memory_accounting);
 
   // Create a new job entry by specifying the origin handler at the top of the
   // chain and a name for the thread. This will only register the job. To start
   // the job, you need to call |RunJobs|.
   void Add(const std::string& name, std::shared_ptr<OriginHandler> handler);
 
-  // Initialize all registered jobs. If any job fails to initialize, this will
-  // return the error and it will not be safe to call |RunJobs| as not all jobs
-  // will be properly initialized.
+  // Initialize all registered jobs, in parallel as the jobs are independent.
+  // If any job fails to initialize, this will return the error and it will not
+  // be safe to call |RunJobs| as not all jobs will be properly initialized.
   Status InitializeJobs();
 
   // Run all registered jobs. Before calling this make sure that
@@ -79,6 +93,14 @@ class JobManager {
   // unblock a call to |RunJobs|.
   void CancelJobs();
 
+  // Enable statistics collection in the handlers of all registered jobs. It
+  // should be called before |RunJobs|.
+  void EnableHandlerStats();
+
+  // Append the statistics of the handlers of all registered jobs to |stats|.
+  // It can be called from another thread while the jobs are running.
+  void GetHandlerStats(std::vector<HandlerStreamStats>* stats) const;
+
   SyncPointQueue* sync_points() { return sync_points_.get(); }
 
  private:
@@ -95,6 +117,7 @@ class JobManager {
   // Stored in JobManager so JobManager can cancel |sync_points| when any job
   // fails or is cancelled.
   std::unique_ptr<SyncPointQueue> sync_points_;
+  MemoryAccounting* const memory_accounting_;
 };
 
 }  // namespace media
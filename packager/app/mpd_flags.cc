@@ -24,6 +24,12 @@ DEFINE_bool(output_media_info,
             "Create a human readable format of MediaInfo. The output file name "
             "will be the name specified by output flag, suffixed with "
             "'.media_info'. Exclusive with --mpd_output.");
+DEFINE_bool(output_binary_media_info,
+            false,
+            "Also create MediaInfo in protobuf binary wire format, which is "
+            "faster for mpd_generator to parse. The output file name will be "
+            "the name specified by output flag, suffixed with "
+            "'.media_info.pb'. Requires --output_media_info.");
 DEFINE_string(mpd_output, "",
               "MPD output file name. Exclusive with --output_media_info.");
 DEFINE_string(base_urls,
@@ -13,6 +13,7 @@
 
 DECLARE_bool(generate_static_mpd);
 DECLARE_bool(output_media_info);
+DECLARE_bool(output_binary_media_info);
 DECLARE_string(mpd_output);
 DECLARE_string(base_urls);
 DECLARE_double(minimum_update_period);
@@ -4,15 +4,26 @@
 // license that can be found in the LICENSE file or at
 // https://developers.google.com/open-source/licenses/bsd
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "packager/app/mpd_generator_flags.h"
 #include "packager/app/vlog_flags.h"
 #include "packager/base/at_exit.h"
 #include "packager/base/command_line.h"
+#include "packager/base/files/file_enumerator.h"
+#include "packager/base/files/file_path.h"
 #include "packager/base/logging.h"
 #include "packager/base/strings/string_split.h"
 #include "packager/base/strings/stringprintf.h"
+#include "packager/base/synchronization/lock.h"
+#include "packager/base/sys_info.h"
+#include "packager/base/threading/simple_thread.h"
+#include "packager/file/file.h"
+#include "packager/mpd/base/binary_media_info.h"
 #include "packager/mpd/util/mpd_writer.h"
 #include "packager/tools/license_notice.h"
 #include "packager/version/version.h"
@@ -33,7 +44,8 @@ namespace {
 const char kUsage[] =
     "MPD generation driver program.\n"
     "This program accepts MediaInfo files in human readable text "
-    "format and outputs an MPD.\n"
+    "format, or in protobuf binary format if suffixed with '.media_info.pb', "
+    "and outputs an MPD.\n"
     "The main use case for this is to output MPD for VOD.\n"
     "Limitations:\n"
     " Each MediaInfo can only have one of VideoInfo, AudioInfo, or TextInfo.\n"
@@ -41,16 +53,38 @@ const char kUsage[] =
     "audio, and 1 text.\n"
     "Sample Usage:\n"
     "%s --input=\"video1.media_info,video2.media_info,audio1.media_info\" "
-    "--output=\"video_audio.mpd\"";
+    "--output=\"video_audio.mpd\"\n"
+    "Batch Usage:\n"
+    "%s --batch_input=\"title_dirs.txt\" --batch_mpd_name=\"manifest.mpd\"";
 
 enum ExitStatus {
   kSuccess = 0,
   kEmptyInputError,
   kEmptyOutputError,
-  kFailedToWriteMpdToFileError
+  kFailedToWriteMpdToFileError,
+  kConflictingFlagsError,
+  kFailedToReadBatchInputError,
 };
 
+// Returns the patterns of MediaInfo files, in order of preference. Binary
+// MediaInfo is preferred as it is faster to parse.
+std::vector<base::FilePath::StringType> GetMediaInfoPatterns() {
+  return {
+      base::FilePath::FromUTF8Unsafe(std::string("*") + kBinaryMediaInfoSuffix)
+          .value(),
+      FILE_PATH_LITERAL("*.media_info"),
+  };
+}
+
 ExitStatus CheckRequiredFlags() {
+  if (!FLAGS_batch_input.empty()) {
+    if (!FLAGS_input.empty() || !FLAGS_output.empty()) {
+      LOG(ERROR) << "--batch_input cannot be used with --input or --output.";
+      return kConflictingFlagsError;
+    }
+    return kSuccess;
+  }
+
   if (FLAGS_input.empty()) {
     LOG(ERROR) << "--input is required.";
     return kEmptyInputError;
@@ -95,6 +129,145 @@ ExitStatus RunMpdGenerator() {
   return kSuccess;
 }
 
+// Title directories shared by the batch workers.
+class TitleQueue {
+ public:
+  explicit TitleQueue(std::vector<std::string> title_dirs)
+      : title_dirs_(std::move(title_dirs)) {}
+
+  // Gets the next title directory to process. Returns false if there is none
+  // left.
+  bool Next(std::string* title_dir) {
+    base::AutoLock auto_lock(lock_);
+    if (next_title_ >= title_dirs_.size())
+      return false;
+    *title_dir = title_dirs_[next_title_++];
+    return true;
+  }
+
+  void ReportFailure() {
+    base::AutoLock auto_lock(lock_);
+    ++num_failures_;
+  }
+
+  size_t num_failures() const {
+    base::AutoLock auto_lock(lock_);
+    return num_failures_;
+  }
+
+ private:
+  TitleQueue(const TitleQueue&) = delete;
+  TitleQueue& operator=(const TitleQueue&) = delete;
+
+  const std::vector<std::string> title_dirs_;
+  mutable base::Lock lock_;
+  size_t next_title_ = 0;
+  size_t num_failures_ = 0;
+};
+
+// Generates the MPDs for the titles in a TitleQueue. A worker reuses a single
+// MpdWriter, and the MediaInfo messages in it, for all of its titles.
+class BatchWorker : public base::SimpleThread {
+ public:
+  BatchWorker(const std::string& name,
+              const std::vector<std::string>& base_urls,
+              TitleQueue* titles)
+      : base::SimpleThread(name),
+        titles_(titles),
+        media_info_patterns_(GetMediaInfoPatterns()) {
+    for (const std::string& base_url : base_urls)
+      mpd_writer_.AddBaseUrl(base_url);
+  }
+
+ private:
+  BatchWorker(const BatchWorker&) = delete;
+  BatchWorker& operator=(const BatchWorker&) = delete;
+
+  void Run() override {
+    std::string title_dir;
+    while (titles_->Next(&title_dir)) {
+      if (!GenerateMpd(title_dir))
+        titles_->ReportFailure();
+    }
+  }
+
+  bool GenerateMpd(const std::string& title_dir) {
+    const base::FilePath title_path = base::FilePath::FromUTF8Unsafe(title_dir);
+    mpd_writer_.ClearFiles();
+
+    std::vector<std::string> media_info_files;
+    for (const base::FilePath::StringType& pattern : media_info_patterns_) {
+      base::FileEnumerator enumerator(title_path, false,
+                                      base::FileEnumerator::FILES, pattern);
+      for (base::FilePath path = enumerator.Next(); !path.empty();
+           path = enumerator.Next()) {
+        media_info_files.push_back(path.AsUTF8Unsafe());
+      }
+      if (!media_info_files.empty())
+        break;
+    }
+    if (media_info_files.empty()) {
+      LOG(ERROR) << "No MediaInfo files found in " << title_dir;
+      return false;
+    }
+    // Keep the order of the Representations stable.
+    std::sort(media_info_files.begin(), media_info_files.end());
+
+    for (const std::string& file : media_info_files) {
+      if (!mpd_writer_.AddFile(file)) {
+        LOG(WARNING) << "MpdWriter failed to read " << file << ", skipping.";
+      }
+    }
+
+    const std::string mpd_output =
+        title_path.Append(base::FilePath::FromUTF8Unsafe(FLAGS_batch_mpd_name))
+            .AsUTF8Unsafe();
+    if (!mpd_writer_.WriteMpdToFile(mpd_output.c_str())) {
+      LOG(ERROR) << "Failed to write MPD to " << mpd_output;
+      return false;
+    }
+    return true;
+  }
+
+  TitleQueue* const titles_;
+  const std::vector<base::FilePath::StringType> media_info_patterns_;
+  MpdWriter mpd_writer_;
+};
+
+ExitStatus RunBatchMpdGenerator() {
+  std::string batch_input;
+  if (!File::ReadFileToString(FLAGS_batch_input.c_str(), &batch_input)) {
+    LOG(ERROR) << "Failed to read " << FLAGS_batch_input;
+    return kFailedToReadBatchInputError;
+  }
+  TitleQueue titles(base::SplitString(
+      batch_input, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY));
+
+  std::vector<std::string> base_urls;
+  if (!FLAGS_base_urls.empty()) {
+    base_urls = base::SplitString(FLAGS_base_urls, ",", base::KEEP_WHITESPACE,
+                                  base::SPLIT_WANT_ALL);
+  }
+
+  const int num_workers = FLAGS_batch_num_workers > 0
+                              ? FLAGS_batch_num_workers
+                              : base::SysInfo::NumberOfProcessors();
+  std::vector<std::unique_ptr<BatchWorker>> workers;
+  for (int i = 0; i < num_workers; ++i) {
+    workers.emplace_back(new BatchWorker(
+        base::StringPrintf("mpd_generator_%d", i), base_urls, &titles));
+    workers.back()->Start();
+  }
+  for (const std::unique_ptr<BatchWorker>& worker : workers)
+    worker->Join();
+
+  if (titles.num_failures() > 0) {
+    LOG(ERROR) << "Failed to generate " << titles.num_failures() << " MPD(s).";
+    return kFailedToWriteMpdToFileError;
+  }
+  return kSuccess;
+}
+
 int MpdMain(int argc, char** argv) {
   base::AtExitManager exit;
   // Needed to enable VLOG/DVLOG through --vmodule or --v.
@@ -106,7 +279,7 @@ int MpdMain(int argc, char** argv) {
   CHECK(logging::InitLogging(log_settings));
 
   google::SetVersionString(GetPackagerVersion());
-  google::SetUsageMessage(base::StringPrintf(kUsage, argv[0]));
+  google::SetUsageMessage(base::StringPrintf(kUsage, argv[0], argv[0]));
   google::ParseCommandLineFlags(&argc, &argv, true);
   if (FLAGS_licenses) {
     for (const char* line : kLicenseNotice)
@@ -123,7 +296,8 @@ int MpdMain(int argc, char** argv) {
   if (!FLAGS_test_packager_version.empty())
     SetPackagerVersionForTesting(FLAGS_test_packager_version);
 
-  return RunMpdGenerator();
+  return FLAGS_batch_input.empty() ? RunMpdGenerator()
+                                   : RunBatchMpdGenerator();
 }
 
 }  // namespace
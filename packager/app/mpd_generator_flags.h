@@ -15,4 +15,19 @@ DEFINE_string(base_urls,
               "",
               "Comma separated BaseURLs for the MPD. The values will be added "
               "as <BaseURL> element(s) immediately under the <MPD> element.");
+DEFINE_string(batch_input,
+              "",
+              "File listing title directories, one per line. In batch mode, "
+              "the MediaInfo files in each title directory are merged into an "
+              "MPD named by --batch_mpd_name in the same directory. MediaInfo "
+              "files in binary format ('.media_info.pb') are used if present, "
+              "otherwise the human readable ones ('.media_info'). Exclusive "
+              "with --input and --output.");
+DEFINE_string(batch_mpd_name,
+              "manifest.mpd",
+              "MPD output file name in each title directory in batch mode.");
+DEFINE_int32(batch_num_workers,
+             0,
+             "Number of title directories processed in parallel in batch "
+             "mode. Defaults to the number of processors if 0.");
 #endif  // APP_MPD_GENERATOR_FLAGS_H_
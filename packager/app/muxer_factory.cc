@@ -22,11 +22,30 @@ MuxerFactory::MuxerFactory(const PackagingParams& packaging_params)
     : mp4_params_(packaging_params.mp4_output_params),
       transport_stream_timestamp_offset_ms_(
           packaging_params.transport_stream_timestamp_offset_ms),
-      temp_dir_(packaging_params.temp_dir) {}
+      temp_dir_(packaging_params.temp_dir),
+      segment_duration_in_seconds_(
+          packaging_params.chunking_params.segment_duration_in_seconds),
+      webm_single_pass_(packaging_params.webm_single_pass) {}
 
 std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
     MediaContainerName output_format,
     const StreamDescriptor& stream) {
+  return CreateMuxer(output_format, CreateMuxerOptions(stream));
+}
+
+std::shared_ptr<Muxer> MuxerFactory::CreateChunkMuxer(
+    MediaContainerName output_format,
+    const StreamDescriptor& stream,
+    uint32_t initial_segment_index,
+    const MuxerOptions::TimelineChunk& timeline_chunk) {
+  MuxerOptions options = CreateMuxerOptions(stream);
+  options.initial_segment_index = initial_segment_index;
+  options.timeline_chunk = timeline_chunk;
+  return CreateMuxer(output_format, options);
+}
+
+MuxerOptions MuxerFactory::CreateMuxerOptions(
+    const StreamDescriptor& stream) const {
   MuxerOptions options;
   options.mp4_params = mp4_params_;
   options.transport_stream_timestamp_offset_ms =
@@ -35,7 +54,17 @@ std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
   options.output_file_name = stream.output;
   options.segment_template = stream.segment_template;
   options.bandwidth = stream.bandwidth;
+  options.segment_duration_in_seconds = segment_duration_in_seconds_;
+  options.webm_single_pass = webm_single_pass_;
+  auto index_it = initial_segment_indices_.find(stream.segment_template);
+  if (index_it != initial_segment_indices_.end())
+    options.initial_segment_index = index_it->second;
+  return options;
+}
 
+std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
+    MediaContainerName output_format,
+    const MuxerOptions& options) {
   std::shared_ptr<Muxer> muxer;
 
   switch (output_format) {
@@ -67,6 +96,7 @@ std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
   if (clock_) {
     muxer->set_clock(clock_);
   }
+  muxer->set_segment_lock(segment_lock_);
 
   return muxer;
 }
@@ -74,5 +104,14 @@ std::shared_ptr<Muxer> MuxerFactory::CreateMuxer(
 void MuxerFactory::OverrideClock(base::Clock* clock) {
   clock_ = clock;
 }
+
+void MuxerFactory::SetInitialSegmentIndices(
+    const std::map<std::string, uint32_t>& initial_segment_indices) {
+  initial_segment_indices_ = initial_segment_indices;
+}
+
+void MuxerFactory::SetSegmentLock(base::subtle::ReadWriteLock* segment_lock) {
+  segment_lock_ = segment_lock;
+}
 }  // namespace media
 }  // namespace shaka
@@ -7,14 +7,19 @@
 #ifndef PACKAGER_APP_MUXER_FACTORY_H_
 #define PACKAGER_APP_MUXER_FACTORY_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "packager/media/base/container_names.h"
+#include "packager/media/base/muxer_options.h"
 #include "packager/media/public/mp4_output_params.h"
 
 namespace base {
 class Clock;
+namespace subtle {
+class ReadWriteLock;
+}  // namespace subtle
 }  // namespace base
 
 namespace shaka {
@@ -38,18 +43,48 @@ class MuxerFactory {
   std::shared_ptr<Muxer> CreateMuxer(MediaContainerName output_format,
                                      const StreamDescriptor& stream);
 
+  /// Create a new muxer for a chunk of the timeline of the given stream,
+  /// which is packaged in parallel with the other chunks, see
+  /// ParallelVodParams.
+  /// @param initial_segment_index is the index of the first segment of the
+  ///        chunk.
+  std::shared_ptr<Muxer> CreateChunkMuxer(
+      MediaContainerName output_format,
+      const StreamDescriptor& stream,
+      uint32_t initial_segment_index,
+      const MuxerOptions::TimelineChunk& timeline_chunk);
+
   /// For testing, if you need to replace the clock that muxers work with
   /// this will replace the clock for all muxers created after this call.
   void OverrideClock(base::Clock* clock);
 
+  /// Sets the index of the first segment of the muxers created after this
+  /// call, to resume live packaging from a checkpoint.
+  /// @param initial_segment_indices contains the indices keyed by segment
+  ///        template. Muxers of other segment templates start from 0.
+  void SetInitialSegmentIndices(
+      const std::map<std::string, uint32_t>& initial_segment_indices);
+
+  /// Sets the segment lock of the muxers created after this call, see
+  /// Muxer::set_segment_lock().
+  void SetSegmentLock(base::subtle::ReadWriteLock* segment_lock);
+
  private:
   MuxerFactory(const MuxerFactory&) = delete;
   MuxerFactory& operator=(const MuxerFactory&) = delete;
 
+  MuxerOptions CreateMuxerOptions(const StreamDescriptor& stream) const;
+  std::shared_ptr<Muxer> CreateMuxer(MediaContainerName output_format,
+                                     const MuxerOptions& options);
+
   const Mp4OutputParams mp4_params_;
   const uint32_t transport_stream_timestamp_offset_ms_ = 0;
   const std::string temp_dir_;
+  const double segment_duration_in_seconds_ = 0;
+  const bool webm_single_pass_ = false;
   base::Clock* clock_ = nullptr;
+  std::map<std::string, uint32_t> initial_segment_indices_;
+  base::subtle::ReadWriteLock* segment_lock_ = nullptr;
 };
 
 }  // namespace media
@@ -43,6 +43,12 @@ DEFINE_string(temp_dir,
               "",
               "Specify a directory in which to store temporary (intermediate) "
               " files. Used only if single_segment=true.");
+DEFINE_bool(webm_single_pass,
+            false,
+            "WebM with single_segment only: write the output in a single pass "
+            "by reserving space for the Cues before the Clusters, instead of "
+            "writing the Clusters to a temporary file first. Falls back to "
+            "two passes if the reserved space is too small.");
 DEFINE_bool(mp4_include_pssh_in_stream,
             true,
             "MP4 only: include pssh in the encrypted stream.");
@@ -18,6 +18,7 @@ DECLARE_double(fragment_duration);
 DECLARE_bool(fragment_sap_aligned);
 DECLARE_bool(generate_sidx_in_media_segments);
 DECLARE_string(temp_dir);
+DECLARE_bool(webm_single_pass);
 DECLARE_bool(mp4_include_pssh_in_stream);
 DECLARE_int32(transport_stream_timestamp_offset_ms);
 
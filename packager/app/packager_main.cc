@@ -38,12 +38,59 @@
 #endif  // defined(OS_WIN)
 
 DEFINE_bool(dump_stream_info, false, "Dump demuxed stream info.");
+DEFINE_double(handler_stats_interval,
+              0,
+              "If positive, log per media handler statistics, i.e. samples/s, "
+              "bytes/s and self time, every this many seconds while "
+              "packaging.");
+DEFINE_double(latency_stats_interval,
+              0,
+              "If positive, log per segment live latency statistics, i.e. "
+              "the time from ingest to segment written and to manifest "
+              "updated, every this many seconds while packaging.");
+DEFINE_bool(lazy_stream_initialization,
+            false,
+            "Start the streams of an MPEG-2 TS input as soon as their own "
+            "stream info is available, instead of waiting for every stream "
+            "in the input, e.g. for a sparse audio stream. Reduces the "
+            "startup time of live inputs.");
 DEFINE_bool(licenses, false, "Dump licenses.");
+DEFINE_double(memory_stats_interval,
+              0,
+              "If positive, log the current and peak memory used by the major "
+              "buffers of every job and stream every this many seconds while "
+              "packaging.");
+DEFINE_uint64(memory_soft_limit_mb,
+              0,
+              "If positive, hold off reading the inputs while the buffers of "
+              "the packaging pipeline use more than this many megabytes. The "
+              "fixed capacity of the I/O caches is not counted.");
 DEFINE_bool(use_fake_clock_for_muxer,
             false,
             "Set to true to use a fake clock for muxer. With this flag set, "
             "creation time and modification time in outputs are set to 0. "
             "Should only be used for testing.");
+DEFINE_string(checkpoint_file,
+              "",
+              "If set, save the segment numbers and the live manifest state "
+              "to this file periodically while packaging live content, and "
+              "resume from it if it exists when the packager starts, e.g. "
+              "after a restart.");
+DEFINE_double(checkpoint_interval,
+              5,
+              "Interval in seconds between checkpoints written to "
+              "--checkpoint_file.");
+DEFINE_int32(parallel_vod_chunks,
+             0,
+             "If greater than 1, split the timeline of every VOD input into "
+             "up to this many chunks of whole segments and package them in "
+             "parallel. Requires MP4 output with segment_template, and "
+             "--derive_iv with encryption.");
+DEFINE_string(trace_file,
+              "",
+              "If set, write timing events of the packaging pipeline to this "
+              "file in Chrome trace event JSON format, which can be viewed in "
+              "chrome://tracing or https://ui.perfetto.dev.");
 DEFINE_string(test_packager_version,
               "",
               "Packager version for testing. Should be used for testing only.");
@@ -338,6 +385,7 @@ base::Optional<PackagingParams> GetPackagingParams() {
     encryption_params.crypto_period_duration_in_seconds =
         FLAGS_crypto_period_duration;
     encryption_params.vp9_subsample_encryption = FLAGS_vp9_subsample_encryption;
+    encryption_params.derive_iv = FLAGS_derive_iv;
     encryption_params.stream_label_func = std::bind(
         &Packager::DefaultStreamLabelFunction, FLAGS_max_sd_pixels,
         FLAGS_max_hd_pixels, FLAGS_max_uhd1_pixels, std::placeholders::_1);
@@ -351,6 +399,7 @@ base::Optional<PackagingParams> GetPackagingParams() {
       widevine.policy = FLAGS_policy;
       widevine.group_id = FLAGS_group_id_bytes;
       widevine.enable_entitlement_license = FLAGS_enable_entitlement_license;
+      widevine.crypto_period_count = FLAGS_crypto_period_count;
       if (!GetWidevineSigner(&widevine.signer))
         return base::nullopt;
       break;
@@ -416,8 +465,10 @@ base::Optional<PackagingParams> GetPackagingParams() {
 
   packaging_params.transport_stream_timestamp_offset_ms =
       FLAGS_transport_stream_timestamp_offset_ms;
+  packaging_params.webm_single_pass = FLAGS_webm_single_pass;
 
   packaging_params.output_media_info = FLAGS_output_media_info;
+  packaging_params.output_binary_media_info = FLAGS_output_binary_media_info;
 
   MpdParams& mpd_params = packaging_params.mpd_params;
   mpd_params.mpd_output = FLAGS_mpd_output;
@@ -463,6 +514,31 @@ base::Optional<PackagingParams> GetPackagingParams() {
   hls_params.default_language = FLAGS_default_language;
   hls_params.default_text_language = FLAGS_default_text_language;
 
+  HandlerStatsParams& handler_stats_params =
+      packaging_params.handler_stats_params;
+  handler_stats_params.enable_handler_stats = FLAGS_handler_stats_interval > 0;
+  handler_stats_params.dump_interval_in_seconds = FLAGS_handler_stats_interval;
+
+  LatencyStatsParams& latency_stats_params =
+      packaging_params.latency_stats_params;
+  latency_stats_params.enable_latency_stats = FLAGS_latency_stats_interval > 0;
+  latency_stats_params.dump_interval_in_seconds = FLAGS_latency_stats_interval;
+
+  MemoryStatsParams& memory_stats_params = packaging_params.memory_stats_params;
+  memory_stats_params.dump_interval_in_seconds = FLAGS_memory_stats_interval;
+  memory_stats_params.soft_limit_in_bytes =
+      static_cast<int64_t>(FLAGS_memory_soft_limit_mb) * 1024 * 1024;
+
+  packaging_params.lazy_stream_initialization =
+      FLAGS_lazy_stream_initialization;
+  packaging_params.trace_file = FLAGS_trace_file;
+
+  CheckpointParams& checkpoint_params = packaging_params.checkpoint_params;
+  checkpoint_params.checkpoint_file = FLAGS_checkpoint_file;
+  checkpoint_params.checkpoint_interval_in_seconds = FLAGS_checkpoint_interval;
+
+  packaging_params.parallel_vod_params.num_chunks = FLAGS_parallel_vod_chunks;
+
   TestParams& test_params = packaging_params.test_params;
   test_params.dump_stream_info = FLAGS_dump_stream_info;
   test_params.inject_fake_clock = FLAGS_use_fake_clock_for_muxer;
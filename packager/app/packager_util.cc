@@ -87,6 +87,10 @@ std::unique_ptr<KeySource> CreateEncryptionKeySource(
         LOG(ERROR) << "'content_id' should not be empty.";
         return nullptr;
       }
+      if (widevine.crypto_period_count == 0) {
+        LOG(ERROR) << "'crypto_period_count' should be positive.";
+        return nullptr;
+      }
       std::unique_ptr<WidevineKeySource> widevine_key_source(
           new WidevineKeySource(widevine.key_server_url,
                                 protection_systems_flags, protection_scheme));
@@ -100,6 +104,8 @@ std::unique_ptr<KeySource> CreateEncryptionKeySource(
       widevine_key_source->set_group_id(widevine.group_id);
       widevine_key_source->set_enable_entitlement_license(
           widevine.enable_entitlement_license);
+      widevine_key_source->set_crypto_period_count(
+          widevine.crypto_period_count);
 
       Status status =
           widevine_key_source->FetchKeys(widevine.content_id, widevine.policy);
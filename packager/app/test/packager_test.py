@@ -413,6 +413,7 @@ class PackagerAppTest(unittest.TestCase):
                 include_pssh_in_stream=True,
                 dash_if_iop=True,
                 output_media_info=False,
+                output_binary_media_info=False,
                 output_dash=False,
                 output_hls=False,
                 hls_playlist_type=None,
@@ -478,6 +479,8 @@ class PackagerAppTest(unittest.TestCase):
 
     if output_media_info:
       flags.append('--output_media_info')
+    if output_binary_media_info:
+      flags.append('--output_binary_media_info')
     if output_dash:
       flags += ['--mpd_output', self.mpd_output]
     if output_hls:
@@ -1297,6 +1300,29 @@ class PackagerFunctionalTest(PackagerAppTest):
     self._CheckTestResults(
         'encryption-and-output-media-info-and-mpd-from-media-info')
 
+  def testMpdGeneratorBatchModeWithBinaryMediaInfo(self):
+    self.assertPackageSuccess(
+        self._GetStreams(['video']),
+        self._GetFlags(output_media_info=True, output_binary_media_info=True))
+    self.assertMpdGeneratorSuccess()
+
+    # The batch mode generates the same MPD from the binary MediaInfo files in
+    # the title directory.
+    batch_input = os.path.join(self.tmp_dir, 'titles.txt')
+    with open(batch_input, 'w') as f:
+      f.write(self.tmp_dir + '\n')
+    batch_mpd_name = 'batch.mpd'
+    flags = ['--batch_input', batch_input, '--batch_mpd_name', batch_mpd_name]
+    flags += ['--batch_num_workers', '2']
+    flags += ['--test_packager_version', '<tag>-<hash>-<test>']
+    self.assertEqual(self.packager.MpdGenerator(flags), 0)
+
+    with open(self.mpd_output, 'r') as f:
+      expected_mpd = f.read()
+    with open(os.path.join(self.tmp_dir, batch_mpd_name), 'r') as f:
+      batch_mpd = f.read()
+    self.assertEqual(expected_mpd, batch_mpd)
+
   def testHlsSingleSegmentMp4Encrypted(self):
     self.assertPackageSuccess(
         self._GetStreams(['audio', 'video'], hls=True),
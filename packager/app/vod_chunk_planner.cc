@@ -0,0 +1,210 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/app/vod_chunk_planner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "packager/base/logging.h"
+#include "packager/media/base/media_handler.h"
+#include "packager/media/base/media_sample.h"
+#include "packager/media/base/stream_info.h"
+#include "packager/media/chunking/chunking_handler.h"
+#include "packager/media/demuxer/demuxer.h"
+#include "packager/status_macros.h"
+
+namespace shaka {
+namespace media {
+namespace {
+
+// A segment of a stream after chunking.
+struct Segment {
+  // Timestamps of the first sample of the segment, which is a key frame.
+  int64_t pts = 0;
+  int64_t dts = 0;
+  int64_t duration = 0;
+};
+
+// Records the segments of a stream. The demuxer is cancelled if the duration
+// of the stream is unknown and the demuxer reads the sample data, e.g. for
+// MPEG2-TS, as the input would have to be read in full to find its segments.
+// Inputs which are scanned without their sample data, e.g. fragmented MP4
+// without 'mehd' box, are planned from their segments.
+class StreamProbe : public MediaHandler {
+ public:
+  explicit StreamProbe(Demuxer* demuxer) : demuxer_(demuxer) {}
+
+  bool duration_unknown() const { return duration_unknown_; }
+  const std::vector<Segment>& segments() const { return segments_; }
+
+ protected:
+  std::string name() const override { return "StreamProbe"; }
+
+  Status InitializeInternal() override { return Status::OK; }
+
+  Status Process(std::unique_ptr<StreamData> stream_data) override {
+    switch (stream_data->stream_data_type) {
+      case StreamDataType::kStreamInfo:
+        if (stream_data->stream_info->duration() == 0 &&
+            !demuxer_->skips_sample_data()) {
+          duration_unknown_ = true;
+          demuxer_->Cancel();
+        }
+        break;
+      case StreamDataType::kSegmentInfo:
+        if (!stream_data->segment_info->is_subsegment && in_segment_) {
+          segments_.back().duration = stream_data->segment_info->duration;
+          in_segment_ = false;
+        }
+        break;
+      case StreamDataType::kMediaSample:
+        if (!in_segment_) {
+          Segment segment;
+          segment.pts = stream_data->media_sample->pts();
+          segment.dts = stream_data->media_sample->dts();
+          segments_.push_back(segment);
+          in_segment_ = true;
+        }
+        break;
+      default:
+        break;
+    }
+    return Status::OK;
+  }
+
+  Status OnFlushRequest(size_t input_stream_index) override {
+    return Status::OK;
+  }
+
+ private:
+  StreamProbe(const StreamProbe&) = delete;
+  StreamProbe& operator=(const StreamProbe&) = delete;
+
+  Demuxer* const demuxer_;
+  bool duration_unknown_ = false;
+  std::vector<Segment> segments_;
+  // Whether the last segment in |segments_| has not ended yet.
+  bool in_segment_ = false;
+};
+
+}  // namespace
+
+VodChunkPlanner::VodChunkPlanner() {}
+
+VodChunkPlanner::~VodChunkPlanner() {}
+
+Status VodChunkPlanner::Plan(std::shared_ptr<Demuxer> demuxer,
+                             const std::vector<std::string>& stream_selectors,
+                             const ChunkingParams& chunking_params,
+                             uint32_t max_num_chunks,
+                             VodChunkPlan* plan) {
+  DCHECK(demuxer);
+  DCHECK(plan);
+
+  // The segments are taken after chunking, which drops the samples before the
+  // first key frame, so the first samples are those of the muxers.
+  std::map<std::string, std::shared_ptr<StreamProbe>> probes;
+  for (const std::string& stream_selector : stream_selectors) {
+    auto chunker = std::make_shared<ChunkingHandler>(chunking_params);
+    auto probe = std::make_shared<StreamProbe>(demuxer.get());
+    RETURN_IF_ERROR(MediaHandler::Chain({chunker, probe}));
+    RETURN_IF_ERROR(demuxer->SetHandler(stream_selector, chunker));
+    probes[stream_selector] = probe;
+  }
+  // Only the timestamps and key frames of the samples are needed.
+  demuxer->set_skip_sample_data(true);
+  {
+    base::AutoLock auto_lock(lock_);
+    if (cancelled_)
+      return Status(error::CANCELLED, "VOD chunk planning cancelled.");
+    demuxer_ = demuxer;
+  }
+  Status status = demuxer->Initialize();
+  if (status.ok())
+    status = demuxer->Run();
+  {
+    base::AutoLock auto_lock(lock_);
+    demuxer_.reset();
+    if (cancelled_)
+      return Status(error::CANCELLED, "VOD chunk planning cancelled.");
+  }
+  // The probes cancel the demuxer if the input cannot be split.
+  if (!status.ok() && status.error_code() != error::CANCELLED)
+    return status;
+
+  VodChunkPlan new_plan;
+  bool duration_unknown = false;
+  size_t num_segments = std::numeric_limits<size_t>::max();
+  for (const auto& entry : probes) {
+    const std::vector<Segment>& segments = entry.second->segments();
+    if (!segments.empty()) {
+      VodChunkPlan::FirstSample first_sample;
+      first_sample.pts = segments.front().pts;
+      first_sample.dts = segments.front().dts;
+      new_plan.first_samples[entry.first] = first_sample;
+    }
+    duration_unknown |= entry.second->duration_unknown();
+    num_segments = std::min(num_segments, segments.size());
+  }
+
+  // The chunks consist of the same number of segments in every stream, as
+  // the segments are numbered per stream. The last chunk takes the segments
+  // left over.
+  if (duration_unknown || max_num_chunks <= 1) {
+    *plan = std::move(new_plan);
+    return Status::OK;
+  }
+  if (num_segments <= 1) {
+    LOG(WARNING) << "Only " << num_segments
+                 << " segment(s) found in a stream, so it cannot be split.";
+    *plan = std::move(new_plan);
+    return Status::OK;
+  }
+  const size_t num_chunks =
+      std::min(static_cast<size_t>(max_num_chunks), num_segments);
+  const size_t segments_per_chunk =
+      (num_segments + num_chunks - 1) / num_chunks;
+  new_plan.segments_per_chunk = static_cast<uint32_t>(segments_per_chunk);
+  new_plan.num_chunks = static_cast<uint32_t>(
+      (num_segments + segments_per_chunk - 1) / segments_per_chunk);
+
+  for (const auto& entry : probes) {
+    const std::vector<Segment>& segments = entry.second->segments();
+    std::vector<VodChunkPlan::ChunkRange>& chunk_ranges =
+        new_plan.chunk_ranges[entry.first];
+    int64_t preceding_duration = 0;
+    for (uint32_t chunk = 0; chunk < new_plan.num_chunks; ++chunk) {
+      const size_t first_segment = chunk * segments_per_chunk;
+      const size_t end_segment = first_segment + segments_per_chunk;
+      VodChunkPlan::ChunkRange chunk_range;
+      chunk_range.start_dts = chunk == 0 ? std::numeric_limits<int64_t>::min()
+                                         : segments[first_segment].dts;
+      chunk_range.end_dts = chunk + 1 < new_plan.num_chunks
+                                ? segments[end_segment].dts
+                                : std::numeric_limits<int64_t>::max();
+      chunk_range.preceding_duration = preceding_duration;
+      chunk_ranges.push_back(chunk_range);
+      for (size_t i = first_segment;
+           i < std::min(end_segment, segments.size()); ++i) {
+        preceding_duration += segments[i].duration;
+      }
+    }
+  }
+
+  *plan = std::move(new_plan);
+  return Status::OK;
+}
+
+void VodChunkPlanner::Cancel() {
+  base::AutoLock auto_lock(lock_);
+  cancelled_ = true;
+  if (demuxer_)
+    demuxer_->Cancel();
+}
+
+}  // namespace media
+}  // namespace shaka
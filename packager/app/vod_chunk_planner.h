@@ -0,0 +1,105 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_APP_VOD_CHUNK_PLANNER_H_
+#define PACKAGER_APP_VOD_CHUNK_PLANNER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "packager/base/synchronization/lock.h"
+#include "packager/media/public/chunking_params.h"
+#include "packager/status.h"
+
+namespace shaka {
+namespace media {
+
+class Demuxer;
+
+/// The chunks which the timeline of a VOD input is split into, to be packaged
+/// in parallel, see ParallelVodParams. A chunk consists of whole segments,
+/// i.e. the samples from a key frame which starts a segment to the key frame
+/// which starts the first segment of the next chunk.
+struct VodChunkPlan {
+  /// Number of chunks. One if the timeline is not split, e.g. because it has
+  /// a single segment.
+  uint32_t num_chunks = 1;
+  /// Number of segments of every chunk but the last one, which has the
+  /// remaining segments.
+  uint32_t segments_per_chunk = 0;
+
+  /// Timestamps of the first sample of a stream after chunking.
+  struct FirstSample {
+    int64_t pts = 0;
+    int64_t dts = 0;
+  };
+  /// The first samples of the streams with samples, keyed by stream selector.
+  std::map<std::string, FirstSample> first_samples;
+
+  /// The samples of a stream in a chunk, see Demuxer::SetSampleRange().
+  struct ChunkRange {
+    /// The decoding timestamp of the first sample of the chunk. The minimum
+    /// timestamp for the first chunk, so that it starts like the stream.
+    int64_t start_dts = 0;
+    /// The decoding timestamp of the first sample of the next chunk. The
+    /// maximum timestamp for the last chunk.
+    int64_t end_dts = 0;
+    /// The duration of the segments before the chunk, in the time scale of
+    /// the stream.
+    int64_t preceding_duration = 0;
+  };
+  /// The chunk ranges of the streams, keyed by stream selector. Empty if the
+  /// timeline is not split.
+  std::map<std::string, std::vector<ChunkRange>> chunk_ranges;
+};
+
+/// Plans the chunks of VOD inputs. Planning scans the inputs, so it can be
+/// cancelled from another thread.
+class VodChunkPlanner {
+ public:
+  VodChunkPlanner();
+  ~VodChunkPlanner();
+
+  /// Plans the chunks of the input of @a demuxer from the segments of its
+  /// streams, which start at key frames. The input is scanned once without
+  /// reading the sample data if the demuxer supports it, e.g. for MP4. Inputs
+  /// of unknown duration which the demuxer would have to read in full, e.g.
+  /// MPEG-2 TS, are not split.
+  /// @param demuxer is a new demuxer of the input, which is used up.
+  /// @param stream_selectors are the streams of the input which are packaged.
+  /// @param chunking_params are the chunking parameters of the streams.
+  /// @param max_num_chunks is the maximum number of chunks.
+  /// @param plan[out] is set to the plan on success.
+  /// @return CANCELLED if Cancel() is called before or during the planning.
+  Status Plan(std::shared_ptr<Demuxer> demuxer,
+              const std::vector<std::string>& stream_selectors,
+              const ChunkingParams& chunking_params,
+              uint32_t max_num_chunks,
+              VodChunkPlan* plan);
+
+  /// Cancels the planning in progress and the later ones. Can be called from
+  /// any thread.
+  void Cancel();
+
+ private:
+  VodChunkPlanner(const VodChunkPlanner&) = delete;
+  VodChunkPlanner& operator=(const VodChunkPlanner&) = delete;
+
+  // Protects |cancelled_| and |demuxer_|.
+  base::Lock lock_;
+  bool cancelled_ = false;
+  // The demuxer of the planning in progress, if any.
+  std::shared_ptr<Demuxer> demuxer_;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_APP_VOD_CHUNK_PLANNER_H_
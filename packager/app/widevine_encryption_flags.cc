@@ -58,6 +58,12 @@ DEFINE_int32(crypto_period_duration,
              0,
              "Crypto period duration in seconds. If it is non-zero, key "
              "rotation is enabled.");
+DEFINE_int32(crypto_period_count,
+             10,
+             "Number of crypto periods to request from Widevine key server in "
+             "a single key rotation request. Keys are prefetched ahead of the "
+             "crypto period being encrypted. Only applicable if key rotation "
+             "is enabled.");
 DEFINE_hex_bytes(group_id, "", "Identifier for a group of licenses (hex).");
 DEFINE_bool(enable_entitlement_license,
             false,
@@ -168,6 +174,10 @@ bool ValidateWidevineCryptoFlags() {
     PrintError("--crypto_period_duration should not be negative.");
     success = false;
   }
+  if (FLAGS_crypto_period_count <= 0) {
+    PrintError("--crypto_period_count should be positive.");
+    success = false;
+  }
   return success;
 }
 
@@ -0,0 +1,170 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/checkpoint.h"
+
+#include "packager/base/logging.h"
+#include "packager/checkpoint.pb.h"
+#include "packager/file/file.h"
+
+namespace shaka {
+namespace {
+
+void ToProto(const hls::MediaPlaylistState& state,
+             Checkpoint::MediaPlaylist* media_playlist) {
+  media_playlist->set_media_sequence_number(state.media_sequence_number);
+  media_playlist->set_discontinuity_sequence_number(
+      state.discontinuity_sequence_number);
+  media_playlist->set_inserted_discontinuity_tag(
+      state.inserted_discontinuity_tag);
+  media_playlist->set_previous_segment_end_offset(
+      state.previous_segment_end_offset);
+  for (const hls::MediaPlaylistState::Entry& entry : state.entries) {
+    Checkpoint::HlsEntry* hls_entry = media_playlist->add_entries();
+    hls_entry->set_type(static_cast<int32_t>(entry.type));
+    if (entry.type != hls::HlsEntry::EntryType::kExtInf) {
+      hls_entry->set_tags(entry.tags);
+      continue;
+    }
+    hls_entry->set_file_name(entry.file_name);
+    hls_entry->set_start_time(entry.start_time);
+    hls_entry->set_duration(entry.duration);
+    hls_entry->set_use_byte_range(entry.use_byte_range);
+    hls_entry->set_start_byte_offset(entry.start_byte_offset);
+    hls_entry->set_size(entry.size);
+    hls_entry->set_previous_segment_end_offset(
+        entry.previous_segment_end_offset);
+  }
+}
+
+void FromProto(const Checkpoint::MediaPlaylist& media_playlist,
+               hls::MediaPlaylistState* state) {
+  state->media_sequence_number = media_playlist.media_sequence_number();
+  state->discontinuity_sequence_number =
+      media_playlist.discontinuity_sequence_number();
+  state->inserted_discontinuity_tag =
+      media_playlist.inserted_discontinuity_tag();
+  state->previous_segment_end_offset =
+      media_playlist.previous_segment_end_offset();
+  for (const Checkpoint::HlsEntry& hls_entry : media_playlist.entries()) {
+    hls::MediaPlaylistState::Entry entry;
+    entry.type = static_cast<hls::HlsEntry::EntryType>(hls_entry.type());
+    entry.tags = hls_entry.tags();
+    entry.file_name = hls_entry.file_name();
+    entry.start_time = hls_entry.start_time();
+    entry.duration = hls_entry.duration();
+    entry.use_byte_range = hls_entry.use_byte_range();
+    entry.start_byte_offset = hls_entry.start_byte_offset();
+    entry.size = hls_entry.size();
+    entry.previous_segment_end_offset =
+        hls_entry.previous_segment_end_offset();
+    state->entries.push_back(entry);
+  }
+}
+
+void ToProto(const MpdState::RepresentationState& state,
+             Checkpoint::Representation* representation) {
+  representation->set_segment_template(state.key);
+  representation->set_period_start_time_seconds(
+      state.period_start_time_seconds);
+  representation->set_start_number(state.start_number);
+  for (const SegmentInfo& segment_info : state.segment_infos) {
+    Checkpoint::Segment* segment = representation->add_segments();
+    segment->set_start_time(segment_info.start_time);
+    segment->set_duration(segment_info.duration);
+    segment->set_repeat(segment_info.repeat);
+  }
+}
+
+void FromProto(const Checkpoint::Representation& representation,
+               MpdState::RepresentationState* state) {
+  state->key = representation.segment_template();
+  state->period_start_time_seconds =
+      representation.period_start_time_seconds();
+  state->start_number = representation.start_number();
+  for (const Checkpoint::Segment& segment : representation.segments()) {
+    SegmentInfo segment_info;
+    segment_info.start_time = segment.start_time();
+    segment_info.duration = segment.duration();
+    segment_info.repeat = segment.repeat();
+    state->segment_infos.push_back(segment_info);
+  }
+}
+
+}  // namespace
+
+Status WriteCheckpoint(const PackagerCheckpoint& checkpoint,
+                       const std::string& checkpoint_file) {
+  Checkpoint checkpoint_proto;
+  for (const auto& entry : checkpoint.next_segment_indices) {
+    Checkpoint::Output* output = checkpoint_proto.add_outputs();
+    output->set_segment_template(entry.first);
+    output->set_next_segment_index(entry.second);
+  }
+  for (const auto& entry : checkpoint.media_playlists) {
+    Checkpoint::MediaPlaylist* media_playlist =
+        checkpoint_proto.add_media_playlists();
+    media_playlist->set_playlist_name(entry.first);
+    ToProto(entry.second, media_playlist);
+  }
+  checkpoint_proto.set_availability_start_time(
+      checkpoint.mpd_state.availability_start_time);
+  for (const MpdState::RepresentationState& representation :
+       checkpoint.mpd_state.representations) {
+    ToProto(representation, checkpoint_proto.add_representations());
+  }
+
+  std::string contents;
+  if (!checkpoint_proto.SerializeToString(&contents))
+    return Status(error::INTERNAL_ERROR, "Failed to serialize checkpoint.");
+  if (!File::WriteFileAtomically(checkpoint_file.c_str(), contents)) {
+    return Status(error::FILE_FAILURE,
+                  "Failed to write checkpoint to " + checkpoint_file);
+  }
+  return Status::OK;
+}
+
+Status ReadCheckpoint(const std::string& checkpoint_file,
+                      PackagerCheckpoint* checkpoint,
+                      bool* found) {
+  DCHECK(checkpoint);
+  DCHECK(found);
+
+  *found = File::GetFileSize(checkpoint_file.c_str()) >= 0;
+  if (!*found)
+    return Status::OK;
+
+  std::string contents;
+  if (!File::ReadFileToString(checkpoint_file.c_str(), &contents)) {
+    return Status(error::FILE_FAILURE,
+                  "Failed to read checkpoint from " + checkpoint_file);
+  }
+  Checkpoint checkpoint_proto;
+  if (!checkpoint_proto.ParseFromString(contents)) {
+    return Status(error::PARSER_FAILURE,
+                  "Failed to parse checkpoint " + checkpoint_file);
+  }
+
+  for (const Checkpoint::Output& output : checkpoint_proto.outputs()) {
+    checkpoint->next_segment_indices[output.segment_template()] =
+        output.next_segment_index();
+  }
+  for (const Checkpoint::MediaPlaylist& media_playlist :
+       checkpoint_proto.media_playlists()) {
+    FromProto(media_playlist,
+              &checkpoint->media_playlists[media_playlist.playlist_name()]);
+  }
+  checkpoint->mpd_state.availability_start_time =
+      checkpoint_proto.availability_start_time();
+  for (const Checkpoint::Representation& representation :
+       checkpoint_proto.representations()) {
+    checkpoint->mpd_state.representations.emplace_back();
+    FromProto(representation, &checkpoint->mpd_state.representations.back());
+  }
+  return Status::OK;
+}
+
+}  // namespace shaka
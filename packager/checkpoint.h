@@ -0,0 +1,47 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_CHECKPOINT_H_
+#define PACKAGER_CHECKPOINT_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+#include "packager/hls/base/media_playlist.h"
+#include "packager/mpd/base/mpd_notifier.h"
+#include "packager/status.h"
+
+namespace shaka {
+
+/// State of a live packager which is saved in checkpoints, so that packaging
+/// can resume after a restart, see CheckpointParams.
+struct PackagerCheckpoint {
+  /// Index of the next segment of every output, keyed by segment template.
+  std::map<std::string, uint32_t> next_segment_indices;
+  /// HLS media playlists, keyed by playlist name.
+  std::map<std::string, hls::MediaPlaylistState> media_playlists;
+  MpdState mpd_state;
+};
+
+/// Writes @a checkpoint to @a checkpoint_file atomically, so that a crash
+/// while writing leaves the previous checkpoint intact.
+Status WriteCheckpoint(const PackagerCheckpoint& checkpoint,
+                       const std::string& checkpoint_file);
+
+/// Reads a checkpoint written by WriteCheckpoint().
+/// @param found[out] is set to false if @a checkpoint_file does not exist, in
+///        which case @a checkpoint is left unchanged.
+/// @return OK on success or if the file does not exist, an error if the file
+///         cannot be read or parsed.
+Status ReadCheckpoint(const std::string& checkpoint_file,
+                      PackagerCheckpoint* checkpoint,
+                      bool* found);
+
+}  // namespace shaka
+
+#endif  // PACKAGER_CHECKPOINT_H_
@@ -0,0 +1,103 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include "packager/file/file.h"
+
+namespace shaka {
+namespace {
+const char kCheckpointFile[] = "memory://checkpoint";
+}  // namespace
+
+TEST(CheckpointTest, NotFound) {
+  PackagerCheckpoint checkpoint;
+  bool found = true;
+  ASSERT_TRUE(ReadCheckpoint("memory://not_found", &checkpoint, &found).ok());
+  EXPECT_FALSE(found);
+}
+
+TEST(CheckpointTest, WriteAndRead) {
+  PackagerCheckpoint checkpoint;
+  checkpoint.next_segment_indices["video-$Number$.m4s"] = 123;
+  checkpoint.next_segment_indices["audio-$Number$.m4s"] = 124;
+
+  hls::MediaPlaylistState& media_playlist =
+      checkpoint.media_playlists["video.m3u8"];
+  media_playlist.media_sequence_number = 10;
+  media_playlist.discontinuity_sequence_number = 2;
+  media_playlist.inserted_discontinuity_tag = true;
+  hls::MediaPlaylistState::Entry key_entry;
+  key_entry.type = hls::HlsEntry::EntryType::kExtKey;
+  key_entry.tags = "#EXT-X-KEY:METHOD=SAMPLE-AES,URI=\"skd://1\"";
+  media_playlist.entries.push_back(key_entry);
+  hls::MediaPlaylistState::Entry segment_entry;
+  segment_entry.file_name = "video-11.ts";
+  segment_entry.start_time = 100.5;
+  segment_entry.duration = 10;
+  segment_entry.size = 5000;
+  media_playlist.entries.push_back(segment_entry);
+
+  checkpoint.mpd_state.availability_start_time = "2020-01-01T00:00:00Z";
+  MpdState::RepresentationState representation;
+  representation.key = "video-$Number$.m4s";
+  representation.period_start_time_seconds = 60;
+  representation.start_number = 7;
+  representation.segment_infos.push_back({900000, 90000, 3});
+  checkpoint.mpd_state.representations.push_back(representation);
+
+  ASSERT_TRUE(WriteCheckpoint(checkpoint, kCheckpointFile).ok());
+
+  PackagerCheckpoint restored;
+  bool found = false;
+  ASSERT_TRUE(ReadCheckpoint(kCheckpointFile, &restored, &found).ok());
+  ASSERT_TRUE(found);
+
+  EXPECT_EQ(checkpoint.next_segment_indices, restored.next_segment_indices);
+
+  ASSERT_EQ(1u, restored.media_playlists.count("video.m3u8"));
+  const hls::MediaPlaylistState& restored_playlist =
+      restored.media_playlists["video.m3u8"];
+  EXPECT_EQ(10, restored_playlist.media_sequence_number);
+  EXPECT_EQ(2, restored_playlist.discontinuity_sequence_number);
+  EXPECT_TRUE(restored_playlist.inserted_discontinuity_tag);
+  ASSERT_EQ(2u, restored_playlist.entries.size());
+  EXPECT_EQ(hls::HlsEntry::EntryType::kExtKey,
+            restored_playlist.entries[0].type);
+  EXPECT_EQ(key_entry.tags, restored_playlist.entries[0].tags);
+  EXPECT_EQ(hls::HlsEntry::EntryType::kExtInf,
+            restored_playlist.entries[1].type);
+  EXPECT_EQ("video-11.ts", restored_playlist.entries[1].file_name);
+  EXPECT_EQ(100.5, restored_playlist.entries[1].start_time);
+  EXPECT_EQ(10, restored_playlist.entries[1].duration);
+  EXPECT_EQ(5000u, restored_playlist.entries[1].size);
+
+  EXPECT_EQ("2020-01-01T00:00:00Z",
+            restored.mpd_state.availability_start_time);
+  ASSERT_EQ(1u, restored.mpd_state.representations.size());
+  const MpdState::RepresentationState& restored_representation =
+      restored.mpd_state.representations[0];
+  EXPECT_EQ("video-$Number$.m4s", restored_representation.key);
+  EXPECT_EQ(60, restored_representation.period_start_time_seconds);
+  EXPECT_EQ(7u, restored_representation.start_number);
+  ASSERT_EQ(1u, restored_representation.segment_infos.size());
+  EXPECT_EQ(900000, restored_representation.segment_infos.front().start_time);
+  EXPECT_EQ(90000, restored_representation.segment_infos.front().duration);
+  EXPECT_EQ(3u, restored_representation.segment_infos.front().repeat);
+}
+
+TEST(CheckpointTest, Corrupted) {
+  ASSERT_TRUE(File::WriteStringToFile(kCheckpointFile, "not a checkpoint"));
+  PackagerCheckpoint checkpoint;
+  bool found = false;
+  EXPECT_EQ(error::PARSER_FAILURE,
+            ReadCheckpoint(kCheckpointFile, &checkpoint, &found).error_code());
+  EXPECT_TRUE(found);
+}
+
+}  // namespace shaka
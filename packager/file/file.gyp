@@ -36,6 +36,8 @@
       ],
       'dependencies': [
         '../base/base.gyp:base',
+        '../packager.gyp:memory_tracker',
+        '../packager.gyp:trace_event',
         '../third_party/gflags/gflags.gyp:gflags',
       ],
     },
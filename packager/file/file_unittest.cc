@@ -9,6 +9,7 @@
 
 #include "packager/base/files/file_util.h"
 #include "packager/file/file.h"
+#include "packager/memory_tracker.h"
 
 DECLARE_uint64(io_cache_size);
 DECLARE_uint64(io_block_size);
@@ -195,6 +196,28 @@ TEST_F(LocalFileTest, WriteFlushCheckSize) {
   }
 }
 
+TEST_F(LocalFileTest, CacheCapacityIsExcludedFromSoftLimit) {
+  ASSERT_EQ(kDataSize,
+            base::WriteFile(test_file_path_, data_.data(), kDataSize));
+  MemoryAccounting accounting;
+  MemoryAccounting::ScopedJob scoped_job(&accounting, "job");
+  // The limit is below the capacity reserved for the cache of the file.
+  accounting.SetSoftLimit(kDataSize);
+
+  File* file = File::Open(local_file_name_.c_str(), "r");
+  ASSERT_TRUE(file != NULL);
+  EXPECT_LT(kDataSize, accounting.reserved_bytes());
+  EXPECT_TRUE(
+      MemoryAccounting::WaitForSoftLimit(base::TimeDelta::FromSeconds(1)));
+  std::string read_data(kDataSize, 0);
+  EXPECT_EQ(kDataSize, file->Read(&read_data[0], kDataSize));
+  EXPECT_EQ(data_, read_data);
+  EXPECT_TRUE(file->Close());
+
+  EXPECT_EQ(base::TimeDelta(), accounting.total_wait_time());
+  EXPECT_EQ(0, accounting.reserved_bytes());
+}
+
 TEST_F(LocalFileTest, IsLocalReguar) {
   ASSERT_EQ(kDataSize,
             base::WriteFile(test_file_path_, data_.data(), kDataSize));
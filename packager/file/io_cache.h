@@ -62,6 +62,9 @@ class IoCache {
   /// Waits until the cache is empty or has been closed.
   void WaitUntilEmptyOrClosed();
 
+  /// @return the capacity of the cache in bytes.
+  uint64_t cache_size() const { return cache_size_; }
+
  private:
   uint64_t BytesCachedInternal();
   uint64_t BytesFreeInternal();
@@ -15,6 +15,7 @@
 #include "packager/base/files/file_path.h"
 #include "packager/base/files/file_util.h"
 #include "packager/base/logging.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 namespace {
@@ -102,6 +103,7 @@ LocalFile::LocalFile(const char* file_name, const char* mode)
 }
 
 bool LocalFile::Close() {
+  SHAKA_TRACE_EVENT("file", "LocalFile::Close");
   bool result = true;
   if (internal_file_) {
     result = base::CloseFile(internal_file_);
@@ -124,6 +126,7 @@ int64_t LocalFile::Read(void* buffer, uint64_t length) {
 }
 
 int64_t LocalFile::Write(const void* buffer, uint64_t length) {
+  SHAKA_TRACE_EVENT("file", "LocalFile::Write");
   DCHECK(buffer != NULL);
   DCHECK(internal_file_ != NULL);
   size_t bytes_written = fwrite(buffer, sizeof(char), length, internal_file_);
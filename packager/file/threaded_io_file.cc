@@ -10,6 +10,7 @@
 #include "packager/base/bind_helpers.h"
 #include "packager/base/location.h"
 #include "packager/base/threading/worker_pool.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 
@@ -30,7 +31,10 @@ ThreadedIoFile::ThreadedIoFile(std::unique_ptr<File, FileCloser> internal_file,
                             base::WaitableEvent::InitialState::NOT_SIGNALED),
       internal_file_error_(0),
       task_exit_event_(base::WaitableEvent::ResetPolicy::AUTOMATIC,
-                       base::WaitableEvent::InitialState::NOT_SIGNALED) {
+                       base::WaitableEvent::InitialState::NOT_SIGNALED),
+      memory_tracker_("ThreadedIoFile",
+                      file_name(),
+                      MemoryTracker::kReserved) {
   DCHECK(internal_file_);
 }
 
@@ -44,6 +48,9 @@ bool ThreadedIoFile::Open() {
 
   position_ = 0;
   size_ = internal_file_->Size();
+  // Attributed to the job opening the file. The capacity is allocated up front
+  // and kept until the file is closed, so it is reserved.
+  memory_tracker_.Set(cache_.cache_size() + io_buffer_.size());
 
   base::WorkerPool::PostTask(
       FROM_HERE,
@@ -53,6 +60,7 @@ bool ThreadedIoFile::Open() {
 }
 
 bool ThreadedIoFile::Close() {
+  SHAKA_TRACE_EVENT("file", "ThreadedIoFile::Close");
   DCHECK(internal_file_);
 
   bool result = true;
@@ -84,6 +92,7 @@ int64_t ThreadedIoFile::Read(void* buffer, uint64_t length) {
 }
 
 int64_t ThreadedIoFile::Write(const void* buffer, uint64_t length) {
+  SHAKA_TRACE_EVENT("file", "ThreadedIoFile::Write");
   DCHECK(internal_file_);
   DCHECK_EQ(kOutputMode, mode_);
 
@@ -105,6 +114,7 @@ int64_t ThreadedIoFile::Size() {
 }
 
 bool ThreadedIoFile::Flush() {
+  SHAKA_TRACE_EVENT("file", "ThreadedIoFile::Flush");
   DCHECK(internal_file_);
   DCHECK_EQ(kOutputMode, mode_);
 
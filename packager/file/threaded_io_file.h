@@ -13,6 +13,7 @@
 #include "packager/file/file.h"
 #include "packager/file/file_closer.h"
 #include "packager/file/io_cache.h"
+#include "packager/memory_tracker.h"
 
 namespace shaka {
 
@@ -61,6 +62,8 @@ class ThreadedIoFile : public File {
   std::atomic<int32_t> internal_file_error_;
   // Signalled when thread task exits.
   base::WaitableEvent task_exit_event_;
+  // Tracks the memory of |cache_| and |io_buffer_|.
+  MemoryTracker memory_tracker_;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadedIoFile);
 };
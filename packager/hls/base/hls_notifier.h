@@ -7,6 +7,7 @@
 #ifndef PACKAGER_HLS_BASE_HLS_NOTIFIER_H_
 #define PACKAGER_HLS_BASE_HLS_NOTIFIER_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -23,6 +24,7 @@ namespace media {
 }  
 namespace hls {
 
+struct MediaPlaylistState;
 
 // TODO(rkuroiwa): Consider merging this with MpdNotifier.
 class HlsNotifier {
@@ -96,6 +98,28 @@ class HlsNotifier {
       const std::vector<uint8_t>& iv,
       const std::vector<uint8_t>& protection_system_specific_data) = 0;
 
+  /// Removes the stream from the master playlist, e.g. when a rendition is
+  /// dropped while packaging live content. Its media playlist is no longer
+  /// updated.
+  /// @param stream_id is the value set by NotifyNewStream(). It cannot be
+  ///        used after this call.
+  /// @return true on success, false otherwise.
+  virtual bool NotifyStreamRemoved(uint32_t stream_id) = 0;
+
+  /// Saves the state of the media playlists to a checkpoint, so that live
+  /// packaging can resume after a restart. No-op by default.
+  /// @param states[out] gets the state of the media playlists, keyed by
+  ///        playlist name.
+  virtual void SaveState(std::map<std::string, MediaPlaylistState>* states) {}
+
+  /// Restores the media playlists saved by SaveState(). A playlist is
+  /// restored when its stream is added by NotifyNewStream(), so this should
+  /// be called before adding any stream. No-op by default.
+  /// @param states is the state of the media playlists, keyed by playlist
+  ///        name.
+  virtual void RestoreState(
+      const std::map<std::string, MediaPlaylistState>& states) {}
+
   /// Process any current buffered states/resources.
   /// @return true on success, false otherwise.
   virtual bool Flush() = 0;
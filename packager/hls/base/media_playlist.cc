@@ -160,9 +160,16 @@ class SegmentInfoEntry : public HlsEntry {
                    uint64_t previous_segment_end_offset);
 
   std::string ToString() override;
+  const std::string& file_name() const { return file_name_; }
   double start_time() const { return start_time_; }
   double duration() const { return duration_; }
   void set_duration(double duration) { duration_ = duration; }
+  bool use_byte_range() const { return use_byte_range_; }
+  uint64_t start_byte_offset() const { return start_byte_offset_; }
+  uint64_t segment_file_size() const { return segment_file_size_; }
+  uint64_t previous_segment_end_offset() const {
+    return previous_segment_end_offset_;
+  }
 
  private:
   SegmentInfoEntry(const SegmentInfoEntry&) = delete;
@@ -555,6 +562,28 @@ std::string SignalReturnEntry::ToString() {
 }
 
 
+// An entry other than a segment restored from a checkpoint. Its tags are
+// written as saved.
+class RestoredEntry : public HlsEntry {
+ public:
+  RestoredEntry(EntryType type, const std::string& tags);
+
+  std::string ToString() override;
+
+ private:
+  RestoredEntry(const RestoredEntry&) = delete;
+  RestoredEntry& operator=(const RestoredEntry&) = delete;
+
+  const std::string tags_;
+};
+
+RestoredEntry::RestoredEntry(EntryType type, const std::string& tags)
+    : HlsEntry(type), tags_(tags) {}
+
+std::string RestoredEntry::ToString() {
+  return tags_;
+}
+
 double LatestSegmentStartTime(
     const std::list<std::unique_ptr<HlsEntry>>& entries) {
   DCHECK(!entries.empty());
@@ -581,7 +610,8 @@ MediaPlaylist::MediaPlaylist(const HlsParams& hls_params,
       file_name_(file_name),
       name_(name),
       group_id_(group_id),
-      bandwidth_estimator_(hls_params_.target_segment_duration) {}
+      bandwidth_estimator_(hls_params_.target_segment_duration),
+      entries_memory_tracker_("MediaPlaylist", name) {}
 
 MediaPlaylist::~MediaPlaylist() {}
 
@@ -782,6 +812,61 @@ bool MediaPlaylist::WriteToFile(const std::string& file_path) {
   return true;
 }
 
+void MediaPlaylist::SaveState(MediaPlaylistState* state) {
+  DCHECK(state);
+  state->media_sequence_number = media_sequence_number_;
+  state->discontinuity_sequence_number = discontinuity_sequence_number_;
+  state->inserted_discontinuity_tag = inserted_discontinuity_tag_;
+  state->previous_segment_end_offset = previous_segment_end_offset_;
+  state->entries.clear();
+  state->entries.reserve(entries_.size());
+  for (const auto& entry : entries_) {
+    MediaPlaylistState::Entry saved_entry;
+    saved_entry.type = entry->type();
+    if (entry->type() == HlsEntry::EntryType::kExtInf) {
+      const SegmentInfoEntry& segment_info =
+          *reinterpret_cast<SegmentInfoEntry*>(entry.get());
+      saved_entry.file_name = segment_info.file_name();
+      saved_entry.start_time = segment_info.start_time();
+      saved_entry.duration = segment_info.duration();
+      saved_entry.use_byte_range = segment_info.use_byte_range();
+      saved_entry.start_byte_offset = segment_info.start_byte_offset();
+      saved_entry.size = segment_info.segment_file_size();
+      saved_entry.previous_segment_end_offset =
+          segment_info.previous_segment_end_offset();
+    } else {
+      saved_entry.tags = entry->ToString();
+    }
+    state->entries.push_back(std::move(saved_entry));
+  }
+}
+
+void MediaPlaylist::RestoreState(const MediaPlaylistState& state) {
+  media_sequence_number_ = state.media_sequence_number;
+  discontinuity_sequence_number_ = state.discontinuity_sequence_number;
+  inserted_discontinuity_tag_ = state.inserted_discontinuity_tag;
+  previous_segment_end_offset_ = state.previous_segment_end_offset;
+  entries_.clear();
+  size_t file_name_size = 0;
+  for (const MediaPlaylistState::Entry& saved_entry : state.entries) {
+    if (saved_entry.type != HlsEntry::EntryType::kExtInf) {
+      entries_.emplace_back(new RestoredEntry(saved_entry.type,
+                                              saved_entry.tags));
+      continue;
+    }
+    entries_.emplace_back(new SegmentInfoEntry(
+        saved_entry.file_name, saved_entry.start_time, saved_entry.duration,
+        saved_entry.use_byte_range, saved_entry.start_byte_offset,
+        saved_entry.size, saved_entry.previous_segment_end_offset));
+    longest_segment_duration_ =
+        std::max(longest_segment_duration_, saved_entry.duration);
+    bandwidth_estimator_.AddBlock(saved_entry.size, saved_entry.duration);
+    file_name_size = saved_entry.file_name.size();
+  }
+  entries_memory_tracker_.Set(entries_.size() *
+                              (sizeof(SegmentInfoEntry) + file_name_size));
+}
+
 uint64_t MediaPlaylist::MaxBitrate() const {
   if (media_info_.has_bandwidth())
     return media_info_.bandwidth();
@@ -899,6 +984,9 @@ void MediaPlaylist::AddSegmentInfoEntry(const std::string& segment_file_name,
   previous_segment_end_offset_ = start_byte_offset + size - 1;
   ++ad_segments_;
   SlideWindow();
+  // Most of the entries are segments with similar file names.
+  entries_memory_tracker_.Set(
+      entries_.size() * (sizeof(SegmentInfoEntry) + segment_file_name.size()));
 }
 
 void MediaPlaylist::AdjustLastSegmentInfoEntryDuration(int64_t next_timestamp) {
@@ -14,6 +14,7 @@
 
 #include "packager/base/macros.h"
 #include "packager/hls/public/hls_params.h"
+#include "packager/memory_tracker.h"
 #include "packager/mpd/base/bandwidth_estimator.h"
 #include "packager/mpd/base/media_info.pb.h"
 
@@ -61,6 +62,30 @@ class HlsEntry {
   EntryType type_;
 };
 
+/// State of a MediaPlaylist which is saved in checkpoints, so that a live
+/// playlist can be resumed after the packager restarts.
+struct MediaPlaylistState {
+  struct Entry {
+    HlsEntry::EntryType type = HlsEntry::EntryType::kExtInf;
+    /// The tags of the entry if it is not a segment.
+    std::string tags;
+    /// The segment if the entry is a segment, i.e. of type kExtInf.
+    std::string file_name;
+    double start_time = 0;
+    double duration = 0;
+    bool use_byte_range = false;
+    uint64_t start_byte_offset = 0;
+    uint64_t size = 0;
+    uint64_t previous_segment_end_offset = 0;
+  };
+
+  int media_sequence_number = 0;
+  int discontinuity_sequence_number = 0;
+  bool inserted_discontinuity_tag = false;
+  uint64_t previous_segment_end_offset = 0;
+  std::vector<Entry> entries;
+};
+
 /// Methods are virtual for mocking.
 class MediaPlaylist {
  public:
@@ -195,6 +220,16 @@ class MediaPlaylist {
   /// @return true on success, false otherwise.
   virtual bool WriteToFile(const std::string& file_path);
 
+  /// Saves the entries and the sequence numbers of the playlist.
+  /// @param state[out] is set to the state of the playlist.
+  virtual void SaveState(MediaPlaylistState* state);
+
+  /// Restores the state saved by SaveState(), e.g. by a packager before it
+  /// restarted. Should be called after SetMediaInfo() and before any segment
+  /// is added. The bandwidth estimate is rebuilt from the restored segments.
+  /// @param state is the state to restore.
+  virtual void RestoreState(const MediaPlaylistState& state);
+
   /// If bitrate is specified in MediaInfo then it will use that value.
   /// Otherwise, returns the max bitrate.
   /// @return the max bitrate (in bits per second) of this MediaPlaylist.
@@ -287,6 +322,8 @@ class MediaPlaylist {
   uint32_t target_duration_ = 0;
 
   std::list<std::unique_ptr<HlsEntry>> entries_;
+  // Tracks the memory of |entries_|.
+  MemoryTracker entries_memory_tracker_;
   // A list to hold the file names of the segments to be removed temporarily.
   // Once a file is actually removed, it is removed from the list.
   std::list<std::string> segments_to_be_removed_;
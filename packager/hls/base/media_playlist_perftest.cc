@@ -0,0 +1,68 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures MediaPlaylist::WriteToFile for a long VOD playlist.
+
+#include <gtest/gtest.h>
+
+#include "packager/base/strings/stringprintf.h"
+#include "packager/base/time/time.h"
+#include "packager/hls/base/media_playlist.h"
+#include "packager/testing/perf/perf_test.h"
+#include "packager/version/version.h"
+
+namespace shaka {
+namespace hls {
+
+namespace {
+
+const int kNumIterations = 20;
+// Two hours of 2 second segments.
+const int kNumSegments = 3600;
+const uint32_t kTimeScale = 90000;
+const uint64_t kZeroByteOffset = 0;
+
+}  // namespace
+
+TEST(MediaPlaylistPerfTest, WriteToFile) {
+  SetPackagerVersionForTesting("perftest");
+
+  HlsParams hls_params;
+  hls_params.playlist_type = HlsPlaylistType::kVod;
+  MediaPlaylist media_playlist(hls_params, "media.m3u8", "name", "group_id");
+
+  MediaInfo media_info;
+  MediaInfo::VideoInfo* video_info = media_info.mutable_video_info();
+  video_info->set_codec("avc1");
+  video_info->set_time_scale(kTimeScale);
+  video_info->set_frame_duration(3000);
+  video_info->set_width(1280);
+  video_info->set_height(720);
+  video_info->set_pixel_width(1);
+  video_info->set_pixel_height(1);
+  media_info.set_reference_time_scale(kTimeScale);
+  media_info.set_segment_template_url("file$Number$.ts");
+  ASSERT_TRUE(media_playlist.SetMediaInfo(media_info));
+
+  const int64_t kDuration = kTimeScale * 2;
+  for (int i = 0; i < kNumSegments; ++i) {
+    media_playlist.AddSegment(base::StringPrintf("file%d.ts", i + 1),
+                              i * kDuration, kDuration, kZeroByteOffset,
+                              250000 + i % 100 * 100);
+  }
+
+  const char kMemoryFilePath[] = "memory://media.m3u8";
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i)
+    ASSERT_TRUE(media_playlist.WriteToFile(kMemoryFilePath));
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  perf_test::PrintResult("media_playlist_write", "", "3600_segments",
+                         elapsed.InMillisecondsF() / kNumIterations, "ms",
+                         true);
+}
+
+}  // namespace hls
+}  // namespace shaka
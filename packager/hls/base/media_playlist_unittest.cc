@@ -763,6 +763,57 @@ TEST_F(LiveMediaPlaylistTest, TimeShiftedWithEncryptionInfoShifted) {
   ASSERT_FILE_STREQ(kMemoryFilePath, kExpectedOutput);
 }
 
+TEST_F(LiveMediaPlaylistTest, SaveAndRestoreState) {
+  ASSERT_TRUE(media_playlist_->SetMediaInfo(valid_video_media_info_));
+
+  media_playlist_->AddSegment("file1.ts", 0, 10 * kTimeScale, kZeroByteOffset,
+                              kMBytes);
+  media_playlist_->AddEncryptionInfo(
+      MediaPlaylist::EncryptionMethod::kSampleAes, "http://example.com", "",
+      "0x12345678", "com.widevine", "1/2/4");
+  media_playlist_->AddSegment("file2.ts", 10 * kTimeScale, 20 * kTimeScale,
+                              kZeroByteOffset, 2 * kMBytes);
+  media_playlist_->AddEncryptionInfo(
+      MediaPlaylist::EncryptionMethod::kSampleAes, "http://example.com", "",
+      "0x22345678", "com.widevine", "1/2/4");
+  media_playlist_->AddSegment("file3.ts", 30 * kTimeScale, 20 * kTimeScale,
+                              kZeroByteOffset, 2 * kMBytes);
+
+  MediaPlaylistState state;
+  media_playlist_->SaveState(&state);
+  EXPECT_EQ(1, state.media_sequence_number);
+  EXPECT_EQ(1, state.discontinuity_sequence_number);
+
+  // Resume the playlist as if the packager restarted.
+  MediaPlaylist restored_playlist(hls_params_, default_file_name_,
+                                  default_name_, default_group_id_);
+  ASSERT_TRUE(restored_playlist.SetMediaInfo(valid_video_media_info_));
+  restored_playlist.RestoreState(state);
+  EXPECT_EQ(20.0, restored_playlist.GetLongestSegmentDuration());
+  restored_playlist.AddSegment("file4.ts", 50 * kTimeScale, 20 * kTimeScale,
+                               kZeroByteOffset, 2 * kMBytes);
+
+  const char kExpectedOutput[] =
+      "#EXTM3U\n"
+      "#EXT-X-VERSION:6\n"
+      "## Generated with https://github.com/google/shaka-packager version "
+      "test\n"
+      "#EXT-X-TARGETDURATION:20\n"
+      "#EXT-X-MEDIA-SEQUENCE:2\n"
+      "#EXT-X-DISCONTINUITY-SEQUENCE:1\n"
+      "#EXT-X-KEY:METHOD=SAMPLE-AES,"
+      "URI=\"http://example.com\",IV=0x22345678,KEYFORMATVERSIONS=\"1/2/4\","
+      "KEYFORMAT=\"com.widevine\"\n"
+      "#EXTINF:20.000,\n"
+      "file3.ts\n"
+      "#EXTINF:20.000,\n"
+      "file4.ts\n";
+
+  const char kMemoryFilePath[] = "memory://media.m3u8";
+  EXPECT_TRUE(restored_playlist.WriteToFile(kMemoryFilePath));
+  ASSERT_FILE_STREQ(kMemoryFilePath, kExpectedOutput);
+}
+
 class EventMediaPlaylistTest : public MediaPlaylistMultiSegmentTest {
  protected:
   EventMediaPlaylistTest()
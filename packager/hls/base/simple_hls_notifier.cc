@@ -20,6 +20,7 @@
 #include "packager/media/base/protection_system_specific_info.h"
 #include "packager/media/base/proto_json_util.h"
 #include "packager/media/base/widevine_pssh_data.pb.h"
+#include "packager/trace_event.h"
 
 DEFINE_bool(enable_legacy_widevine_hls_signaling,
             false,
@@ -332,6 +333,11 @@ bool SimpleHlsNotifier::NotifyNewStream(const MediaInfo& media_info,
   }
 
   base::AutoLock auto_lock(lock_);
+  auto state_iterator = states_to_restore_.find(media_playlist->file_name());
+  if (state_iterator != states_to_restore_.end()) {
+    media_playlist->RestoreState(state_iterator->second);
+    states_to_restore_.erase(state_iterator);
+  }
   *stream_id = sequence_number_++;
   media_playlists_.push_back(media_playlist.get());
   stream_map_[*stream_id].reset(
@@ -547,7 +553,48 @@ bool SimpleHlsNotifier::NotifyEncryptionUpdate(
   return true;
 }
 
+bool SimpleHlsNotifier::NotifyStreamRemoved(uint32_t stream_id) {
+  base::AutoLock auto_lock(lock_);
+  auto stream_iterator = stream_map_.find(stream_id);
+  if (stream_iterator == stream_map_.end()) {
+    LOG(ERROR) << "Cannot find stream with ID: " << stream_id;
+    return false;
+  }
+  media_playlists_.remove(stream_iterator->second->media_playlist.get());
+  stream_map_.erase(stream_iterator);
+
+  // The master playlist is otherwise only written on new segments in live
+  // mode, which may not come soon for the remaining streams.
+  if (hls_params().playlist_type == HlsPlaylistType::kLive ||
+      hls_params().playlist_type == HlsPlaylistType::kEvent) {
+    if (!master_playlist_->WriteMasterPlaylist(hls_params().base_url,
+                                               output_dir_, media_playlists_)) {
+      LOG(ERROR) << "Failed to write master playlist.";
+      return false;
+    }
+  }
+  return true;
+}
+
+void SimpleHlsNotifier::SaveState(
+    std::map<std::string, MediaPlaylistState>* states) {
+  DCHECK(states);
+  base::AutoLock auto_lock(lock_);
+  // Keep the state of the streams which are not added yet, e.g. if their
+  // input is late after a restart.
+  *states = states_to_restore_;
+  for (MediaPlaylist* playlist : media_playlists_)
+    playlist->SaveState(&(*states)[playlist->file_name()]);
+}
+
+void SimpleHlsNotifier::RestoreState(
+    const std::map<std::string, MediaPlaylistState>& states) {
+  base::AutoLock auto_lock(lock_);
+  states_to_restore_ = states;
+}
+
 bool SimpleHlsNotifier::Flush() {
+  SHAKA_TRACE_EVENT("notifier", "SimpleHlsNotifier::Flush");
   base::AutoLock auto_lock(lock_);
   for (MediaPlaylist* playlist : media_playlists_) {
     playlist->SetTargetDuration(target_duration_);
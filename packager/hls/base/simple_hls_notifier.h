@@ -66,6 +66,10 @@ class SimpleHlsNotifier : public HlsNotifier {
       const std::vector<uint8_t>& system_id,
       const std::vector<uint8_t>& iv,
       const std::vector<uint8_t>& protection_system_specific_data) override;
+  bool NotifyStreamRemoved(uint32_t stream_id) override;
+  void SaveState(std::map<std::string, MediaPlaylistState>* states) override;
+  void RestoreState(
+      const std::map<std::string, MediaPlaylistState>& states) override;
   bool Flush() override;
   /// }@
 
@@ -86,6 +90,9 @@ class SimpleHlsNotifier : public HlsNotifier {
   // Maps to unique_ptr because StreamEntry also holds unique_ptr
   std::map<uint32_t, std::unique_ptr<StreamEntry>> stream_map_;
   std::list<MediaPlaylist*> media_playlists_;
+  // Restored state of the playlists whose streams are not added yet, keyed
+  // by playlist name.
+  std::map<std::string, MediaPlaylistState> states_to_restore_;
 
   uint32_t sequence_number_ = 0;
 
@@ -26,7 +26,9 @@ namespace hls {
 using ::testing::_;
 using ::testing::ElementsAre;
 using ::testing::Eq;
+using ::testing::Field;
 using ::testing::InSequence;
+using ::testing::Invoke;
 using ::testing::Mock;
 using ::testing::Property;
 using ::testing::Return;
@@ -387,6 +389,51 @@ TEST_F(SimpleHlsNotifierTest, NotifyNewStream) {
   EXPECT_EQ(1u, NumRegisteredMediaPlaylists(notifier));
 }
 
+TEST_F(SimpleHlsNotifierTest, SaveAndRestoreState) {
+  std::unique_ptr<MockMasterPlaylist> mock_master_playlist(
+      new MockMasterPlaylist());
+  std::unique_ptr<MockMediaPlaylistFactory> factory(
+      new MockMediaPlaylistFactory());
+
+  // Pointer released by SimpleHlsNotifier.
+  MockMediaPlaylist* mock_media_playlist =
+      new MockMediaPlaylist("playlist1.m3u8", "", "");
+
+  EXPECT_CALL(*mock_media_playlist, SetMediaInfo(_)).WillOnce(Return(true));
+  EXPECT_CALL(*factory, CreateMock(_, StrEq("playlist1.m3u8"), _, _))
+      .WillOnce(Return(mock_media_playlist));
+
+  SimpleHlsNotifier notifier(hls_params_);
+  InjectMasterPlaylist(std::move(mock_master_playlist), &notifier);
+  InjectMediaPlaylistFactory(std::move(factory), &notifier);
+  EXPECT_TRUE(notifier.Init());
+
+  std::map<std::string, MediaPlaylistState> states;
+  states["playlist1.m3u8"].media_sequence_number = 10;
+  states["playlist2.m3u8"].media_sequence_number = 20;
+  notifier.RestoreState(states);
+
+  // The playlist is restored when its stream is added.
+  EXPECT_CALL(*mock_media_playlist,
+              RestoreState(Field(&MediaPlaylistState::media_sequence_number,
+                                 10)));
+  MediaInfo media_info;
+  uint32_t stream_id;
+  EXPECT_TRUE(notifier.NotifyNewStream(media_info, "playlist1.m3u8", "name",
+                                       "groupid", &stream_id));
+
+  // The state of the playlist not added yet is kept.
+  EXPECT_CALL(*mock_media_playlist, SaveState(_))
+      .WillOnce(Invoke([](MediaPlaylistState* state) {
+        state->media_sequence_number = 11;
+      }));
+  std::map<std::string, MediaPlaylistState> saved_states;
+  notifier.SaveState(&saved_states);
+  ASSERT_EQ(2u, saved_states.size());
+  EXPECT_EQ(11, saved_states["playlist1.m3u8"].media_sequence_number);
+  EXPECT_EQ(20, saved_states["playlist2.m3u8"].media_sequence_number);
+}
+
 TEST_F(SimpleHlsNotifierTest, NotifyNewSegment) {
   std::unique_ptr<MockMasterPlaylist> mock_master_playlist(
       new MockMasterPlaylist());
@@ -716,6 +763,52 @@ TEST_P(LiveOrEventSimpleHlsNotifierTest, NotifyNewSegmentsWithMultipleStreams) {
                                         kDuration, 0, kSize));
 }
 
+TEST_P(LiveOrEventSimpleHlsNotifierTest, NotifyStreamRemoved) {
+  std::unique_ptr<MockMasterPlaylist> mock_master_playlist(
+      new MockMasterPlaylist());
+  MockMasterPlaylist* mock_master_playlist_ptr = mock_master_playlist.get();
+  std::unique_ptr<MockMediaPlaylistFactory> factory(
+      new MockMediaPlaylistFactory());
+
+  // Pointers released by SimpleHlsNotifier.
+  MockMediaPlaylist* mock_media_playlist1 =
+      new MockMediaPlaylist("playlist1.m3u8", "", "");
+  MockMediaPlaylist* mock_media_playlist2 =
+      new MockMediaPlaylist("playlist2.m3u8", "", "");
+
+  EXPECT_CALL(*mock_media_playlist1, SetMediaInfo(_)).WillOnce(Return(true));
+  EXPECT_CALL(*mock_media_playlist2, SetMediaInfo(_)).WillOnce(Return(true));
+  EXPECT_CALL(*factory, CreateMock(_, StrEq("playlist1.m3u8"), _, _))
+      .WillOnce(Return(mock_media_playlist1));
+  EXPECT_CALL(*factory, CreateMock(_, StrEq("playlist2.m3u8"), _, _))
+      .WillOnce(Return(mock_media_playlist2));
+
+  hls_params_.playlist_type = GetParam();
+  SimpleHlsNotifier notifier(hls_params_);
+  InjectMasterPlaylist(std::move(mock_master_playlist), &notifier);
+  InjectMediaPlaylistFactory(std::move(factory), &notifier);
+  EXPECT_TRUE(notifier.Init());
+  MediaInfo media_info;
+  uint32_t stream_id1;
+  EXPECT_TRUE(notifier.NotifyNewStream(media_info, "playlist1.m3u8", "name",
+                                       "groupid", &stream_id1));
+  uint32_t stream_id2;
+  EXPECT_TRUE(notifier.NotifyNewStream(media_info, "playlist2.m3u8", "name",
+                                       "groupid", &stream_id2));
+
+  // The master playlist is rewritten without the removed stream.
+  EXPECT_CALL(*mock_master_playlist_ptr,
+              WriteMasterPlaylist(_, _, ElementsAre(mock_media_playlist2)))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(notifier.NotifyStreamRemoved(stream_id1));
+  Mock::VerifyAndClearExpectations(mock_master_playlist_ptr);
+
+  // The stream cannot be used once removed.
+  EXPECT_FALSE(notifier.NotifyStreamRemoved(stream_id1));
+  EXPECT_FALSE(
+      notifier.NotifyNewSegment(stream_id1, "segment_name", 0, 100, 0, 1000));
+}
+
 INSTANTIATE_TEST_CASE_P(PlaylistTypes,
                         LiveOrEventSimpleHlsNotifierTest,
                         ::testing::Values(HlsPlaylistType::kLive,
@@ -31,6 +31,8 @@
         '../media/base/media_base.gyp:widevine_pssh_data_proto',
         '../mpd/mpd.gyp:manifest_base',
         '../mpd/mpd.gyp:media_info_proto',
+        '../packager.gyp:memory_tracker',
+        '../packager.gyp:trace_event',
         '../third_party/gflags/gflags.gyp:gflags',
       ],
     },
@@ -54,5 +56,20 @@
         'hls_builder',
       ],
     },
+    {
+      'target_name': 'hls_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'base/media_playlist_perftest.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../media/test/media_test.gyp:run_tests_with_atexit_manager',
+        '../testing/gtest.gyp:gtest',
+        '../testing/perf/perf_test.gyp:perf_test',
+        '../version/version.gyp:version',
+        'hls_builder',
+      ],
+    },
   ],
 }
@@ -104,16 +104,19 @@ void AesCryptor::UpdateIv() {
   SetIvInternal();
 }
 
-bool AesCryptor::GenerateRandomIv(FourCC protection_scheme,
-                                  std::vector<uint8_t>* iv) {
+size_t AesCryptor::GetDefaultIvSize(FourCC protection_scheme) {
   // ISO/IEC 23001-7:2016 10.1 and 10.3 For 'cenc' and 'cens'
   // default_Per_Sample_IV_Size and Per_Sample_IV_Size SHOULD be 8-bytes.
   // There is no official guideline on the iv size for 'cbc1' and 'cbcs',
   // but 16-byte provides better security.
-  const size_t iv_size =
-      (protection_scheme == FOURCC_cenc || protection_scheme == FOURCC_cens)
-          ? 8
-          : 16;
+  return (protection_scheme == FOURCC_cenc || protection_scheme == FOURCC_cens)
+             ? 8
+             : 16;
+}
+
+bool AesCryptor::GenerateRandomIv(FourCC protection_scheme,
+                                  std::vector<uint8_t>* iv) {
+  const size_t iv_size = GetDefaultIvSize(protection_scheme);
   iv->resize(iv_size);
   if (RAND_bytes(iv->data(), iv_size) != 1) {
     LOG(ERROR) << "RAND_bytes failed with error: "
@@ -91,6 +91,11 @@ class AesCryptor {
   static bool GenerateRandomIv(FourCC protection_scheme,
                                std::vector<uint8_t>* iv);
 
+  /// @param protection_scheme specifies the protection scheme: 'cenc', 'cens',
+  ///        'cbc1', 'cbcs'.
+  /// @return the iv size used for @a protection_scheme, 8 or 16 bytes.
+  static size_t GetDefaultIvSize(FourCC protection_scheme);
+
  protected:
   const AES_KEY* aes_key() const { return aes_key_.get(); }
   AES_KEY* mutable_aes_key() { return aes_key_.get(); }
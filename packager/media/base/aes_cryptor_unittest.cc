@@ -197,6 +197,23 @@ TEST_F(AesCtrEncryptorTest, 64BitIvUpdate) {
   EXPECT_EQ(iv_one, encryptor_.iv());
 }
 
+TEST_F(AesCtrEncryptorTest, BlockWiseMatchesByteWise) {
+  // Not a multiple of the block size, with data in the last partial block.
+  std::vector<uint8_t> plaintext(kAesBlockSize * 5 + 7);
+  for (size_t i = 0; i < plaintext.size(); ++i)
+    plaintext[i] = static_cast<uint8_t>(i * 31);
+
+  std::vector<uint8_t> encrypted;
+  ASSERT_TRUE(encryptor_.Crypt(plaintext, &encrypted));
+
+  ASSERT_TRUE(decryptor_.SetIv(iv_));
+  std::vector<uint8_t> encrypted_byte_wise(plaintext.size());
+  for (size_t i = 0; i < plaintext.size(); ++i) {
+    ASSERT_TRUE(decryptor_.Crypt(&plaintext[i], 1, &encrypted_byte_wise[i]));
+  }
+  EXPECT_EQ(encrypted_byte_wise, encrypted);
+}
+
 TEST_F(AesCtrEncryptorTest, GenerateRandomIv) {
   const uint8_t kCencIvSize = 8;
   std::vector<uint8_t> iv;
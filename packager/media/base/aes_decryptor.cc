@@ -97,7 +97,7 @@ bool AesCbcDecryptor::CryptInternal(const uint8_t* ciphertext,
                     internal_iv_.data(), AES_DECRYPT);
 
     // The residual block is not encrypted.
-    memcpy(plaintext + cbc_size, ciphertext + cbc_size, residual_block_size);
+    memmove(plaintext + cbc_size, ciphertext + cbc_size, residual_block_size);
     return true;
   } else if (padding_scheme_ != kCtsPadding) {
     LOG(ERROR) << "Expecting cipher text size to be multiple of "
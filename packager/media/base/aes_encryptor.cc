@@ -7,6 +7,7 @@
 #include "packager/media/base/aes_encryptor.h"
 
 #include <openssl/aes.h>
+#include <string.h>
 
 #include "packager/base/logging.h"
 
@@ -74,22 +75,46 @@ bool AesCtrEncryptor::CryptInternal(const uint8_t* plaintext,
   }
   *ciphertext_size = plaintext_size;
 
-  for (size_t i = 0; i < plaintext_size; ++i) {
-    if (block_offset_ == 0) {
-      AES_encrypt(&counter_[0], &encrypted_counter_[0], aes_key());
-      // As mentioned in ISO/IEC 23001-7:2016 CENC spec, of the 16 byte counter
-      // block, bytes 8 to 15 (i.e. the least significant bytes) are used as a
-      // simple 64 bit unsigned integer that is incremented by one for each
-      // subsequent block of sample data processed and is kept in network byte
-      // order.
-      Increment64(&counter_[8]);
-    }
+  size_t i = 0;
+  // Use up the key stream left over from the previous call.
+  for (; block_offset_ != 0 && i < plaintext_size; ++i) {
     ciphertext[i] = plaintext[i] ^ encrypted_counter_[block_offset_];
     block_offset_ = (block_offset_ + 1) % AES_BLOCK_SIZE;
   }
+
+  // Whole blocks are XORed a word at a time. memcpy avoids unaligned accesses
+  // and keeps in place encryption well defined.
+  for (; i + AES_BLOCK_SIZE <= plaintext_size; i += AES_BLOCK_SIZE) {
+    GenerateKeyStreamBlock();
+    for (size_t j = 0; j < AES_BLOCK_SIZE; j += sizeof(uint64_t)) {
+      uint64_t text;
+      uint64_t key_stream;
+      memcpy(&text, plaintext + i + j, sizeof(text));
+      memcpy(&key_stream, &encrypted_counter_[j], sizeof(key_stream));
+      text ^= key_stream;
+      memcpy(ciphertext + i + j, &text, sizeof(text));
+    }
+  }
+
+  // The partial block at the end leaves key stream for the next call.
+  if (i < plaintext_size) {
+    GenerateKeyStreamBlock();
+    for (; i < plaintext_size; ++i)
+      ciphertext[i] = plaintext[i] ^ encrypted_counter_[block_offset_++];
+  }
   return true;
 }
 
+void AesCtrEncryptor::GenerateKeyStreamBlock() {
+  AES_encrypt(&counter_[0], &encrypted_counter_[0], aes_key());
+  // As mentioned in ISO/IEC 23001-7:2016 CENC spec, of the 16 byte counter
+  // block, bytes 8 to 15 (i.e. the least significant bytes) are used as a
+  // simple 64 bit unsigned integer that is incremented by one for each
+  // subsequent block of sample data processed and is kept in network byte
+  // order.
+  Increment64(&counter_[8]);
+}
+
 void AesCtrEncryptor::SetIvInternal() {
   block_offset_ = 0;
   counter_ = iv();
@@ -53,6 +53,10 @@ class AesCtrEncryptor : public AesEncryptor {
                      size_t* ciphertext_size) override;
   void SetIvInternal() override;
 
+  // Encrypts the current counter into |encrypted_counter_| and increments the
+  // counter.
+  void GenerateKeyStreamBlock();
+
   // Current block offset.
   uint32_t block_offset_;
   // Current AES-CTR counter.
@@ -68,8 +68,9 @@ bool AesPatternCryptor::CryptInternal(const uint8_t* text,
         crypt_text += aligned_crypt_byte_size;
       }
 
-      // The remaining bytes are not encrypted.
-      memcpy(crypt_text, text, text_size);
+      // The remaining bytes are not encrypted. |text| and |crypt_text| may be
+      // the same for in place encryption / decryption.
+      memmove(crypt_text, text, text_size);
       return true;
     }
 
@@ -81,7 +82,7 @@ bool AesPatternCryptor::CryptInternal(const uint8_t* text,
 
     const size_t skip_byte_size = std::min(
         static_cast<size_t>(skip_byte_block_ * AES_BLOCK_SIZE), text_size);
-    memcpy(crypt_text, text, skip_byte_size);
+    memmove(crypt_text, text, skip_byte_size);
     text += skip_byte_size;
     text_size -= skip_byte_size;
     crypt_text += skip_byte_size;
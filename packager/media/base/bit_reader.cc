@@ -4,109 +4,154 @@
 
 #include "packager/media/base/bit_reader.h"
 
-#include <algorithm>
+#include "packager/media/base/bit_util.h"
 
 namespace shaka {
 namespace media {
 
+namespace {
+// Refill() stops once the cache holds more bits than this, so any read of up
+// to this many bits can be served from the cache after one refill.
+const size_t kMaxBitsPerRefill = 56;
+}  // namespace
+
 BitReader::BitReader(const uint8_t* data, size_t size)
     : data_(data),
       initial_size_(size),
       bytes_left_(size),
-      num_remaining_bits_in_curr_byte_(0) {
+      cache_(0),
+      num_cached_bits_(0) {
   DCHECK(data_ != NULL && bytes_left_ > 0);
-
-  UpdateCurrByte();
 }
 
 BitReader::~BitReader() {}
 
 bool BitReader::SkipBits(size_t num_bits) {
-  // Skip any bits in the current byte waiting to be processed, then
-  // process full bytes until less than 8 bits remaining.
-  if (num_bits > num_remaining_bits_in_curr_byte_) {
-    num_bits -= num_remaining_bits_in_curr_byte_;
-    num_remaining_bits_in_curr_byte_ = 0;
-
-    size_t num_bytes = num_bits / 8;
-    num_bits %= 8;
-    if (bytes_left_ < num_bytes) {
-      bytes_left_ = 0;
-      return false;
-    }
-    bytes_left_ -= num_bytes;
-    data_ += num_bytes;
-    UpdateCurrByte();
+  if (num_bits <= num_cached_bits_) {
+    ConsumeBits(num_bits);
+    return true;
+  }
+
+  // Drop the cached bits, then skip whole bytes in the stream directly.
+  num_bits -= num_cached_bits_;
+  cache_ = 0;
+  num_cached_bits_ = 0;
 
-    // If there is no more data remaining, only return true if we
-    // skipped all that were requested.
-    if (num_remaining_bits_in_curr_byte_ == 0)
-      return (num_bits == 0);
+  const size_t num_bytes = num_bits / 8;
+  if (bytes_left_ < num_bytes) {
+    Exhaust();
+    return false;
   }
+  data_ += num_bytes;
+  bytes_left_ -= num_bytes;
 
   // Less than 8 bits remaining to skip. Use ReadBitsInternal to verify
-  // that the remaining bits we need exist, and adjust them as necessary
-  // for subsequent operations.
+  // that the remaining bits we need exist.
   uint64_t not_needed;
-  return ReadBitsInternal(num_bits, &not_needed);
+  return ReadBitsInternal(num_bits % 8, &not_needed);
 }
 
 void BitReader::SkipToNextByte() {
-  // Already aligned.
-  if (num_remaining_bits_in_curr_byte_ == 8)
-    return;
-
-  num_remaining_bits_in_curr_byte_ = 0;
-  UpdateCurrByte();
+  ConsumeBits(num_cached_bits_ % 8);
 }
 
 bool BitReader::SkipBytes(size_t num_bytes) {
-  if (num_remaining_bits_in_curr_byte_ != 8)
+  // There is no byte to be aligned to at the end of the stream.
+  if (num_cached_bits_ % 8 != 0 || bits_available() == 0)
     return false;
-  if (num_bytes == 0)
+  if (num_bytes * 8 <= num_cached_bits_) {
+    ConsumeBits(num_bytes * 8);
     return true;
+  }
 
-  data_ += num_bytes - 1;  // One additional byte in curr_byte_.
-  if (num_bytes > bytes_left_ + 1)
+  const size_t num_uncached_bytes = num_bytes - num_cached_bits_ / 8;
+  if (num_uncached_bytes > bytes_left_)
     return false;
-  bytes_left_ -= num_bytes - 1;
-  num_remaining_bits_in_curr_byte_ = 0;
-  UpdateCurrByte();
+  cache_ = 0;
+  num_cached_bits_ = 0;
+  data_ += num_uncached_bytes;
+  bytes_left_ -= num_uncached_bytes;
   return true;
 }
 
-bool BitReader::ReadBitsInternal(size_t num_bits, uint64_t* out) {
-  DCHECK_LE(num_bits, 64u);
-
-  *out = 0;
-
-  while (num_remaining_bits_in_curr_byte_ != 0 && num_bits != 0) {
-    size_t bits_to_take = std::min(num_remaining_bits_in_curr_byte_, num_bits);
+bool BitReader::ReadLeadingZeroBits(size_t* num_zero_bits) {
+  size_t count = 0;
+  while (true) {
+    // Only the valid bits count; the bits below them may be set.
+    const uint64_t valid_bits =
+        num_cached_bits_ == 0 ? 0 : cache_ & (~0ULL << (64 - num_cached_bits_));
+    if (valid_bits != 0) {
+      const size_t leading_zeros = CountLeadingZeros64(valid_bits);
+      ConsumeBits(leading_zeros + 1);
+      *num_zero_bits = count + leading_zeros;
+      return true;
+    }
+    count += num_cached_bits_;
+    ConsumeBits(num_cached_bits_);
+    Refill();
+    if (num_cached_bits_ == 0) {
+      Exhaust();
+      return false;
+    }
+  }
+}
 
-    *out <<= bits_to_take;
-    *out += curr_byte_ >> (num_remaining_bits_in_curr_byte_ - bits_to_take);
-    num_bits -= bits_to_take;
-    num_remaining_bits_in_curr_byte_ -= bits_to_take;
-    curr_byte_ &= (1 << num_remaining_bits_in_curr_byte_) - 1;
+bool BitReader::ReadBitsSlow(size_t num_bits, uint64_t* out) {
+  DCHECK_LE(num_bits, 64u);
 
-    if (num_remaining_bits_in_curr_byte_ == 0)
-      UpdateCurrByte();
+  if (num_bits > kMaxBitsPerRefill) {
+    // The cache is not guaranteed to hold that many bits after a refill.
+    uint64_t high_bits = 0;
+    uint64_t low_bits = 0;
+    if (!ReadBitsInternal(num_bits - 32, &high_bits) ||
+        !ReadBitsInternal(32, &low_bits)) {
+      *out = 0;
+      return false;
+    }
+    *out = (high_bits << 32) | low_bits;
+    return true;
   }
 
-  return num_bits == 0;
+  Refill();
+  if (num_bits > num_cached_bits_) {
+    Exhaust();
+    *out = 0;
+    return false;
+  }
+  *out = cache_ >> (64 - num_bits);
+  ConsumeBits(num_bits);
+  return true;
 }
 
-void BitReader::UpdateCurrByte() {
-  DCHECK_EQ(num_remaining_bits_in_curr_byte_, 0u);
+void BitReader::Refill() {
+  DCHECK_LT(num_cached_bits_, 64u);
 
-  if (bytes_left_ == 0)
+  if (bytes_left_ >= sizeof(uint64_t)) {
+    // Load eight bytes at once and keep the whole bytes that fit. The bits of
+    // the partially fitting byte end up below the valid bits; they are the
+    // same bits the next refill loads into that position, so or-ing them in
+    // again is harmless.
+    cache_ |= LoadBigEndian64(data_) >> num_cached_bits_;
+    const size_t num_bytes = (64 - num_cached_bits_) / 8;
+    data_ += num_bytes;
+    bytes_left_ -= num_bytes;
+    num_cached_bits_ += num_bytes * 8;
     return;
+  }
+
+  while (num_cached_bits_ <= kMaxBitsPerRefill && bytes_left_ > 0) {
+    cache_ |= static_cast<uint64_t>(*data_) << (56 - num_cached_bits_);
+    ++data_;
+    --bytes_left_;
+    num_cached_bits_ += 8;
+  }
+}
 
-  // Load a new byte and advance pointers.
-  curr_byte_ = *data_;
-  ++data_;
-  --bytes_left_;
-  num_remaining_bits_in_curr_byte_ = 8;
+void BitReader::Exhaust() {
+  data_ += bytes_left_;
+  bytes_left_ = 0;
+  cache_ = 0;
+  num_cached_bits_ = 0;
 }
 
 }  // namespace media
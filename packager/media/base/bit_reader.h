@@ -85,38 +85,67 @@ class BitReader {
   ///         stream), true otherwise.
   bool SkipBytes(size_t num_bytes);
 
+  /// Read a run of zero bits and the one bit terminating it, i.e. the prefix
+  /// of an Exp-Golomb code.
+  /// @param[out] num_zero_bits stores the number of zero bits read.
+  /// @return false if there is no one bit before the end of the stream, true
+  ///         otherwise. When false is returned, the stream will enter a state
+  ///         where further ReadXXX/SkipXXX operations will always return
+  ///         false unless |num_bits/bytes| is 0.
+  bool ReadLeadingZeroBits(size_t* num_zero_bits);
+
   /// @return The number of bits available for reading.
   size_t bits_available() const {
-    return 8 * bytes_left_ + num_remaining_bits_in_curr_byte_;
+    return 8 * bytes_left_ + num_cached_bits_;
   }
 
   /// @return The current bit position.
   size_t bit_position() const { return 8 * initial_size_ - bits_available(); }
 
  private:
-  // Help function used by ReadBits to avoid inlining the bit reading logic.
-  bool ReadBitsInternal(size_t num_bits, uint64_t* out);
+  // Reads from the cache if it holds enough bits; the common case is inlined.
+  bool ReadBitsInternal(size_t num_bits, uint64_t* out) {
+    if (num_bits > num_cached_bits_)
+      return ReadBitsSlow(num_bits, out);
+    *out = num_bits == 0 ? 0 : cache_ >> (64 - num_bits);
+    ConsumeBits(num_bits);
+    return true;
+  }
+
+  // Refills the cache, then reads. Used when the cache runs short.
+  bool ReadBitsSlow(size_t num_bits, uint64_t* out);
+
+  // Loads whole bytes into the cache until it holds more than 56 bits or the
+  // stream has no more bytes.
+  void Refill();
+
+  // Drops |num_bits| from the cache, which must hold at least |num_bits|.
+  void ConsumeBits(size_t num_bits) {
+    DCHECK_LE(num_bits, num_cached_bits_);
+    cache_ = num_bits < 64 ? cache_ << num_bits : 0;
+    num_cached_bits_ -= num_bits;
+  }
 
-  // Advance to the next byte, loading it into curr_byte_.
-  // If the num_remaining_bits_in_curr_byte_ is 0 after this function returns,
-  // the stream has reached the end.
-  void UpdateCurrByte();
+  // Drops all the remaining bits, so further reads fail.
+  void Exhaust();
 
-  // Pointer to the next unread (not in curr_byte_) byte in the stream.
+  // Pointer to the next byte not loaded into the cache.
   const uint8_t* data_;
 
   // Initial size of the input data.
   size_t initial_size_;
 
-  // Bytes left in the stream (without the curr_byte_).
+  // Bytes left in the stream (without the bytes in cache_).
   size_t bytes_left_;
 
-  // Contents of the current byte; first unread bit starting at position
-  // 8 - num_remaining_bits_in_curr_byte_ from MSB.
-  uint8_t curr_byte_;
+  // Cached bits, first unread bit at the MSB. Bits below the
+  // num_cached_bits_ valid bits are either zero or the following bits of the
+  // stream (see Refill()).
+  uint64_t cache_;
 
-  // Number of bits remaining in curr_byte_
-  size_t num_remaining_bits_in_curr_byte_;
+  // Number of valid bits in cache_. Always a whole number of bytes are
+  // loaded, so num_cached_bits_ % 8 bits are left in the current byte.
+  size_t num_cached_bits_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(BitReader);
@@ -113,5 +113,42 @@ TEST(BitReaderTest, SkipToNextByteTestUnaligned) {
   EXPECT_EQ(8u, reader.bit_position());
 }
 
+TEST(BitReaderTest, ReadLeadingZeroBits) {
+  // 0000 0000 0000 0000 0000 0000 0000 0000 0000 0001 1010 0000
+  uint8_t buffer[] = {0x00, 0x00, 0x00, 0x00, 0x01, 0xa0};
+  BitReader reader(buffer, sizeof(buffer));
+
+  size_t num_zero_bits = 0;
+  EXPECT_TRUE(reader.ReadLeadingZeroBits(&num_zero_bits));
+  EXPECT_EQ(39u, num_zero_bits);
+  EXPECT_EQ(40u, reader.bit_position());
+  EXPECT_TRUE(reader.ReadLeadingZeroBits(&num_zero_bits));
+  EXPECT_EQ(0u, num_zero_bits);
+  EXPECT_TRUE(reader.ReadLeadingZeroBits(&num_zero_bits));
+  EXPECT_EQ(1u, num_zero_bits);
+  EXPECT_FALSE(reader.ReadLeadingZeroBits(&num_zero_bits));
+  EXPECT_EQ(0u, reader.bits_available());
+}
+
+// Reads across several cache refills.
+TEST(BitReaderTest, ReadLongStream) {
+  uint8_t buffer[37];
+  for (size_t i = 0; i < sizeof(buffer); ++i)
+    buffer[i] = static_cast<uint8_t>(i * 7 + 1);
+  BitReader reader(buffer, sizeof(buffer));
+
+  // Read 3 bits at a time and compare with the bits of the buffer.
+  for (size_t bit_position = 0; bit_position + 3 <= sizeof(buffer) * 8;
+       bit_position += 3) {
+    uint8_t expected = 0;
+    for (size_t j = bit_position; j < bit_position + 3; ++j)
+      expected = (expected << 1) | ((buffer[j / 8] >> (7 - j % 8)) & 1);
+    uint8_t value = 0;
+    ASSERT_TRUE(reader.ReadBits(3, &value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_EQ(2u, reader.bits_available());
+}
+
 }  // namespace media
 }  // namespace shaka
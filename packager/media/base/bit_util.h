@@ -0,0 +1,64 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_BIT_UTIL_H_
+#define PACKAGER_MEDIA_BASE_BIT_UTIL_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "packager/base/logging.h"
+#include "packager/base/sys_byteorder.h"
+
+namespace shaka {
+namespace media {
+
+/// @return The number of leading zero bits in @a value, which cannot be 0.
+inline int CountLeadingZeros64(uint64_t value) {
+  DCHECK_NE(value, 0u);
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return 63 - static_cast<int>(index);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  if (_BitScanReverse(&index, static_cast<uint32_t>(value >> 32)))
+    return 31 - static_cast<int>(index);
+  _BitScanReverse(&index, static_cast<uint32_t>(value));
+  return 63 - static_cast<int>(index);
+#else
+  return __builtin_clzll(value);
+#endif
+}
+
+/// @return The number of bits set in @a value.
+inline int CountSetBits64(uint64_t value) {
+#if defined(_MSC_VER)
+  int count = 0;
+  for (; value; value &= value - 1)
+    ++count;
+  return count;
+#else
+  return __builtin_popcountll(value);
+#endif
+}
+
+/// @return The 64-bit big-endian value starting at @a data. @a data does not
+///         need to be aligned.
+inline uint64_t LoadBigEndian64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return base::NetToHost64(value);
+}
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_BIT_UTIL_H_
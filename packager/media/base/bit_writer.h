@@ -36,18 +36,21 @@ class BitWriter {
   void Flush();
 
   /// @return last written position, in bits.
-  size_t BitPos() const { return BytePos() * 8 + num_bits_; }
+  size_t BitPos() const {
+    return (storage_->size() - initial_storage_size_) * 8 + num_bits_;
+  }
 
   /// @return last written position, in bytes.
-  size_t BytePos() const { return storage_->size() - initial_storage_size_; }
+  size_t BytePos() const { return BitPos() / 8; }
 
  private:
   BitWriter(const BitWriter&) = delete;
   BitWriter& operator=(const BitWriter&) = delete;
 
-  // Accumulator for unwritten bits.
+  // Accumulator for unwritten bits, first bit at the MSB. Bits are written
+  // to |storage_| 32 bits at a time.
   uint64_t bits_ = 0;
-  // Number of unwritten bits.
+  // Number of unwritten bits, less than 32 between calls.
   int num_bits_ = 0;
   // Buffer contains the written bits.
   std::vector<uint8_t>* const storage_ = nullptr;
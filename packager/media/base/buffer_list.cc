@@ -0,0 +1,81 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/base/buffer_list.h"
+
+#include <iterator>
+
+#include "packager/base/logging.h"
+#include "packager/file/file.h"
+#include "packager/media/base/buffer_writer.h"
+
+namespace shaka {
+namespace media {
+
+BufferList::BufferList() {}
+
+BufferList::~BufferList() {}
+
+void BufferList::AppendBuffer(const BufferWriter& buffer) {
+  if (buffer.Size() == 0)
+    return;
+  std::shared_ptr<std::vector<uint8_t>> copy(new std::vector<uint8_t>(
+      buffer.Buffer(), buffer.Buffer() + buffer.Size()));
+  // Aliasing constructor: the buffer shares the ownership of |copy|.
+  std::shared_ptr<const uint8_t> data(copy, copy->data());
+  AppendSharedData(std::move(data), copy->size());
+}
+
+void BufferList::AppendSharedData(std::shared_ptr<const uint8_t> data,
+                                  size_t size) {
+  if (size == 0)
+    return;
+  DCHECK(data);
+  buffers_.push_back({std::move(data), size});
+  size_ += size;
+}
+
+void BufferList::AppendBufferList(BufferList* buffer_list) {
+  DCHECK(buffer_list);
+  if (buffers_.empty()) {
+    buffers_.swap(buffer_list->buffers_);
+  } else {
+    buffers_.insert(buffers_.end(),
+                    std::make_move_iterator(buffer_list->buffers_.begin()),
+                    std::make_move_iterator(buffer_list->buffers_.end()));
+  }
+  size_ += buffer_list->size_;
+  buffer_list->Clear();
+}
+
+void BufferList::Clear() {
+  buffers_.clear();
+  size_ = 0;
+}
+
+Status BufferList::WriteToFile(File* file) {
+  DCHECK(file);
+  DCHECK(!buffers_.empty());
+
+  for (const Buffer& buffer : buffers_) {
+    size_t remaining_size = buffer.size;
+    const uint8_t* buf = buffer.data.get();
+    while (remaining_size > 0) {
+      int64_t size_written = file->Write(buf, remaining_size);
+      if (size_written <= 0) {
+        return Status(error::FILE_FAILURE,
+                      "Fail to write to file in BufferList");
+      }
+      remaining_size -= size_written;
+      buf += size_written;
+    }
+  }
+  Clear();
+  return Status::OK;
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,71 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_BUFFER_LIST_H_
+#define PACKAGER_MEDIA_BASE_BUFFER_LIST_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "packager/status.h"
+
+namespace shaka {
+
+class File;
+
+namespace media {
+
+class BufferWriter;
+
+/// A list of buffers which are written to a file one after another, without
+/// being assembled into a contiguous buffer first. Unlike BufferWriter, the
+/// list can reference data it does not own, e.g. the payload of a
+/// MediaSample, so the data is not copied before it is written.
+class BufferList {
+ public:
+  BufferList();
+  ~BufferList();
+
+  /// Append a copy of the contents of @a buffer to the list.
+  void AppendBuffer(const BufferWriter& buffer);
+  /// Append a reference to @a data to the list. No data copying is involved.
+  /// @param data is the data to be referenced, which must not be modified
+  ///        while it is in the list.
+  /// @param size is the size of @a data in bytes.
+  void AppendSharedData(std::shared_ptr<const uint8_t> data, size_t size);
+  /// Move the buffers of @a buffer_list to the end of this list. No data
+  /// copying is involved. @a buffer_list is cleared.
+  void AppendBufferList(BufferList* buffer_list);
+
+  void Clear();
+  /// @return The total size of the buffers in the list in bytes.
+  size_t Size() const { return size_; }
+
+  /// Write the buffers to file in order. The list will be cleared after
+  /// writing.
+  /// @param file should not be NULL.
+  /// @return OK on success.
+  Status WriteToFile(File* file);
+
+ private:
+  BufferList(const BufferList&) = delete;
+  BufferList& operator=(const BufferList&) = delete;
+
+  struct Buffer {
+    std::shared_ptr<const uint8_t> data;
+    size_t size;
+  };
+
+  std::vector<Buffer> buffers_;
+  size_t size_ = 0;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_BUFFER_LIST_H_
@@ -0,0 +1,82 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/base/buffer_list.h"
+
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+#include "packager/file/file.h"
+#include "packager/media/base/buffer_writer.h"
+#include "packager/status_test_util.h"
+
+namespace shaka {
+namespace media {
+namespace {
+
+const char kOutputFile[] = "memory://buffer_list_output";
+const uint8_t kHeader[] = {1, 2, 3};
+const uint8_t kPayload1[] = {10, 20, 30, 40};
+const uint8_t kPayload2[] = {50, 60};
+
+std::shared_ptr<const uint8_t> CreateSharedData(const uint8_t* data,
+                                                size_t size) {
+  std::shared_ptr<uint8_t> shared_data(new uint8_t[size],
+                                       std::default_delete<uint8_t[]>());
+  memcpy(shared_data.get(), data, size);
+  return shared_data;
+}
+
+}  // namespace
+
+TEST(BufferListTest, AppendAndWriteToFile) {
+  BufferWriter header;
+  header.AppendArray(kHeader, sizeof(kHeader));
+
+  BufferList samples;
+  std::shared_ptr<const uint8_t> payload1 =
+      CreateSharedData(kPayload1, sizeof(kPayload1));
+  samples.AppendSharedData(payload1, sizeof(kPayload1));
+  samples.AppendSharedData(CreateSharedData(kPayload2, sizeof(kPayload2)),
+                           sizeof(kPayload2));
+  EXPECT_EQ(sizeof(kPayload1) + sizeof(kPayload2), samples.Size());
+
+  BufferList buffer_list;
+  buffer_list.AppendBuffer(header);
+  buffer_list.AppendBufferList(&samples);
+  EXPECT_EQ(0u, samples.Size());
+  EXPECT_EQ(sizeof(kHeader) + sizeof(kPayload1) + sizeof(kPayload2),
+            buffer_list.Size());
+  // The payload is referenced rather than copied.
+  EXPECT_EQ(2, payload1.use_count());
+
+  // Changing the BufferWriter after it is appended does not affect the list.
+  header.Clear();
+
+  File* const output_file = File::Open(kOutputFile, "w");
+  ASSERT_TRUE(output_file);
+  ASSERT_OK(buffer_list.WriteToFile(output_file));
+  ASSERT_TRUE(output_file->Close());
+  EXPECT_EQ(0u, buffer_list.Size());
+  EXPECT_EQ(1, payload1.use_count());
+
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(kOutputFile, &contents));
+  const std::vector<uint8_t> expected = {1, 2, 3, 10, 20, 30, 40, 50, 60};
+  EXPECT_EQ(expected, std::vector<uint8_t>(contents.begin(), contents.end()));
+}
+
+TEST(BufferListTest, Clear) {
+  BufferList buffer_list;
+  buffer_list.AppendSharedData(CreateSharedData(kPayload1, sizeof(kPayload1)),
+                               sizeof(kPayload1));
+  buffer_list.Clear();
+  EXPECT_EQ(0u, buffer_list.Size());
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -16,7 +16,9 @@ ByteQueue::ByteQueue()
     : buffer_(new uint8_t[kDefaultQueueSize]),
       size_(kDefaultQueueSize),
       offset_(0),
-      used_(0) {
+      used_(0),
+      memory_tracker_("ByteQueue", "") {
+  memory_tracker_.Set(size_);
 }
 
 ByteQueue::~ByteQueue() {}
@@ -50,6 +52,7 @@ void ByteQueue::Push(const uint8_t* data, int size) {
     buffer_.reset(new_buffer.release());
     size_ = new_size;
     offset_ = 0;
+    memory_tracker_.Set(size_);
   } else if ((offset_ + used_ + size) > size_) {
     // The buffer is big enough, but we need to move the data in the queue.
     memmove(buffer_.get(), front(), used_);
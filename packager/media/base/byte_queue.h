@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "packager/base/macros.h"
+#include "packager/memory_tracker.h"
 
 namespace shaka {
 namespace media {
@@ -53,6 +54,9 @@ class ByteQueue {
   // Number of bytes stored in the queue.
   int used_;
 
+  // Tracks the size of |buffer_|.
+  MemoryTracker memory_tracker_;
+
   DISALLOW_COPY_AND_ASSIGN(ByteQueue);
 };
 
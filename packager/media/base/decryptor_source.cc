@@ -39,62 +39,16 @@ bool DecryptorSource::DecryptSampleBuffer(const DecryptConfig* decrypt_config,
   DCHECK(encrypted_buffer);
   DCHECK(decrypted_buffer);
 
-  if (CheckMemoryOverlap(encrypted_buffer, buffer_size, decrypted_buffer)) {
+  const bool in_place = encrypted_buffer == decrypted_buffer;
+  if (!in_place &&
+      CheckMemoryOverlap(encrypted_buffer, buffer_size, decrypted_buffer)) {
     LOG(ERROR) << "Encrypted buffer and decrypted buffer cannot overlap.";
     return false;
   }
 
-  // Get the decryptor object.
-  AesCryptor* decryptor = nullptr;
-  auto found = decryptor_map_.find(decrypt_config->key_id());
-  if (found == decryptor_map_.end()) {
-    // Create new AesDecryptor based on decryption mode.
-    EncryptionKey key;
-    Status status(key_source_->GetKey(decrypt_config->key_id(), &key));
-    if (!status.ok()) {
-      LOG(ERROR) << "Error retrieving decryption key: " << status;
-      return false;
-    }
-
-    std::unique_ptr<AesCryptor> aes_decryptor;
-    switch (decrypt_config->protection_scheme()) {
-      case FOURCC_cenc:
-        aes_decryptor.reset(new AesCtrDecryptor);
-        break;
-      case FOURCC_cbc1:
-        aes_decryptor.reset(new AesCbcDecryptor(kNoPadding));
-        break;
-      case FOURCC_cens:
-        aes_decryptor.reset(new AesPatternCryptor(
-            decrypt_config->crypt_byte_block(),
-            decrypt_config->skip_byte_block(),
-            AesPatternCryptor::kEncryptIfCryptByteBlockRemaining,
-            AesCryptor::kDontUseConstantIv,
-            std::unique_ptr<AesCryptor>(new AesCtrDecryptor())));
-        break;
-      case FOURCC_cbcs:
-        aes_decryptor.reset(new AesPatternCryptor(
-            decrypt_config->crypt_byte_block(),
-            decrypt_config->skip_byte_block(),
-            AesPatternCryptor::kEncryptIfCryptByteBlockRemaining,
-            AesCryptor::kUseConstantIv,
-            std::unique_ptr<AesCryptor>(new AesCbcDecryptor(kNoPadding))));
-        break;
-      default:
-        LOG(ERROR) << "Unsupported protection scheme: "
-                   << decrypt_config->protection_scheme();
-        return false;
-    }
-
-    if (!aes_decryptor->InitializeWithIv(key.key, decrypt_config->iv())) {
-      LOG(ERROR) << "Failed to initialize AesDecryptor for decryption.";
-      return false;
-    }
-    decryptor = aes_decryptor.get();
-    decryptor_map_[decrypt_config->key_id()] = std::move(aes_decryptor);
-  } else {
-    decryptor = found->second.get();
-  }
+  AesCryptor* decryptor = GetDecryptor(*decrypt_config);
+  if (!decryptor)
+    return false;
   if (!decryptor->SetIv(decrypt_config->iv())) {
     LOG(ERROR) << "Invalid initialization vector.";
     return false;
@@ -119,7 +73,9 @@ bool DecryptorSource::DecryptSampleBuffer(const DecryptConfig* decrypt_config,
       LOG(ERROR) << "Subsamples overflow sample buffer.";
       return false;
     }
-    memcpy(decrypted_buffer, current_ptr, subsample.clear_bytes);
+    // Clear bytes are already in place for in place decryption.
+    if (!in_place)
+      memcpy(decrypted_buffer, current_ptr, subsample.clear_bytes);
     current_ptr += subsample.clear_bytes;
     decrypted_buffer += subsample.clear_bytes;
     if (!decryptor->Crypt(current_ptr, subsample.cipher_bytes,
@@ -133,5 +89,55 @@ bool DecryptorSource::DecryptSampleBuffer(const DecryptConfig* decrypt_config,
   return true;
 }
 
+AesCryptor* DecryptorSource::GetDecryptor(const DecryptConfig& decrypt_config) {
+  auto found = decryptor_map_.find(decrypt_config.key_id());
+  if (found != decryptor_map_.end())
+    return found->second.get();
+
+  // Create new AesDecryptor based on decryption mode.
+  EncryptionKey key;
+  Status status(key_source_->GetKey(decrypt_config.key_id(), &key));
+  if (!status.ok()) {
+    LOG(ERROR) << "Error retrieving decryption key: " << status;
+    return nullptr;
+  }
+
+  std::unique_ptr<AesCryptor> aes_decryptor;
+  switch (decrypt_config.protection_scheme()) {
+    case FOURCC_cenc:
+      aes_decryptor.reset(new AesCtrDecryptor);
+      break;
+    case FOURCC_cbc1:
+      aes_decryptor.reset(new AesCbcDecryptor(kNoPadding));
+      break;
+    case FOURCC_cens:
+      aes_decryptor.reset(new AesPatternCryptor(
+          decrypt_config.crypt_byte_block(), decrypt_config.skip_byte_block(),
+          AesPatternCryptor::kEncryptIfCryptByteBlockRemaining,
+          AesCryptor::kDontUseConstantIv,
+          std::unique_ptr<AesCryptor>(new AesCtrDecryptor())));
+      break;
+    case FOURCC_cbcs:
+      aes_decryptor.reset(new AesPatternCryptor(
+          decrypt_config.crypt_byte_block(), decrypt_config.skip_byte_block(),
+          AesPatternCryptor::kEncryptIfCryptByteBlockRemaining,
+          AesCryptor::kUseConstantIv,
+          std::unique_ptr<AesCryptor>(new AesCbcDecryptor(kNoPadding))));
+      break;
+    default:
+      LOG(ERROR) << "Unsupported protection scheme: "
+                 << decrypt_config.protection_scheme();
+      return nullptr;
+  }
+
+  if (!aes_decryptor->InitializeWithIv(key.key, decrypt_config.iv())) {
+    LOG(ERROR) << "Failed to initialize AesDecryptor for decryption.";
+    return nullptr;
+  }
+  AesCryptor* decryptor = aes_decryptor.get();
+  decryptor_map_[decrypt_config.key_id()] = std::move(aes_decryptor);
+  return decryptor;
+}
+
 }  // namespace media
 }  // namespace shaka
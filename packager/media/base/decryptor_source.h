@@ -30,9 +30,11 @@ class DecryptorSource {
   /// @param decrypt_config contains decrypt configuration, e.g. protection
   ///        scheme, subsample information etc.
   /// @param encrypted_buffer points to the encrypted buffer that is to be
-  ///        decrypted. It should not overlap with @a decrypted_buffer.
+  ///        decrypted. It should either be the same as @a decrypted_buffer
+  ///        for in place decryption or not overlap with @a decrypted_buffer.
   /// @param buffer_size is the size of encrypted buffer and decrypted buffer.
-  /// @param decrypted_buffer points to the decrypted buffer. It should not
+  /// @param decrypted_buffer points to the decrypted buffer. It should either
+  ///        be the same as @a encrypted_buffer for in place decryption or not
   ///        overlap with @a encrypted_buffer.
   /// @return true if success, false otherwise.
   bool DecryptSampleBuffer(const DecryptConfig* decrypt_config,
@@ -41,6 +43,10 @@ class DecryptorSource {
                            uint8_t* decrypted_buffer);
 
  private:
+  // Returns the decryptor for |decrypt_config|, creating it if it does not
+  // exist yet. Returns NULL on failure.
+  AesCryptor* GetDecryptor(const DecryptConfig& decrypt_config);
+
   KeySource* key_source_;
   std::map<std::vector<uint8_t>, std::unique_ptr<AesCryptor>> decryptor_map_;
 
@@ -144,6 +144,74 @@ TEST_F(DecryptorSourceTest, SubsampleDecryption) {
             decrypted_buffer_);
 }
 
+TEST_F(DecryptorSourceTest, InPlaceDecryption) {
+  EncryptionKey encryption_key;
+  encryption_key.key.assign(kMockKey, kMockKey + arraysize(kMockKey));
+  EXPECT_CALL(mock_key_source_, GetKey(key_id_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(encryption_key), Return(Status::OK)));
+
+  DecryptConfig decrypt_config(key_id_,
+                               std::vector<uint8_t>(kIv, kIv + arraysize(kIv)),
+                               std::vector<SubsampleEntry>());
+  ASSERT_TRUE(decryptor_source_.DecryptSampleBuffer(
+      &decrypt_config, &encrypted_buffer_[0], encrypted_buffer_.size(),
+      &encrypted_buffer_[0]));
+  EXPECT_EQ(std::vector<uint8_t>(
+                kExpectedDecryptedBuffer,
+                kExpectedDecryptedBuffer + arraysize(kExpectedDecryptedBuffer)),
+            encrypted_buffer_);
+}
+
+TEST_F(DecryptorSourceTest, InPlaceSubsampleDecryption) {
+  EncryptionKey encryption_key;
+  encryption_key.key.assign(kMockKey, kMockKey + arraysize(kMockKey));
+  EXPECT_CALL(mock_key_source_, GetKey(key_id_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(encryption_key), Return(Status::OK)));
+
+  const SubsampleEntry kSubsamples[] = {
+    {2, 3},
+    {3, 13},
+  };
+  DecryptConfig decrypt_config(
+      key_id_, std::vector<uint8_t>(kIv, kIv + arraysize(kIv)),
+      std::vector<SubsampleEntry>(kSubsamples,
+                                  kSubsamples + arraysize(kSubsamples)));
+  ASSERT_TRUE(decryptor_source_.DecryptSampleBuffer(
+      &decrypt_config, &encrypted_buffer_[0], encrypted_buffer_.size(),
+      &decrypted_buffer_[0]));
+  ASSERT_TRUE(decryptor_source_.DecryptSampleBuffer(
+      &decrypt_config, &encrypted_buffer_[0], encrypted_buffer_.size(),
+      &encrypted_buffer_[0]));
+  EXPECT_EQ(decrypted_buffer_, encrypted_buffer_);
+}
+
+TEST_F(DecryptorSourceTest, SwitchKeys) {
+  const uint8_t kKeyId2[] = {
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+  };
+  const std::vector<uint8_t> key_id2(kKeyId2, kKeyId2 + arraysize(kKeyId2));
+
+  EncryptionKey encryption_key;
+  encryption_key.key.assign(kMockKey, kMockKey + arraysize(kMockKey));
+  // Decryptors are created only once per key id.
+  EXPECT_CALL(mock_key_source_, GetKey(key_id_, _))
+      .WillOnce(DoAll(SetArgPointee<1>(encryption_key), Return(Status::OK)));
+  EXPECT_CALL(mock_key_source_, GetKey(key_id2, _))
+      .WillOnce(DoAll(SetArgPointee<1>(encryption_key), Return(Status::OK)));
+
+  const std::vector<uint8_t> iv(kIv, kIv + arraysize(kIv));
+  const std::vector<uint8_t> expected_decrypted_buffer(
+      kExpectedDecryptedBuffer,
+      kExpectedDecryptedBuffer + arraysize(kExpectedDecryptedBuffer));
+  for (const auto& key_id : {key_id_, key_id_, key_id2, key_id2, key_id_}) {
+    DecryptConfig decrypt_config(key_id, iv, std::vector<SubsampleEntry>());
+    ASSERT_TRUE(decryptor_source_.DecryptSampleBuffer(
+        &decrypt_config, &encrypted_buffer_[0], encrypted_buffer_.size(),
+        &decrypted_buffer_[0]));
+    EXPECT_EQ(expected_decrypted_buffer, decrypted_buffer_);
+  }
+}
+
 TEST_F(DecryptorSourceTest, SubsampleDecryptionSizeValidation) {
   EncryptionKey encryption_key;
   encryption_key.key.assign(kMockKey, kMockKey + arraysize(kMockKey));
@@ -8,10 +8,14 @@
 
 #include <curl/curl.h>
 
+#include "packager/base/bind.h"
+#include "packager/base/location.h"
 #include "packager/base/logging.h"
 #include "packager/base/strings/string_number_conversions.h"
 #include "packager/base/strings/stringprintf.h"
 #include "packager/base/synchronization/lock.h"
+#include "packager/base/threading/worker_pool.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 
@@ -25,6 +29,9 @@ const char kJsonContentTypeHeader[] = "Content-Type: application/json";
 
 const int kMinLogLevelForCurlDebugFunction = 2;
 
+// Default maximum number of concurrent requests of a HttpKeyFetcher.
+const size_t kDefaultMaxConcurrentRequests = 4;
+
 int CurlDebugFunction(CURL* /* handle */,
                       curl_infotype type,
                       const char* data,
@@ -75,22 +82,6 @@ int CurlDebugFunction(CURL* /* handle */,
   return 0;
 }
 
-// Scoped CURL implementation which cleans up itself when goes out of scope.
-class ScopedCurl {
- public:
-  ScopedCurl() { ptr_ = curl_easy_init(); }
-  ~ScopedCurl() {
-    if (ptr_)
-      curl_easy_cleanup(ptr_);
-  }
-
-  CURL* get() { return ptr_; }
-
- private:
-  CURL* ptr_;
-  DISALLOW_COPY_AND_ASSIGN(ScopedCurl);
-};
-
 size_t AppendToString(char* ptr, size_t size, size_t nmemb, std::string* response) {
   DCHECK(ptr);
   DCHECK(response);
@@ -124,20 +115,91 @@ class LibCurlInitializer {
   DISALLOW_COPY_AND_ASSIGN(LibCurlInitializer);
 };
 
+// Wraps a curl share handle which allows connections, TLS sessions and DNS
+// cache to be shared among all the curl handles in the process.
+class CurlShare {
+ public:
+  CurlShare() : share_(curl_share_init()) {
+    if (!share_) {
+      LOG(ERROR) << "curl_share_init() failed.";
+      return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &CurlShare::LockFunction);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &CurlShare::UnlockFunction);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  }
+
+  ~CurlShare() {
+    if (share_)
+      curl_share_cleanup(share_);
+  }
+
+  CURLSH* get() { return share_; }
+
+ private:
+  static void LockFunction(CURL* /* handle */,
+                           curl_lock_data data,
+                           curl_lock_access /* access */,
+                           void* userptr) {
+    DCHECK_LT(data, CURL_LOCK_DATA_LAST);
+    static_cast<CurlShare*>(userptr)->locks_[data].Acquire();
+  }
+
+  static void UnlockFunction(CURL* /* handle */,
+                             curl_lock_data data,
+                             void* userptr) {
+    DCHECK_LT(data, CURL_LOCK_DATA_LAST);
+    static_cast<CurlShare*>(userptr)->locks_[data].Release();
+  }
+
+  CURLSH* share_;
+  base::Lock locks_[CURL_LOCK_DATA_LAST];
+
+  DISALLOW_COPY_AND_ASSIGN(CurlShare);
+};
+
+CURLSH* GetCurlShare() {
+  // |lib_curl_initializer| must be constructed before |curl_share| so it is
+  // destructed after |curl_share|.
+  static LibCurlInitializer lib_curl_initializer;
+  static CurlShare curl_share;
+  return curl_share.get();
+}
+
 }  // namespace
 
 namespace media {
 
-HttpKeyFetcher::HttpKeyFetcher() : timeout_in_seconds_(0) {}
+HttpKeyFetcher::HttpKeyFetcher()
+    : HttpKeyFetcher(0, kDefaultMaxConcurrentRequests) {}
 
 HttpKeyFetcher::HttpKeyFetcher(uint32_t timeout_in_seconds)
-    : timeout_in_seconds_(timeout_in_seconds) {}
+    : HttpKeyFetcher(timeout_in_seconds, kDefaultMaxConcurrentRequests) {}
+
+HttpKeyFetcher::HttpKeyFetcher(uint32_t timeout_in_seconds,
+                               size_t max_concurrent_requests)
+    : timeout_in_seconds_(timeout_in_seconds),
+      max_concurrent_requests_(max_concurrent_requests),
+      handle_released_(&lock_) {
+  DCHECK_GT(max_concurrent_requests_, 0u);
+}
 
-HttpKeyFetcher::~HttpKeyFetcher() {}
+HttpKeyFetcher::~HttpKeyFetcher() {
+  base::AutoLock scoped_lock(lock_);
+  while (num_pending_async_requests_ > 0)
+    handle_released_.Wait();
+  DCHECK_EQ(idle_curl_handles_.size(), num_curl_handles_);
+  for (void* curl : idle_curl_handles_)
+    curl_easy_cleanup(static_cast<CURL*>(curl));
+}
 
 Status HttpKeyFetcher::FetchKeys(const std::string& url,
                                  const std::string& request,
                                  std::string* response) {
+  SHAKA_TRACE_EVENT("key_source", "HttpKeyFetcher::FetchKeys");
   return Post(url, request, response);
 }
 
@@ -151,15 +213,89 @@ Status HttpKeyFetcher::Post(const std::string& path,
   return FetchInternal(POST, path, data, response);
 }
 
+void HttpKeyFetcher::GetAsync(const std::string& path,
+                              const FetchCallback& callback) {
+  {
+    base::AutoLock scoped_lock(lock_);
+    ++num_pending_async_requests_;
+  }
+  base::WorkerPool::PostTask(
+      FROM_HERE,
+      base::Bind(&HttpKeyFetcher::FetchTask, base::Unretained(this), GET, path,
+                 std::string(), callback),
+      true /* task_is_slow */);
+}
+
+void HttpKeyFetcher::PostAsync(const std::string& path,
+                               const std::string& data,
+                               const FetchCallback& callback) {
+  {
+    base::AutoLock scoped_lock(lock_);
+    ++num_pending_async_requests_;
+  }
+  base::WorkerPool::PostTask(
+      FROM_HERE,
+      base::Bind(&HttpKeyFetcher::FetchTask, base::Unretained(this), POST, path,
+                 data, callback),
+      true /* task_is_slow */);
+}
+
+void HttpKeyFetcher::FetchTask(HttpMethod method,
+                               const std::string& path,
+                               const std::string& data,
+                               const FetchCallback& callback) {
+  std::string response;
+  Status status = FetchInternal(method, path, data, &response);
+  callback.Run(status, response);
+
+  base::AutoLock scoped_lock(lock_);
+  DCHECK_GT(num_pending_async_requests_, 0u);
+  --num_pending_async_requests_;
+  handle_released_.Broadcast();
+}
+
+void* HttpKeyFetcher::AcquireCurlHandle() {
+  CURLSH* share = GetCurlShare();
+
+  base::AutoLock scoped_lock(lock_);
+  while (idle_curl_handles_.empty() &&
+         num_curl_handles_ >= max_concurrent_requests_) {
+    handle_released_.Wait();
+  }
+  if (!idle_curl_handles_.empty()) {
+    CURL* curl = static_cast<CURL*>(idle_curl_handles_.back());
+    idle_curl_handles_.pop_back();
+    // Reset the options of the previous request. The live connections, TLS
+    // session and DNS caches are kept.
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    return curl;
+  }
+  CURL* curl = curl_easy_init();
+  if (!curl)
+    return nullptr;
+  if (share)
+    curl_easy_setopt(curl, CURLOPT_SHARE, share);
+  ++num_curl_handles_;
+  return curl;
+}
+
+void HttpKeyFetcher::ReleaseCurlHandle(void* curl) {
+  DCHECK(curl);
+  base::AutoLock scoped_lock(lock_);
+  idle_curl_handles_.push_back(curl);
+  // The destructor waits on the same condition variable, so a single waiter
+  // woken up may not be the one waiting for a handle.
+  handle_released_.Broadcast();
+}
+
 Status HttpKeyFetcher::FetchInternal(HttpMethod method,
                                      const std::string& path,
                                      const std::string& data,
                                      std::string* response) {
   DCHECK(method == GET || method == POST);
-  static LibCurlInitializer lib_curl_initializer;
 
-  ScopedCurl scoped_curl;
-  CURL* curl = scoped_curl.get();
+  CURL* curl = static_cast<CURL*>(AcquireCurlHandle());
   if (!curl) {
     LOG(ERROR) << "curl_easy_init() failed.";
     return Status(error::HTTP_FAILURE, "curl_easy_init() failed.");
@@ -192,11 +328,11 @@ Status HttpKeyFetcher::FetchInternal(HttpMethod method,
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
     curl_easy_setopt(curl, CURLOPT_CAINFO, ca_file_.data());
   }
+  curl_slist* chunk = nullptr;
   if (method == POST) {
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
     curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, data.size());
 
-    curl_slist* chunk = nullptr;
     if (data.find("soap:Envelope") != std::string::npos) {
       // Adds Http headers for SOAP requests.
       chunk = curl_slist_append(chunk, kXmlContentTypeHeader);
@@ -213,15 +349,23 @@ Status HttpKeyFetcher::FetchInternal(HttpMethod method,
   }
 
   CURLcode res = curl_easy_perform(curl);
+  std::string error_message;
   if (res != CURLE_OK) {
-    std::string error_message = base::StringPrintf(
-        "curl_easy_perform() failed: %s.", curl_easy_strerror(res));
+    error_message = base::StringPrintf("curl_easy_perform() failed: %s.",
+                                       curl_easy_strerror(res));
     if (res == CURLE_HTTP_RETURNED_ERROR) {
       long response_code = 0;
       curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
       error_message += base::StringPrintf(" Response code: %ld.", response_code);
     }
+  }
+  // |chunk| is still referenced by |curl| until the options are reset, so it
+  // can only be freed after the request completes.
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+  curl_slist_free_all(chunk);
+  ReleaseCurlHandle(curl);
 
+  if (res != CURLE_OK) {
     LOG(ERROR) << error_message;
     return Status(
         res == CURLE_OPERATION_TIMEDOUT ? error::TIME_OUT : error::HTTP_FAILURE,
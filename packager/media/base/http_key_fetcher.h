@@ -11,7 +11,12 @@
 #ifndef PACKAGER_MEDIA_BASE_HTTP_KEY_FETCHER_H_
 #define PACKAGER_MEDIA_BASE_HTTP_KEY_FETCHER_H_
 
+#include <vector>
+
+#include "packager/base/callback.h"
 #include "packager/base/compiler_specific.h"
+#include "packager/base/synchronization/condition_variable.h"
+#include "packager/base/synchronization/lock.h"
 #include "packager/media/base/key_fetcher.h"
 #include "packager/status.h"
 
@@ -19,17 +24,36 @@ namespace shaka {
 namespace media {
 
 /// A KeyFetcher implementation that retrieves keys over HTTP(s).
+/// Connections, TLS sessions and DNS lookups are shared by all the
+/// HttpKeyFetcher instances in the process, so consecutive requests to the same
+/// server reuse the established connection instead of paying the full TCP and
+/// TLS setup again. Each instance keeps a pool of curl handles, which bounds
+/// the number of concurrent requests issued through the instance.
 /// This class is not fully thread safe. It can be used in multi-thread
 /// environment once constructed, but it may not be safe to create a
 /// HttpKeyFetcher object when any other thread is running due to use of
 /// curl_global_init.
 class HttpKeyFetcher : public KeyFetcher {
  public:
+  /// Callback invoked when an asynchronous request completes.
+  /// @param status is OK on success.
+  /// @param response contains the body of the http response on success.
+  typedef base::Callback<void(const Status& status,
+                              const std::string& response)>
+      FetchCallback;
+
   /// Creates a fetcher with no timeout.
   HttpKeyFetcher();
   /// Create a fetcher with timeout.
   /// @param timeout_in_seconds specifies the timeout in seconds.
   HttpKeyFetcher(uint32_t timeout_in_seconds);
+  /// Create a fetcher with timeout and concurrency limit.
+  /// @param timeout_in_seconds specifies the timeout in seconds.
+  /// @param max_concurrent_requests specifies the maximum number of requests
+  ///        in flight at the same time. Additional requests wait until one of
+  ///        the in-flight requests completes.
+  HttpKeyFetcher(uint32_t timeout_in_seconds, size_t max_concurrent_requests);
+  /// Waits for pending asynchronous requests to complete.
   ~HttpKeyFetcher() override;
 
   /// @name KeyFetcher implementation overrides.
@@ -53,6 +77,21 @@ class HttpKeyFetcher : public KeyFetcher {
                       const std::string& data,
                       std::string* response);
 
+  /// Fetch content using HTTP GET asynchronously. The request is performed in
+  /// a worker thread.
+  /// @param url specifies the content URL.
+  /// @param callback is invoked in the worker thread on completion.
+  void GetAsync(const std::string& url, const FetchCallback& callback);
+
+  /// Fetch content using HTTP POST asynchronously. The request is performed
+  /// in a worker thread.
+  /// @param url specifies the content URL.
+  /// @param data specifies the data to post.
+  /// @param callback is invoked in the worker thread on completion.
+  void PostAsync(const std::string& url,
+                 const std::string& data,
+                 const FetchCallback& callback);
+
   /// Sets client certificate information for http requests.
   /// @param cert_file absolute path to the client certificate.
   /// @param private_key_file absolute path to the client certificate
@@ -81,13 +120,36 @@ class HttpKeyFetcher : public KeyFetcher {
   // Internal implementation of HTTP functions, e.g. Get and Post.
   Status FetchInternal(HttpMethod method, const std::string& url,
                        const std::string& data, std::string* response);
+  // Task running in the worker pool for GetAsync and PostAsync.
+  void FetchTask(HttpMethod method,
+                 const std::string& url,
+                 const std::string& data,
+                 const FetchCallback& callback);
+
+  // Returns an idle curl handle from the pool, or creates one if there are
+  // less than |max_concurrent_requests_| handles. Otherwise blocks until a
+  // handle is released. Returns NULL if a new handle cannot be created.
+  void* AcquireCurlHandle();
+  // Returns |curl| to the pool. The connection associated with the handle is
+  // kept alive for the next request.
+  void ReleaseCurlHandle(void* curl);
 
   const uint32_t timeout_in_seconds_;
+  const size_t max_concurrent_requests_;
   std::string ca_file_;
   std::string client_cert_file_;
   std::string client_cert_private_key_file_;
   std::string client_cert_private_key_password_;
 
+  base::Lock lock_;
+  // Signaled when a curl handle is released or an async request completes.
+  base::ConditionVariable handle_released_;
+  // Idle curl handles, i.e. CURL*. Not using CURL to avoid exposing curl
+  // headers.
+  std::vector<void*> idle_curl_handles_;
+  size_t num_curl_handles_ = 0;
+  size_t num_pending_async_requests_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(HttpKeyFetcher);
 };
 
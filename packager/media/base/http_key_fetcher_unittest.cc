@@ -6,6 +6,22 @@
 
 #include "packager/media/base/http_key_fetcher.h"
 
+#if !defined(OS_WIN)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif  // !defined(OS_WIN)
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "packager/base/bind.h"
 #include "packager/base/logging.h"
 #include "packager/base/strings/string_number_conversions.h"
 #include "packager/base/strings/string_util.h"
@@ -95,6 +111,230 @@ TEST(DISABLED_HttpKeyFetcherTest, BigTimeout) {
   EXPECT_OK(status);
 }
 
+#if !defined(OS_WIN)
+
+namespace {
+
+const char kDelayPath[] = "/delay";
+const int kDelayInMilliseconds = 200;
+
+// A minimal HTTP/1.1 server on the loopback interface, which keeps the
+// connections alive and echoes the body of POST requests. Requests to
+// |kDelayPath| are answered after |kDelayInMilliseconds|. It counts the
+// connections and the requests in flight, so the connection reuse and the
+// concurrency limit of HttpKeyFetcher can be verified.
+class LocalHttpServer {
+ public:
+  LocalHttpServer() {
+    listen_socket_ = socket(AF_INET, SOCK_STREAM, 0);
+    CHECK_GE(listen_socket_, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    CHECK_EQ(0, bind(listen_socket_, reinterpret_cast<sockaddr*>(&address),
+                     sizeof(address)));
+    CHECK_EQ(0, listen(listen_socket_, SOMAXCONN));
+    socklen_t address_size = sizeof(address);
+    CHECK_EQ(0,
+             getsockname(listen_socket_, reinterpret_cast<sockaddr*>(&address),
+                         &address_size));
+    port_ = ntohs(address.sin_port);
+    accept_thread_ = std::thread(&LocalHttpServer::AcceptConnections, this);
+  }
+
+  ~LocalHttpServer() {
+    // Unblocks accept() and recv(), including the connections kept alive by
+    // the curl connection cache.
+    shutdown(listen_socket_, SHUT_RDWR);
+    accept_thread_.join();
+    close(listen_socket_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int connection_socket : connection_sockets_)
+        shutdown(connection_socket, SHUT_RDWR);
+    }
+    for (std::thread& thread : connection_threads_)
+      thread.join();
+    for (int connection_socket : connection_sockets_)
+      close(connection_socket);
+  }
+
+  std::string GetUrl(const std::string& path) const {
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+  }
+
+  size_t num_connections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connection_sockets_.size();
+  }
+  size_t num_requests() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_requests_;
+  }
+  size_t max_requests_in_flight() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_requests_in_flight_;
+  }
+
+ private:
+  LocalHttpServer(const LocalHttpServer&) = delete;
+  LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+  void AcceptConnections() {
+    while (true) {
+      const int connection_socket = accept(listen_socket_, nullptr, nullptr);
+      if (connection_socket < 0)
+        return;
+      std::lock_guard<std::mutex> lock(mutex_);
+      connection_sockets_.push_back(connection_socket);
+      connection_threads_.emplace_back(&LocalHttpServer::ServeConnection,
+                                       this, connection_socket);
+    }
+  }
+
+  void ServeConnection(int connection_socket) {
+    std::string buffer;
+    while (true) {
+      // Reads the request headers and body.
+      size_t headers_end;
+      while ((headers_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (!Receive(connection_socket, &buffer))
+          return;
+      }
+      const std::string headers =
+          base::ToLowerASCII(buffer.substr(0, headers_end));
+      size_t content_length = 0;
+      const char kContentLength[] = "content-length:";
+      const size_t content_length_pos = headers.find(kContentLength);
+      if (content_length_pos != std::string::npos) {
+        const size_t value_pos = content_length_pos + strlen(kContentLength);
+        base::StringToSizeT(
+            base::TrimWhitespaceASCII(
+                headers.substr(value_pos,
+                               headers.find("\r\n", value_pos) - value_pos),
+                base::TRIM_ALL),
+            &content_length);
+      }
+      const size_t body_pos = headers_end + 4;
+      while (buffer.size() < body_pos + content_length) {
+        if (!Receive(connection_socket, &buffer))
+          return;
+      }
+      const std::string request_line = buffer.substr(0, buffer.find("\r\n"));
+      const std::string body = buffer.substr(body_pos, content_length);
+      buffer.erase(0, body_pos + content_length);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++num_requests_;
+        ++num_requests_in_flight_;
+        max_requests_in_flight_ =
+            std::max(max_requests_in_flight_, num_requests_in_flight_);
+      }
+      if (request_line.find(kDelayPath) != std::string::npos) {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kDelayInMilliseconds));
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --num_requests_in_flight_;
+      }
+
+      const std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                                   std::to_string(body.size()) + "\r\n\r\n" +
+                                   body;
+      if (send(connection_socket, response.data(), response.size(), 0) !=
+          static_cast<ssize_t>(response.size())) {
+        return;
+      }
+    }
+  }
+
+  static bool Receive(int connection_socket, std::string* buffer) {
+    char data[4096];
+    const ssize_t size = recv(connection_socket, data, sizeof(data), 0);
+    if (size <= 0)
+      return false;
+    buffer->append(data, size);
+    return true;
+  }
+
+  int listen_socket_ = -1;
+  uint16_t port_ = 0;
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::vector<int> connection_sockets_;
+  std::vector<std::thread> connection_threads_;
+  size_t num_requests_ = 0;
+  size_t num_requests_in_flight_ = 0;
+  size_t max_requests_in_flight_ = 0;
+};
+
+void OnFetchCompleted(std::mutex* mutex,
+                      size_t* num_completed,
+                      const Status& status,
+                      const std::string& response) {
+  EXPECT_OK(status);
+  EXPECT_EQ(kPostData, response);
+  std::lock_guard<std::mutex> lock(*mutex);
+  ++*num_completed;
+}
+
+}  // namespace
+
+TEST(HttpKeyFetcherTest, ReusesConnection) {
+  LocalHttpServer server;
+  HttpKeyFetcher fetcher;
+  for (int i = 0; i < 3; ++i) {
+    std::string response;
+    ASSERT_OK(fetcher.Post(server.GetUrl("/"), kPostData, &response));
+    EXPECT_EQ(kPostData, response);
+  }
+  EXPECT_EQ(3u, server.num_requests());
+  EXPECT_EQ(1u, server.num_connections());
+}
+
+TEST(HttpKeyFetcherTest, AsyncPostLimitsConcurrentRequests) {
+  const size_t kNumRequests = 6;
+  const uint32_t kTimeoutInSeconds = 5;
+  const size_t kMaxConcurrentRequests = 2;
+  LocalHttpServer server;
+  std::mutex mutex;
+  size_t num_completed = 0;
+  {
+    HttpKeyFetcher fetcher(kTimeoutInSeconds, kMaxConcurrentRequests);
+    for (size_t i = 0; i < kNumRequests; ++i) {
+      fetcher.PostAsync(server.GetUrl(kDelayPath), kPostData,
+                        base::Bind(&OnFetchCompleted, base::Unretained(&mutex),
+                                   base::Unretained(&num_completed)));
+    }
+    // The destructor waits for the pending requests.
+  }
+  EXPECT_EQ(kNumRequests, num_completed);
+  EXPECT_EQ(kNumRequests, server.num_requests());
+  EXPECT_EQ(kMaxConcurrentRequests, server.max_requests_in_flight());
+  EXPECT_GE(kMaxConcurrentRequests, server.num_connections());
+}
+
+TEST(HttpKeyFetcherTest, SyncRequestWaitsForAsyncRequests) {
+  const uint32_t kTimeoutInSeconds = 5;
+  const size_t kMaxConcurrentRequests = 1;
+  LocalHttpServer server;
+  std::mutex mutex;
+  size_t num_completed = 0;
+  HttpKeyFetcher fetcher(kTimeoutInSeconds, kMaxConcurrentRequests);
+  fetcher.PostAsync(server.GetUrl(kDelayPath), kPostData,
+                    base::Bind(&OnFetchCompleted, base::Unretained(&mutex),
+                               base::Unretained(&num_completed)));
+  std::string response;
+  ASSERT_OK(fetcher.Post(server.GetUrl(kDelayPath), kPostData, &response));
+  EXPECT_EQ(kPostData, response);
+  EXPECT_EQ(1u, server.max_requests_in_flight());
+}
+
+#endif  // !defined(OS_WIN)
+
 }  // namespace media
 }  // namespace shaka
 
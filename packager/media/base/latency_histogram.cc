@@ -0,0 +1,83 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/base/latency_histogram.h"
+
+#include <algorithm>
+
+#include "packager/base/logging.h"
+#include "packager/base/macros.h"
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+// Exclusive upper bounds of the buckets between the zero latency bucket and
+// the last unbounded bucket.
+const int64_t kBucketUpperBoundsInMilliseconds[] = {
+    1,    2,    5,     10,    20,    50,     100,   200,
+    500,  1000, 2000,  5000,  10000, 20000,  50000,
+};
+static_assert(arraysize(kBucketUpperBoundsInMilliseconds) + 2 ==
+                  LatencyHistogram::kNumBuckets,
+              "Number of buckets mismatch");
+
+}  // namespace
+
+const size_t LatencyHistogram::kNumBuckets;
+
+LatencyHistogram::LatencyHistogram() {
+  for (auto& bucket_count : bucket_counts_)
+    bucket_count.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::~LatencyHistogram() {}
+
+base::TimeDelta LatencyHistogram::BucketUpperBound(size_t index) {
+  DCHECK_LT(index, kNumBuckets);
+  // The first bucket only holds zero latencies, which are common when the
+  // clock resolution is coarse.
+  if (index == 0)
+    return base::TimeDelta::FromMicroseconds(1);
+  if (index == kNumBuckets - 1)
+    return base::TimeDelta::Max();
+  return base::TimeDelta::FromMilliseconds(
+      kBucketUpperBoundsInMilliseconds[index - 1]);
+}
+
+void LatencyHistogram::Record(base::TimeDelta latency) {
+  const int64_t latency_us = std::max<int64_t>(latency.InMicroseconds(), 0);
+  size_t index = 0;
+  while (index < kNumBuckets - 1 &&
+         latency_us >= BucketUpperBound(index).InMicroseconds()) {
+    ++index;
+  }
+  // Only a single thread records, so there is no need for a compare and swap
+  // loop to update the maximum.
+  if (latency_us > max_us_.load(std::memory_order_relaxed))
+    max_us_.store(latency_us, std::memory_order_relaxed);
+  sum_us_.fetch_add(latency_us, std::memory_order_relaxed);
+  bucket_counts_[index].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+base::TimeDelta LatencyHistogram::Percentile(double percentile) const {
+  const uint64_t total = count();
+  if (total == 0)
+    return base::TimeDelta();
+  const double rank = std::min(std::max(percentile, 0.0), 100.0) * total / 100;
+  uint64_t cumulative_count = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    cumulative_count += bucket_count(i);
+    if (cumulative_count >= rank && cumulative_count > 0)
+      return std::min(BucketUpperBound(i), max());
+  }
+  return max();
+}
+
+}  // namespace media
+}  // namespace shaka
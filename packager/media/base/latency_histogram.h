@@ -0,0 +1,74 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_BASE_LATENCY_HISTOGRAM_H_
+#define PACKAGER_MEDIA_BASE_LATENCY_HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "packager/base/time/time.h"
+
+namespace shaka {
+namespace media {
+
+/// A histogram of latencies with a bucket for zero latencies and fixed buckets
+/// following a 1-2-5 series from 1 millisecond to 50 seconds. Latencies are
+/// recorded by a single thread but the histogram can be read from any thread.
+class LatencyHistogram {
+ public:
+  /// Number of buckets, including the last unbounded bucket.
+  static const size_t kNumBuckets = 17;
+
+  LatencyHistogram();
+  ~LatencyHistogram();
+
+  /// @return The exclusive upper bound of the bucket at @a index. It is
+  ///         base::TimeDelta::Max() for the last bucket.
+  static base::TimeDelta BucketUpperBound(size_t index);
+
+  /// Records a latency. Negative latencies are recorded as zero.
+  void Record(base::TimeDelta latency);
+
+  /// @return The number of latencies recorded.
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  /// @return The number of latencies in the bucket at @a index.
+  uint64_t bucket_count(size_t index) const {
+    return bucket_counts_[index].load(std::memory_order_relaxed);
+  }
+  /// @return The sum of the latencies recorded.
+  base::TimeDelta sum() const {
+    return base::TimeDelta::FromMicroseconds(
+        sum_us_.load(std::memory_order_relaxed));
+  }
+  /// @return The largest latency recorded.
+  base::TimeDelta max() const {
+    return base::TimeDelta::FromMicroseconds(
+        max_us_.load(std::memory_order_relaxed));
+  }
+
+  /// Estimates a percentile from the buckets.
+  /// @param percentile is in the range of [0, 100].
+  /// @return The upper bound of the bucket containing @a percentile, capped
+  ///         by the largest latency recorded. Zero if nothing is recorded.
+  base::TimeDelta Percentile(double percentile) const;
+
+ private:
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  std::atomic<uint64_t> bucket_counts_[kNumBuckets];
+  std::atomic<uint64_t> count_{0};
+  std::atomic<int64_t> sum_us_{0};
+  std::atomic<int64_t> max_us_{0};
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_BASE_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,84 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/base/latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+base::TimeDelta Milliseconds(int64_t milliseconds) {
+  return base::TimeDelta::FromMilliseconds(milliseconds);
+}
+
+}  // namespace
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0u, histogram.count());
+  EXPECT_EQ(base::TimeDelta(), histogram.sum());
+  EXPECT_EQ(base::TimeDelta(), histogram.max());
+  EXPECT_EQ(base::TimeDelta(), histogram.Percentile(50));
+  for (size_t i = 0; i < LatencyHistogram::kNumBuckets; ++i)
+    EXPECT_EQ(0u, histogram.bucket_count(i));
+}
+
+TEST(LatencyHistogramTest, BucketUpperBounds) {
+  EXPECT_EQ(base::TimeDelta::FromMicroseconds(1),
+            LatencyHistogram::BucketUpperBound(0));
+  EXPECT_EQ(Milliseconds(1), LatencyHistogram::BucketUpperBound(1));
+  EXPECT_EQ(Milliseconds(50000),
+            LatencyHistogram::BucketUpperBound(LatencyHistogram::kNumBuckets -
+                                               2));
+  EXPECT_EQ(base::TimeDelta::Max(),
+            LatencyHistogram::BucketUpperBound(LatencyHistogram::kNumBuckets -
+                                               1));
+  for (size_t i = 1; i < LatencyHistogram::kNumBuckets; ++i) {
+    EXPECT_LT(LatencyHistogram::BucketUpperBound(i - 1),
+              LatencyHistogram::BucketUpperBound(i));
+  }
+}
+
+TEST(LatencyHistogramTest, Record) {
+  LatencyHistogram histogram;
+  histogram.Record(base::TimeDelta());
+  // Negative latencies are recorded as zero.
+  histogram.Record(Milliseconds(-5));
+  histogram.Record(Milliseconds(1));
+  histogram.Record(Milliseconds(150));
+  histogram.Record(Milliseconds(100000));
+
+  EXPECT_EQ(5u, histogram.count());
+  EXPECT_EQ(Milliseconds(100151), histogram.sum());
+  EXPECT_EQ(Milliseconds(100000), histogram.max());
+  EXPECT_EQ(2u, histogram.bucket_count(0));
+  // [1ms, 2ms).
+  EXPECT_EQ(1u, histogram.bucket_count(2));
+  // [100ms, 200ms).
+  EXPECT_EQ(1u, histogram.bucket_count(8));
+  EXPECT_EQ(1u, histogram.bucket_count(LatencyHistogram::kNumBuckets - 1));
+}
+
+TEST(LatencyHistogramTest, Percentile) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 90; ++i)
+    histogram.Record(Milliseconds(15));
+  for (int i = 0; i < 9; ++i)
+    histogram.Record(Milliseconds(300));
+  histogram.Record(Milliseconds(700));
+
+  EXPECT_EQ(Milliseconds(20), histogram.Percentile(50));
+  EXPECT_EQ(Milliseconds(20), histogram.Percentile(90));
+  EXPECT_EQ(Milliseconds(500), histogram.Percentile(99));
+  // Capped by the largest latency.
+  EXPECT_EQ(Milliseconds(700), histogram.Percentile(100));
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -27,8 +27,11 @@
         'audio_timestamp_helper.h',
         'bit_reader.cc',
         'bit_reader.h',
+        'bit_util.h',
         'bit_writer.cc',
         'bit_writer.h',
+        'buffer_list.cc',
+        'buffer_list.h',
         'buffer_reader.cc',
         'buffer_reader.h',
         'buffer_writer.cc',
@@ -57,6 +60,8 @@
         'key_source.h',
         'language_utils.cc',
         'language_utils.h',
+        'latency_histogram.cc',
+        'latency_histogram.h',
         'limits.h',
         'macros.h',
         'media_handler.cc',
@@ -118,6 +123,8 @@
         'widevine_pssh_data_proto',
         '../../base/base.gyp:base',
         '../../packager.gyp:status',
+        '../../packager.gyp:memory_tracker',
+        '../../packager.gyp:trace_event',
         '../../third_party/boringssl/boringssl.gyp:boringssl',
         '../../third_party/curl/curl.gyp:libcurl',
         '../../third_party/libxml/libxml.gyp:libxml',
@@ -169,12 +176,15 @@
         'audio_timestamp_helper_unittest.cc',
         'bit_reader_unittest.cc',
         'bit_writer_unittest.cc',
+        'buffer_list_unittest.cc',
         'buffer_writer_unittest.cc',
         'closure_thread_unittest.cc',
         'container_names_unittest.cc',
         'decryptor_source_unittest.cc',
         'http_key_fetcher_unittest.cc',
         'id3_tag_unittest.cc',
+        'latency_histogram_unittest.cc',
+        'media_handler_unittest.cc',
         'muxer_util_unittest.cc',
         'offset_byte_queue_unittest.cc',
         'producer_consumer_queue_unittest.cc',
@@ -196,6 +206,21 @@
         '../../third_party/boringssl/boringssl.gyp:boringssl',
         '../test/media_test.gyp:media_test_support',
         'media_base',
+        'media_handler_test_base',
+      ],
+    },
+    {
+      'target_name': 'media_base_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'aes_cryptor_perftest.cc',
+      ],
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../testing/gtest.gyp:gtest',
+        '../../testing/perf/perf_test.gyp:perf_test',
+        '../test/media_test.gyp:media_test_support',
+        'media_base',
       ],
     },
   ],
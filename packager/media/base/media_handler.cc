@@ -6,11 +6,39 @@
 
 #include "packager/media/base/media_handler.h"
 
+#include <chrono>
+
 #include "packager/status_macros.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 namespace media {
 
+namespace {
+
+// Time spent in downstream handlers by the innermost handler with statistics
+// enabled on this thread, which is excluded from its self time.
+thread_local int64_t g_downstream_time_ns = 0;
+
+int64_t NowInNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+size_t StreamData::EstimateMemoryUsage() const {
+  size_t size = sizeof(*this);
+  if (media_sample) {
+    size += sizeof(*media_sample) + media_sample->data_size() +
+            media_sample->side_data_size();
+  }
+  if (text_sample)
+    size += sizeof(*text_sample) + text_sample->payload().size();
+  return size;
+}
+
 std::string StreamDataTypeToString(StreamDataType type) {
   switch (type) {
     case StreamDataType::kStreamInfo:
@@ -33,6 +61,7 @@ std::string StreamDataTypeToString(StreamDataType type) {
 
 Status MediaHandler::SetHandler(size_t output_stream_index,
                                 std::shared_ptr<MediaHandler> handler) {
+  base::AutoLock auto_lock(output_handlers_lock_);
   if (output_handlers_.find(output_stream_index) != output_handlers_.end()) {
     return Status(error::ALREADY_EXISTS,
                   "The handler at the specified index already exists.");
@@ -99,7 +128,73 @@ Status MediaHandler::Dispatch(std::unique_ptr<StreamData> stream_data) const {
                   "No output handler exist at the specified index.");
   }
   stream_data->stream_index = handler_it->second.second;
-  return handler_it->second.first->Process(std::move(stream_data));
+  MediaHandler* handler = handler_it->second.first.get();
+  SHAKA_TRACE_EVENT("handler", handler->trace_name());
+  if (handler->stats_)
+    return handler->ProcessWithStats(std::move(stream_data));
+  return handler->Process(std::move(stream_data));
+}
+
+const char* MediaHandler::trace_name() const {
+  const char* trace_name = trace_name_.load(std::memory_order_relaxed);
+  if (!trace_name) {
+    trace_name = TraceLog::InternName(name());
+    trace_name_.store(trace_name, std::memory_order_relaxed);
+  }
+  return trace_name;
+}
+
+void MediaHandler::EnableStats() {
+  if (stats_)
+    return;
+  stats_.reset(new InputStreamStats[num_input_streams_]);
+  for (auto& pair : output_handlers_)
+    pair.second.first->EnableStats();
+}
+
+void MediaHandler::GetStats(std::set<const MediaHandler*>* visited,
+                            std::vector<HandlerStreamStats>* stats) const {
+  if (!visited->insert(this).second)
+    return;
+  if (stats_) {
+    for (size_t i = 0; i < num_input_streams_; ++i) {
+      HandlerStreamStats stream_stats;
+      stream_stats.handler_name = name();
+      stream_stats.stream_index = i;
+      stream_stats.num_samples =
+          stats_[i].num_samples.load(std::memory_order_relaxed);
+      stream_stats.num_bytes =
+          stats_[i].num_bytes.load(std::memory_order_relaxed);
+      stream_stats.self_time_ns =
+          stats_[i].self_time_ns.load(std::memory_order_relaxed);
+      stats->push_back(stream_stats);
+    }
+  }
+  base::AutoLock auto_lock(output_handlers_lock_);
+  for (const auto& pair : output_handlers_)
+    pair.second.first->GetStats(visited, stats);
+}
+
+Status MediaHandler::ProcessWithStats(std::unique_ptr<StreamData> stream_data) {
+  DCHECK_LT(stream_data->stream_index, num_input_streams_);
+  InputStreamStats& stats = stats_[stream_data->stream_index];
+  if (stream_data->stream_data_type == StreamDataType::kMediaSample) {
+    stats.num_samples.fetch_add(1, std::memory_order_relaxed);
+    stats.num_bytes.fetch_add(stream_data->media_sample->data_size(),
+                              std::memory_order_relaxed);
+  } else if (stream_data->stream_data_type == StreamDataType::kTextSample) {
+    stats.num_samples.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const int64_t upstream_downstream_time_ns = g_downstream_time_ns;
+  g_downstream_time_ns = 0;
+  const int64_t start_ns = NowInNanoseconds();
+  Status status = Process(std::move(stream_data));
+  const int64_t elapsed_ns = NowInNanoseconds() - start_ns;
+  stats.self_time_ns.fetch_add(elapsed_ns - g_downstream_time_ns,
+                               std::memory_order_relaxed);
+  g_downstream_time_ns = upstream_downstream_time_ns + elapsed_ns;
+  return status;
 }
 
 Status MediaHandler::FlushDownstream(size_t output_stream_index) {
@@ -120,5 +215,35 @@ Status MediaHandler::FlushAllDownstreams() {
   }
   return Status::OK;
 }
+
+Status MediaHandler::AttachHandler(size_t output_stream_index,
+                                   std::shared_ptr<MediaHandler> handler) {
+  if (output_handlers_.find(output_stream_index) != output_handlers_.end()) {
+    return Status(error::ALREADY_EXISTS,
+                  "The handler at the specified index already exists.");
+  }
+  // The handler is set up before it is connected, so that GetStats() never
+  // sees it half initialized.
+  const size_t input_stream_index = handler->num_input_streams_++;
+  RETURN_IF_ERROR(handler->Initialize());
+  if (stats_)
+    handler->EnableStats();
+
+  base::AutoLock auto_lock(output_handlers_lock_);
+  output_handlers_[output_stream_index] =
+      std::make_pair(std::move(handler), input_stream_index);
+  next_output_stream_index_ = output_stream_index + 1;
+  return Status::OK;
+}
+
+Status MediaHandler::DetachHandler(size_t output_stream_index) {
+  base::AutoLock auto_lock(output_handlers_lock_);
+  if (output_handlers_.erase(output_stream_index) == 0) {
+    return Status(error::NOT_FOUND,
+                  "No output handler exist at the specified index.");
+  }
+  return Status::OK;
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -7,10 +7,15 @@
 #ifndef PACKAGER_MEDIA_BASE_MEDIA_HANDLER_H_
 #define PACKAGER_MEDIA_BASE_MEDIA_HANDLER_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "packager/base/synchronization/lock.h"
 #include "packager/media/base/media_sample.h"
 #include "packager/media/base/stream_info.h"
 #include "packager/media/base/text_sample.h"
@@ -67,7 +72,7 @@ struct SegmentInfo {
   // This is only available if key rotation is enabled. Note that we may have
   // a |key_rotation_encryption_config| even if the segment is not encrypted,
   // which is the case for clear lead.
-  std::shared_ptr<EncryptionConfig> key_rotation_encryption_config;
+  std::shared_ptr<const EncryptionConfig> key_rotation_encryption_config;
 };
 
 // TODO(kqyang): Should we use protobuf?
@@ -141,6 +146,25 @@ struct StreamData {
     stream_data->cue_event = std::move(cue_event);
     return stream_data;
   }
+
+  /// @return An estimate of the bytes held by this stream data, which is
+  ///         dominated by the sample data. Used for memory accounting.
+  size_t EstimateMemoryUsage() const;
+};
+
+/// Snapshot of the statistics of one input stream of a media handler.
+struct HandlerStreamStats {
+  /// Name of the job running the handler. Filled in by the job manager.
+  std::string job_name;
+  std::string handler_name;
+  size_t stream_index = 0;
+  /// Number of media and text samples received.
+  uint64_t num_samples = 0;
+  /// Number of media sample bytes received.
+  uint64_t num_bytes = 0;
+  /// Time spent processing the stream in the handler itself, excluding the
+  /// time spent in downstream handlers.
+  int64_t self_time_ns = 0;
 };
 
 /// MediaHandler is the base media processing unit. Media handlers transform
@@ -182,6 +206,21 @@ class MediaHandler {
   static Status Chain(
       std::initializer_list<std::shared_ptr<MediaHandler>> list);
 
+  /// @return The name of the handler, used to label its statistics.
+  virtual std::string name() const { return "MediaHandler"; }
+
+  /// Enable statistics collection in the handler and its downstream handlers.
+  /// It should be called after setting up the graph before running the graph.
+  /// Without it, collecting statistics costs a null check per dispatch.
+  void EnableStats();
+
+  /// Append the statistics of the handler and its downstream handlers to
+  /// @a stats. It can be called while the graph is running.
+  /// @param visited contains the handlers already reported, which are
+  ///        skipped. The handler and its downstream handlers are added.
+  void GetStats(std::set<const MediaHandler*>* visited,
+                std::vector<HandlerStreamStats>* stats) const;
+
  protected:
   /// Internal implementation of initialize. Note that it should only initialize
   /// the MediaHandler itself. Downstream handlers are handled in Initialize().
@@ -257,6 +296,17 @@ class MediaHandler {
   /// Flush all connected downstream handlers.
   Status FlushAllDownstreams();
 
+  /// Connect and initialize a downstream handler while the graph is running.
+  /// Statistics are enabled in the downstream handler if they are enabled in
+  /// this handler. It must be called on the thread running this handler.
+  Status AttachHandler(size_t output_stream_index,
+                       std::shared_ptr<MediaHandler> handler);
+
+  /// Disconnect the downstream handler at the specified output stream index
+  /// while the graph is running. The downstream handler is not flushed. It
+  /// must be called on the thread running this handler.
+  Status DetachHandler(size_t output_stream_index);
+
   bool initialized() { return initialized_; }
   size_t num_input_streams() const { return num_input_streams_; }
   size_t next_output_stream_index() const { return next_output_stream_index_; }
@@ -269,6 +319,20 @@ class MediaHandler {
   MediaHandler(const MediaHandler&) = delete;
   MediaHandler& operator=(const MediaHandler&) = delete;
 
+  // Counters of one input stream. They are only updated by the thread running
+  // the stream, but can be read from any thread.
+  struct InputStreamStats {
+    std::atomic<uint64_t> num_samples{0};
+    std::atomic<uint64_t> num_bytes{0};
+    std::atomic<int64_t> self_time_ns{0};
+  };
+
+  // Process() with statistics collection.
+  Status ProcessWithStats(std::unique_ptr<StreamData> stream_data);
+
+  // @return name() interned for trace events.
+  const char* trace_name() const;
+
   bool initialized_ = false;
   // Number of input streams.
   size_t num_input_streams_ = 0;
@@ -278,6 +342,14 @@ class MediaHandler {
   // map.
   std::map<size_t, std::pair<std::shared_ptr<MediaHandler>, size_t>>
       output_handlers_;
+  // Protects |output_handlers_| against changes while GetStats() walks it
+  // from another thread. The thread running the handler does not need it to
+  // read |output_handlers_|, as it is the only one changing it.
+  mutable base::Lock output_handlers_lock_;
+  // Per input stream statistics. Null unless statistics are enabled.
+  std::unique_ptr<InputStreamStats[]> stats_;
+  // Lazily interned by trace_name().
+  mutable std::atomic<const char*> trace_name_{nullptr};
 };
 
 }  // namespace media
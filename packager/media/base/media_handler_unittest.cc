@@ -0,0 +1,115 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/base/media_handler.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "packager/base/threading/platform_thread.h"
+#include "packager/media/base/media_handler_test_base.h"
+#include "packager/status_macros.h"
+#include "packager/status_test_util.h"
+
+namespace shaka {
+namespace media {
+namespace {
+
+const size_t kStreamIndex = 0;
+const int64_t kDuration = 1000;
+const bool kKeyFrame = true;
+const uint8_t kData[] = {1, 2, 3, 4, 5};
+const int64_t kSleepMs = 20;
+
+// Forwards everything to the downstream handler.
+class PassThroughHandler : public MediaHandler {
+ public:
+  std::string name() const override { return "PassThroughHandler"; }
+
+ private:
+  Status InitializeInternal() override { return Status::OK; }
+  Status Process(std::unique_ptr<StreamData> stream_data) override {
+    return Dispatch(std::move(stream_data));
+  }
+};
+
+// Sleeps on every stream data received.
+class SleepingHandler : public MediaHandler {
+ public:
+  std::string name() const override { return "SleepingHandler"; }
+
+ private:
+  Status InitializeInternal() override { return Status::OK; }
+  Status Process(std::unique_ptr<StreamData> stream_data) override {
+    base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(kSleepMs));
+    return Status::OK;
+  }
+};
+
+}  // namespace
+
+class MediaHandlerStatsTest : public MediaHandlerTestBase {
+ protected:
+  void SetUp() override {
+    input_.reset(new FakeInputMediaHandler);
+    pass_through_.reset(new PassThroughHandler);
+    sleeping_.reset(new SleepingHandler);
+    ASSERT_OK(MediaHandler::Chain({input_, pass_through_, sleeping_}));
+    ASSERT_OK(input_->Initialize());
+  }
+
+  Status DispatchSamples(int num_samples) {
+    for (int i = 0; i < num_samples; ++i) {
+      RETURN_IF_ERROR(input_->Dispatch(StreamData::FromMediaSample(
+          kStreamIndex, GetMediaSample(i * kDuration, kDuration, kKeyFrame,
+                                       kData, sizeof(kData)))));
+    }
+    return Status::OK;
+  }
+
+  std::vector<HandlerStreamStats> GetStats() {
+    std::set<const MediaHandler*> visited;
+    std::vector<HandlerStreamStats> stats;
+    input_->GetStats(&visited, &stats);
+    return stats;
+  }
+
+  std::shared_ptr<FakeInputMediaHandler> input_;
+  std::shared_ptr<PassThroughHandler> pass_through_;
+  std::shared_ptr<SleepingHandler> sleeping_;
+};
+
+TEST_F(MediaHandlerStatsTest, Disabled) {
+  ASSERT_OK(DispatchSamples(2));
+  EXPECT_TRUE(GetStats().empty());
+}
+
+TEST_F(MediaHandlerStatsTest, Enabled) {
+  input_->EnableStats();
+  ASSERT_OK(DispatchSamples(2));
+
+  const std::vector<HandlerStreamStats> stats = GetStats();
+  // The input handler has no input streams, so there are no stats for it.
+  ASSERT_EQ(2u, stats.size());
+  EXPECT_EQ("PassThroughHandler", stats[0].handler_name);
+  EXPECT_EQ("SleepingHandler", stats[1].handler_name);
+  for (const HandlerStreamStats& stream_stats : stats) {
+    EXPECT_EQ(0u, stream_stats.stream_index);
+    EXPECT_EQ(2u, stream_stats.num_samples);
+    EXPECT_EQ(2 * sizeof(kData), stream_stats.num_bytes);
+  }
+
+  // The time spent in the sleeping handler is not counted in the self time of
+  // the pass through handler.
+  const int64_t kTwoSleepsNs = 2 * kSleepMs * 1000000;
+  EXPECT_GE(stats[1].self_time_ns, kTwoSleepsNs);
+  EXPECT_LT(stats[0].self_time_ns, kTwoSleepsNs / 2);
+}
+
+}  // namespace media
+}  // namespace shaka
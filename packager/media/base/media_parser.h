@@ -62,6 +62,28 @@ class MediaParser {
   /// @return true if successful.
   virtual bool Parse(const uint8_t* buf, int size) WARN_UNUSED_RESULT = 0;
 
+  /// Skip the samples of a track which are before a decoding timestamp, e.g.
+  /// to parse a chunk of the input. Parsers which need to read the skipped
+  /// samples to find the next ones may still emit them.
+  /// @param track_id is the track id of the samples.
+  /// @param dts is the decoding timestamp of the first sample to emit.
+  virtual void SkipSamplesBefore(uint32_t track_id, int64_t dts) {}
+
+  /// Emit the samples without their data, e.g. to find the key frames of the
+  /// input. Parsers which need to read the data to find the samples may still
+  /// emit them with their data.
+  /// @return true if the parser emits the samples without their data.
+  virtual bool SkipSampleData() { return false; }
+
+  /// Skip the part of the input which is not needed any more, e.g. the data
+  /// of skipped samples.
+  /// @param[out] position is set to the position in the input of the next
+  ///             bytes needed by the parser, if it is after the bytes passed
+  ///             to Parse() so far.
+  /// @return true if @a position is set. Parse() then expects the input from
+  ///         @a position on.
+  virtual bool SkipInput(int64_t* position) { return false; }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(MediaParser);
 };
@@ -90,6 +90,7 @@ std::shared_ptr<MediaSample> MediaSample::Clone() const {
   new_media_sample->side_data_ = side_data_;
   new_media_sample->side_data_size_ = side_data_size_;
   new_media_sample->config_id_ = config_id_;
+  new_media_sample->ingest_time_ = ingest_time_;
   if (decrypt_config_) {
     new_media_sample->decrypt_config_.reset(new DecryptConfig(
         decrypt_config_->key_id(), decrypt_config_->iv(),
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "packager/base/logging.h"
+#include "packager/base/time/time.h"
 #include "packager/media/base/decrypt_config.h"
 
 namespace shaka {
@@ -124,6 +125,13 @@ class MediaSample {
     return data_size_;
   }
 
+  /// @return the data shared with this media sample, which allows the data to
+  ///         be referenced beyond the lifetime of the sample without copying.
+  std::shared_ptr<const uint8_t> shared_data() const {
+    DCHECK(!end_of_stream());
+    return data_;
+  }
+
   const uint8_t* side_data() const { return side_data_.get(); }
 
   size_t side_data_size() const { return side_data_size_; }
@@ -150,6 +158,14 @@ class MediaSample {
     config_id_ = config_id;
   }
 
+  /// @return The time at which the data completing the sample was read from
+  ///         the input, or a null TimeTicks if unknown. Used for live latency
+  ///         accounting.
+  base::TimeTicks ingest_time() const { return ingest_time_; }
+  void set_ingest_time(base::TimeTicks ingest_time) {
+    ingest_time_ = ingest_time;
+  }
+
  protected:
   // Made it protected to disallow the constructor to be called directly.
   // Create a MediaSample. Buffer will be padded and aligned as necessary.
@@ -184,6 +200,9 @@ class MediaSample {
   // For now this is the cue identifier for WebVTT.
   std::string config_id_;
 
+  // Time at which the sample was read from the input. Null if unknown.
+  base::TimeTicks ingest_time_;
+
   // Decrypt configuration.
   std::unique_ptr<DecryptConfig> decrypt_config_;
 
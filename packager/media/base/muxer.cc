@@ -19,7 +19,8 @@ const bool kInitialEncryptionInfo = true;
 const int64_t kStartTime = 0;
 }  // namespace
 
-Muxer::Muxer(const MuxerOptions& options) : options_(options) {
+Muxer::Muxer(const MuxerOptions& options)
+    : options_(options), next_segment_index_(options.initial_segment_index) {
   // "$" is only allowed if the output file name is a template, which is used to
   // support one file per Representation per Period when there are Ad Cues.
   if (options_.output_file_name.find("$") != std::string::npos)
@@ -68,11 +69,31 @@ Status Muxer::Process(std::unique_ptr<StreamData> stream_data) {
           muxer_listener_->OnEncryptionStart();
         }
       }
+      if (!segment_info.is_subsegment && !segment_ingest_time_.is_null()) {
+        if (muxer_listener_)
+          muxer_listener_->OnSegmentIngestTime(segment_ingest_time_);
+        segment_ingest_time_ = base::TimeTicks();
+      }
+      if (segment_info.is_subsegment)
+        return FinalizeSegment(stream_data->stream_index, segment_info);
+      // The segment is counted and notified to the manifests as a whole for
+      // the holders of |segment_lock_|.
+      std::unique_ptr<base::subtle::AutoReadLock> read_lock;
+      if (segment_lock_)
+        read_lock.reset(new base::subtle::AutoReadLock(*segment_lock_));
+      ++next_segment_index_;
       return FinalizeSegment(stream_data->stream_index, segment_info);
     }
     
-    case StreamDataType::kMediaSample:
+    case StreamDataType::kMediaSample: {
+      const base::TimeTicks ingest_time =
+          stream_data->media_sample->ingest_time();
+      if (!ingest_time.is_null() && (segment_ingest_time_.is_null() ||
+                                     ingest_time < segment_ingest_time_)) {
+        segment_ingest_time_ = ingest_time;
+      }
       return AddSample(stream_data->stream_index, *stream_data->media_sample);
+    }
     
     case StreamDataType::kCueEvent:
       if (muxer_listener_) {
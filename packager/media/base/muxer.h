@@ -9,10 +9,13 @@
 #ifndef PACKAGER_MEDIA_BASE_MUXER_H_
 #define PACKAGER_MEDIA_BASE_MUXER_H_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
+#include "packager/base/synchronization/read_write_lock.h"
 #include "packager/base/time/clock.h"
+#include "packager/base/time/time.h"
 #include "packager/media/base/media_handler.h"
 #include "packager/media/base/muxer_options.h"
 #include "packager/media/event/muxer_listener.h"
@@ -48,6 +51,20 @@ class Muxer : public MediaHandler {
     return streams_;
   }
 
+  /// @return The index of the next segment to be written. It starts from
+  ///         MuxerOptions::initial_segment_index and is incremented before a
+  ///         segment is finalized. Can be called from any thread.
+  uint32_t next_segment_index() const { return next_segment_index_; }
+
+  /// Sets a lock which is held for reading while a segment is counted and
+  /// finalized, including the notification of the segment to the listener.
+  /// Holding it for writing gives a view of next_segment_index() consistent
+  /// with the segments notified.
+  /// @param segment_lock can be NULL and must outlive the muxer otherwise.
+  void set_segment_lock(base::subtle::ReadWriteLock* segment_lock) {
+    segment_lock_ = segment_lock;
+  }
+
   /// Inject clock, mainly used for testing.
   /// The injected clock will be used to generate the creation time-stamp and
   /// modification time-stamp of the muxer output.
@@ -61,6 +78,7 @@ class Muxer : public MediaHandler {
  protected:
   /// @name MediaHandler implementation overrides.
   /// @{
+  std::string name() const override { return "Muxer"; }
   Status InitializeInternal() override { return Status::OK; }
   Status Process(std::unique_ptr<StreamData> stream_data) override;
   Status OnFlushRequest(size_t input_stream_index) override;
@@ -102,6 +120,12 @@ class Muxer : public MediaHandler {
   std::vector<uint8_t> current_key_id_;
   bool encryption_started_ = false;
   bool cancelled_ = false;
+  // Read by next_segment_index() from other threads.
+  std::atomic<uint32_t> next_segment_index_;
+  base::subtle::ReadWriteLock* segment_lock_ = nullptr;
+  // Earliest ingest time of the samples in the current segment. Null if
+  // unknown.
+  base::TimeTicks segment_ingest_time_;
 
   std::unique_ptr<MuxerListener> muxer_listener_;
   std::unique_ptr<ProgressListener> progress_listener_;
@@ -11,6 +11,7 @@
 
 #include <string>
 
+#include "packager/base/optional.h"
 #include "packager/media/public/mp4_output_params.h"
 
 namespace shaka {
@@ -39,12 +40,41 @@ struct MuxerOptions {
   /// Optional.
   std::string segment_template;
 
+  /// Index of the first segment, which is used for the $Number$ identifier
+  /// of segment_template. Non-zero when live packaging resumes from a
+  /// checkpoint.
+  uint32_t initial_segment_index = 0;
+
   /// Specify temporary directory for intermediate files.
   std::string temp_dir;
 
   /// User-specified bit rate for the media stream. If zero, the muxer will
   /// attempt to estimate.
   uint32_t bandwidth = 0;
+
+  /// Target segment duration in seconds. Muxers may use it to estimate the
+  /// number of segments in the output. Zero if unknown.
+  double segment_duration_in_seconds = 0;
+
+  /// Write single-segment WebM output in a single pass if possible, see
+  /// PackagingParams::webm_single_pass.
+  bool webm_single_pass = false;
+
+  /// A chunk of the timeline which is packaged in parallel with the other
+  /// chunks of the output, see ParallelVodParams.
+  struct TimelineChunk {
+    /// Only the muxer of the first chunk writes the init segment. The init
+    /// segment is not updated with the media duration, which is unknown to
+    /// the muxer of any single chunk.
+    bool is_first_chunk = false;
+    /// Timestamps of the first sample of the timeline, which determine the
+    /// edit list offset of every chunk.
+    int64_t first_sample_pts = 0;
+    int64_t first_sample_dts = 0;
+  };
+  /// Set if the muxer only outputs a chunk of the timeline. Only supported by
+  /// MP4 muxers with segment_template.
+  base::Optional<TimelineChunk> timeline_chunk;
 };
 
 }  // namespace media
@@ -58,6 +58,13 @@ bool OffsetByteQueue::Trim(int64_t max_offset) {
   return true;
 }
 
+void OffsetByteQueue::SkipTo(int64_t offset) {
+  DCHECK_GE(offset, tail());
+  queue_.Reset();
+  head_ = offset;
+  Sync();
+}
+
 void OffsetByteQueue::Sync() {
   queue_.Peek(&buf_, &size_);
 }
@@ -48,6 +48,10 @@ class OffsetByteQueue {
   ///         buffered are still cleared).
   bool Trim(int64_t max_offset);
 
+  /// Clear the buffered bytes and continue the queue at @a offset, which must
+  /// not be before tail(), e.g. after the input skipped the bytes up to it.
+  void SkipTo(int64_t offset);
+
   /// @return The head position, in terms of the file's absolute offset.
   int64_t head() { return head_; }
   /// @return The tail position (exclusive), in terms of the file's absolute
@@ -89,5 +89,21 @@ TEST_F(OffsetByteQueueTest, Trim) {
   EXPECT_TRUE(queue_->Trim(512));
 }
 
+TEST_F(OffsetByteQueueTest, SkipTo) {
+  queue_->SkipTo(1024);
+  EXPECT_EQ(1024, queue_->head());
+  EXPECT_EQ(1024, queue_->tail());
+
+  const uint8_t buf[] = {1, 2, 3};
+  queue_->Push(buf, sizeof(buf));
+  EXPECT_EQ(1027, queue_->tail());
+
+  const uint8_t* peeked_buf;
+  int size;
+  queue_->PeekAt(1025, &peeked_buf, &size);
+  EXPECT_EQ(2, size);
+  EXPECT_EQ(2, peeked_buf[0]);
+}
+
 }  // namespace media
 }  // namespace shaka
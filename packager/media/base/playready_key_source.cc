@@ -17,6 +17,7 @@
 #include "packager/media/base/key_source.h"
 #include "packager/media/base/protection_system_ids.h"
 #include "packager/status_macros.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 namespace media {
@@ -164,6 +165,7 @@ Status SetKeyInformationFromServerResponse(
 
 Status PlayReadyKeySource::FetchKeysWithProgramIdentifier(
     const std::string& program_identifier) {
+  SHAKA_TRACE_EVENT("key_source", "PlayReadyKeySource::FetchKeys");
   std::unique_ptr<EncryptionKey> encryption_key(new EncryptionKey);
   HttpKeyFetcher key_fetcher(kHttpFetchTimeout);
   if (!client_cert_file_.empty() && !client_cert_private_key_file_.empty()) {
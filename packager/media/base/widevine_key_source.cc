@@ -6,9 +6,12 @@
 
 #include "packager/media/base/widevine_key_source.h"
 
+#include <algorithm>
+
 #include "packager/base/base64.h"
 #include "packager/base/bind.h"
 #include "packager/base/strings/string_number_conversions.h"
+#include "packager/base/time/time.h"
 #include "packager/media/base/http_key_fetcher.h"
 #include "packager/media/base/network_util.h"
 #include "packager/media/base/producer_consumer_queue.h"
@@ -19,6 +22,7 @@
 #include "packager/media/base/rcheck.h"
 #include "packager/media/base/request_signer.h"
 #include "packager/media/base/widevine_common_encryption.pb.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 namespace media {
@@ -33,7 +37,7 @@ const int kFirstRetryDelayMilliseconds = 1000;
 
 // Default crypto period count, which is the number of keys to fetch on every
 // key rotation enabled request.
-const int kDefaultCryptoPeriodCount = 10;
+const uint32_t kDefaultCryptoPeriodCount = 10;
 const int kGetKeyTimeoutInSeconds = 5 * 60;  // 5 minutes.
 const int kKeyFetchTimeoutInSeconds = 60;  // 1 minute.
 
@@ -101,6 +105,14 @@ WidevineKeySource::WidevineKeySource(const std::string& server_url,
 }
 
 WidevineKeySource::~WidevineKeySource() {
+  const CryptoPeriodKeyStats stats = crypto_period_key_stats();
+  if (stats.num_served_from_cache + stats.num_stalled > 0) {
+    LOG(INFO) << "Crypto period keys served from cache: "
+              << stats.num_served_from_cache
+              << ", stalled: " << stats.num_stalled
+              << " (total " << stats.total_stall_time_ms << " ms, max "
+              << stats.max_stall_time_ms << " ms).";
+  }
   if (key_pool_)
     key_pool_->Stop();
   if (key_production_thread_.HasBeenStarted()) {
@@ -215,6 +227,7 @@ Status WidevineKeySource::GetKey(const std::vector<uint8_t>& key_id,
 Status WidevineKeySource::GetCryptoPeriodKey(uint32_t crypto_period_index,
                                              const std::string& stream_label,
                                              EncryptionKey* key) {
+  SHAKA_TRACE_EVENT("key_source", "WidevineKeySource::GetCryptoPeriodKey");
   DCHECK(key_production_thread_.HasBeenStarted());
   // TODO(kqyang): This is not elegant. Consider refactoring later.
   {
@@ -244,6 +257,19 @@ void WidevineKeySource::set_key_fetcher(
   key_fetcher_ = std::move(key_fetcher);
 }
 
+void WidevineKeySource::set_crypto_period_count(uint32_t crypto_period_count) {
+  base::AutoLock scoped_lock(lock_);
+  DCHECK(!key_production_started_);
+  DCHECK_GT(crypto_period_count, 0u);
+  crypto_period_count_ = crypto_period_count;
+}
+
+WidevineKeySource::CryptoPeriodKeyStats
+WidevineKeySource::crypto_period_key_stats() const {
+  base::AutoLock scoped_lock(stats_lock_);
+  return crypto_period_key_stats_;
+}
+
 Status WidevineKeySource::GetKeyInternal(uint32_t crypto_period_index,
                                          const std::string& stream_label,
                                          EncryptionKey* key) {
@@ -251,8 +277,23 @@ Status WidevineKeySource::GetKeyInternal(uint32_t crypto_period_index,
   DCHECK(key);
 
   std::shared_ptr<EncryptionKeyMap> encryption_key_map;
+  // Keys are normally prefetched by |key_production_thread_|, so try the key
+  // pool without waiting first. Only wait if the key request for this crypto
+  // period is still in flight.
   Status status = key_pool_->Peek(crypto_period_index, &encryption_key_map,
-                                  kGetKeyTimeoutInSeconds * 1000);
+                                  0 /* timeout_ms */);
+  if (status.ok()) {
+    UpdateCryptoPeriodKeyStats(-1);
+  } else if (status.error_code() == error::TIME_OUT) {
+    const base::TimeTicks start_time = base::TimeTicks::Now();
+    status = key_pool_->Peek(crypto_period_index, &encryption_key_map,
+                             kGetKeyTimeoutInSeconds * 1000);
+    const int64_t stall_time_ms =
+        (base::TimeTicks::Now() - start_time).InMilliseconds();
+    UpdateCryptoPeriodKeyStats(stall_time_ms);
+    VLOG(1) << "Waited " << stall_time_ms << " ms for crypto period "
+            << crypto_period_index << " key of '" << stream_label << "'.";
+  }
   if (!status.ok()) {
     if (status.error_code() == error::STOPPED) {
       CHECK(!common_encryption_request_status_.ok());
@@ -291,6 +332,7 @@ void WidevineKeySource::FetchKeysTask() {
 Status WidevineKeySource::FetchKeysInternal(bool enable_key_rotation,
                                             uint32_t first_crypto_period_index,
                                             bool widevine_classic) {
+  SHAKA_TRACE_EVENT("key_source", "WidevineKeySource::FetchKeys");
   CommonEncryptionRequest request;
   FillRequest(enable_key_rotation, first_crypto_period_index, &request);
 
@@ -412,7 +454,8 @@ bool WidevineKeySource::ExtractEncryptionKey(
   }
 
   RCHECK(enable_key_rotation
-             ? response_proto.tracks_size() >= crypto_period_count_
+             ? static_cast<uint32_t>(response_proto.tracks_size()) >=
+                   crypto_period_count_
              : response_proto.tracks_size() >= 1);
 
   uint32_t current_crypto_period_index = first_crypto_period_index_;
@@ -490,5 +533,17 @@ bool WidevineKeySource::PushToKeyPool(
   return true;
 }
 
+void WidevineKeySource::UpdateCryptoPeriodKeyStats(int64_t stall_time_ms) {
+  base::AutoLock scoped_lock(stats_lock_);
+  if (stall_time_ms < 0) {
+    ++crypto_period_key_stats_.num_served_from_cache;
+    return;
+  }
+  ++crypto_period_key_stats_.num_stalled;
+  crypto_period_key_stats_.total_stall_time_ms += stall_time_ms;
+  crypto_period_key_stats_.max_stall_time_ms =
+      std::max(crypto_period_key_stats_.max_stall_time_ms, stall_time_ms);
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -28,6 +28,19 @@ template <class T> class ProducerConsumerQueue;
 /// acquire the encryption keys.
 class WidevineKeySource : public KeySource {
  public:
+  /// Statistics of crypto period key lookups, i.e. GetCryptoPeriodKey calls,
+  /// when key rotation is enabled.
+  struct CryptoPeriodKeyStats {
+    /// Number of lookups served from the prefetched key pool immediately.
+    uint64_t num_served_from_cache = 0;
+    /// Number of lookups which had to wait for a key request to complete.
+    uint64_t num_stalled = 0;
+    /// Accumulated waiting time of the stalled lookups in milliseconds.
+    int64_t total_stall_time_ms = 0;
+    /// Longest waiting time of a single stalled lookup in milliseconds.
+    int64_t max_stall_time_ms = 0;
+  };
+
   /// @param server_url is the Widevine common encryption server url.
   /// @param protection_systems_flags is the flags indicating which PSSH should
   ///        be included.
@@ -74,6 +87,17 @@ class WidevineKeySource : public KeySource {
     enable_entitlement_license_ = enable_entitlement_license;
   }
 
+  /// Set the number of crypto periods requested in a single key rotation
+  /// request. Keys for all stream labels of these crypto periods are fetched
+  /// together, and the key pool prefetches up to 5 requests ahead of the
+  /// crypto period being consumed. Must be called before key rotation starts,
+  /// i.e. before the first GetCryptoPeriodKey call.
+  /// @param crypto_period_count is the number of crypto periods per request.
+  void set_crypto_period_count(uint32_t crypto_period_count);
+
+  /// @return The statistics of crypto period key lookups so far.
+  CryptoPeriodKeyStats crypto_period_key_stats() const;
+
  private:
   typedef ProducerConsumerQueue<std::shared_ptr<EncryptionKeyMap>>
       EncryptionKeyQueue;
@@ -110,6 +134,9 @@ class WidevineKeySource : public KeySource {
                             bool* transient_error);
   // Push the keys to the key pool.
   bool PushToKeyPool(EncryptionKeyMap* encryption_key_map);
+  // Update crypto period key lookup statistics. |stall_time_ms| is negative if
+  // the key is served from the key pool without waiting.
+  void UpdateCryptoPeriodKeyStats(int64_t stall_time_ms);
 
   // Indicates whether Widevine protection system should be generated.
   bool generate_widevine_protection_system_ = true;
@@ -123,7 +150,7 @@ class WidevineKeySource : public KeySource {
   std::unique_ptr<RequestSigner> signer_;
   std::unique_ptr<CommonEncryptionRequest> common_encryption_request_;
 
-  const int crypto_period_count_;
+  uint32_t crypto_period_count_;
   FourCC protection_scheme_ = FOURCC_NULL;
   base::Lock lock_;
   bool key_production_started_ = false;
@@ -135,6 +162,9 @@ class WidevineKeySource : public KeySource {
   EncryptionKeyMap encryption_key_map_;  // For non key rotation request.
   Status common_encryption_request_status_;
 
+  mutable base::Lock stats_lock_;
+  CryptoPeriodKeyStats crypto_period_key_stats_;
+
   DISALLOW_COPY_AND_ASSIGN(WidevineKeySource);
 };
 
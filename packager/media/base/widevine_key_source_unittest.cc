@@ -615,6 +615,59 @@ TEST_P(WidevineKeySourceParameterizedTest, KeyRotationTest) {
   Status status = widevine_key_source_->GetCryptoPeriodKey(
       kFirstCryptoPeriodIndex, kStreamLabels[0], &encryption_key);
   EXPECT_EQ(error::INVALID_ARGUMENT, status.error_code());
+
+  // Every successful lookup is either served from the key pool or stalled.
+  const WidevineKeySource::CryptoPeriodKeyStats stats =
+      widevine_key_source_->crypto_period_key_stats();
+  EXPECT_EQ(arraysize(kCryptoPeriodIndexes) * arraysize(kStreamLabels),
+            stats.num_served_from_cache + stats.num_stalled);
+  EXPECT_GE(stats.total_stall_time_ms, stats.max_stall_time_ms);
+}
+
+TEST_P(WidevineKeySourceParameterizedTest, KeyRotationWithCryptoPeriodCount) {
+  const uint32_t kFirstCryptoPeriodIndex = 3;
+  const uint32_t kCryptoPeriodCount = 4;
+
+  // Generate expectations in sequence.
+  InSequence dummy;
+
+  EXPECT_CALL(*mock_request_signer_, GenerateSignature(_, _))
+      .WillOnce(Return(true));
+  std::string mock_response = base::StringPrintf(
+      kHttpResponseFormat, Base64Encode(GenerateMockLicenseResponse()).c_str());
+  EXPECT_CALL(*mock_key_fetcher_, FetchKeys(_, _, _))
+      .WillOnce(DoAll(SetArgPointee<2>(mock_response), Return(Status::OK)));
+
+  const uint32_t first_crypto_period_index = kFirstCryptoPeriodIndex - 1;
+  std::string expected_message = base::StringPrintf(
+      kCryptoPeriodRequestMessageFormat, Base64Encode(kContentId).c_str(),
+      kPolicy, first_crypto_period_index, kCryptoPeriodCount,
+      GetExpectedProtectionScheme().c_str());
+  EXPECT_CALL(*mock_request_signer_, GenerateSignature(expected_message, _))
+      .WillOnce(DoAll(SetArgPointee<1>(kMockSignature), Return(true)));
+  mock_response = base::StringPrintf(
+      kHttpResponseFormat,
+      Base64Encode(GenerateMockKeyRotationLicenseResponse(
+                       first_crypto_period_index, kCryptoPeriodCount))
+          .c_str());
+  EXPECT_CALL(*mock_key_fetcher_, FetchKeys(_, _, _))
+      .WillOnce(DoAll(SetArgPointee<2>(mock_response), Return(Status::OK)));
+  // Fail future requests.
+  EXPECT_CALL(*mock_request_signer_, GenerateSignature(_, _))
+      .WillRepeatedly(Return(false));
+
+  CreateWidevineKeySource();
+  widevine_key_source_->set_signer(std::move(mock_request_signer_));
+  widevine_key_source_->set_crypto_period_count(kCryptoPeriodCount);
+  ASSERT_OK(widevine_key_source_->FetchKeys(content_id_, kPolicy));
+
+  EncryptionKey encryption_key;
+  for (uint32_t index = kFirstCryptoPeriodIndex;
+       index < first_crypto_period_index + kCryptoPeriodCount; ++index) {
+    ASSERT_OK(
+        widevine_key_source_->GetCryptoPeriodKey(index, "HD", &encryption_key));
+    EXPECT_EQ(GetMockKey("HD", index), ToString(encryption_key.key));
+  }
 }
 
 INSTANTIATE_TEST_CASE_P(WidevineKeySourceInstance,
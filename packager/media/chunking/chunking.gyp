@@ -24,6 +24,8 @@
       ],
       'dependencies': [
         '../base/media_base.gyp:media_base',
+        '../../packager.gyp:memory_tracker',
+        '../../packager.gyp:trace_event',
       ],
     },
     {
@@ -44,6 +44,7 @@ class ChunkingHandler : public MediaHandler {
  protected:
   /// @name MediaHandler implementation overrides.
   /// @{
+  std::string name() const override { return "ChunkingHandler"; }
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
   Status OnFlushRequest(size_t input_stream_index) override;
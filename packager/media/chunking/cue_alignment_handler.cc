@@ -89,6 +89,10 @@ CueAlignmentHandler::CueAlignmentHandler(SyncPointQueue* sync_points)
 Status CueAlignmentHandler::InitializeInternal() {
   sync_points_->AddThread();
   stream_states_.resize(num_input_streams());
+  for (size_t i = 0; i < stream_states_.size(); ++i) {
+    stream_states_[i].memory_tracker.reset(new MemoryTracker(
+        "CueAlignmentHandler", "stream " + std::to_string(i)));
+  }
 
   // Get the first hint for the stream. Use a negative hint so that if there is
   // suppose to be a sync point at zero, we will still respect it.
@@ -392,6 +396,7 @@ Status CueAlignmentHandler::AcceptSample(std::unique_ptr<StreamData> sample,
   // the sample to the queue.
   const size_t stream_index = sample->stream_index;
 
+  stream->memory_tracker->Add(sample->EstimateMemoryUsage());
   stream->samples.push_back(std::move(sample));
 
   if (stream->samples.size() > kMaxBufferSize) {
@@ -414,6 +419,8 @@ Status CueAlignmentHandler::RunThroughSamples(StreamState* stream) {
         TimeInSeconds(*stream->info, *stream->samples.front());
 
     if (sample_time < cue_time) {
+      stream->memory_tracker->Release(
+          stream->samples.front()->EstimateMemoryUsage());
       RETURN_IF_ERROR(Dispatch(std::move(stream->samples.front())));
       stream->samples.pop_front();
     } else {
@@ -427,6 +434,8 @@ Status CueAlignmentHandler::RunThroughSamples(StreamState* stream) {
   // downstream.
   while (stream->samples.size() &&
          TimeInSeconds(*stream->info, *stream->samples.front()) < hint_) {
+    stream->memory_tracker->Release(
+        stream->samples.front()->EstimateMemoryUsage());
     RETURN_IF_ERROR(Dispatch(std::move(stream->samples.front())));
     stream->samples.pop_front();
   }
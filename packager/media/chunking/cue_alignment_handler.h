@@ -11,6 +11,7 @@
 
 #include "packager/media/base/media_handler.h"
 #include "packager/media/chunking/sync_point_queue.h"
+#include "packager/memory_tracker.h"
 
 namespace shaka {
 namespace media {
@@ -39,6 +40,8 @@ class CueAlignmentHandler : public MediaHandler {
     // Cached samples that cannot be dispatched. All the samples should be at or
     // after |hint|.
     std::list<std::unique_ptr<StreamData>> samples;
+    // Tracks the memory of |samples|.
+    std::unique_ptr<MemoryTracker> memory_tracker;
     // If set, the stream is pending to be flushed.
     bool to_be_flushed = false;
     // Only set for text stream.
@@ -54,6 +57,7 @@ class CueAlignmentHandler : public MediaHandler {
   };
 
   // MediaHandler overrides.
+  std::string name() const override { return "CueAlignmentHandler"; }
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> data) override;
   Status OnFlushRequest(size_t stream_index) override;
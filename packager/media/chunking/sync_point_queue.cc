@@ -6,6 +6,7 @@
 
 #include "packager/media/chunking/sync_point_queue.h"
 #include "packager/media/base/media_handler.h"
+#include "packager/trace_event.h"
 
 #include <algorithm>
 #include <limits>
@@ -58,6 +59,7 @@ double SyncPointQueue::GetHint(double time_in_seconds) {
 
 std::shared_ptr<const CueEvent> SyncPointQueue::GetNext(
     double hint_in_seconds) {
+  SHAKA_TRACE_EVENT("sync", "SyncPointQueue::GetNext");
   base::AutoLock auto_lock(lock_);
   while (!cancelled_) {
     // Find the promoted cue that would line up with our hint, which is the
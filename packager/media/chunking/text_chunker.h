@@ -26,6 +26,7 @@ class TextChunker : public MediaHandler {
   TextChunker(const TextChunker&) = delete;
   TextChunker& operator=(const TextChunker&) = delete;
 
+  std::string name() const override { return "TextChunker"; }
   Status InitializeInternal() override { return Status::OK; }
 
   Status Process(std::unique_ptr<StreamData> stream_data) override;
@@ -110,14 +110,8 @@ int FloorLog2(int x) {
 // 4.10.3. uvlc(). This is a modified form of Exponential-Golomb coding.
 bool ReadUvlc(BitReader* reader, uint32_t* val) {
   // Count the number of contiguous zero bits.
-  int leading_zeros = 0;
-  while (true) {
-    bool done = false;
-    RCHECK(reader->ReadBits(1, &done));
-    if (done)
-      break;
-    leading_zeros++;
-  }
+  size_t leading_zeros = 0;
+  RCHECK(reader->ReadLeadingZeroBits(&leading_zeros));
 
   if (leading_zeros >= 32) {
     *val = (1ull << 32) - 1;
@@ -0,0 +1,163 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures how many codec headers per second the parsers built on BitReader
+// and H26xBitReader get through.
+
+#include <gtest/gtest.h>
+
+#include "packager/base/time/time.h"
+#include "packager/media/codecs/av1_parser.h"
+#include "packager/media/codecs/h264_parser.h"
+#include "packager/media/codecs/h265_parser.h"
+#include "packager/media/codecs/nalu_reader.h"
+#include "packager/media/codecs/vp9_parser.h"
+#include "packager/media/formats/mp2t/ac3_header.h"
+#include "packager/media/test/test_data_util.h"
+#include "packager/testing/perf/perf_test.h"
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+const int kNumIterations = 2000;
+
+// A VP9 keyframe, from vp9_parser_unittest.cc.
+const uint8_t kVp9Keyframe[] = {
+    0x82, 0x49, 0x83, 0x42, 0x00, 0x01, 0xf0, 0x00, 0x74, 0x04, 0x38, 0x24,
+    0x1c, 0x18, 0x34, 0x00, 0x00, 0x90, 0x3e, 0x9e, 0xe3, 0xe1, 0xdf, 0x9c,
+    0x6c, 0x00, 0x00, 0x41, 0x4d, 0xe4, 0x39, 0x94, 0xcd, 0x7b, 0x78, 0x30,
+    0x4e, 0xb5, 0xb1, 0x78, 0x40, 0x6f, 0xe5, 0x75, 0xa4, 0x28, 0x93, 0xf7,
+    0x97, 0x9f, 0x4f, 0xdf, 0xbf, 0xfc, 0xe2, 0x73, 0xfa, 0xef, 0xab, 0xcd,
+    0x2a, 0x93, 0xed, 0xfc, 0x17, 0x32, 0x8f, 0x40, 0x15, 0xfa, 0xd5, 0x3e,
+    0x35, 0x7a, 0x88, 0x69, 0xf7, 0x1f, 0x26, 0x8b,
+};
+
+void PrintHeadersPerSecond(const std::string& codec,
+                           size_t num_headers,
+                           base::TimeDelta elapsed) {
+  perf_test::PrintResult("headers_per_second", "", codec,
+                         num_headers / elapsed.InSecondsF(), "headers/s",
+                         true);
+}
+
+// Splits |buffer| into Nalus, which point into |buffer|.
+std::vector<Nalu> SplitNalus(Nalu::CodecType type,
+                             const std::vector<uint8_t>& buffer) {
+  NaluReader reader(type, kIsAnnexbByteStream, buffer.data(), buffer.size());
+  std::vector<Nalu> nalus;
+  Nalu nalu;
+  while (reader.Advance(&nalu) == NaluReader::kOk)
+    nalus.push_back(nalu);
+  return nalus;
+}
+
+}  // namespace
+
+TEST(CodecHeaderPerfTest, H264) {
+  const std::vector<uint8_t> buffer = ReadTestDataFile("test-25fps.h264");
+  const std::vector<Nalu> nalus = SplitNalus(Nalu::kH264, buffer);
+  ASSERT_FALSE(nalus.empty());
+
+  size_t num_headers = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    H264Parser parser;
+    for (const Nalu& nalu : nalus) {
+      int id;
+      H264SliceHeader slice_header;
+      switch (nalu.type()) {
+        case Nalu::H264_IDRSlice:
+        case Nalu::H264_NonIDRSlice:
+          ASSERT_EQ(H264Parser::kOk,
+                    parser.ParseSliceHeader(nalu, &slice_header));
+          break;
+        case Nalu::H264_SPS:
+          ASSERT_EQ(H264Parser::kOk, parser.ParseSps(nalu, &id));
+          break;
+        case Nalu::H264_PPS:
+          ASSERT_EQ(H264Parser::kOk, parser.ParsePps(nalu, &id));
+          break;
+        default:
+          continue;
+      }
+      ++num_headers;
+    }
+  }
+  PrintHeadersPerSecond("h264", num_headers, base::TimeTicks::Now() - start);
+}
+
+TEST(CodecHeaderPerfTest, H265) {
+  const std::vector<uint8_t> buffer =
+      ReadTestDataFile("hevc-byte-stream-frame.h265");
+  const std::vector<Nalu> nalus = SplitNalus(Nalu::kH265, buffer);
+  ASSERT_FALSE(nalus.empty());
+
+  size_t num_headers = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    H265Parser parser;
+    for (const Nalu& nalu : nalus) {
+      int id;
+      H265SliceHeader slice_header;
+      if (nalu.is_video_slice()) {
+        ASSERT_EQ(H265Parser::kOk,
+                  parser.ParseSliceHeader(nalu, &slice_header));
+      } else if (nalu.type() == Nalu::H265_SPS) {
+        ASSERT_EQ(H265Parser::kOk, parser.ParseSps(nalu, &id));
+      } else if (nalu.type() == Nalu::H265_PPS) {
+        ASSERT_EQ(H265Parser::kOk, parser.ParsePps(nalu, &id));
+      } else {
+        continue;
+      }
+      ++num_headers;
+    }
+  }
+  PrintHeadersPerSecond("h265", num_headers, base::TimeTicks::Now() - start);
+}
+
+TEST(CodecHeaderPerfTest, VP9) {
+  VP9Parser parser;
+  std::vector<VPxFrameInfo> frames;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations * 100; ++i)
+    ASSERT_TRUE(parser.Parse(kVp9Keyframe, sizeof(kVp9Keyframe), &frames));
+  PrintHeadersPerSecond("vp9", kNumIterations * 100,
+                        base::TimeTicks::Now() - start);
+}
+
+TEST(CodecHeaderPerfTest, AV1) {
+  const std::vector<uint8_t> buffer = ReadTestDataFile("av1-I-frame-320x240");
+  AV1Parser parser;
+  std::vector<AV1Parser::Tile> tiles;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations * 10; ++i)
+    ASSERT_TRUE(parser.Parse(buffer.data(), buffer.size(), &tiles));
+  PrintHeadersPerSecond("av1", kNumIterations * 10,
+                        base::TimeTicks::Now() - start);
+}
+
+TEST(CodecHeaderPerfTest, AC3) {
+  const std::vector<uint8_t> buffer = ReadTestDataFile("bear.ac3");
+  mp2t::Ac3Header header;
+
+  size_t num_headers = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    size_t offset = 0;
+    while (offset + header.GetMinFrameSize() <= buffer.size()) {
+      ASSERT_TRUE(
+          header.Parse(buffer.data() + offset, buffer.size() - offset));
+      offset += header.GetFrameSize();
+      ++num_headers;
+    }
+  }
+  PrintHeadersPerSecond("ac3", num_headers, base::TimeTicks::Now() - start);
+}
+
+}  // namespace media
+}  // namespace shaka
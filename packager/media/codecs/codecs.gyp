@@ -97,5 +97,21 @@
         'codecs',
       ],
     },
+    {
+      'target_name': 'codecs_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'codec_header_perftest.cc',
+        'nalu_reader_perftest.cc',
+      ],
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../testing/gtest.gyp:gtest',
+        '../../testing/perf/perf_test.gyp:perf_test',
+        '../formats/mp2t/mp2t.gyp:mp2t',
+        '../test/media_test.gyp:media_test_support',
+        'codecs',
+      ],
+    },
   ],
 }
@@ -193,11 +193,21 @@ H264Parser::H264Parser() {}
 H264Parser::~H264Parser() {}
 
 const H264Pps* H264Parser::GetPps(int pps_id) {
-  return active_PPSes_[pps_id].get();
+  if (pps_id != last_pps_id_) {
+    PpsById::const_iterator iter = active_PPSes_.find(pps_id);
+    last_pps_ = iter == active_PPSes_.end() ? nullptr : iter->second.get();
+    last_pps_id_ = pps_id;
+  }
+  return last_pps_;
 }
 
 const H264Sps* H264Parser::GetSps(int sps_id) {
-  return active_SPSes_[sps_id].get();
+  if (sps_id != last_sps_id_) {
+    SpsById::const_iterator iter = active_SPSes_.find(sps_id);
+    last_sps_ = iter == active_SPSes_.end() ? nullptr : iter->second.get();
+    last_sps_id_ = sps_id;
+  }
+  return last_sps_;
 }
 
 // Default scaling lists (per spec).
@@ -706,6 +716,7 @@ H264Parser::Result H264Parser::ParseSps(const Nalu& nalu, int* sps_id) {
   // If an SPS with the same id already exists, replace it.
   *sps_id = sps->seq_parameter_set_id;
   active_SPSes_[*sps_id] = std::move(sps);
+  last_sps_id_ = -1;
 
   return kOk;
 }
@@ -779,6 +790,7 @@ H264Parser::Result H264Parser::ParsePps(const Nalu& nalu, int* pps_id) {
   // If a PPS with the same id already exists, replace it.
   *pps_id = pps->pic_parameter_set_id;
   active_PPSes_[*pps_id] = std::move(pps);
+  last_pps_id_ = -1;
 
   return kOk;
 }
@@ -332,6 +332,13 @@ class H264Parser {
   typedef std::map<int, std::unique_ptr<H264Pps>> PpsById;
   SpsById active_SPSes_;
   PpsById active_PPSes_;
+  // The most recent lookups. Consecutive slices almost always refer to the
+  // same PPS and SPS, so this saves the map lookups. Reset when the
+  // corresponding map changes.
+  int last_sps_id_ = -1;
+  const H264Sps* last_sps_ = nullptr;
+  int last_pps_id_ = -1;
+  const H264Pps* last_pps_ = nullptr;
 
   DISALLOW_COPY_AND_ASSIGN(H264Parser);
 };
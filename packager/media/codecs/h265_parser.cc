@@ -502,6 +502,7 @@ H265Parser::Result H265Parser::ParsePps(const Nalu& nalu, int* pps_id) {
   // This will replace any existing PPS instance.
   *pps_id = pps->pic_parameter_set_id;
   active_ppses_[*pps_id] = std::move(pps);
+  last_pps_id_ = -1;
 
   return kOk;
 }
@@ -619,16 +620,27 @@ H265Parser::Result H265Parser::ParseSps(const Nalu& nalu, int* sps_id) {
   // This will replace any existing SPS instance.
   *sps_id = sps->seq_parameter_set_id;
   active_spses_[*sps_id] = std::move(sps);
+  last_sps_id_ = -1;
 
   return kOk;
 }
 
 const H265Pps* H265Parser::GetPps(int pps_id) {
-  return active_ppses_[pps_id].get();
+  if (pps_id != last_pps_id_) {
+    PpsById::const_iterator iter = active_ppses_.find(pps_id);
+    last_pps_ = iter == active_ppses_.end() ? nullptr : iter->second.get();
+    last_pps_id_ = pps_id;
+  }
+  return last_pps_;
 }
 
 const H265Sps* H265Parser::GetSps(int sps_id) {
-  return active_spses_[sps_id].get();
+  if (sps_id != last_sps_id_) {
+    SpsById::const_iterator iter = active_spses_.find(sps_id);
+    last_sps_ = iter == active_spses_.end() ? nullptr : iter->second.get();
+    last_sps_id_ = sps_id;
+  }
+  return last_sps_;
 }
 
 H265Parser::Result H265Parser::ParseVuiParameters(int max_num_sub_layers_minus1,
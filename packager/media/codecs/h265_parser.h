@@ -358,6 +358,12 @@ class H265Parser {
 
   SpsById active_spses_;
   PpsById active_ppses_;
+  // The most recent lookups, which save the map lookups for consecutive
+  // slices. Reset when the corresponding map changes.
+  int last_sps_id_ = -1;
+  const H265Sps* last_sps_ = nullptr;
+  int last_pps_id_ = -1;
+  const H265Pps* last_pps_ = nullptr;
 
   DISALLOW_COPY_AND_ASSIGN(H265Parser);
 };
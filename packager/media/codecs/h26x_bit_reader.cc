@@ -3,24 +3,25 @@
 // found in the LICENSE file.
 
 #include "packager/base/logging.h"
+#include "packager/media/base/bit_util.h"
 #include "packager/media/codecs/h26x_bit_reader.h"
 
 namespace shaka {
 namespace media {
 namespace {
 
-// Check if any bits in the least significant |valid_bits| are set to 1.
-bool CheckAnyBitsSet(int byte, int valid_bits) {
-  return (byte & ((1 << valid_bits) - 1)) != 0;
-}
+// Refill() stops once the cache holds more bits than this, so any read of up
+// to 31 bits can be served from the cache after one refill.
+const int kMaxBitsPerRefill = 56;
 
 }  // namespace
 
 H26xBitReader::H26xBitReader()
     : data_(NULL),
       bytes_left_(0),
-      curr_byte_(0),
-      num_remaining_bits_in_curr_byte_(0),
+      cache_(0),
+      num_cached_bits_(0),
+      emulation_prevention_markers_(0),
       prev_two_bytes_(0),
       emulation_prevention_bytes_(0) {}
 
@@ -34,7 +35,9 @@ bool H26xBitReader::Initialize(const uint8_t* data, off_t size) {
 
   data_ = data;
   bytes_left_ = size;
-  num_remaining_bits_in_curr_byte_ = 0;
+  cache_ = 0;
+  num_cached_bits_ = 0;
+  emulation_prevention_markers_ = 0;
   // Initially set to 0xffff to accept all initial two-byte sequences.
   prev_two_bytes_ = 0xffff;
   emulation_prevention_bytes_ = 0;
@@ -42,71 +45,94 @@ bool H26xBitReader::Initialize(const uint8_t* data, off_t size) {
   return true;
 }
 
-bool H26xBitReader::UpdateCurrByte() {
-  if (bytes_left_ < 1)
-    return false;
-
-  // Emulation prevention three-byte detection.
-  // If a sequence of 0x000003 is found, skip (ignore) the last byte (0x03).
-  if (*data_ == 0x03 && (prev_two_bytes_ & 0xffff) == 0) {
-    // Detected 0x000003, skip last byte.
-    ++data_;
+void H26xBitReader::Refill() {
+  while (num_cached_bits_ <= kMaxBitsPerRefill && bytes_left_ > 0) {
+    // Emulation prevention three-byte detection.
+    // If a sequence of 0x000003 is found, skip (ignore) the last byte (0x03).
+    bool follows_emulation_prevention_byte = false;
+    if (*data_ == 0x03 && (prev_two_bytes_ & 0xffff) == 0) {
+      // A trailing emulation prevention byte is skipped only once all the
+      // cached bits are read, as there is no byte after it to load.
+      if (bytes_left_ < 2 && num_cached_bits_ > 0)
+        return;
+      // Detected 0x000003, skip last byte.
+      ++data_;
+      --bytes_left_;
+      ++emulation_prevention_bytes_;
+      // Need another full three bytes before we can detect the sequence
+      // again.
+      prev_two_bytes_ = 0xffff;
+
+      if (bytes_left_ < 1)
+        return;
+      follows_emulation_prevention_byte = true;
+    }
+
+    // Load a new byte and advance pointers.
+    const int byte = *data_++ & 0xff;
     --bytes_left_;
-    ++emulation_prevention_bytes_;
-    // Need another full three bytes before we can detect the sequence again.
-    prev_two_bytes_ = 0xffff;
+    cache_ |= static_cast<uint64_t>(byte) << (56 - num_cached_bits_);
+    if (follows_emulation_prevention_byte)
+      emulation_prevention_markers_ |= 1ULL << (63 - num_cached_bits_);
+    num_cached_bits_ += 8;
 
-    if (bytes_left_ < 1)
-      return false;
+    prev_two_bytes_ = (prev_two_bytes_ << 8) | byte;
   }
-
-  // Load a new byte and advance pointers.
-  curr_byte_ = *data_++ & 0xff;
-  --bytes_left_;
-  num_remaining_bits_in_curr_byte_ = 8;
-
-  prev_two_bytes_ = (prev_two_bytes_ << 8) | curr_byte_;
-
-  return true;
 }
 
 // Read |num_bits| (1 to 31 inclusive) from the stream and return them
 // in |out|, with first bit in the stream as MSB in |out| at position
 // (|num_bits| - 1).
 bool H26xBitReader::ReadBits(int num_bits, int* out) {
-  int bits_left = num_bits;
-  *out = 0;
   DCHECK(num_bits <= 31);
 
-  while (num_remaining_bits_in_curr_byte_ < bits_left) {
-    // Take all that's left in current byte, shift to make space for the rest.
-    *out |= (curr_byte_ << (bits_left - num_remaining_bits_in_curr_byte_));
-    bits_left -= num_remaining_bits_in_curr_byte_;
-
-    if (!UpdateCurrByte())
+  if (num_bits > num_cached_bits_) {
+    Refill();
+    if (num_bits > num_cached_bits_)
       return false;
   }
-
-  *out |= (curr_byte_ >> (num_remaining_bits_in_curr_byte_ - bits_left));
-  *out &= ((1 << num_bits) - 1);
-  num_remaining_bits_in_curr_byte_ -= bits_left;
-
+  *out = num_bits == 0 ? 0 : static_cast<int>(cache_ >> (64 - num_bits));
+  ConsumeBits(num_bits);
   return true;
 }
 
 bool H26xBitReader::SkipBits(int num_bits) {
-  int bits_left = num_bits;
-  while (num_remaining_bits_in_curr_byte_ < bits_left) {
-    bits_left -= num_remaining_bits_in_curr_byte_;
-    if (!UpdateCurrByte())
+  while (num_bits > num_cached_bits_) {
+    Refill();
+    if (num_bits <= num_cached_bits_)
+      break;
+    // A refill stopping short of a full cache means the end of the stream.
+    if (num_cached_bits_ <= kMaxBitsPerRefill)
       return false;
+    num_bits -= num_cached_bits_;
+    ConsumeBits(num_cached_bits_);
   }
 
-  num_remaining_bits_in_curr_byte_ -= bits_left;
+  ConsumeBits(num_bits);
   return true;
 }
 
 bool H26xBitReader::ReadUE(int* val) {
+  if (num_cached_bits_ <= kMaxBitsPerRefill)
+    Refill();
+
+  // Decode the whole code from the cache if it is there. Bits below the
+  // valid bits are zero, so |cache_| is non-zero only if the one bit ending
+  // the leading zero bits is cached.
+  if (cache_ != 0) {
+    const int leading_zeros = CountLeadingZeros64(cache_);
+    const int code_length = 2 * leading_zeros + 1;
+    if (leading_zeros < 31 && code_length <= num_cached_bits_) {
+      // The code is the value plus 1 in |leading_zeros| + 1 bits.
+      *val = static_cast<int>((cache_ >> (64 - code_length)) - 1);
+      ConsumeBits(code_length);
+      return true;
+    }
+  }
+  return ReadUESlow(val);
+}
+
+bool H26xBitReader::ReadUESlow(int* val) {
   int num_bits = -1;
   int bit;
   int rest;
@@ -149,20 +175,29 @@ bool H26xBitReader::ReadSE(int* val) {
 }
 
 off_t H26xBitReader::NumBitsLeft() {
-  return (num_remaining_bits_in_curr_byte_ + bytes_left_ * 8);
+  // Emulation prevention bytes before bytes not read yet are still counted,
+  // as if the bytes were not loaded into the cache.
+  return num_cached_bits_ + bytes_left_ * 8 +
+         CountSetBits64(emulation_prevention_markers_) * 8;
 }
 
 bool H26xBitReader::HasMoreRBSPData() {
   // Make sure we have more bits, if we are at 0 bits in current byte and
   // updating current byte fails, we don't have more data anyway.
-  if (num_remaining_bits_in_curr_byte_ == 0 && !UpdateCurrByte())
-    return false;
+  if (num_cached_bits_ == 0) {
+    Refill();
+    if (num_cached_bits_ == 0)
+      return false;
+  }
+  // The current byte is considered read from now on.
+  emulation_prevention_markers_ &= ~(1ULL << 63);
 
   // If there is no more RBSP data, then the remaining bits is the stop bit
   // followed by zero paddings. So if there are 1s in the remaining bits
   // excluding the current bit, then the current bit is not a stop bit,
   // regardless of whether it is 1 or not. Therefore there is more data.
-  if (CheckAnyBitsSet(curr_byte_, num_remaining_bits_in_curr_byte_ - 1))
+  // The emulation prevention bytes skipped in the cache are not zero either.
+  if ((cache_ << 1) != 0 || emulation_prevention_markers_ != 0)
     return true;
 
   // While the spec disallows it (7.4.1: "The last byte of the NAL unit shall
@@ -174,12 +209,15 @@ bool H26xBitReader::HasMoreRBSPData() {
       return true;
   }
 
+  // Drop the trailing null bytes, keeping the rest of the current byte.
   bytes_left_ = 0;
+  num_cached_bits_ = (num_cached_bits_ - 1) % 8 + 1;
   return false;
 }
 
 size_t H26xBitReader::NumEmulationPreventionBytesRead() {
-  return emulation_prevention_bytes_;
+  return emulation_prevention_bytes_ -
+         CountSetBits64(emulation_prevention_markers_);
 }
 
 }  // namespace media
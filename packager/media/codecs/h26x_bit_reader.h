@@ -68,28 +68,50 @@ class H26xBitReader {
   size_t NumEmulationPreventionBytesRead();
 
  private:
-  // Advance to the next byte, loading it into curr_byte_.
-  // Return false on end of stream.
-  bool UpdateCurrByte();
+  // Loads bytes into the cache, skipping emulation prevention bytes, until it
+  // holds more than 56 bits or the stream has no more bytes.
+  void Refill();
+
+  // Drops |num_bits| from the cache, which must hold at least |num_bits|.
+  void ConsumeBits(int num_bits) {
+    cache_ = num_bits < 64 ? cache_ << num_bits : 0;
+    emulation_prevention_markers_ =
+        num_bits < 64 ? emulation_prevention_markers_ << num_bits : 0;
+    num_cached_bits_ -= num_bits;
+  }
+
+  // Reads one unsigned exp-Golomb code bit by bit. Used for codes not held
+  // entirely in the cache.
+  bool ReadUESlow(int* val);
 
-  // Pointer to the next unread (not in curr_byte_) byte in the stream.
+  // Pointer to the next byte not loaded into the cache.
   const uint8_t* data_;
 
-  // Bytes left in the stream (without the curr_byte_).
+  // Bytes left in the stream (without the bytes in cache_).
   off_t bytes_left_;
 
-  // Contents of the current byte; first unread bit starting at position
-  // 8 - num_remaining_bits_in_curr_byte_ from MSB.
-  int curr_byte_;
+  // Cached bits, first unread bit at the MSB. Bits below the
+  // num_cached_bits_ valid bits are zero.
+  uint64_t cache_;
+
+  // Number of valid bits in cache_. Always a whole number of bytes are
+  // loaded, so num_cached_bits_ % 8 bits are left in the current byte.
+  int num_cached_bits_;
 
-  // Number of bits remaining in curr_byte_
-  int num_remaining_bits_in_curr_byte_;
+  // Marks, at the position of their first bit in cache_, the cached bytes
+  // that were preceded by an emulation prevention byte. A byte is considered
+  // read, together with the emulation prevention byte before it, once its
+  // first bit is read, which keeps NumBitsLeft() and
+  // NumEmulationPreventionBytesRead() independent of how far ahead the cache
+  // is filled.
+  uint64_t emulation_prevention_markers_;
 
   // Used in emulation prevention three byte detection (see spec).
   // Initially set to 0xffff to accept all initial two-byte sequences.
   int prev_two_bytes_;
 
-  // Number of emulation preventation bytes (0x000003) we met.
+  // Number of emulation preventation bytes (0x000003) we met, including the
+  // ones for bytes not read yet.
   size_t emulation_prevention_bytes_;
 
   DISALLOW_COPY_AND_ASSIGN(H26xBitReader);
@@ -130,5 +130,56 @@ TEST(H26xBitReaderTest, StopBitOccupyFullByte) {
   EXPECT_FALSE(reader.HasMoreRBSPData());
 }
 
+TEST(H26xBitReaderTest, ReadExpGolomb) {
+  H26xBitReader reader;
+  // ue(v): 1 -> 0, 010 -> 1, 011 -> 2, 00100 -> 3, then se(v): 00101 -> -2,
+  // followed by 7 zero bits.
+  const unsigned char rbsp[] = {0xa6, 0x42, 0x80};
+  int value = 0;
+
+  EXPECT_TRUE(reader.Initialize(rbsp, sizeof(rbsp)));
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(reader.ReadUE(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_TRUE(reader.ReadSE(&value));
+  EXPECT_EQ(-2, value);
+  EXPECT_EQ(7, reader.NumBitsLeft());
+  // No one bit left.
+  EXPECT_FALSE(reader.ReadUE(&value));
+}
+
+TEST(H26xBitReaderTest, EmulationPreventionBytes) {
+  H26xBitReader reader;
+  const unsigned char rbsp[] = {0x80, 0x00, 0x00, 0x03, 0x01, 0x00,
+                                0x00, 0x03, 0x02, 0xff};
+  int value = 0;
+
+  EXPECT_TRUE(reader.Initialize(rbsp, sizeof(rbsp)));
+  EXPECT_TRUE(reader.ReadBits(8, &value));
+  EXPECT_EQ(0x80, value);
+  // The emulation prevention bytes are counted until the bytes after them are
+  // read.
+  EXPECT_EQ(72, reader.NumBitsLeft());
+  EXPECT_EQ(0u, reader.NumEmulationPreventionBytesRead());
+
+  EXPECT_TRUE(reader.ReadBits(17, &value));
+  EXPECT_EQ(0, value);
+  EXPECT_EQ(47, reader.NumBitsLeft());
+  EXPECT_EQ(1u, reader.NumEmulationPreventionBytesRead());
+
+  EXPECT_TRUE(reader.SkipBits(23));
+  EXPECT_EQ(24, reader.NumBitsLeft());
+  EXPECT_EQ(1u, reader.NumEmulationPreventionBytesRead());
+  EXPECT_TRUE(reader.ReadBits(16, &value));
+  EXPECT_EQ(0x02ff, value);
+  EXPECT_EQ(0, reader.NumBitsLeft());
+  EXPECT_EQ(2u, reader.NumEmulationPreventionBytesRead());
+}
+
 }  // namespace media
 }  // namespace shaka
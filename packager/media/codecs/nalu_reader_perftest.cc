@@ -0,0 +1,64 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures how fast NaluReader locates NAL units by start code scanning in
+// Annex B byte streams.
+
+#include <gtest/gtest.h>
+
+#include "packager/base/time/time.h"
+#include "packager/media/codecs/nalu_reader.h"
+#include "packager/testing/perf/perf_test.h"
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+const int kNumIterations = 50;
+const size_t kNumNalus = 200;
+const size_t kNaluPayloadSize = 10 * 1024;
+// nal_ref_idc = 2, nal_unit_type = 1 (non-IDR slice).
+const uint8_t kNonIdrSliceNaluHeader = 0x41;
+
+// Creates a byte stream of |kNumNalus| NAL units. The payload never contains
+// zero bytes, so it has no start code emulation.
+std::vector<uint8_t> CreateByteStream() {
+  const uint8_t kStartCode[] = {0x00, 0x00, 0x00, 0x01};
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < kNumNalus; ++i) {
+    stream.insert(stream.end(), kStartCode, kStartCode + sizeof(kStartCode));
+    stream.push_back(kNonIdrSliceNaluHeader);
+    for (size_t j = 0; j < kNaluPayloadSize; ++j)
+      stream.push_back(static_cast<uint8_t>(j * 31) | 1);
+  }
+  return stream;
+}
+
+}  // namespace
+
+TEST(NaluReaderPerfTest, StartCodeScan) {
+  const std::vector<uint8_t> stream = CreateByteStream();
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    NaluReader reader(Nalu::kH264, kIsAnnexbByteStream, stream.data(),
+                      stream.size());
+    Nalu nalu;
+    size_t num_nalus = 0;
+    while (reader.Advance(&nalu) == NaluReader::kOk)
+      ++num_nalus;
+    ASSERT_EQ(kNumNalus, num_nalus);
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  perf_test::PrintResult(
+      "nalu_reader_throughput", "", "annexb_start_code_scan",
+      stream.size() * kNumIterations / elapsed.InSecondsF() / (1024 * 1024),
+      "MB/s", true);
+}
+
+}  // namespace media
+}  // namespace shaka
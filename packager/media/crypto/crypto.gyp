@@ -15,24 +15,31 @@
       'sources': [
         'aes_encryptor_factory.cc',
         'aes_encryptor_factory.h',
+        'encryption_config_cache.cc',
+        'encryption_config_cache.h',
         'encryption_handler.cc',
         'encryption_handler.h',
         'sample_aes_ec3_cryptor.cc',
         'sample_aes_ec3_cryptor.h',
+        'sample_iv_deriver.cc',
+        'sample_iv_deriver.h',
         'subsample_generator.cc',
         'subsample_generator.h',
       ],
       'dependencies': [
         '../base/media_base.gyp:media_base',
         '../codecs/codecs.gyp:codecs',
+        '../../third_party/boringssl/boringssl.gyp:boringssl',
       ],
     },
     {
       'target_name': 'crypto_unittest',
       'type': '<(gtest_target_type)',
       'sources': [
+        'encryption_config_cache_unittest.cc',
         'encryption_handler_unittest.cc',
         'sample_aes_ec3_cryptor_unittest.cc',
+        'sample_iv_deriver_unittest.cc',
         'subsample_generator_unittest.cc',
       ],
       'dependencies': [
@@ -43,6 +50,20 @@
         'crypto',
       ]
     },
+    {
+      'target_name': 'crypto_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'subsample_generator_perftest.cc',
+      ],
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../testing/gtest.gyp:gtest',
+        '../../testing/perf/perf_test.gyp:perf_test',
+        '../test/media_test.gyp:media_test_support',
+        'crypto',
+      ],
+    },
   ],
 }
 
@@ -0,0 +1,70 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/crypto/encryption_config_cache.h"
+
+#include "packager/base/logging.h"
+#include "packager/media/base/key_source.h"
+
+namespace shaka {
+namespace media {
+
+EncryptionConfigCache::EncryptionConfigCache(size_t max_entries)
+    : max_entries_(max_entries) {
+  DCHECK_GT(max_entries_, 0u);
+}
+
+EncryptionConfigCache::~EncryptionConfigCache() = default;
+
+std::shared_ptr<const EncryptionConfig>
+EncryptionConfigCache::GetEncryptionConfig(
+    const EncryptionKey& encryption_key,
+    FourCC protection_scheme,
+    uint8_t crypt_byte_block,
+    uint8_t skip_byte_block,
+    const std::vector<uint8_t>& constant_iv,
+    uint8_t per_sample_iv_size) {
+  CacheKey cache_key(encryption_key.key_id, protection_scheme,
+                     crypt_byte_block, skip_byte_block, constant_iv,
+                     per_sample_iv_size);
+
+  base::AutoLock scoped_lock(lock_);
+  auto iter = entries_.find(cache_key);
+  if (iter != entries_.end()) {
+    ++num_hits_;
+    return iter->second;
+  }
+
+  std::shared_ptr<EncryptionConfig> encryption_config(new EncryptionConfig);
+  encryption_config->protection_scheme = protection_scheme;
+  encryption_config->crypt_byte_block = crypt_byte_block;
+  encryption_config->skip_byte_block = skip_byte_block;
+  encryption_config->per_sample_iv_size = per_sample_iv_size;
+  encryption_config->constant_iv = constant_iv;
+  encryption_config->key_id = encryption_key.key_id;
+  encryption_config->key_system_info = encryption_key.key_system_info;
+
+  if (entries_.size() >= max_entries_) {
+    entries_.erase(insertion_order_.front());
+    insertion_order_.pop_front();
+  }
+  insertion_order_.push_back(cache_key);
+  entries_[std::move(cache_key)] = encryption_config;
+  return encryption_config;
+}
+
+size_t EncryptionConfigCache::num_hits() const {
+  base::AutoLock scoped_lock(lock_);
+  return num_hits_;
+}
+
+size_t EncryptionConfigCache::size() const {
+  base::AutoLock scoped_lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace media
+}  // namespace shaka
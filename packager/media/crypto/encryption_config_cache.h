@@ -0,0 +1,84 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_CRYPTO_ENCRYPTION_CONFIG_CACHE_H_
+#define PACKAGER_MEDIA_CRYPTO_ENCRYPTION_CONFIG_CACHE_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "packager/base/synchronization/lock.h"
+#include "packager/media/base/encryption_config.h"
+
+namespace shaka {
+namespace media {
+
+struct EncryptionKey;
+
+/// A thread safe cache of EncryptionConfig objects keyed by key id and
+/// encryption parameters. It is shared by the EncryptionHandlers of a job, so
+/// streams encrypted with the same key, e.g. streams with the same drm label,
+/// share one EncryptionConfig including its protection system specific info
+/// (PSSH boxes) instead of each building its own copy on every crypto period.
+/// Cached EncryptionConfig objects are immutable.
+class EncryptionConfigCache {
+ public:
+  /// @param max_entries is the maximum number of cached entries. The oldest
+  ///        entries are evicted first.
+  explicit EncryptionConfigCache(size_t max_entries);
+  ~EncryptionConfigCache();
+
+  /// Look up the EncryptionConfig for the specified key and encryption
+  /// parameters, creating it if it is not in the cache yet. The protection
+  /// system specific info is assumed to be determined by the key.
+  /// @param encryption_key contains the key id and key system info.
+  /// @param constant_iv is the constant iv. It should be empty if per sample
+  ///        iv is used.
+  /// @param per_sample_iv_size is the size of per sample iv. It should be 0 if
+  ///        constant iv is used.
+  /// @return The cached EncryptionConfig.
+  std::shared_ptr<const EncryptionConfig> GetEncryptionConfig(
+      const EncryptionKey& encryption_key,
+      FourCC protection_scheme,
+      uint8_t crypt_byte_block,
+      uint8_t skip_byte_block,
+      const std::vector<uint8_t>& constant_iv,
+      uint8_t per_sample_iv_size);
+
+  /// @return The number of lookups served from the cache.
+  size_t num_hits() const;
+  /// @return The number of cached entries.
+  size_t size() const;
+
+ private:
+  EncryptionConfigCache(const EncryptionConfigCache&) = delete;
+  EncryptionConfigCache& operator=(const EncryptionConfigCache&) = delete;
+
+  // key_id, protection_scheme, crypt_byte_block, skip_byte_block, constant_iv,
+  // per_sample_iv_size.
+  typedef std::tuple<std::vector<uint8_t>,
+                     FourCC,
+                     uint8_t,
+                     uint8_t,
+                     std::vector<uint8_t>,
+                     uint8_t>
+      CacheKey;
+
+  const size_t max_entries_;
+  mutable base::Lock lock_;
+  std::map<CacheKey, std::shared_ptr<const EncryptionConfig>> entries_;
+  // Cache keys in insertion order for eviction.
+  std::deque<CacheKey> insertion_order_;
+  size_t num_hits_ = 0;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_CRYPTO_ENCRYPTION_CONFIG_CACHE_H_
@@ -0,0 +1,122 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/crypto/encryption_config_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "packager/media/base/key_source.h"
+
+namespace shaka {
+namespace media {
+namespace {
+
+const uint8_t kKeyId1[] = {0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                           0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x10};
+const uint8_t kKeyId2[] = {0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+                           0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x20};
+const uint8_t kSystemId[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                             0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x00};
+const uint8_t kPssh[] = {0x00, 0x00, 0x00, 0x20, 'p', 's', 's', 'h'};
+const uint8_t kConstantIv[] = {0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38,
+                               0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x30};
+const uint8_t kCryptByteBlock = 1;
+const uint8_t kSkipByteBlock = 9;
+const uint8_t kPerSampleIvSize = 8;
+const size_t kMaxEntries = 2;
+
+EncryptionKey CreateEncryptionKey(const std::vector<uint8_t>& key_id) {
+  EncryptionKey encryption_key;
+  encryption_key.key_id = key_id;
+  encryption_key.key_system_info.push_back(
+      {std::vector<uint8_t>(std::begin(kSystemId), std::end(kSystemId)),
+       std::vector<uint8_t>(std::begin(kPssh), std::end(kPssh))});
+  return encryption_key;
+}
+
+}  // namespace
+
+class EncryptionConfigCacheTest : public ::testing::Test {
+ protected:
+  EncryptionConfigCacheTest()
+      : key_id1_(std::begin(kKeyId1), std::end(kKeyId1)),
+        key_id2_(std::begin(kKeyId2), std::end(kKeyId2)),
+        constant_iv_(std::begin(kConstantIv), std::end(kConstantIv)),
+        cache_(kMaxEntries) {}
+
+  const std::vector<uint8_t> key_id1_;
+  const std::vector<uint8_t> key_id2_;
+  const std::vector<uint8_t> constant_iv_;
+  const std::vector<uint8_t> no_constant_iv_;
+  EncryptionConfigCache cache_;
+};
+
+TEST_F(EncryptionConfigCacheTest, CreateEncryptionConfig) {
+  std::shared_ptr<const EncryptionConfig> encryption_config =
+      cache_.GetEncryptionConfig(CreateEncryptionKey(key_id1_), FOURCC_cbcs,
+                                 kCryptByteBlock, kSkipByteBlock, constant_iv_,
+                                 0);
+  ASSERT_TRUE(encryption_config);
+  EXPECT_EQ(FOURCC_cbcs, encryption_config->protection_scheme);
+  EXPECT_EQ(kCryptByteBlock, encryption_config->crypt_byte_block);
+  EXPECT_EQ(kSkipByteBlock, encryption_config->skip_byte_block);
+  EXPECT_EQ(0u, encryption_config->per_sample_iv_size);
+  EXPECT_EQ(constant_iv_, encryption_config->constant_iv);
+  EXPECT_EQ(key_id1_, encryption_config->key_id);
+  ASSERT_EQ(1u, encryption_config->key_system_info.size());
+  EXPECT_EQ(std::vector<uint8_t>(std::begin(kPssh), std::end(kPssh)),
+            encryption_config->key_system_info[0].psshs);
+  EXPECT_EQ(0u, cache_.num_hits());
+}
+
+TEST_F(EncryptionConfigCacheTest, SameKeySharesEncryptionConfig) {
+  auto encryption_config1 = cache_.GetEncryptionConfig(
+      CreateEncryptionKey(key_id1_), FOURCC_cenc, 0, 0, no_constant_iv_,
+      kPerSampleIvSize);
+  auto encryption_config2 = cache_.GetEncryptionConfig(
+      CreateEncryptionKey(key_id1_), FOURCC_cenc, 0, 0, no_constant_iv_,
+      kPerSampleIvSize);
+  EXPECT_EQ(encryption_config1, encryption_config2);
+  EXPECT_EQ(1u, cache_.num_hits());
+  EXPECT_EQ(1u, cache_.size());
+}
+
+TEST_F(EncryptionConfigCacheTest, DifferentParametersDoNotShare) {
+  auto encryption_config1 = cache_.GetEncryptionConfig(
+      CreateEncryptionKey(key_id1_), FOURCC_cbcs, kCryptByteBlock,
+      kSkipByteBlock, constant_iv_, 0);
+  // Audio streams do not use pattern encryption.
+  auto encryption_config2 = cache_.GetEncryptionConfig(
+      CreateEncryptionKey(key_id1_), FOURCC_cbcs, 0, 0, constant_iv_, 0);
+  auto encryption_config3 = cache_.GetEncryptionConfig(
+      CreateEncryptionKey(key_id2_), FOURCC_cbcs, kCryptByteBlock,
+      kSkipByteBlock, constant_iv_, 0);
+  EXPECT_NE(encryption_config1, encryption_config2);
+  EXPECT_NE(encryption_config1, encryption_config3);
+  EXPECT_EQ(0u, cache_.num_hits());
+}
+
+TEST_F(EncryptionConfigCacheTest, EvictOldestEntry) {
+  auto encryption_config1 = cache_.GetEncryptionConfig(
+      CreateEncryptionKey(key_id1_), FOURCC_cenc, 0, 0, no_constant_iv_,
+      kPerSampleIvSize);
+  cache_.GetEncryptionConfig(CreateEncryptionKey(key_id2_), FOURCC_cenc, 0, 0,
+                             no_constant_iv_, kPerSampleIvSize);
+  cache_.GetEncryptionConfig(CreateEncryptionKey(key_id2_), FOURCC_cbcs, 0, 0,
+                             constant_iv_, 0);
+  EXPECT_EQ(kMaxEntries, cache_.size());
+
+  // |key_id1_| has been evicted, so a new EncryptionConfig is created.
+  auto encryption_config2 = cache_.GetEncryptionConfig(
+      CreateEncryptionKey(key_id1_), FOURCC_cenc, 0, 0, no_constant_iv_,
+      kPerSampleIvSize);
+  EXPECT_NE(encryption_config1, encryption_config2);
+  EXPECT_EQ(encryption_config1->key_id, encryption_config2->key_id);
+  EXPECT_EQ(0u, cache_.num_hits());
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <string>
 
 #include "packager/media/base/aes_encryptor.h"
 #include "packager/media/base/audio_stream_info.h"
@@ -18,6 +19,8 @@
 #include "packager/media/base/media_sample.h"
 #include "packager/media/base/video_stream_info.h"
 #include "packager/media/crypto/aes_encryptor_factory.h"
+#include "packager/media/crypto/encryption_config_cache.h"
+#include "packager/media/crypto/sample_iv_deriver.h"
 #include "packager/media/crypto/subsample_generator.h"
 #include "packager/status_macros.h"
 
@@ -28,6 +31,10 @@ namespace {
 // The encryption handler only supports a single output.
 const size_t kStreamIndex = 0;
 
+// Maximum number of EncryptionConfigs cached by a standalone handler, i.e.
+// one not sharing the cache with other handlers.
+const size_t kDefaultEncryptionConfigCacheSize = 8;
+
 // The default KID, KEY and IV for key rotation are all 0s.
 // They are placeholders and are not really being used to encrypt data.
 const uint8_t kKeyRotationDefaultKeyId[] = {
@@ -69,10 +76,20 @@ bool IsPatternEncryptionScheme(FourCC protection_scheme) {
 
 EncryptionHandler::EncryptionHandler(const EncryptionParams& encryption_params,
                                      KeySource* key_source)
+    : EncryptionHandler(encryption_params,
+                        key_source,
+                        std::make_shared<EncryptionConfigCache>(
+                            kDefaultEncryptionConfigCacheSize)) {}
+
+EncryptionHandler::EncryptionHandler(
+    const EncryptionParams& encryption_params,
+    KeySource* key_source,
+    std::shared_ptr<EncryptionConfigCache> encryption_config_cache)
     : encryption_params_(encryption_params),
       protection_scheme_(
           static_cast<FourCC>(encryption_params.protection_scheme)),
       key_source_(key_source),
+      encryption_config_cache_(std::move(encryption_config_cache)),
       subsample_generator_(
           new SubsampleGenerator(encryption_params.vp9_subsample_encryption)),
       encryptor_factory_(new AesEncryptorFactory) {}
@@ -134,7 +151,8 @@ Status EncryptionHandler::ProcessStreamInfo(const StreamInfo& clear_info) {
       subsample_generator_->Initialize(protection_scheme_, *stream_info));
 
   remaining_clear_lead_ =
-      encryption_params_.clear_lead_in_seconds * stream_info->time_scale();
+      encryption_params_.clear_lead_in_seconds * stream_info->time_scale() -
+      preceding_duration_;
   crypto_period_duration_ =
       encryption_params_.crypto_period_duration_in_seconds *
       stream_info->time_scale();
@@ -174,9 +192,8 @@ Status EncryptionHandler::ProcessMediaSample(
 
   // Process the frame even if the frame is not encrypted as the next
   // (encrypted) frame may be dependent on this clear frame.
-  std::vector<SubsampleEntry> subsamples;
   RETURN_IF_ERROR(subsample_generator_->GenerateSubsamples(
-      clear_sample->data(), clear_sample->data_size(), &subsamples));
+      clear_sample->data(), clear_sample->data_size(), &subsamples_));
 
   // Need to setup the encryptor for new segments even if this segment does not
   // need to be encrypted, so we can signal encryption metadata earlier to
@@ -203,14 +220,29 @@ Status EncryptionHandler::ProcessMediaSample(
     return DispatchMediaSample(kStreamIndex, std::move(clear_sample));
   }
 
+  // The IV of the sample does not depend on the previous samples, so that
+  // the stream can also be encrypted from the middle.
+  if (iv_deriver_ && !encryptor_->use_constant_iv()) {
+    const int64_t dts = clear_sample->dts();
+    if (last_derived_iv_dts_ && dts <= *last_derived_iv_dts_) {
+      return Status(error::ENCRYPTION_FAILURE,
+                    "Cannot derive a unique IV for a sample with DTS " +
+                        std::to_string(dts) + " after DTS " +
+                        std::to_string(*last_derived_iv_dts_) + ".");
+    }
+    last_derived_iv_dts_ = dts;
+    if (!encryptor_->SetIv(iv_deriver_->DeriveSampleIv(dts)))
+      return Status(error::ENCRYPTION_FAILURE, "Failed to set the derived IV.");
+  }
+
   std::shared_ptr<uint8_t> cipher_sample_data(
       new uint8_t[clear_sample->data_size()], std::default_delete<uint8_t[]>());
 
   const uint8_t* source = clear_sample->data();
   uint8_t* dest = cipher_sample_data.get();
-  if (!subsamples.empty()) {
+  if (!subsamples_.empty()) {
     size_t total_size = 0;
-    for (const SubsampleEntry& subsample : subsamples) {
+    for (const SubsampleEntry& subsample : subsamples_) {
       if (subsample.clear_bytes > 0) {
         memcpy(dest, source, subsample.clear_bytes);
         source += subsample.clear_bytes;
@@ -238,11 +270,12 @@ Status EncryptionHandler::ProcessMediaSample(
   // |decrypt_config| once we set it.
   cipher_sample->set_is_encrypted(true);
   std::unique_ptr<DecryptConfig> decrypt_config(new DecryptConfig(
-      encryption_config_->key_id, encryptor_->iv(), subsamples,
+      encryption_config_->key_id, encryptor_->iv(), subsamples_,
       protection_scheme_, crypt_byte_block_, skip_byte_block_));
   cipher_sample->set_decrypt_config(std::move(decrypt_config));
 
-  encryptor_->UpdateIv();
+  if (!iv_deriver_)
+    encryptor_->UpdateIv();
 
   return DispatchMediaSample(kStreamIndex, std::move(cipher_sample));
 }
@@ -263,28 +296,33 @@ void EncryptionHandler::SetupProtectionPattern(StreamType stream_type) {
 }
 
 bool EncryptionHandler::CreateEncryptor(const EncryptionKey& encryption_key) {
+  std::vector<uint8_t> initial_iv = encryption_key.iv;
+  std::unique_ptr<SampleIvDeriver> iv_deriver;
+  if (encryption_params_.derive_iv) {
+    iv_deriver.reset(new SampleIvDeriver);
+    if (!iv_deriver->Initialize(protection_scheme_, encryption_key.key,
+                                stream_id_)) {
+      return false;
+    }
+    // Replaced by the sample IVs unless the encryptor uses a constant IV.
+    initial_iv = iv_deriver->DeriveConstantIv();
+  }
+
   std::unique_ptr<AesCryptor> encryptor = encryptor_factory_->CreateEncryptor(
       protection_scheme_, crypt_byte_block_, skip_byte_block_, codec_,
-      encryption_key.key, encryption_key.iv);
+      encryption_key.key, initial_iv);
   if (!encryptor)
     return false;
   encryptor_ = std::move(encryptor);
-
-  encryption_config_.reset(new EncryptionConfig);
-  encryption_config_->protection_scheme = protection_scheme_;
-  encryption_config_->crypt_byte_block = crypt_byte_block_;
-  encryption_config_->skip_byte_block = skip_byte_block_;
+  iv_deriver_ = std::move(iv_deriver);
+  last_derived_iv_dts_ = base::nullopt;
 
   const std::vector<uint8_t>& iv = encryptor_->iv();
-  if (encryptor_->use_constant_iv()) {
-    encryption_config_->per_sample_iv_size = 0;
-    encryption_config_->constant_iv = iv;
-  } else {
-    encryption_config_->per_sample_iv_size = static_cast<uint8_t>(iv.size());
-  }
-
-  encryption_config_->key_id = encryption_key.key_id;
-  encryption_config_->key_system_info = encryption_key.key_system_info;
+  const std::vector<uint8_t> kNoConstantIv;
+  encryption_config_ = encryption_config_cache_->GetEncryptionConfig(
+      encryption_key, protection_scheme_, crypt_byte_block_, skip_byte_block_,
+      encryptor_->use_constant_iv() ? iv : kNoConstantIv,
+      encryptor_->use_constant_iv() ? 0 : static_cast<uint8_t>(iv.size()));
   return true;
 }
 
@@ -7,6 +7,8 @@
 #ifndef PACKAGER_MEDIA_CRYPTO_ENCRYPTION_HANDLER_H_
 #define PACKAGER_MEDIA_CRYPTO_ENCRYPTION_HANDLER_H_
 
+#include "packager/base/optional.h"
+#include "packager/media/base/decrypt_config.h"
 #include "packager/media/base/key_source.h"
 #include "packager/media/base/media_handler.h"
 #include "packager/media/public/crypto_params.h"
@@ -16,6 +18,8 @@ namespace media {
 
 class AesCryptor;
 class AesEncryptorFactory;
+class EncryptionConfigCache;
+class SampleIvDeriver;
 class SubsampleGenerator;
 struct EncryptionKey;
 
@@ -23,12 +27,33 @@ class EncryptionHandler : public MediaHandler {
  public:
   EncryptionHandler(const EncryptionParams& encryption_params,
                     KeySource* key_source);
+  /// @param encryption_config_cache is shared by the encryption handlers of a
+  ///        job, so streams encrypted with the same key share the same
+  ///        EncryptionConfig.
+  EncryptionHandler(
+      const EncryptionParams& encryption_params,
+      KeySource* key_source,
+      std::shared_ptr<EncryptionConfigCache> encryption_config_cache);
 
   ~EncryptionHandler() override;
 
+  /// @param stream_id identifies the stream among the streams encrypted with
+  ///        the same key, which keeps the derived IVs of the streams apart.
+  ///        Only used if EncryptionParams::derive_iv is set.
+  void set_stream_id(const std::string& stream_id) { stream_id_ = stream_id; }
+
+  /// @param preceding_duration is the duration of the segments of the stream
+  ///        before the first segment passed to the handler, e.g. if it
+  ///        encrypts a chunk of the timeline, in the time scale of the stream.
+  ///        It counts towards the clear lead.
+  void set_preceding_duration(int64_t preceding_duration) {
+    preceding_duration_ = preceding_duration;
+  }
+
  protected:
   /// @name MediaHandler implementation overrides.
   /// @{
+  std::string name() const override { return "EncryptionHandler"; }
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
   /// @}
@@ -72,10 +97,20 @@ class EncryptionHandler : public MediaHandler {
   const FourCC protection_scheme_ = FOURCC_NULL;
   KeySource* key_source_ = nullptr;
   std::string stream_label_;
+  std::string stream_id_;
   // Current encryption config and encryptor.
-  std::shared_ptr<EncryptionConfig> encryption_config_;
+  std::shared_ptr<const EncryptionConfig> encryption_config_;
   std::unique_ptr<AesCryptor> encryptor_;
+  // Derives the IVs of |encryptor_| if EncryptionParams::derive_iv is set.
+  std::unique_ptr<SampleIvDeriver> iv_deriver_;
+  // DTS of the last sample whose IV is derived by |iv_deriver_|. The derived
+  // IVs are only unique if the DTS increases.
+  base::Optional<int64_t> last_derived_iv_dts_;
+  std::shared_ptr<EncryptionConfigCache> encryption_config_cache_;
   Codec codec_ = kUnknownCodec;
+  // Duration of the segments before the first one, see
+  // set_preceding_duration().
+  int64_t preceding_duration_ = 0;
   // Remaining clear lead in the stream's time scale.
   int64_t remaining_clear_lead_ = 0;
   // Crypto period duration in the stream's time scale.
@@ -85,6 +120,9 @@ class EncryptionHandler : public MediaHandler {
   bool check_new_crypto_period_ = false;
 
   std::unique_ptr<SubsampleGenerator> subsample_generator_;
+  // Subsamples of the current sample. Kept across samples to reuse its
+  // capacity.
+  std::vector<SubsampleEntry> subsamples_;
   std::unique_ptr<AesEncryptorFactory> encryptor_factory_;
   // Number of encrypted blocks (16-byte-block) in pattern based encryption.
   uint8_t crypt_byte_block_ = 0;
@@ -14,6 +14,7 @@
 #include "packager/media/base/mock_aes_cryptor.h"
 #include "packager/media/base/raw_key_source.h"
 #include "packager/media/crypto/aes_encryptor_factory.h"
+#include "packager/media/crypto/sample_iv_deriver.h"
 #include "packager/media/crypto/subsample_generator.h"
 #include "packager/status_test_util.h"
 
@@ -380,6 +381,47 @@ TEST_P(EncryptionHandlerEncryptionTest, ClearLeadWithNoKeyRotation) {
   }
 }
 
+TEST_P(EncryptionHandlerEncryptionTest, ClearLeadWithPrecedingDuration) {
+  const double kClearLeadInSeconds = 1.5 * kSegmentDuration / kTimeScale;
+  EncryptionParams encryption_params;
+  encryption_params.protection_scheme = protection_scheme_;
+  encryption_params.clear_lead_in_seconds = kClearLeadInSeconds;
+  SetUpEncryptionHandler(encryption_params);
+  // The handler starts at the second segment, e.g. in a chunk of the timeline.
+  encryption_handler_->set_preceding_duration(kSegmentDuration);
+
+  EXPECT_CALL(mock_key_source_, GetKey(_, _))
+      .WillOnce(
+          DoAll(SetArgPointee<1>(GetMockEncryptionKey()), Return(Status::OK)));
+  if (IsVideoCodec(codec_)) {
+    ASSERT_OK(Process(StreamData::FromStreamInfo(
+        kStreamIndex, GetVideoStreamInfo(kTimeScale, codec_))));
+  } else {
+    ASSERT_OK(Process(StreamData::FromStreamInfo(
+        kStreamIndex, GetAudioStreamInfo(kTimeScale, codec_))));
+  }
+  ClearOutputStreamDataVector();
+
+  // The second segment is still in the clear lead, the third is encrypted like
+  // when the handler gets every segment.
+  for (int i = 1; i < 3; ++i) {
+    ASSERT_OK(Process(StreamData::FromMediaSample(
+        kStreamIndex, GetMediaSample(i * kSegmentDuration, kSegmentDuration,
+                                     kIsKeyFrame, kData, kDataSize))));
+    ASSERT_OK(Process(StreamData::FromSegmentInfo(
+        kStreamIndex, GetSegmentInfo(i * kSegmentDuration, kSegmentDuration,
+                                     !kIsSubsegment))));
+    const bool is_encrypted = i == 2;
+    EXPECT_THAT(GetOutputStreamDataVector(),
+                ElementsAre(IsMediaSample(kStreamIndex, i * kSegmentDuration,
+                                          kSegmentDuration, is_encrypted, _),
+                            IsSegmentInfo(kStreamIndex, i * kSegmentDuration,
+                                          kSegmentDuration, !kIsSubsegment,
+                                          is_encrypted)));
+    ClearOutputStreamDataVector();
+  }
+}
+
 TEST_P(EncryptionHandlerEncryptionTest, ClearLeadWithKeyRotation) {
   const double kClearLeadInSeconds = 1.5 * kSegmentDuration / kTimeScale;
   const int kSegmentsPerCryptoPeriod = 2;  // 2 segments.
@@ -600,5 +642,86 @@ TEST_F(EncryptionHandlerTrackTypeTest, VideoTrackType) {
   EXPECT_EQ(captured_stream_attributes.oneof.video.height, kHeight);
 }
 
+namespace {
+const char kStreamId[] = "input.mp4:video";
+}  // namespace
+
+class EncryptionHandlerDeriveIvTest : public EncryptionHandlerTest {
+ public:
+  void SetUpDeriveIv(FourCC protection_scheme) {
+    EncryptionParams encryption_params;
+    encryption_params.protection_scheme = protection_scheme;
+    encryption_params.derive_iv = true;
+    SetUpEncryptionHandler(encryption_params);
+    encryption_handler_->set_stream_id(kStreamId);
+
+    EXPECT_CALL(mock_key_source_, GetKey(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(GetMockEncryptionKey()),
+                        Return(Status::OK)));
+    ASSERT_TRUE(iv_deriver_.Initialize(protection_scheme,
+                                       GetMockEncryptionKey().key, kStreamId));
+  }
+
+ protected:
+  SampleIvDeriver iv_deriver_;
+};
+
+TEST_F(EncryptionHandlerDeriveIvTest, SampleIvs) {
+  SetUpDeriveIv(FOURCC_cenc);
+
+  ASSERT_OK(Process(StreamData::FromStreamInfo(
+      kStreamIndex, GetVideoStreamInfo(kTimeScale, kCodecH264))));
+  // Starts from the middle of the stream.
+  const int64_t kFirstDts = 10 * kSampleDuration;
+  for (int64_t dts : {kFirstDts, kFirstDts + kSampleDuration}) {
+    ASSERT_OK(Process(StreamData::FromMediaSample(
+        kStreamIndex,
+        GetMediaSample(dts, kSampleDuration, kIsKeyFrame, kData, kDataSize))));
+  }
+
+  const auto& output_stream_data = GetOutputStreamDataVector();
+  ASSERT_EQ(3u, output_stream_data.size());
+  EXPECT_EQ(8u, output_stream_data[0]
+                    ->stream_info->encryption_config()
+                    .per_sample_iv_size);
+  EXPECT_EQ(iv_deriver_.DeriveSampleIv(kFirstDts),
+            output_stream_data[1]->media_sample->decrypt_config()->iv());
+  EXPECT_EQ(iv_deriver_.DeriveSampleIv(kFirstDts + kSampleDuration),
+            output_stream_data[2]->media_sample->decrypt_config()->iv());
+}
+
+TEST_F(EncryptionHandlerDeriveIvTest, NonIncreasingDts) {
+  SetUpDeriveIv(FOURCC_cenc);
+
+  ASSERT_OK(Process(StreamData::FromStreamInfo(
+      kStreamIndex, GetVideoStreamInfo(kTimeScale, kCodecH264))));
+  ASSERT_OK(Process(StreamData::FromMediaSample(
+      kStreamIndex, GetMediaSample(kSampleDuration, kSampleDuration,
+                                   kIsKeyFrame, kData, kDataSize))));
+  // The same DTS would give the same IV again.
+  for (int64_t dts : {kSampleDuration, static_cast<int64_t>(0)}) {
+    EXPECT_EQ(error::ENCRYPTION_FAILURE,
+              Process(StreamData::FromMediaSample(
+                          kStreamIndex,
+                          GetMediaSample(dts, kSampleDuration, kIsKeyFrame,
+                                         kData, kDataSize)))
+                  .error_code());
+  }
+}
+
+TEST_F(EncryptionHandlerDeriveIvTest, ConstantIv) {
+  SetUpDeriveIv(FOURCC_cbcs);
+
+  ASSERT_OK(Process(StreamData::FromStreamInfo(
+      kStreamIndex, GetVideoStreamInfo(kTimeScale, kCodecH264))));
+
+  const auto& output_stream_data = GetOutputStreamDataVector();
+  ASSERT_EQ(1u, output_stream_data.size());
+  const EncryptionConfig& encryption_config =
+      output_stream_data[0]->stream_info->encryption_config();
+  EXPECT_EQ(0u, encryption_config.per_sample_iv_size);
+  EXPECT_EQ(iv_deriver_.DeriveConstantIv(), encryption_config.constant_iv);
+}
+
 }  // namespace media
 }  // namespace shaka
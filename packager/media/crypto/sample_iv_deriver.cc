@@ -0,0 +1,94 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/crypto/sample_iv_deriver.h"
+
+#include <openssl/aes.h>
+#include <openssl/sha.h>
+#include <string.h>
+
+#include "packager/base/logging.h"
+#include "packager/media/base/aes_cryptor.h"
+
+namespace shaka {
+namespace media {
+namespace {
+
+// Encrypted with the content key to derive the IV key.
+const uint8_t kIvKeyLabel[AES_BLOCK_SIZE] = {
+    's', 'h', 'a', 'k', 'a', '-', 'd', 'e',
+    'r', 'i', 'v', 'e', 'd', '-', 'i', 'v',
+};
+const size_t kStreamPrefixSize = 8;
+
+// Writes |value| in big endian to |dest|.
+void WriteUint64(uint64_t value, uint8_t* dest) {
+  for (int i = 7; i >= 0; --i) {
+    dest[i] = value & 0xFF;
+    value >>= 8;
+  }
+}
+
+}  // namespace
+
+SampleIvDeriver::SampleIvDeriver() : iv_key_(new AES_KEY) {}
+
+SampleIvDeriver::~SampleIvDeriver() = default;
+
+bool SampleIvDeriver::Initialize(FourCC protection_scheme,
+                                 const std::vector<uint8_t>& key,
+                                 const std::string& stream_id) {
+  AES_KEY content_key;
+  if (AES_set_encrypt_key(key.data(), key.size() * 8, &content_key) != 0) {
+    LOG(ERROR) << "Failed to set AES key of size " << key.size();
+    return false;
+  }
+  uint8_t iv_key[AES_BLOCK_SIZE];
+  AES_encrypt(kIvKeyLabel, iv_key, &content_key);
+  CHECK_EQ(AES_set_encrypt_key(iv_key, sizeof(iv_key) * 8, iv_key_.get()), 0);
+
+  uint8_t stream_hash[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const uint8_t*>(stream_id.data()), stream_id.size(),
+         stream_hash);
+  stream_prefix_.assign(stream_hash, stream_hash + kStreamPrefixSize);
+
+  // The constant IV, which is also the base of 8-byte sample IVs, uses the
+  // other half of the hash than the blocks of 16-byte sample IVs.
+  uint8_t block[AES_BLOCK_SIZE] = {};
+  memcpy(block, stream_hash + kStreamPrefixSize, kStreamPrefixSize);
+  uint8_t constant_iv[AES_BLOCK_SIZE];
+  AES_encrypt(block, constant_iv, iv_key_.get());
+  constant_iv_.assign(
+      constant_iv,
+      constant_iv + AesCryptor::GetDefaultIvSize(protection_scheme));
+  return true;
+}
+
+std::vector<uint8_t> SampleIvDeriver::DeriveConstantIv() const {
+  DCHECK(!constant_iv_.empty()) << "SampleIvDeriver is not initialized.";
+  return constant_iv_;
+}
+
+std::vector<uint8_t> SampleIvDeriver::DeriveSampleIv(int64_t dts) const {
+  DCHECK(!constant_iv_.empty()) << "SampleIvDeriver is not initialized.";
+  std::vector<uint8_t> iv(constant_iv_.size());
+  if (iv.size() == 8) {
+    uint64_t base_iv = 0;
+    for (uint8_t byte : constant_iv_)
+      base_iv = (base_iv << 8) | byte;
+    WriteUint64(base_iv + static_cast<uint64_t>(dts), iv.data());
+    return iv;
+  }
+  DCHECK_EQ(static_cast<size_t>(AES_BLOCK_SIZE), iv.size());
+  uint8_t block[AES_BLOCK_SIZE];
+  memcpy(block, stream_prefix_.data(), kStreamPrefixSize);
+  WriteUint64(static_cast<uint64_t>(dts), block + kStreamPrefixSize);
+  AES_encrypt(block, iv.data(), iv_key_.get());
+  return iv;
+}
+
+}  // namespace media
+}  // namespace shaka
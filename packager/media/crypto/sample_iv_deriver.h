@@ -0,0 +1,72 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_CRYPTO_SAMPLE_IV_DERIVER_H_
+#define PACKAGER_MEDIA_CRYPTO_SAMPLE_IV_DERIVER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "packager/media/base/fourccs.h"
+
+struct aes_key_st;
+typedef struct aes_key_st AES_KEY;
+
+namespace shaka {
+namespace media {
+
+/// Derives the IVs of a stream from its key, an identifier of the stream and
+/// the DTS of the samples, so that the IV of a sample does not depend on the
+/// samples encrypted before it. Encryptors which start in the middle of a
+/// stream, e.g. after a restart or in a parallel chunk, then produce the same
+/// IVs as an encryptor which encrypts the whole stream.
+///
+/// The IVs are computed with an IV key, which is derived from the content key,
+/// so that they do not reveal any key stream of the content key:
+/// - 8-byte IVs start from a base IV derived from the stream and are
+///   incremented by the DTS, which is strictly increasing in a stream. This
+///   follows the incrementing IVs recommended by ISO/IEC 23001-7:2016 9.1 and
+///   keeps the IVs of a stream unique.
+/// - 16-byte IVs are the encryption of the stream and the DTS with the IV key,
+///   which is a permutation, so they are unique and unpredictable.
+class SampleIvDeriver {
+ public:
+  SampleIvDeriver();
+  ~SampleIvDeriver();
+
+  /// @param protection_scheme determines the IV size, see
+  ///        AesCryptor::GetDefaultIvSize().
+  /// @param key is the content key of the stream.
+  /// @param stream_id identifies the stream among the streams encrypted with
+  ///        @a key. It must be the same for every encryptor of the stream.
+  /// @return true on success, false if @a key is not a valid AES key.
+  bool Initialize(FourCC protection_scheme,
+                  const std::vector<uint8_t>& key,
+                  const std::string& stream_id);
+
+  /// @return the IV of the stream if it uses a constant IV, e.g. for 'cbcs'.
+  std::vector<uint8_t> DeriveConstantIv() const;
+
+  /// @return the IV of the sample with @a dts.
+  std::vector<uint8_t> DeriveSampleIv(int64_t dts) const;
+
+ private:
+  SampleIvDeriver(const SampleIvDeriver&) = delete;
+  SampleIvDeriver& operator=(const SampleIvDeriver&) = delete;
+
+  std::unique_ptr<AES_KEY> iv_key_;
+  // Identifies the stream in the blocks encrypted with |iv_key_|.
+  std::vector<uint8_t> stream_prefix_;
+  std::vector<uint8_t> constant_iv_;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_CRYPTO_SAMPLE_IV_DERIVER_H_
@@ -0,0 +1,115 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/crypto/sample_iv_deriver.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+namespace shaka {
+namespace media {
+namespace {
+
+const uint8_t kKey[]{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+};
+const uint8_t kOtherKey[]{
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25,
+};
+const char kStreamId[] = "input.mp4:video";
+const char kOtherStreamId[] = "input.mp4:audio";
+const int64_t kSampleDuration = 3003;
+const int kNumSamples = 1000;
+
+std::vector<uint8_t> GetKey() {
+  return std::vector<uint8_t>(std::begin(kKey), std::end(kKey));
+}
+
+uint64_t ToUint64(const std::vector<uint8_t>& iv) {
+  uint64_t value = 0;
+  for (uint8_t byte : iv)
+    value = (value << 8) | byte;
+  return value;
+}
+
+}  // namespace
+
+TEST(SampleIvDeriverTest, InvalidKey) {
+  SampleIvDeriver iv_deriver;
+  EXPECT_FALSE(iv_deriver.Initialize(FOURCC_cenc, std::vector<uint8_t>(5),
+                                     kStreamId));
+}
+
+TEST(SampleIvDeriverTest, IvSize) {
+  SampleIvDeriver iv_deriver;
+  ASSERT_TRUE(iv_deriver.Initialize(FOURCC_cenc, GetKey(), kStreamId));
+  EXPECT_EQ(8u, iv_deriver.DeriveConstantIv().size());
+  EXPECT_EQ(8u, iv_deriver.DeriveSampleIv(0).size());
+
+  ASSERT_TRUE(iv_deriver.Initialize(FOURCC_cbcs, GetKey(), kStreamId));
+  EXPECT_EQ(16u, iv_deriver.DeriveConstantIv().size());
+  EXPECT_EQ(16u, iv_deriver.DeriveSampleIv(0).size());
+}
+
+TEST(SampleIvDeriverTest, Deterministic) {
+  SampleIvDeriver iv_deriver;
+  ASSERT_TRUE(iv_deriver.Initialize(FOURCC_cbc1, GetKey(), kStreamId));
+  SampleIvDeriver other_iv_deriver;
+  ASSERT_TRUE(other_iv_deriver.Initialize(FOURCC_cbc1, GetKey(), kStreamId));
+
+  EXPECT_EQ(iv_deriver.DeriveConstantIv(), other_iv_deriver.DeriveConstantIv());
+  EXPECT_EQ(iv_deriver.DeriveSampleIv(90000),
+            other_iv_deriver.DeriveSampleIv(90000));
+}
+
+TEST(SampleIvDeriverTest, DependsOnKeyAndStream) {
+  SampleIvDeriver iv_deriver;
+  ASSERT_TRUE(iv_deriver.Initialize(FOURCC_cbcs, GetKey(), kStreamId));
+  SampleIvDeriver other_stream_iv_deriver;
+  ASSERT_TRUE(other_stream_iv_deriver.Initialize(FOURCC_cbcs, GetKey(),
+                                                 kOtherStreamId));
+  SampleIvDeriver other_key_iv_deriver;
+  ASSERT_TRUE(other_key_iv_deriver.Initialize(
+      FOURCC_cbcs, std::vector<uint8_t>(std::begin(kOtherKey),
+                                        std::end(kOtherKey)),
+      kStreamId));
+
+  EXPECT_NE(iv_deriver.DeriveConstantIv(),
+            other_stream_iv_deriver.DeriveConstantIv());
+  EXPECT_NE(iv_deriver.DeriveConstantIv(),
+            other_key_iv_deriver.DeriveConstantIv());
+  EXPECT_NE(iv_deriver.DeriveSampleIv(0),
+            other_stream_iv_deriver.DeriveSampleIv(0));
+  EXPECT_NE(iv_deriver.DeriveSampleIv(0),
+            other_key_iv_deriver.DeriveSampleIv(0));
+}
+
+TEST(SampleIvDeriverTest, EightByteIvsIncrementWithDts) {
+  SampleIvDeriver iv_deriver;
+  ASSERT_TRUE(iv_deriver.Initialize(FOURCC_cens, GetKey(), kStreamId));
+
+  const uint64_t base_iv = ToUint64(iv_deriver.DeriveConstantIv());
+  EXPECT_EQ(base_iv, ToUint64(iv_deriver.DeriveSampleIv(0)));
+  EXPECT_EQ(base_iv + kSampleDuration,
+            ToUint64(iv_deriver.DeriveSampleIv(kSampleDuration)));
+}
+
+TEST(SampleIvDeriverTest, UniqueSampleIvs) {
+  for (FourCC protection_scheme : {FOURCC_cenc, FOURCC_cbc1}) {
+    SampleIvDeriver iv_deriver;
+    ASSERT_TRUE(iv_deriver.Initialize(protection_scheme, GetKey(), kStreamId));
+    std::set<std::vector<uint8_t>> ivs;
+    for (int i = 0; i < kNumSamples; ++i)
+      ivs.insert(iv_deriver.DeriveSampleIv(i * kSampleDuration));
+    EXPECT_EQ(static_cast<size_t>(kNumSamples), ivs.size());
+  }
+}
+
+}  // namespace media
+}  // namespace shaka
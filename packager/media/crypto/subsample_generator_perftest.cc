@@ -0,0 +1,101 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures the per-sample overhead of SubsampleGenerator on samples sized for
+// 4K60 content, which has a frame budget of about 16.7 milliseconds.
+
+#include <gtest/gtest.h>
+
+#include "packager/base/time/time.h"
+#include "packager/media/base/audio_stream_info.h"
+#include "packager/media/base/decrypt_config.h"
+#include "packager/media/base/video_stream_info.h"
+#include "packager/media/codecs/h264_byte_to_unit_stream_converter.h"
+#include "packager/media/crypto/subsample_generator.h"
+#include "packager/media/test/test_data_util.h"
+#include "packager/status_test_util.h"
+#include "packager/testing/perf/perf_test.h"
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+const int kNumIterations = 5000;
+const bool kVP9SubsampleEncryption = true;
+// Roughly the size of a 4K60 frame at 50 Mbps.
+const size_t kTargetSampleSize = 104 * 1024;
+
+void PrintMicrosecondsPerSample(const std::string& trace,
+                                base::TimeDelta elapsed) {
+  perf_test::PrintResult("subsample_generation", "", trace,
+                         elapsed.InMicrosecondsF() / kNumIterations,
+                         "us/sample", true);
+}
+
+// Repeats the NAL units of a unit stream frame until the sample reaches
+// |kTargetSampleSize|, so the sample carries as many slices as a 4K encoder
+// would typically produce.
+std::vector<uint8_t> MakeLargeSample(const std::vector<uint8_t>& frame) {
+  std::vector<uint8_t> sample;
+  while (sample.size() < kTargetSampleSize)
+    sample.insert(sample.end(), frame.begin(), frame.end());
+  return sample;
+}
+
+void RunSubsampleGeneration(const std::string& trace,
+                            FourCC protection_scheme,
+                            const StreamInfo& stream_info,
+                            const std::vector<uint8_t>& sample) {
+  SubsampleGenerator generator(kVP9SubsampleEncryption);
+  ASSERT_OK(generator.Initialize(protection_scheme, stream_info));
+
+  std::vector<SubsampleEntry> subsamples;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    ASSERT_OK(generator.GenerateSubsamples(sample.data(), sample.size(),
+                                           &subsamples));
+  }
+  PrintMicrosecondsPerSample(trace, base::TimeTicks::Now() - start);
+}
+
+}  // namespace
+
+TEST(SubsampleGeneratorPerfTest, H264) {
+  const std::vector<uint8_t> byte_stream =
+      ReadTestDataFile("avc-byte-stream-frame.h264");
+  ASSERT_FALSE(byte_stream.empty());
+
+  H264ByteToUnitStreamConverter converter(
+      H26xStreamFormat::kNalUnitStreamWithoutParameterSetNalus);
+  std::vector<uint8_t> frame;
+  ASSERT_TRUE(converter.ConvertByteStreamToNalUnitStream(
+      byte_stream.data(), byte_stream.size(), &frame));
+  std::vector<uint8_t> decoder_config;
+  ASSERT_TRUE(converter.GetDecoderConfigurationRecord(&decoder_config));
+
+  const VideoStreamInfo stream_info(
+      1, 90000, 0, kCodecH264, converter.stream_format(), "avc1",
+      decoder_config.data(), decoder_config.size(), 3840, 2160, 1, 1, 0,
+      H26xByteToUnitStreamConverter::kUnitStreamNaluLengthSize, "und", false);
+  const std::vector<uint8_t> sample = MakeLargeSample(frame);
+
+  RunSubsampleGeneration("h264_cenc", FOURCC_cenc, stream_info, sample);
+  RunSubsampleGeneration("h264_cbcs", FOURCC_cbcs, stream_info, sample);
+}
+
+TEST(SubsampleGeneratorPerfTest, Audio) {
+  const uint8_t kCodecConfig[] = {0x12, 0x10};
+  const AudioStreamInfo stream_info(1, 48000, 0, kCodecAAC, "mp4a.40.2",
+                                    kCodecConfig, sizeof(kCodecConfig), 16, 2,
+                                    48000, 0, 0, 0, 0, "und", false);
+  const std::vector<uint8_t> sample(768, 0);
+
+  RunSubsampleGeneration("aac_cenc", FOURCC_cenc, stream_info, sample);
+}
+
+}  // namespace media
+}  // namespace shaka
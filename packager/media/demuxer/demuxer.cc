@@ -7,10 +7,12 @@
 #include "packager/media/demuxer/demuxer.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "packager/base/bind.h"
 #include "packager/base/logging.h"
 #include "packager/base/strings/string_number_conversions.h"
+#include "packager/base/strings/string_util.h"
 #include "packager/file/file.h"
 #include "packager/media/base/decryptor_source.h"
 #include "packager/media/base/key_source.h"
@@ -21,6 +23,10 @@
 #include "packager/media/formats/mp4/mp4_media_parser.h"
 #include "packager/media/formats/webm/webm_media_parser.h"
 #include "packager/media/formats/wvm/wvm_media_parser.h"
+#include "packager/media/synthetic/synthetic_media_file.h"
+#include "packager/media/synthetic/synthetic_media_options.h"
+#include "packager/memory_tracker.h"
+#include "packager/status_macros.h"
 
 namespace {
 // 65KB, sufficient to determine the container and likely all init data.
@@ -34,6 +40,10 @@ const size_t kInvalidStreamIndex = static_cast<size_t>(-1);
 const size_t kBaseVideoOutputStreamIndex = 0x100;
 const size_t kBaseAudioOutputStreamIndex = 0x200;
 const size_t kBaseTextOutputStreamIndex = 0x300;
+// Maximum time to hold off reading while the memory soft limit is exceeded.
+// Some of the memory may only be released with more input, so reading has to
+// resume eventually.
+const int64_t kMaxSoftLimitWaitInMilliseconds = 1000;
 
 std::string GetStreamLabel(size_t stream_index) {
   switch (stream_index) {
@@ -86,10 +96,14 @@ void Demuxer::SetKeySource(std::unique_ptr<KeySource> key_source) {
 
 Status Demuxer::Run() {
   LOG(INFO) << "Demuxer::Run() on file '" << file_name_ << "'.";
+  // Attributes the parser buffers to the input.
+  MemoryAccounting::ScopedInput scoped_input(file_name_);
   Status status = InitializeParser();
   // ParserInitEvent callback is called after a few calls to Parse(), which sets
   // up the streams. Only after that, we can verify the outputs below.
-  while (!all_streams_ready_ && status.ok())
+  // With lazy stream initialization, the streams are started before all of
+  // them are ready, so this loop may carry all the media.
+  while (!all_streams_ready_ && !cancelled_ && status.ok())
     status.Update(Parse());
   // If no output is defined, then return success after receiving all stream
   // info.
@@ -97,24 +111,44 @@ Status Demuxer::Run() {
     return Status::OK;
   if (!init_event_status_.ok())
     return init_event_status_;
-  if (!status.ok())
+  // The input may end before a stream is ready, e.g. if its config is never
+  // found. The streams started already are flushed below.
+  const bool ended_with_started_streams =
+      !all_streams_ready_ && !stream_indexes_.empty() &&
+      status.error_code() == error::END_OF_STREAM;
+  if (!status.ok() && !ended_with_started_streams)
     return status;
   // Check if all specified outputs exists.
   for (const auto& pair : output_handlers()) {
     if (std::find(stream_indexes_.begin(), stream_indexes_.end(), pair.first) ==
         stream_indexes_.end()) {
+      // The run is cancelled or the input ends before the stream is ready.
+      if (!all_streams_ready_) {
+        LOG_IF(WARNING, ended_with_started_streams)
+            << "Stream " << GetStreamLabel(pair.first)
+            << " is not started before the end of " << file_name_;
+        continue;
+      }
       LOG(ERROR) << "Invalid argument, stream=" << GetStreamLabel(pair.first)
                  << " not available.";
       return Status(error::INVALID_ARGUMENT, "Stream not available");
     }
   }
 
-  while (!cancelled_ && status.ok())
+  while (!cancelled_ && status.ok() && !AllSampleRangesEnded())
     status.Update(Parse());
   if (cancelled_ && status.ok())
     return Status(error::CANCELLED, "Demuxer run cancelled");
 
-  if (status.error_code() == error::END_OF_STREAM) {
+  // The rest of the input is not needed once the sample ranges have ended.
+  if (status.ok() || status.error_code() == error::END_OF_STREAM) {
+    for (const auto& pair : sample_ranges_) {
+      if (!pair.second.has_samples) {
+        LOG(WARNING) << "No samples of stream " << GetStreamLabel(pair.first)
+                     << " in [" << pair.second.start_dts << ", "
+                     << pair.second.end_dts << ") of " << file_name_;
+      }
+    }
     for (size_t stream_index : stream_indexes_) {
       status = FlushDownstream(stream_index);
       if (!status.ok())
@@ -139,6 +173,24 @@ Status Demuxer::SetHandler(const std::string& stream_label,
   return MediaHandler::SetHandler(stream_index, std::move(handler));
 }
 
+Status Demuxer::SetSampleRange(const std::string& stream_label,
+                               int64_t start_dts,
+                               int64_t end_dts) {
+  size_t stream_index = kInvalidStreamIndex;
+  if (!GetStreamIndex(stream_label, &stream_index)) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Invalid stream: " + stream_label);
+  }
+  if (start_dts >= end_dts) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Empty sample range for stream " + stream_label);
+  }
+  SampleRange& sample_range = sample_ranges_[stream_index];
+  sample_range.start_dts = start_dts;
+  sample_range.end_dts = end_dts;
+  return Status::OK;
+}
+
 void Demuxer::SetLanguageOverride(const std::string& stream_label,
                                   const std::string& language_override) {
   size_t stream_index = kInvalidStreamIndex;
@@ -159,7 +211,14 @@ Status Demuxer::InitializeParser() {
 
   LOG(INFO) << "Initialize Demuxer for file '" << file_name_ << "'.";
 
-  media_file_ = File::Open(file_name_.c_str(), "r");
+  // synth:// is handled here instead of in File as the generator depends on
+  // media.
+  if (base::StartsWith(file_name_, kSyntheticFilePrefix,
+                       base::CompareCase::SENSITIVE)) {
+    media_file_ = SyntheticMediaFile::Create(file_name_);
+  } else {
+    media_file_ = File::Open(file_name_.c_str(), "r");
+  }
   if (!media_file_) {
     return Status(error::FILE_FAILURE,
                   "Cannot open file for reading " + file_name_);
@@ -174,8 +233,10 @@ Status Demuxer::InitializeParser() {
       return Status(error::FILE_FAILURE, "Cannot read file " + file_name_);
     if (read_result == 0)
       break;
+    last_read_time_ = base::TimeTicks::Now();
     bytes_read += read_result;
   }
+  input_position_ = bytes_read;
   container_name_ = DetermineContainer(buffer_.get(), bytes_read);
 
   // Initialize media parser.
@@ -220,11 +281,18 @@ Status Demuxer::InitializeParser() {
   // (ecl) set the SCTE-35 signal callback for the MP2T parser to pass the parsed section back to the demuxer
   if (container_name_ == CONTAINER_MPEG2TS)
     static_cast<mp2t::Mp2tMediaParser*>(parser_.get())->SetSignalCallback(base::Bind(&Demuxer::NewSignalEvent, base::Unretained(this)));
-  
+  if (container_name_ == CONTAINER_MPEG2TS && lazy_stream_initialization_) {
+    static_cast<mp2t::Mp2tMediaParser*>(parser_.get())
+        ->EnableLazyInitialization(base::Bind(&Demuxer::NewStreamInfoEvent,
+                                              base::Unretained(this)));
+  }
+
 
   // Handle trailing 'moov'.
   if (container_name_ == CONTAINER_MOV)
     static_cast<mp4::MP4MediaParser*>(parser_.get())->LoadMoov(file_name_);
+  if (skip_sample_data_)
+    skips_sample_data_ = parser_->SkipSampleData();
   if (!parser_->Parse(buffer_.get(), bytes_read)) {
     return Status(error::PARSER_FAILURE,
                   "Cannot parse media file " + file_name_);
@@ -241,63 +309,129 @@ void Demuxer::ParserInitEvent(
       printf("Stream [%zu] %s\n", i, stream_infos[i]->ToString().c_str());
   }
 
-  int base_stream_index = 0;
-  bool video_handler_set =
-      output_handlers().find(kBaseVideoOutputStreamIndex) !=
-      output_handlers().end();
-  bool audio_handler_set =
-      output_handlers().find(kBaseAudioOutputStreamIndex) !=
-      output_handlers().end();
-  bool text_handler_set =
-      output_handlers().find(kBaseTextOutputStreamIndex) !=
-      output_handlers().end();
-  for (const std::shared_ptr<StreamInfo>& stream_info : stream_infos) {
-    size_t stream_index = base_stream_index;
-    if (video_handler_set && stream_info->stream_type() == kStreamVideo) {
-      stream_index = kBaseVideoOutputStreamIndex;
-      // Only for the first video stream.
-      video_handler_set = false;
+  bool first_video = true;
+  bool first_audio = true;
+  bool first_text = true;
+  for (size_t i = 0; i < stream_infos.size(); ++i) {
+    const std::shared_ptr<StreamInfo>& stream_info = stream_infos[i];
+    bool first_of_type = false;
+    switch (stream_info->stream_type()) {
+      case kStreamVideo:
+        first_of_type = first_video;
+        first_video = false;
+        break;
+      case kStreamAudio:
+        first_of_type = first_audio;
+        first_audio = false;
+        break;
+      case kStreamText:
+        first_of_type = first_text;
+        first_text = false;
+        break;
+      default:
+        break;
     }
-    if (audio_handler_set && stream_info->stream_type() == kStreamAudio) {
-      stream_index = kBaseAudioOutputStreamIndex;
-      // Only for the first audio stream.
-      audio_handler_set = false;
+    // Skip the streams set up already in lazy stream initialization.
+    if (lazy_stream_initialization_ &&
+        track_id_to_stream_index_map_.find(stream_info->track_id()) !=
+            track_id_to_stream_index_map_.end()) {
+      continue;
     }
-    if (text_handler_set && stream_info->stream_type() == kStreamText) {
-      stream_index = kBaseTextOutputStreamIndex;
-      text_handler_set = false;
+    SetUpStream(i, first_of_type, stream_info);
+  }
+  all_streams_ready_ = true;
+}
+
+void Demuxer::NewStreamInfoEvent(
+    size_t stream_position,
+    bool first_of_type,
+    const std::shared_ptr<StreamInfo>& stream_info) {
+  DCHECK(!all_streams_ready_);
+  SetUpStream(stream_position, first_of_type, stream_info);
+  if (!init_event_status_.ok())
+    return;
+
+  // Push the samples of the stream which are queued, keeping the others.
+  std::deque<QueuedSample> other_samples;
+  for (const QueuedSample& queued_sample : queued_samples_) {
+    if (queued_sample.track_id != stream_info->track_id()) {
+      other_samples.push_back(queued_sample);
+    } else if (!PushSample(queued_sample.track_id, queued_sample.sample)) {
+      init_event_status_.Update(Status(error::PARSER_FAILURE,
+                                       "Failed to push queued samples."));
+      return;
     }
+  }
+  queued_samples_.swap(other_samples);
+}
 
-    const bool handler_set =
-        output_handlers().find(stream_index) != output_handlers().end();
-    if (handler_set) {
-      track_id_to_stream_index_map_[stream_info->track_id()] = stream_index;
-      stream_indexes_.push_back(stream_index);
-      auto iter = language_overrides_.find(stream_index);
-      if (iter != language_overrides_.end() &&
-          stream_info->stream_type() != kStreamVideo) {
-        stream_info->set_language(iter->second);
-      }
-      if (stream_info->is_encrypted()) {
-        init_event_status_.Update(Status(error::INVALID_ARGUMENT,
-                                         "A decryption key source is not "
-                                         "provided for an encrypted stream."));
-      } else {
-        init_event_status_.Update(
-            DispatchStreamInfo(stream_index, stream_info));
-      }
-    } else {
-      track_id_to_stream_index_map_[stream_info->track_id()] =
-          kInvalidStreamIndex;
+void Demuxer::SetUpStream(size_t stream_position,
+                          bool first_of_type,
+                          const std::shared_ptr<StreamInfo>& stream_info) {
+  // The first stream of a type goes to the handler of the type, if set.
+  size_t stream_index = stream_position;
+  if (first_of_type) {
+    size_t type_stream_index = kInvalidStreamIndex;
+    switch (stream_info->stream_type()) {
+      case kStreamVideo:
+        type_stream_index = kBaseVideoOutputStreamIndex;
+        break;
+      case kStreamAudio:
+        type_stream_index = kBaseAudioOutputStreamIndex;
+        break;
+      case kStreamText:
+        type_stream_index = kBaseTextOutputStreamIndex;
+        break;
+      default:
+        break;
     }
-    ++base_stream_index;
+    if (output_handlers().find(type_stream_index) != output_handlers().end())
+      stream_index = type_stream_index;
+  }
+
+  const bool handler_set =
+      output_handlers().find(stream_index) != output_handlers().end();
+  if (!handler_set) {
+    track_id_to_stream_index_map_[stream_info->track_id()] =
+        kInvalidStreamIndex;
+    // The samples of the stream are not needed, so the parser does not have
+    // to read them when the input is read in sample ranges.
+    if (!sample_ranges_.empty()) {
+      parser_->SkipSamplesBefore(stream_info->track_id(),
+                                 std::numeric_limits<int64_t>::max());
+    }
+    return;
+  }
+  track_id_to_stream_index_map_[stream_info->track_id()] = stream_index;
+  auto sample_range = sample_ranges_.find(stream_index);
+  if (sample_range != sample_ranges_.end()) {
+    parser_->SkipSamplesBefore(stream_info->track_id(),
+                               sample_range->second.start_dts);
+  }
+  stream_indexes_.push_back(stream_index);
+  auto iter = language_overrides_.find(stream_index);
+  if (iter != language_overrides_.end() &&
+      stream_info->stream_type() != kStreamVideo) {
+    stream_info->set_language(iter->second);
+  }
+  if (stream_info->is_encrypted()) {
+    init_event_status_.Update(Status(error::INVALID_ARGUMENT,
+                                     "A decryption key source is not "
+                                     "provided for an encrypted stream."));
+  } else {
+    init_event_status_.Update(DispatchStreamInfo(stream_index, stream_info));
   }
-  all_streams_ready_ = true;
 }
 
 bool Demuxer::NewSampleEvent(uint32_t track_id,
                              const std::shared_ptr<MediaSample>& sample) {
+  sample->set_ingest_time(last_read_time_);
   if (!all_streams_ready_) {
+    // The streams set up in lazy stream initialization are started already.
+    if (track_id_to_stream_index_map_.find(track_id) !=
+        track_id_to_stream_index_map_.end()) {
+      return init_event_status_.ok() && PushSample(track_id, sample);
+    }
     if (queued_samples_.size() >= kQueuedSamplesLimit) {
       LOG(ERROR) << "Queued samples limit reached: " << kQueuedSamplesLimit;
       return false;
@@ -327,6 +461,17 @@ bool Demuxer::PushSample(uint32_t track_id,
   }
   if (stream_index_iter->second == kInvalidStreamIndex)
     return true;
+  auto sample_range = sample_ranges_.find(stream_index_iter->second);
+  if (sample_range != sample_ranges_.end()) {
+    // Parsers which cannot skip the samples before the range still emit them.
+    if (sample->dts() < sample_range->second.start_dts)
+      return true;
+    if (sample->dts() >= sample_range->second.end_dts) {
+      sample_range->second.ended = true;
+      return true;
+    }
+    sample_range->second.has_samples = true;
+  }
   Status status = DispatchMediaSample(stream_index_iter->second, sample);
   if (!status.ok()) {
     LOG(ERROR) << "Failed to process sample " << stream_index_iter->second
@@ -359,6 +504,15 @@ Status Demuxer::Parse() {
   DCHECK(parser_);
   DCHECK(buffer_);
 
+  // Ingest is throttled rather than the downstream buffers, which are drained
+  // by the same thread and cannot wait for themselves.
+  MemoryAccounting::WaitForSoftLimit(
+      base::TimeDelta::FromMilliseconds(kMaxSoftLimitWaitInMilliseconds));
+
+  int64_t skip_position = 0;
+  if (parser_->SkipInput(&skip_position))
+    RETURN_IF_ERROR(SkipInput(skip_position));
+
   int64_t bytes_read = media_file_->Read(buffer_.get(), kBufSize);
   if (bytes_read == 0) {
     if (!parser_->Flush())
@@ -367,6 +521,8 @@ Status Demuxer::Parse() {
   } else if (bytes_read < 0) {
     return Status(error::FILE_FAILURE, "Cannot read file " + file_name_);
   }
+  last_read_time_ = base::TimeTicks::Now();
+  input_position_ += bytes_read;
 
   return parser_->Parse(buffer_.get(), bytes_read)
              ? Status::OK
@@ -374,5 +530,38 @@ Status Demuxer::Parse() {
                       "Cannot parse media file " + file_name_);
 }
 
+Status Demuxer::SkipInput(int64_t position) {
+  DCHECK_GE(position, input_position_);
+  // Seeking may be costly, e.g. for files read ahead by a thread, so short
+  // gaps are read instead.
+  if (position - input_position_ >= static_cast<int64_t>(kBufSize) &&
+      media_file_->Seek(position)) {
+    input_position_ = position;
+    return Status::OK;
+  }
+  while (input_position_ < position) {
+    const int64_t bytes_read = media_file_->Read(
+        buffer_.get(),
+        std::min(static_cast<int64_t>(kBufSize), position - input_position_));
+    if (bytes_read < 0)
+      return Status(error::FILE_FAILURE, "Cannot read file " + file_name_);
+    // The end of the input is handled by the next read.
+    if (bytes_read == 0)
+      break;
+    input_position_ += bytes_read;
+  }
+  return Status::OK;
+}
+
+bool Demuxer::AllSampleRangesEnded() const {
+  if (sample_ranges_.empty())
+    return false;
+  for (const auto& pair : sample_ranges_) {
+    if (!pair.second.ended)
+      return false;
+  }
+  return true;
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -24,6 +24,8 @@
         '../formats/webvtt/webvtt.gyp:webvtt',
         '../formats/wvm/wvm.gyp:wvm',
         '../origin/origin.gyp:origin',
+        '../synthetic/synthetic.gyp:synthetic',
+        '../../packager.gyp:memory_tracker',
       ],
     },
     {
@@ -8,10 +8,13 @@
 #define PACKAGER_MEDIA_BASE_DEMUXER_H_
 
 #include <deque>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "packager/base/compiler_specific.h"
+#include "packager/base/time/time.h"
 #include "packager/media/base/container_names.h"
 #include "packager/media/origin/origin_handler.h"
 #include "packager/status.h"
@@ -71,13 +74,43 @@ class Demuxer : public OriginHandler {
   void SetLanguageOverride(const std::string& stream_label,
                            const std::string& language_override);
 
+  /// Only pass on the samples of a stream whose decoding timestamps are in
+  /// [@a start_dts, @a end_dts), e.g. to package a chunk of the input. The
+  /// input before the samples is skipped if the parser supports it, and the
+  /// demuxer stops once the samples of every stream with a range are passed
+  /// on.
+  /// @param stream_label can be 'audio', 'video', or stream number (zero
+  ///        based).
+  Status SetSampleRange(const std::string& stream_label,
+                        int64_t start_dts,
+                        int64_t end_dts);
+
+  /// Let the parser emit the samples without their data if it supports it,
+  /// e.g. when only the timestamps and key frames of the samples are needed.
+  void set_skip_sample_data(bool skip_sample_data) {
+    skip_sample_data_ = skip_sample_data;
+  }
+
+  /// @return true if the parser emits the samples without their data, see
+  ///         set_skip_sample_data(). Set once the demuxer is initialized.
+  bool skips_sample_data() const { return skips_sample_data_; }
+
   void set_dump_stream_info(bool dump_stream_info) {
     dump_stream_info_ = dump_stream_info;
   }
 
+  /// Start every stream as soon as its own stream info is available, instead
+  /// of waiting for the stream info of all the streams. The streams whose
+  /// stream info comes later are started afterwards. Only MPEG-2 TS inputs
+  /// support it; it is ignored for other inputs.
+  void set_lazy_stream_initialization(bool lazy_stream_initialization) {
+    lazy_stream_initialization_ = lazy_stream_initialization;
+  }
+
  protected:
   /// @name MediaHandler implementation overrides.
   /// @{
+  std::string name() const override { return "Demuxer"; }
   Status InitializeInternal() override { return Status::OK; }
   Status Process(std::unique_ptr<StreamData> stream_data) override {
     return Status(error::INTERNAL_ERROR,
@@ -94,6 +127,15 @@ class Demuxer : public OriginHandler {
   Demuxer(const Demuxer&) = delete;
   Demuxer& operator=(const Demuxer&) = delete;
 
+  struct SampleRange {
+    int64_t start_dts = 0;
+    int64_t end_dts = 0;
+    // Whether a sample in the range is passed on.
+    bool has_samples = false;
+    // Whether a sample at or after |end_dts| is seen.
+    bool ended = false;
+  };
+
   struct QueuedSample {
     QueuedSample(uint32_t track_id, std::shared_ptr<MediaSample> sample);
     ~QueuedSample();
@@ -109,6 +151,16 @@ class Demuxer : public OriginHandler {
 
   // Parser init event.
   void ParserInitEvent(const std::vector<std::shared_ptr<StreamInfo>>& streams);
+  // Parser event for a single stream in lazy stream initialization. Sets up
+  // the stream and pushes the samples queued for it.
+  void NewStreamInfoEvent(size_t stream_position,
+                          bool first_of_type,
+                          const std::shared_ptr<StreamInfo>& stream_info);
+  // Maps the stream at |stream_position| in the parser stream info list to
+  // its output stream and dispatches its stream info if it has a handler.
+  void SetUpStream(size_t stream_position,
+                   bool first_of_type,
+                   const std::shared_ptr<StreamInfo>& stream_info);
   // Parser new sample event handler. Queues the samples if init event has not
   // been received, otherwise calls PushSample() to push the sample to
   // corresponding stream.
@@ -124,6 +176,10 @@ class Demuxer : public OriginHandler {
 
   // Read from the source and send it to the parser.
   Status Parse();
+  // Skip the source up to |position|, see MediaParser::SkipInput().
+  Status SkipInput(int64_t position);
+  // Whether every stream with a sample range has passed its end.
+  bool AllSampleRangesEnded() const;
 
   std::string file_name_;
   File* media_file_ = nullptr;
@@ -139,12 +195,22 @@ class Demuxer : public OriginHandler {
   std::vector<size_t> stream_indexes_;
   // StreamIndex -> language_override map.
   std::map<size_t, std::string> language_overrides_;
+  // StreamIndex -> sample range map.
+  std::map<size_t, SampleRange> sample_ranges_;
   MediaContainerName container_name_ = CONTAINER_UNKNOWN;
   std::unique_ptr<uint8_t[]> buffer_;
+  // Position in |media_file_| of the bytes read next.
+  int64_t input_position_ = 0;
+  // Time of the last read from |media_file_|, which is the ingest time of the
+  // samples parsed from that read.
+  base::TimeTicks last_read_time_;
   std::unique_ptr<KeySource> key_source_;
   bool cancelled_ = false;
   // Whether to dump stream info when it is received.
   bool dump_stream_info_ = false;
+  bool skip_sample_data_ = false;
+  bool skips_sample_data_ = false;
+  bool lazy_stream_initialization_ = false;
   Status init_event_status_;
 };
 
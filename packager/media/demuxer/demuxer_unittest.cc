@@ -9,7 +9,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
+#include "packager/file/file.h"
 #include "packager/media/base/media_handler_test_base.h"
+#include "packager/media/base/media_sample.h"
 #include "packager/media/base/raw_key_source.h"
 #include "packager/media/test/test_data_util.h"
 #include "packager/status_test_util.h"
@@ -45,6 +49,20 @@ class DemuxerTest : public MediaHandlerGraphTestBase {
     encryption_key.key.assign(kKey, kKey + sizeof(kKey));
     return encryption_key;
   }
+
+  // Runs |demuxer| on its video stream and returns the samples.
+  std::vector<std::shared_ptr<const MediaSample>> GetVideoSamples(
+      Demuxer* demuxer) {
+    auto handler = std::make_shared<CachingMediaHandler>();
+    EXPECT_OK(demuxer->SetHandler("video", handler));
+    EXPECT_OK(demuxer->Run());
+    std::vector<std::shared_ptr<const MediaSample>> samples;
+    for (const auto& stream_data : handler->Cache()) {
+      if (stream_data->stream_data_type == StreamDataType::kMediaSample)
+        samples.push_back(stream_data->media_sample);
+    }
+    return samples;
+  }
 };
 
 TEST_F(DemuxerTest, FileNotFound) {
@@ -72,7 +90,115 @@ TEST_F(DemuxerTest, EncryptedContentWithKeySource) {
   EXPECT_OK(demuxer.Run());
 }
 
-// TODO(kqyang): Add more tests.
+TEST_F(DemuxerTest, LazyStreamInitialization) {
+  Demuxer demuxer(GetTestDataFilePath("bear-640x360.ts").AsUTF8Unsafe());
+  demuxer.set_lazy_stream_initialization(true);
+  ASSERT_OK(demuxer.SetHandler("video", some_handler()));
+  EXPECT_OK(demuxer.Run());
+}
+
+TEST_F(DemuxerTest, LazyStreamInitializationWithoutConfig) {
+  // The audio PID of the input is listed in the PMT but its packets are
+  // removed, so the audio stream never gets a config.
+  const uint16_t kAudioPid = 257;
+  const size_t kTsPacketSize = 188;
+  std::string input;
+  ASSERT_TRUE(File::ReadFileToString(
+      GetTestDataFilePath("bear-640x360.ts").AsUTF8Unsafe().c_str(), &input));
+  std::string input_without_audio;
+  for (size_t pos = 0; pos + kTsPacketSize <= input.size();
+       pos += kTsPacketSize) {
+    const uint16_t pid = ((input[pos + 1] & 0x1f) << 8) |
+                         static_cast<uint8_t>(input[pos + 2]);
+    if (pid != kAudioPid)
+      input_without_audio.append(input, pos, kTsPacketSize);
+  }
+  const char kInputWithoutAudio[] = "memory://bear-640x360-no-audio.ts";
+  ASSERT_TRUE(
+      File::WriteStringToFile(kInputWithoutAudio, input_without_audio));
+
+  Demuxer demuxer(kInputWithoutAudio);
+  demuxer.set_lazy_stream_initialization(true);
+  auto handler = std::make_shared<MockOutputMediaHandler>();
+  EXPECT_CALL(*handler, OnProcess(_)).Times(::testing::AtLeast(2));
+  // The video stream is flushed although the input ends before all the
+  // streams are ready.
+  EXPECT_CALL(*handler, OnFlush(_));
+  ASSERT_OK(demuxer.SetHandler("video", handler));
+  EXPECT_OK(demuxer.Run());
+}
+
+TEST_F(DemuxerTest, CancelBeforeStreamsAreReady) {
+  Demuxer demuxer(GetTestDataFilePath("bear-640x360.ts").AsUTF8Unsafe());
+  demuxer.set_lazy_stream_initialization(true);
+  ASSERT_OK(demuxer.SetHandler("video", some_handler()));
+  demuxer.Cancel();
+  EXPECT_EQ(error::CANCELLED, demuxer.Run().error_code());
+}
+
+TEST_F(DemuxerTest, InvalidSampleRange) {
+  Demuxer demuxer(GetTestDataFilePath("bear-640x360.mp4").AsUTF8Unsafe());
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            demuxer.SetSampleRange("video", 1000, 1000).error_code());
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            demuxer.SetSampleRange("subtitle", 0, 1000).error_code());
+}
+
+TEST_F(DemuxerTest, SampleRange) {
+  const size_t kFirstSample = 10;
+  const size_t kEndSample = 20;
+  // The MP4 parser skips the samples before the range, the TS parser does not.
+  for (const char* test_file : {"bear-640x360-av_frag.mp4", "bear-640x360.mp4",
+                                "bear-640x360.ts"}) {
+    SCOPED_TRACE(test_file);
+    const std::string file_name =
+        GetTestDataFilePath(test_file).AsUTF8Unsafe();
+    Demuxer full_demuxer(file_name);
+    const auto full_samples = GetVideoSamples(&full_demuxer);
+    ASSERT_GT(full_samples.size(), kEndSample);
+    Demuxer range_demuxer(file_name);
+    ASSERT_OK(range_demuxer.SetSampleRange("video",
+                                           full_samples[kFirstSample]->dts(),
+                                           full_samples[kEndSample]->dts()));
+    const auto range_samples = GetVideoSamples(&range_demuxer);
+    ASSERT_EQ(kEndSample - kFirstSample, range_samples.size());
+    for (size_t i = 0; i < range_samples.size(); ++i) {
+      const MediaSample& expected = *full_samples[kFirstSample + i];
+      EXPECT_EQ(expected.dts(), range_samples[i]->dts());
+      EXPECT_EQ(expected.pts(), range_samples[i]->pts());
+      EXPECT_EQ(expected.is_key_frame(), range_samples[i]->is_key_frame());
+      ASSERT_EQ(expected.data_size(), range_samples[i]->data_size());
+      EXPECT_TRUE(std::equal(expected.data(),
+                             expected.data() + expected.data_size(),
+                             range_samples[i]->data()));
+    }
+  }
+}
+
+TEST_F(DemuxerTest, SkipSampleData) {
+  const std::string file_name =
+      GetTestDataFilePath("bear-640x360-av_frag.mp4").AsUTF8Unsafe();
+  Demuxer full_demuxer(file_name);
+  const auto full_samples = GetVideoSamples(&full_demuxer);
+
+  Demuxer demuxer(file_name);
+  demuxer.set_skip_sample_data(true);
+  const auto samples = GetVideoSamples(&demuxer);
+  EXPECT_TRUE(demuxer.skips_sample_data());
+  ASSERT_EQ(full_samples.size(), samples.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    EXPECT_EQ(full_samples[i]->dts(), samples[i]->dts());
+    EXPECT_EQ(full_samples[i]->pts(), samples[i]->pts());
+    EXPECT_EQ(full_samples[i]->is_key_frame(), samples[i]->is_key_frame());
+    EXPECT_EQ(0u, samples[i]->data_size());
+  }
+
+  // The TS parser reads the sample data to find the samples.
+  Demuxer ts_demuxer(GetTestDataFilePath("bear-640x360.ts").AsUTF8Unsafe());
+  ts_demuxer.set_skip_sample_data(true);
+  EXPECT_FALSE(GetVideoSamples(&ts_demuxer).empty());
+  EXPECT_FALSE(ts_demuxer.skips_sample_data());
+}
 
 }  // namespace media
 }  // namespace shaka
@@ -0,0 +1,150 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/event/chunked_muxer_listener.h"
+
+#include "packager/base/logging.h"
+#include "packager/media/base/protection_system_specific_info.h"
+
+namespace shaka {
+namespace media {
+
+class ChunkedMuxerListener::ChunkListener : public MuxerListener {
+ public:
+  ChunkListener(std::shared_ptr<State> state, size_t chunk_index)
+      : state_(std::move(state)),
+        chunk_(&state_->chunks[chunk_index]),
+        // The events of the first chunk are forwarded as they come.
+        forwarding_(chunk_index == 0) {}
+
+  void OnEncryptionInfoReady(bool is_initial_encryption_info,
+                             FourCC protection_scheme,
+                             const std::vector<uint8_t>& key_id,
+                             const std::vector<uint8_t>& iv,
+                             const std::vector<ProtectionSystemSpecificInfo>&
+                                 key_system_info) override {
+    // The initial encryption info is the same for every chunk.
+    if (is_initial_encryption_info && !forwarding_)
+      return;
+    Forward([=](MuxerListener* listener) {
+      listener->OnEncryptionInfoReady(is_initial_encryption_info,
+                                      protection_scheme, key_id, iv,
+                                      key_system_info);
+    });
+  }
+
+  void OnEncryptionStart() override {
+    Forward([](MuxerListener* listener) { listener->OnEncryptionStart(); });
+  }
+
+  void OnMediaStart(const MuxerOptions& muxer_options,
+                    const StreamInfo& stream_info,
+                    uint32_t time_scale,
+                    ContainerType container_type) override {
+    // The output starts with the first chunk.
+    if (forwarding_) {
+      state_->listener->OnMediaStart(muxer_options, stream_info, time_scale,
+                                     container_type);
+    }
+  }
+
+  void OnSampleDurationReady(uint32_t sample_duration) override {
+    if (forwarding_)
+      state_->listener->OnSampleDurationReady(sample_duration);
+  }
+
+  void OnMediaEnd(const MediaRanges& media_ranges,
+                  float duration_seconds) override {
+    // The output ends with the last chunk, see Flush().
+    chunk_->media_ended = true;
+    chunk_->media_ranges = media_ranges;
+    chunk_->duration_seconds = duration_seconds;
+  }
+
+  void OnNewSegment(const std::string& segment_name,
+                    int64_t start_time,
+                    int64_t duration,
+                    uint64_t segment_file_size) override {
+    Forward([=](MuxerListener* listener) {
+      listener->OnNewSegment(segment_name, start_time, duration,
+                             segment_file_size);
+    });
+  }
+
+  void OnKeyFrame(int64_t timestamp,
+                  uint64_t start_byte_offset,
+                  uint64_t size) override {
+    Forward([=](MuxerListener* listener) {
+      listener->OnKeyFrame(timestamp, start_byte_offset, size);
+    });
+  }
+
+  void OnCueEvent(int64_t timestamp, const CueEvent& cue_event) override {
+    Forward([=](MuxerListener* listener) {
+      listener->OnCueEvent(timestamp, cue_event);
+    });
+  }
+
+  void OnSegmentIngestTime(base::TimeTicks ingest_time) override {
+    Forward([=](MuxerListener* listener) {
+      listener->OnSegmentIngestTime(ingest_time);
+    });
+  }
+
+ private:
+  ChunkListener(const ChunkListener&) = delete;
+  ChunkListener& operator=(const ChunkListener&) = delete;
+
+  void Forward(std::function<void(MuxerListener*)> event) {
+    if (forwarding_) {
+      event(state_->listener.get());
+      return;
+    }
+    MuxerListener* listener = state_->listener.get();
+    chunk_->events.push_back([event, listener]() { event(listener); });
+  }
+
+  std::shared_ptr<State> state_;
+  Chunk* chunk_ = nullptr;
+  const bool forwarding_ = false;
+};
+
+ChunkedMuxerListener::ChunkedMuxerListener(
+    std::unique_ptr<MuxerListener> listener,
+    size_t num_chunks)
+    : state_(new State) {
+  DCHECK(listener);
+  DCHECK_GT(num_chunks, 0u);
+  state_->listener = std::move(listener);
+  state_->chunks.resize(num_chunks);
+}
+
+ChunkedMuxerListener::~ChunkedMuxerListener() {}
+
+std::unique_ptr<MuxerListener> ChunkedMuxerListener::CreateChunkListener(
+    size_t chunk_index) {
+  DCHECK_LT(chunk_index, state_->chunks.size());
+  return std::unique_ptr<MuxerListener>(
+      new ChunkListener(state_, chunk_index));
+}
+
+void ChunkedMuxerListener::Flush() {
+  float duration_seconds = 0;
+  for (Chunk& chunk : state_->chunks) {
+    for (const std::function<void()>& event : chunk.events)
+      event();
+    chunk.events.clear();
+    duration_seconds += chunk.duration_seconds;
+  }
+  // The output did not start if the first chunk has no samples.
+  const Chunk& first_chunk = state_->chunks.front();
+  if (first_chunk.media_ended) {
+    state_->listener->OnMediaEnd(first_chunk.media_ranges, duration_seconds);
+  }
+}
+
+}  // namespace media
+}  // namespace shaka
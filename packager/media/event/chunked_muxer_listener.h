@@ -0,0 +1,67 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_EVENT_CHUNKED_MUXER_LISTENER_H_
+#define PACKAGER_MEDIA_EVENT_CHUNKED_MUXER_LISTENER_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "packager/media/event/muxer_listener.h"
+
+namespace shaka {
+namespace media {
+
+/// ChunkedMuxerListener stitches the events of the muxers of the chunks of an
+/// output, which are packaged in parallel, see ParallelVodParams, so that the
+/// listener of the output sees the events of a single muxer. The events of
+/// the first chunk are forwarded as they come. The events of the other chunks
+/// are recorded and forwarded in order by Flush(), followed by OnMediaEnd()
+/// for the whole output.
+class ChunkedMuxerListener {
+ public:
+  /// @param listener is the listener of the output.
+  /// @param num_chunks is the number of chunks of the output.
+  ChunkedMuxerListener(std::unique_ptr<MuxerListener> listener,
+                       size_t num_chunks);
+  ~ChunkedMuxerListener();
+
+  /// @return The listener of the muxer of chunk @a chunk_index. It is only
+  ///         called by that muxer, on the thread of its chunk.
+  std::unique_ptr<MuxerListener> CreateChunkListener(size_t chunk_index);
+
+  /// Forwards the recorded events of the chunks to the listener of the output.
+  /// Must be called after the muxers of all the chunks are finalized.
+  void Flush();
+
+ private:
+  ChunkedMuxerListener(const ChunkedMuxerListener&) = delete;
+  ChunkedMuxerListener& operator=(const ChunkedMuxerListener&) = delete;
+
+  class ChunkListener;
+
+  struct Chunk {
+    // The recorded events, which are forwarded by Flush().
+    std::vector<std::function<void()>> events;
+    bool media_ended = false;
+    MuxerListener::MediaRanges media_ranges;
+    float duration_seconds = 0;
+  };
+
+  // Shared with the chunk listeners, as the muxers own them.
+  struct State {
+    std::unique_ptr<MuxerListener> listener;
+    std::vector<Chunk> chunks;
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_EVENT_CHUNKED_MUXER_LISTENER_H_
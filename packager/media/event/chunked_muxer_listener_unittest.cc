@@ -0,0 +1,102 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/event/chunked_muxer_listener.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "packager/media/base/fourccs.h"
+#include "packager/media/base/muxer_options.h"
+#include "packager/media/base/protection_system_specific_info.h"
+#include "packager/media/event/mock_muxer_listener.h"
+#include "packager/media/event/muxer_listener_test_helper.h"
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::StrictMock;
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+const size_t kNumChunks = 2;
+const uint32_t kTimeScale = 90000;
+const int64_t kDuration = 180000;
+const uint64_t kSegmentFileSize = 1000;
+const float kChunkDurationSeconds = 4;
+const bool kInitialEncryptionInfo = true;
+
+}  // namespace
+
+class ChunkedMuxerListenerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::unique_ptr<StrictMock<MockMuxerListener>> mock_listener(
+        new StrictMock<MockMuxerListener>);
+    mock_listener_ = mock_listener.get();
+    listener_.reset(
+        new ChunkedMuxerListener(std::move(mock_listener), kNumChunks));
+  }
+
+  // Simulates the muxer of a chunk, which has a single segment.
+  void RunChunk(MuxerListener* chunk_listener, size_t chunk_index) {
+    const std::vector<uint8_t> kKeyId(16, 1);
+    const std::vector<uint8_t> kIv(16, 2);
+    chunk_listener->OnEncryptionInfoReady(kInitialEncryptionInfo, FOURCC_cenc,
+                                          kKeyId, kIv, {});
+    std::shared_ptr<StreamInfo> stream_info =
+        CreateVideoStreamInfo(GetDefaultVideoStreamInfoParams());
+    chunk_listener->OnMediaStart(MuxerOptions(), *stream_info, kTimeScale,
+                                 MuxerListener::kContainerMp4);
+    chunk_listener->OnSampleDurationReady(3000);
+    chunk_listener->OnEncryptionStart();
+    chunk_listener->OnNewSegment(SegmentName(chunk_index),
+                                 chunk_index * kDuration, kDuration,
+                                 kSegmentFileSize);
+    chunk_listener->OnMediaEnd(MuxerListener::MediaRanges(),
+                               kChunkDurationSeconds);
+  }
+
+  static std::string SegmentName(size_t chunk_index) {
+    return "video_" + std::to_string(chunk_index + 1) + ".m4s";
+  }
+
+  StrictMock<MockMuxerListener>* mock_listener_ = nullptr;
+  std::unique_ptr<ChunkedMuxerListener> listener_;
+};
+
+TEST_F(ChunkedMuxerListenerTest, StitchesChunksInOrder) {
+  std::unique_ptr<MuxerListener> chunk_listener0 =
+      listener_->CreateChunkListener(0);
+  std::unique_ptr<MuxerListener> chunk_listener1 =
+      listener_->CreateChunkListener(1);
+
+  // The second chunk completes first, but its events are held back.
+  RunChunk(chunk_listener1.get(), 1);
+
+  InSequence s;
+  EXPECT_CALL(*mock_listener_,
+              OnEncryptionInfoReady(kInitialEncryptionInfo, _, _, _, _));
+  EXPECT_CALL(*mock_listener_, OnMediaStart(_, _, kTimeScale, _));
+  EXPECT_CALL(*mock_listener_, OnSampleDurationReady(3000));
+  EXPECT_CALL(*mock_listener_, OnEncryptionStart());
+  EXPECT_CALL(*mock_listener_,
+              OnNewSegment(SegmentName(0), 0, kDuration, kSegmentFileSize));
+  RunChunk(chunk_listener0.get(), 0);
+
+  EXPECT_CALL(*mock_listener_, OnEncryptionStart());
+  EXPECT_CALL(*mock_listener_, OnNewSegment(SegmentName(1), kDuration,
+                                            kDuration, kSegmentFileSize));
+  EXPECT_CALL(*mock_listener_,
+              OnMediaEndMock(_, _, _, _, _, _, _, _,
+                             kNumChunks * kChunkDurationSeconds));
+  listener_->Flush();
+}
+
+}  // namespace media
+}  // namespace shaka
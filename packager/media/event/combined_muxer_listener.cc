@@ -83,5 +83,17 @@ void CombinedMuxerListener::OnCueEvent(int64_t timestamp,
   }
 }
 
+void CombinedMuxerListener::OnSegmentIngestTime(base::TimeTicks ingest_time) {
+  for (auto& listener : muxer_listeners_) {
+    listener->OnSegmentIngestTime(ingest_time);
+  }
+}
+
+void CombinedMuxerListener::OnMediaRemoved() {
+  for (auto& listener : muxer_listeners_) {
+    listener->OnMediaRemoved();
+  }
+}
+
 }  // namespace media
 }  // namespace shaka
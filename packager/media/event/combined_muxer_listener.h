@@ -43,7 +43,8 @@ class CombinedMuxerListener : public MuxerListener {
   void OnKeyFrame(int64_t timestamp, uint64_t start_byte_offset, uint64_t size);
   //void OnCueEvent(int64_t timestamp, const std::string& cue_data) override;
   void OnCueEvent(int64_t timestamp, const CueEvent& cue_event) override;
-   
+  void OnSegmentIngestTime(base::TimeTicks ingest_time) override;
+  void OnMediaRemoved() override;
 
 
  private:
@@ -258,6 +258,16 @@ void HlsNotifyMuxerListener::OnCueEvent(int64_t timestamp,
   }
 }
 
+void HlsNotifyMuxerListener::OnMediaRemoved() {
+  if (!stream_id_)
+    return;
+  if (!hls_notifier_->NotifyStreamRemoved(stream_id_.value())) {
+    LOG(WARNING) << "Failed to remove stream " << stream_id_.value();
+    return;
+  }
+  stream_id_.reset();
+}
+
 bool HlsNotifyMuxerListener::NotifyNewStream() {
   DCHECK(media_info_);
 
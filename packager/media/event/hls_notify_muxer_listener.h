@@ -70,6 +70,7 @@ class HlsNotifyMuxerListener : public MuxerListener {
                     uint64_t segment_file_size) override;
   void OnKeyFrame(int64_t timestamp, uint64_t start_byte_offset, uint64_t size);
   void OnCueEvent(int64_t timestamp, const CueEvent& cue_event) override;
+  void OnMediaRemoved() override;
   
   /// @}
 
@@ -58,6 +58,7 @@ class MockHlsNotifier : public hls::HlsNotifier {
            const std::vector<uint8_t>& system_id,
            const std::vector<uint8_t>& iv,
            const std::vector<uint8_t>& protection_system_specific_data));
+  MOCK_METHOD1(NotifyStreamRemoved, bool(uint32_t stream_id));
   MOCK_METHOD0(Flush, bool());
 };
 
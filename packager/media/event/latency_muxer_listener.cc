@@ -0,0 +1,46 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/event/latency_muxer_listener.h"
+
+#include "packager/base/logging.h"
+
+namespace shaka {
+namespace media {
+
+LatencyMuxerListener::LatencyMuxerListener(
+    std::shared_ptr<SegmentLatencyStats> stats)
+    : stats_(std::move(stats)) {
+  DCHECK(stats_);
+}
+
+LatencyMuxerListener::~LatencyMuxerListener() {}
+
+void LatencyMuxerListener::OnNewSegment(const std::string& file_name,
+                                        int64_t start_time,
+                                        int64_t duration,
+                                        uint64_t segment_file_size) {
+  const base::TimeTicks segment_time = base::TimeTicks::Now();
+  CombinedMuxerListener::OnNewSegment(file_name, start_time, duration,
+                                      segment_file_size);
+  // Subsegments of single segment outputs are also notified through
+  // OnNewSegment(), without an ingest time.
+  if (segment_ingest_time_.is_null())
+    return;
+  const base::TimeTicks manifest_time = base::TimeTicks::Now();
+  stats_->ingest_to_segment.Record(segment_time - segment_ingest_time_);
+  stats_->segment_to_manifest.Record(manifest_time - segment_time);
+  stats_->ingest_to_manifest.Record(manifest_time - segment_ingest_time_);
+  segment_ingest_time_ = base::TimeTicks();
+}
+
+void LatencyMuxerListener::OnSegmentIngestTime(base::TimeTicks ingest_time) {
+  CombinedMuxerListener::OnSegmentIngestTime(ingest_time);
+  segment_ingest_time_ = ingest_time;
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,68 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_EVENT_LATENCY_MUXER_LISTENER_H_
+#define PACKAGER_MEDIA_EVENT_LATENCY_MUXER_LISTENER_H_
+
+#include <memory>
+#include <string>
+
+#include "packager/media/base/latency_histogram.h"
+#include "packager/media/event/combined_muxer_listener.h"
+
+namespace shaka {
+namespace media {
+
+/// Per segment latencies of a stream. Updated by LatencyMuxerListener and can
+/// be read from any thread.
+struct SegmentLatencyStats {
+  explicit SegmentLatencyStats(const std::string& stream_name)
+      : stream_name(stream_name) {}
+
+  /// Name identifying the stream, e.g. its segment template.
+  const std::string stream_name;
+  /// From the ingest of the earliest sample of a segment to the segment being
+  /// written.
+  LatencyHistogram ingest_to_segment;
+  /// From the segment being written to the manifests being updated.
+  LatencyHistogram segment_to_manifest;
+  /// From the ingest of the earliest sample of a segment to the manifests
+  /// being updated.
+  LatencyHistogram ingest_to_manifest;
+};
+
+/// A CombinedMuxerListener which also measures how long segments take from
+/// ingest to publication. A segment is considered written when OnNewSegment()
+/// is called and its manifests updated when the combined listeners return
+/// from OnNewSegment(), which is the case for live DASH and HLS.
+class LatencyMuxerListener : public CombinedMuxerListener {
+ public:
+  /// @param stats receives the latencies of the segments.
+  explicit LatencyMuxerListener(std::shared_ptr<SegmentLatencyStats> stats);
+  ~LatencyMuxerListener() override;
+
+  /// @name MuxerListener implementation overrides.
+  /// @{
+  void OnNewSegment(const std::string& file_name,
+                    int64_t start_time,
+                    int64_t duration,
+                    uint64_t segment_file_size) override;
+  void OnSegmentIngestTime(base::TimeTicks ingest_time) override;
+  /// @}
+
+ private:
+  LatencyMuxerListener(const LatencyMuxerListener&) = delete;
+  LatencyMuxerListener& operator=(const LatencyMuxerListener&) = delete;
+
+  std::shared_ptr<SegmentLatencyStats> stats_;
+  // Ingest time of the segment to be notified in the next OnNewSegment().
+  base::TimeTicks segment_ingest_time_;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_EVENT_LATENCY_MUXER_LISTENER_H_
@@ -0,0 +1,90 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/event/latency_muxer_listener.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "packager/base/threading/platform_thread.h"
+#include "packager/media/event/mock_muxer_listener.h"
+
+using ::testing::_;
+using ::testing::InvokeWithoutArgs;
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+const char kStreamName[] = "video_$Number$.m4s";
+const char kSegmentName[] = "video_1.m4s";
+const int64_t kStartTime = 0;
+const int64_t kDuration = 180000;
+const uint64_t kSegmentFileSize = 1000;
+const int64_t kIngestDelayInMilliseconds = 30;
+const int64_t kManifestDelayInMilliseconds = 10;
+
+}  // namespace
+
+class LatencyMuxerListenerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    stats_.reset(new SegmentLatencyStats(kStreamName));
+    listener_.reset(new LatencyMuxerListener(stats_));
+    std::unique_ptr<MockMuxerListener> mock_listener(new MockMuxerListener);
+    mock_listener_ = mock_listener.get();
+    listener_->AddListener(std::move(mock_listener));
+  }
+
+  std::shared_ptr<SegmentLatencyStats> stats_;
+  std::unique_ptr<LatencyMuxerListener> listener_;
+  MockMuxerListener* mock_listener_ = nullptr;
+};
+
+TEST_F(LatencyMuxerListenerTest, RecordsLatencies) {
+  // Simulates the time to update the manifests.
+  EXPECT_CALL(*mock_listener_, OnNewSegment(kSegmentName, kStartTime,
+                                            kDuration, kSegmentFileSize))
+      .WillOnce(InvokeWithoutArgs([]() {
+        base::PlatformThread::Sleep(
+            base::TimeDelta::FromMilliseconds(kManifestDelayInMilliseconds));
+      }));
+
+  listener_->OnSegmentIngestTime(
+      base::TimeTicks::Now() -
+      base::TimeDelta::FromMilliseconds(kIngestDelayInMilliseconds));
+  listener_->OnNewSegment(kSegmentName, kStartTime, kDuration,
+                          kSegmentFileSize);
+
+  EXPECT_EQ(kStreamName, stats_->stream_name);
+  ASSERT_EQ(1u, stats_->ingest_to_segment.count());
+  ASSERT_EQ(1u, stats_->segment_to_manifest.count());
+  ASSERT_EQ(1u, stats_->ingest_to_manifest.count());
+  EXPECT_GE(stats_->ingest_to_segment.max().InMilliseconds(),
+            kIngestDelayInMilliseconds);
+  EXPECT_GE(stats_->segment_to_manifest.max().InMilliseconds(),
+            kManifestDelayInMilliseconds);
+  EXPECT_GE(stats_->ingest_to_manifest.max().InMilliseconds(),
+            kIngestDelayInMilliseconds + kManifestDelayInMilliseconds);
+}
+
+TEST_F(LatencyMuxerListenerTest, IgnoresSegmentsWithoutIngestTime) {
+  EXPECT_CALL(*mock_listener_, OnNewSegment(_, _, _, _)).Times(2);
+
+  listener_->OnSegmentIngestTime(base::TimeTicks::Now());
+  listener_->OnNewSegment(kSegmentName, kStartTime, kDuration,
+                          kSegmentFileSize);
+  // The ingest time only applies to the following segment.
+  listener_->OnNewSegment(kSegmentName, kStartTime + kDuration, kDuration,
+                          kSegmentFileSize);
+
+  EXPECT_EQ(1u, stats_->ingest_to_segment.count());
+  EXPECT_EQ(1u, stats_->ingest_to_manifest.count());
+}
+
+}  // namespace media
+}  // namespace shaka
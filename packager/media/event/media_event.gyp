@@ -13,11 +13,15 @@
       'target_name': 'media_event',
       'type': '<(component)',
       'sources': [
+        'chunked_muxer_listener.cc',
+        'chunked_muxer_listener.h',
         'combined_muxer_listener.cc',
         'combined_muxer_listener.h',
         'event_info.h',
         'hls_notify_muxer_listener.cc',
         'hls_notify_muxer_listener.h',
+        'latency_muxer_listener.cc',
+        'latency_muxer_listener.h',
         'mpd_notify_muxer_listener.cc',
         'mpd_notify_muxer_listener.h',
         'muxer_listener.h',
@@ -30,6 +34,7 @@
       ],
       'dependencies': [
         '../../file/file.gyp:file',
+        '../../mpd/mpd.gyp:binary_media_info',
         '../../mpd/mpd.gyp:media_info_proto',
         # Depends on full protobuf to read/write with TextFormat.
         '../../third_party/protobuf/protobuf.gyp:protobuf_full_do_not_use',
@@ -53,7 +58,9 @@
       'target_name': 'media_event_unittest',
       'type': '<(gtest_target_type)',
       'sources': [
+        'chunked_muxer_listener_unittest.cc',
         'hls_notify_muxer_listener_unittest.cc',
+        'latency_muxer_listener_unittest.cc',
         'mpd_notify_muxer_listener_unittest.cc',
         'muxer_listener_test_helper.cc',
         'muxer_listener_test_helper.h',
@@ -69,6 +76,7 @@
         '../../third_party/protobuf/protobuf.gyp:protobuf_full_do_not_use',
         '../test/media_test.gyp:run_tests_with_atexit_manager',
         'media_event',
+        'mock_muxer_listener',
       ],
     },
   ],
@@ -206,6 +206,18 @@ void MpdNotifyMuxerListener::OnCueEvent(int64_t timestamp,
   }
 }
 
+void MpdNotifyMuxerListener::OnMediaRemoved() {
+  if (!notification_id_)
+    return;
+  if (!mpd_notifier_->NotifyContainerRemoved(notification_id_.value())) {
+    LOG(WARNING) << "Failed to remove container " << notification_id_.value();
+    return;
+  }
+  notification_id_.reset();
+  if (mpd_notifier_->mpd_type() == MpdType::kDynamic)
+    mpd_notifier_->Flush();
+}
+
 bool MpdNotifyMuxerListener::NotifyNewContainer() {
   uint32_t notification_id;
   if (!mpd_notifier_->NotifyNewContainer(*media_info_, &notification_id)) {
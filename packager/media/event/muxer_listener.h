@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "packager/base/optional.h"
+#include "packager/base/time/time.h"
 #include "packager/media/base/fourccs.h"
 #include "packager/media/base/range.h"
 #include "packager/media/base/media_handler.h"
@@ -145,6 +146,19 @@ class MuxerListener {
   //virtual void OnCueEvent(int64_t timestamp, const std::string& cue_data) = 0;
   virtual void OnCueEvent(int64_t timestamp, const CueEvent& event) = 0;
 
+  /// Called before OnNewSegment() for every segment, but not subsegment, with
+  /// the earliest ingest time of the samples in the segment. Not called if the
+  /// ingest time is unknown. Used for live latency accounting; the default
+  /// implementation does nothing.
+  /// @param ingest_time is the time the earliest sample was read from the
+  ///        input, see MediaSample::ingest_time().
+  virtual void OnSegmentIngestTime(base::TimeTicks ingest_time) {}
+
+  /// Called after OnMediaEnd() if the stream is removed while packaging, e.g.
+  /// by Packager::RemoveStream(), so it is no longer advertised in manifests.
+  /// The default implementation does nothing.
+  virtual void OnMediaRemoved() {}
+
  protected:
   MuxerListener() = default;
 };
@@ -10,9 +10,11 @@
 #include "packager/hls/base/hls_notifier.h"
 #include "packager/media/event/combined_muxer_listener.h"
 #include "packager/media/event/hls_notify_muxer_listener.h"
+#include "packager/media/event/latency_muxer_listener.h"
 #include "packager/media/event/mpd_notify_muxer_listener.h"
 #include "packager/media/event/muxer_listener.h"
 #include "packager/media/event/vod_media_info_dump_muxer_listener.h"
+#include "packager/mpd/base/binary_media_info.h"
 #include "packager/mpd/base/mpd_notifier.h"
 
 namespace shaka {
@@ -21,11 +23,13 @@ namespace {
 const char kMediaInfoSuffix[] = ".media_info";
 
 std::unique_ptr<MuxerListener> CreateMediaInfoDumpListenerInternal(
-    const std::string& output) {
+    const std::string& output,
+    bool output_binary_media_info) {
   DCHECK(!output.empty());
 
-  std::unique_ptr<MuxerListener> listener(
-      new VodMediaInfoDumpMuxerListener(output + kMediaInfoSuffix));
+  std::unique_ptr<MuxerListener> listener(new VodMediaInfoDumpMuxerListener(
+      output + kMediaInfoSuffix,
+      output_binary_media_info ? output + kBinaryMediaInfoSuffix : ""));
   return listener;
 }
 
@@ -73,9 +77,11 @@ std::list<std::unique_ptr<MuxerListener>> CreateHlsListenersInternal(
 }  // namespace
 
 MuxerListenerFactory::MuxerListenerFactory(bool output_media_info,
+                                           bool output_binary_media_info,
                                            MpdNotifier* mpd_notifier,
                                            hls::HlsNotifier* hls_notifier)
     : output_media_info_(output_media_info),
+      output_binary_media_info_(output_binary_media_info),
       mpd_notifier_(mpd_notifier),
       hls_notifier_(hls_notifier) {}
 
@@ -83,12 +89,19 @@ std::unique_ptr<MuxerListener> MuxerListenerFactory::CreateListener(
     const StreamData& stream) {
   const int stream_index = stream_index_++;
 
-  std::unique_ptr<CombinedMuxerListener> combined_listener(
-      new CombinedMuxerListener);
+  std::unique_ptr<CombinedMuxerListener> combined_listener;
+  if (enable_latency_stats_) {
+    latency_stats_.emplace_back(
+        new SegmentLatencyStats(stream.latency_stats_name));
+    combined_listener.reset(new LatencyMuxerListener(latency_stats_.back()));
+  } else {
+    combined_listener.reset(new CombinedMuxerListener);
+  }
 
   if (output_media_info_) {
     combined_listener->AddListener(
-        CreateMediaInfoDumpListenerInternal(stream.media_info_output));
+        CreateMediaInfoDumpListenerInternal(stream.media_info_output,
+                                            output_binary_media_info_));
   }
   if (mpd_notifier_) {
     combined_listener->AddListener(CreateMpdListenerInternal(mpd_notifier_));
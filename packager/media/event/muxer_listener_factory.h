@@ -20,6 +20,7 @@ class HlsNotifier;
 
 namespace media {
 class MuxerListener;
+struct SegmentLatencyStats;
 
 /// Factory class for creating MuxerListeners. Will produce a single muxer
 /// listener that will wrap the various muxer listeners that the factory
@@ -46,22 +47,40 @@ class MuxerListenerFactory {
     std::string hls_playlist_name;
     std::string hls_iframe_playlist_name;
     std::vector<std::string> hls_characteristics;
+
+    // A name identifying the stream in latency statistics. Will only be used
+    // if latency statistics are enabled.
+    std::string latency_stats_name;
   };
 
   /// Create a new muxer listener.
   /// @param output_media_info must be true for the combined listener to include
   ///        a media info dump listener.
+  /// @param output_binary_media_info indicates whether the media info dump
+  ///        listener also writes MediaInfo in protobuf binary wire format.
   /// @param mpd_notifer must be non-null for the combined listener to include a
   ///        mpd listener.
   /// @param hls_notifier must be non-null for the combined listener to include
   ///        an HLS listener.
   MuxerListenerFactory(bool output_media_info,
+                       bool output_binary_media_info,
                        MpdNotifier* mpd_notifier,
                        hls::HlsNotifier* hls_notifier);
 
+  /// Measure the latency of the segments of every listener created by
+  /// CreateListener() from now on, see LatencyMuxerListener.
+  void EnableLatencyStats() { enable_latency_stats_ = true; }
+
   /// Create a listener for a stream.
   std::unique_ptr<MuxerListener> CreateListener(const StreamData& stream);
 
+  /// @return The latency statistics of the listeners created with latency
+  ///         statistics enabled.
+  const std::vector<std::shared_ptr<SegmentLatencyStats>>& latency_stats()
+      const {
+    return latency_stats_;
+  }
+
   /// Create an HLS listener if possible. If it is not possible to
   /// create an HLS listener, this method will return null.
   std::unique_ptr<MuxerListener> CreateHlsListener(const StreamData& stream);
@@ -71,8 +90,11 @@ class MuxerListenerFactory {
   MuxerListenerFactory operator=(const MuxerListenerFactory&) = delete;
 
   bool output_media_info_;
+  bool output_binary_media_info_;
   MpdNotifier* mpd_notifier_;
   hls::HlsNotifier* hls_notifier_;
+  bool enable_latency_stats_ = false;
+  std::vector<std::shared_ptr<SegmentLatencyStats>> latency_stats_;
 
   // A counter to track which stream we are on.
   int stream_index_ = 0;
@@ -16,6 +16,7 @@
 #include "packager/media/base/protection_system_specific_info.h"
 #include "packager/media/base/stream_info.h"
 #include "packager/media/event/muxer_listener_internal.h"
+#include "packager/mpd/base/binary_media_info.h"
 #include "packager/mpd/base/media_info.pb.h"
 
 namespace shaka {
@@ -25,6 +26,12 @@ VodMediaInfoDumpMuxerListener::VodMediaInfoDumpMuxerListener(
     const std::string& output_file_path)
     : output_file_name_(output_file_path) {}
 
+VodMediaInfoDumpMuxerListener::VodMediaInfoDumpMuxerListener(
+    const std::string& output_file_path,
+    const std::string& binary_output_file_path)
+    : output_file_name_(output_file_path),
+      binary_output_file_name_(binary_output_file_path) {}
+
 VodMediaInfoDumpMuxerListener::~VodMediaInfoDumpMuxerListener() {}
 
 void VodMediaInfoDumpMuxerListener::OnEncryptionInfoReady(
@@ -62,6 +69,12 @@ void VodMediaInfoDumpMuxerListener::OnMediaStart(
     internal::SetContentProtectionFields(protection_scheme_, default_key_id_,
                                          key_system_info_, media_info_.get());
   }
+
+  if (!binary_output_file_name_.empty()) {
+    binary_writer_.reset(new BinaryMediaInfoWriter);
+    if (!binary_writer_->Open(binary_output_file_name_))
+      binary_writer_.reset();
+  }
 }
 
 void VodMediaInfoDumpMuxerListener::OnEncryptionStart() {}
@@ -85,6 +98,11 @@ void VodMediaInfoDumpMuxerListener::OnMediaEnd(const MediaRanges& media_ranges,
   if (!media_info_->has_bandwidth())
     media_info_->set_bandwidth(max_bitrate_);
   WriteMediaInfoToFile(*media_info_, output_file_name_);
+  if (binary_writer_) {
+    if (!binary_writer_->Finalize(*media_info_))
+      LOG(ERROR) << "Failed to write " << binary_output_file_name_;
+    binary_writer_.reset();
+  }
 }
 
 void VodMediaInfoDumpMuxerListener::OnNewSegment(const std::string& file_name,
@@ -98,6 +116,13 @@ void VodMediaInfoDumpMuxerListener::OnNewSegment(const std::string& file_name,
   const uint64_t bitrate =
       ceil(kBitsInByte * segment_file_size / segment_duration_seconds);
   max_bitrate_ = std::max(max_bitrate_, bitrate);
+
+  if (binary_writer_ &&
+      !binary_writer_->AddSegment(start_time, duration, segment_file_size)) {
+    LOG(ERROR) << "Failed to write segment index to "
+               << binary_output_file_name_;
+    binary_writer_.reset();
+  }
 }
 
 void VodMediaInfoDumpMuxerListener::OnKeyFrame(int64_t timestamp,
@@ -137,5 +162,13 @@ bool VodMediaInfoDumpMuxerListener::WriteMediaInfoToFile(
   return true;
 }
 
+// static
+bool VodMediaInfoDumpMuxerListener::WriteMediaInfoToBinaryFile(
+    const MediaInfo& media_info,
+    const std::string& output_file_path) {
+  BinaryMediaInfoWriter writer;
+  return writer.Open(output_file_path) && writer.Finalize(media_info);
+}
+
 }  // namespace media
 }  // namespace shaka
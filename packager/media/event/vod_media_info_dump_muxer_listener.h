@@ -21,6 +21,7 @@
 
 namespace shaka {
 
+class BinaryMediaInfoWriter;
 class MediaInfo;
 
 namespace media {
@@ -28,6 +29,12 @@ namespace media {
 class VodMediaInfoDumpMuxerListener : public MuxerListener {
  public:
   VodMediaInfoDumpMuxerListener(const std::string& output_file_name);
+  /// @param output_file_name is the human readable MediaInfo output file.
+  /// @param binary_output_file_name is the binary MediaInfo dump output file.
+  ///        The segment index is streamed to it as segments complete. No
+  ///        binary output is written if it is empty.
+  VodMediaInfoDumpMuxerListener(const std::string& output_file_name,
+                                const std::string& binary_output_file_name);
   ~VodMediaInfoDumpMuxerListener() override;
 
   /// @name MuxerListener implementation overrides.
@@ -63,9 +70,19 @@ class VodMediaInfoDumpMuxerListener : public MuxerListener {
   static bool WriteMediaInfoToFile(const MediaInfo& media_info,
                                    const std::string& output_file_path);
 
+  /// Write @a media_info to @a output_file_path as a binary MediaInfo dump
+  /// without segment index.
+  /// @param media_info is the MediaInfo to write out.
+  /// @param output_file_path is the path of the output file.
+  /// @return true on success, false otherwise.
+  static bool WriteMediaInfoToBinaryFile(const MediaInfo& media_info,
+                                         const std::string& output_file_path);
+
  private:
   std::string output_file_name_;
+  std::string binary_output_file_name_;
   std::unique_ptr<MediaInfo> media_info_;
+  std::unique_ptr<BinaryMediaInfoWriter> binary_writer_;
   uint64_t max_bitrate_ = 0;
 
   bool is_encrypted_ = false;
@@ -19,6 +19,7 @@
 #include "packager/media/base/video_stream_info.h"
 #include "packager/media/event/muxer_listener_test_helper.h"
 #include "packager/media/event/vod_media_info_dump_muxer_listener.h"
+#include "packager/mpd/base/binary_media_info.h"
 #include "packager/mpd/base/media_info.pb.h"
 
 namespace {
@@ -274,5 +275,49 @@ TEST_F(VodMediaInfoDumpMuxerListenerTest, CheckBandwidth) {
               FileContentEqualsProto(kExpectedProtobufOutput));
 }
 
+// Verify that the binary output, if requested, has the same MediaInfo as the
+// text output and the segment index.
+TEST_F(VodMediaInfoDumpMuxerListenerTest, BinaryOutput) {
+  const std::string binary_file_path =
+      temp_file_path_.AsUTF8Unsafe() + ".media_info.pb";
+  listener_.reset(new VodMediaInfoDumpMuxerListener(
+      temp_file_path_.AsUTF8Unsafe(), binary_file_path));
+
+  std::shared_ptr<StreamInfo> stream_info =
+      CreateVideoStreamInfo(GetDefaultVideoStreamInfoParams());
+  FireOnMediaStartWithDefaultMuxerOptions(*stream_info, kEnableEncryption);
+  OnNewSegmentParameters new_segment_param;
+  new_segment_param.start_time = 0;
+  new_segment_param.duration = 1000;
+  new_segment_param.segment_file_size = 100;
+  FireOnNewSegmentWithParams(new_segment_param);
+  new_segment_param.start_time = 1000;
+  new_segment_param.segment_file_size = 200;
+  FireOnNewSegmentWithParams(new_segment_param);
+  FireOnMediaEndWithParams(GetDefaultOnMediaEndParams());
+
+  std::string text_media_info_str;
+  ASSERT_TRUE(File::ReadFileToString(temp_file_path_.AsUTF8Unsafe().c_str(),
+                                     &text_media_info_str));
+  MediaInfo text_media_info;
+  ASSERT_TRUE(::google::protobuf::TextFormat::ParseFromString(
+      text_media_info_str, &text_media_info));
+
+  BinaryMediaInfoReader reader;
+  ASSERT_TRUE(reader.Open(binary_file_path));
+  MediaInfo binary_media_info;
+  ASSERT_TRUE(reader.ReadMediaInfo(&binary_media_info));
+  EXPECT_TRUE(::google::protobuf::util::MessageDifferencer::Equals(
+      text_media_info, binary_media_info));
+
+  std::vector<BinaryMediaInfoReader::Segment> segments;
+  ASSERT_TRUE(reader.ReadSegments(&segments));
+  ASSERT_EQ(2u, segments.size());
+  EXPECT_EQ(1000, segments[1].start_time);
+  EXPECT_EQ(1000, segments[1].duration);
+  EXPECT_EQ(200u, segments[1].size);
+  File::Delete(binary_file_path.c_str());
+}
+
 }  // namespace media
 }  // namespace shaka
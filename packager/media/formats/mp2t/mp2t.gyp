@@ -63,6 +63,7 @@
       ],
       'dependencies': [
         '../../base/media_base.gyp:media_base',
+        '../../../packager.gyp:trace_event',
         '../../crypto/crypto.gyp:crypto',
         '../../codecs/codecs.gyp:codecs',
       ],
@@ -90,5 +91,19 @@
         'mp2t',
       ]
     },
+    {
+      'target_name': 'mp2t_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'mp2t_media_parser_perftest.cc',
+      ],
+      'dependencies': [
+        '../../../base/base.gyp:base',
+        '../../../testing/gtest.gyp:gtest',
+        '../../../testing/perf/perf_test.gyp:perf_test',
+        '../../test/media_test.gyp:media_test_support',
+        'mp2t',
+      ],
+    },
   ],
 }
@@ -181,6 +181,13 @@ void Mp2tMediaParser::SetSignalCallback(
   new_signal_cb_ = new_signal_cb;
 }
 
+void Mp2tMediaParser::EnableLazyInitialization(
+    const NewStreamInfoCB& new_stream_info_cb) {
+  DCHECK(!is_initialized_);
+  DCHECK(!new_stream_info_cb.is_null());
+  new_stream_info_cb_ = new_stream_info_cb;
+}
+
 bool Mp2tMediaParser::Flush() {
   DVLOG(1) << "Mp2tMediaParser::Flush";
 
@@ -381,10 +388,30 @@ void Mp2tMediaParser::OnNewStreamInfo(
   }
 
   // Set the stream configuration information for the PID.
+  const bool first_config = !pid_state->second->config();
   pid_state->second->set_config(new_stream_info);
 
   // Finish initialization if all streams have configs.
   FinishInitializationIfNeeded();
+
+  // Otherwise start the stream right away in lazy initialization. The
+  // elementary streams are all registered with the PMT, so the position of
+  // the stream is known already.
+  if (is_initialized_ || !first_config || new_stream_info_cb_.is_null())
+    return;
+  const PidState::PidType pid_type = pid_state->second->pid_type();
+  size_t stream_position = 0;
+  bool first_of_type = true;
+  for (PidMap::const_iterator iter = pids_.begin(); iter != pid_state;
+       ++iter) {
+    if ((iter->second->pid_type() == PidState::kPidAudioPes) ||
+        (iter->second->pid_type() == PidState::kPidVideoPes)) {
+      ++stream_position;
+      if (iter->second->pid_type() == pid_type)
+        first_of_type = false;
+    }
+  }
+  new_stream_info_cb_.Run(stream_position, first_of_type, new_stream_info);
 }
 
 bool Mp2tMediaParser::FinishInitializationIfNeeded() {
@@ -445,13 +472,17 @@ void Mp2tMediaParser::OnEmitSample(
 bool Mp2tMediaParser::EmitRemainingSamples() {
   DVLOG(LOG_LEVEL_ES) << "Mp2tMediaParser::EmitRemainingBuffers";
 
-  // No buffer should be sent until fully initialized.
-  if (!is_initialized_)
+  // No buffer should be sent until fully initialized, or until the stream is
+  // initialized in lazy initialization.
+  const bool lazy_initialization = !new_stream_info_cb_.is_null();
+  if (!is_initialized_ && !lazy_initialization)
     return true;
 
   // Buffer emission.
   for (PidMap::const_iterator pid_iter = pids_.begin(); pid_iter != pids_.end();
        ++pid_iter) {
+    if (!is_initialized_ && !pid_iter->second->config())
+      continue;
     SampleQueue& sample_queue = pid_iter->second->sample_queue();
     for (SampleQueue::iterator sample_iter = sample_queue.begin();
          sample_iter != sample_queue.end();
@@ -39,6 +39,18 @@ class Mp2tMediaParser : public MediaParser {
   typedef base::Callback<void(const std::shared_ptr<Scte35Event>& signal)>
       NewSignalCB;
 
+  /// Called in lazy initialization when the stream info of an elementary
+  /// stream is available while the stream info of other streams is pending.
+  /// @param stream_position is the position of the stream in the stream info
+  ///        list passed to InitCB later.
+  /// @param first_of_type is true if no stream of the same type comes before
+  ///        the stream in that list.
+  /// @param stream_info is the stream info of the stream.
+  typedef base::Callback<void(size_t stream_position,
+                              bool first_of_type,
+                              const std::shared_ptr<StreamInfo>& stream_info)>
+      NewStreamInfoCB;
+
 
   /// @name MediaParser implementation overrides.
   /// @{
@@ -51,6 +63,13 @@ class Mp2tMediaParser : public MediaParser {
 
   void SetSignalCallback(const NewSignalCB& new_signal_cb);
 
+  /// Enables lazy initialization: the stream info of every elementary stream
+  /// is passed to @a new_stream_info_cb as soon as it is available, and the
+  /// samples of the stream are emitted from then on, instead of waiting for
+  /// the stream info of all the streams, e.g. of a sparse audio stream. InitCB
+  /// is still called once all the stream info is available.
+  void EnableLazyInitialization(const NewStreamInfoCB& new_stream_info_cb);
+
  private:
   typedef std::map<int, std::unique_ptr<PidState>> PidMap;
 
@@ -92,6 +111,8 @@ class Mp2tMediaParser : public MediaParser {
   InitCB init_cb_;
   NewSampleCB new_sample_cb_;
   NewSignalCB new_signal_cb_;
+  // Set in lazy initialization.
+  NewStreamInfoCB new_stream_info_cb_;
 
   bool sbr_in_mimetype_;
 
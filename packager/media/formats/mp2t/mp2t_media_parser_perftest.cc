@@ -0,0 +1,77 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures Mp2tMediaParser::Parse throughput.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "packager/base/bind.h"
+#include "packager/base/time/time.h"
+#include "packager/media/base/media_sample.h"
+#include "packager/media/base/stream_info.h"
+#include "packager/media/formats/mp2t/mp2t_media_parser.h"
+#include "packager/media/test/test_data_util.h"
+#include "packager/testing/perf/perf_test.h"
+
+namespace shaka {
+namespace media {
+namespace mp2t {
+
+namespace {
+
+const int kNumIterations = 50;
+// Data is appended in chunks of this size, like reading from a file.
+const size_t kChunkSize = 64 * 1024;
+
+void OnInit(const std::vector<std::shared_ptr<StreamInfo>>& stream_infos) {}
+
+bool OnNewSample(size_t* num_samples,
+                 uint32_t track_id,
+                 const std::shared_ptr<MediaSample>& sample) {
+  ++*num_samples;
+  return true;
+}
+
+void RunParse(const std::string& file_name) {
+  const std::vector<uint8_t> buffer = ReadTestDataFile(file_name);
+  ASSERT_FALSE(buffer.empty());
+
+  size_t num_samples = 0;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    Mp2tMediaParser parser;
+    parser.Init(base::Bind(&OnInit),
+                base::Bind(&OnNewSample, base::Unretained(&num_samples)),
+                nullptr);
+    for (size_t offset = 0; offset < buffer.size(); offset += kChunkSize) {
+      const size_t size = std::min(kChunkSize, buffer.size() - offset);
+      ASSERT_TRUE(parser.Parse(buffer.data() + offset, static_cast<int>(size)));
+    }
+    ASSERT_TRUE(parser.Flush());
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  ASSERT_GT(num_samples, 0u);
+  perf_test::PrintResult(
+      "mp2t_parse_throughput", "", file_name,
+      buffer.size() * kNumIterations / elapsed.InSecondsF() / (1024 * 1024),
+      "MB/s", true);
+}
+
+}  // namespace
+
+TEST(Mp2tMediaParserPerfTest, H264Aac) {
+  RunParse("bear-640x360.ts");
+}
+
+TEST(Mp2tMediaParserPerfTest, H265Aac) {
+  RunParse("bear-640x360-hevc.ts");
+}
+
+}  // namespace mp2t
+}  // namespace media
+}  // namespace shaka
@@ -41,6 +41,9 @@ class Mp2tMediaParserTest : public testing::Test {
   int video_frame_count_;
   int64_t video_min_dts_;
   int64_t video_max_dts_;
+  // Streams started in lazy initialization, keyed by stream position.
+  std::map<size_t, std::shared_ptr<StreamInfo>> lazy_streams_;
+  std::vector<std::shared_ptr<StreamInfo>> init_stream_infos_;
 
   bool AppendData(const uint8_t* data, size_t length) {
     return parser_->Parse(data, static_cast<int>(length));
@@ -63,12 +66,21 @@ class Mp2tMediaParserTest : public testing::Test {
 
   void OnInit(const std::vector<std::shared_ptr<StreamInfo>>& stream_infos) {
     DVLOG(1) << "OnInit: " << stream_infos.size() << " streams.";
+    init_stream_infos_ = stream_infos;
     for (const auto& stream_info : stream_infos) {
       DVLOG(1) << stream_info->ToString();
       stream_map_[stream_info->track_id()] = stream_info;
     }
   }
 
+  void OnNewStreamInfo(size_t stream_position,
+                       bool first_of_type,
+                       const std::shared_ptr<StreamInfo>& stream_info) {
+    EXPECT_TRUE(init_stream_infos_.empty());
+    lazy_streams_[stream_position] = stream_info;
+    stream_map_[stream_info->track_id()] = stream_info;
+  }
+
   bool OnNewSample(uint32_t track_id,
                    const std::shared_ptr<MediaSample>& sample) {
     StreamMap::const_iterator stream = stream_map_.find(track_id);
@@ -149,6 +161,22 @@ TEST_F(Mp2tMediaParserTest, UnalignedAppend512_H265) {
   EXPECT_EQ(82, video_frame_count_);
 }
 
+TEST_F(Mp2tMediaParserTest, LazyInitialization) {
+  parser_->EnableLazyInitialization(base::Bind(
+      &Mp2tMediaParserTest::OnNewStreamInfo, base::Unretained(this)));
+  ParseMpeg2TsFile("bear-640x360.ts", 512);
+  EXPECT_TRUE(parser_->Flush());
+  EXPECT_EQ(82, video_frame_count_);
+
+  // The streams started early are at their position in the full list.
+  ASSERT_FALSE(init_stream_infos_.empty());
+  EXPECT_LT(lazy_streams_.size(), init_stream_infos_.size());
+  for (const auto& entry : lazy_streams_) {
+    ASSERT_LT(entry.first, init_stream_infos_.size());
+    EXPECT_EQ(entry.second, init_stream_infos_[entry.first]);
+  }
+}
+
 TEST_F(Mp2tMediaParserTest, TimestampWrapAround) {
   // "bear-640x360.ts" has been transcoded from bear-640x360.mp4 by applying a
   // time offset of 95442s (close to 2^33 / 90000) which results in timestamps
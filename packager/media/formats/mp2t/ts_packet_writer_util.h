@@ -21,6 +21,12 @@ namespace mp2t {
 
 class ContinuityCounter;
 
+/// Computes the CRC32/MPEG2 used by PSI tables and SCTE-35 sections.
+/// @param data points to the table, starting from table_id.
+/// @param data_size is the size of @a data.
+/// @return the CRC32 to append to the table.
+uint32_t Crc32Mpeg2(const uint8_t* data, size_t data_size);
+
 /// General purpose TS packet writing function. The output goes to @a output.
 /// @param payload can be any payload. Most likely raw PSI tables or PES packet
 ///        payload.
@@ -15,6 +15,7 @@
 #include "packager/media/formats/mp2t/pes_packet.h"
 #include "packager/media/formats/mp2t/program_map_table_writer.h"
 #include "packager/status.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 namespace media {
@@ -38,6 +39,7 @@ TsSegmenter::TsSegmenter(const MuxerOptions& options, MuxerListener* listener)
       listener_(listener),
       transport_stream_timestamp_offset_(
           options.transport_stream_timestamp_offset_ms * kTsTimescale / 1000),
+      segment_number_(options.initial_segment_index),
       pes_packet_generator_(
           new PesPacketGenerator(transport_stream_timestamp_offset_)) {}
 
@@ -170,6 +172,7 @@ Status TsSegmenter::WritePesPacketsToFile() {
 
 Status TsSegmenter::FinalizeSegment(uint64_t start_timestamp,
                                     uint64_t duration) {
+  SHAKA_TRACE_EVENT("muxer", "TsSegmenter::FinalizeSegment");
   if (!pes_packet_generator_->Flush()) {
     return Status(error::MUXER_FAILURE,
                   "Failed to flush PesPacketGenerator.");
@@ -36,6 +36,14 @@ struct Box {
   /// @param writer points to a BufferWriter object which wraps the buffer for
   ///        writing.
   void Write(BufferWriter* writer);
+  /// Write the box to buffer without computing the box size again, which
+  /// saves a traversal of the box tree if the size has already been computed
+  /// to lay out the data that follows the box. Note that this function
+  /// expects that ComputeSize has been invoked already and that the box has
+  /// not been changed in a way that affects its size since then.
+  /// @param writer points to a BufferWriter object which wraps the buffer for
+  ///        writing.
+  void WriteWithComputedSize(BufferWriter* writer);
   /// Write the box header to buffer. This function calls ComputeSize internally
   /// to compute and update box size.
   /// @param writer points to a BufferWriter object which wraps the buffer for
@@ -1112,6 +1112,22 @@ TYPED_TEST_P(BoxDefinitionsTestGeneral, WriteModifyWrite) {
   ASSERT_EQ(box, box_readback);
 }
 
+TYPED_TEST_P(BoxDefinitionsTestGeneral, WriteWithComputedSize) {
+  TypeParam box;
+  LOG(INFO) << "Processing " << FourCCToString(box.BoxType());
+  this->Fill(&box);
+  box.Write(this->buffer_.get());
+
+  // Writing with the size computed beforehand should be byte exact.
+  BufferWriter buffer;
+  box.ComputeSize();
+  box.WriteWithComputedSize(&buffer);
+  const uint8_t* expected = this->buffer_->Buffer();
+  EXPECT_EQ(std::vector<uint8_t>(expected, expected + this->buffer_->Size()),
+            std::vector<uint8_t>(buffer.Buffer(),
+                                 buffer.Buffer() + buffer.Size()));
+}
+
 TYPED_TEST_P(BoxDefinitionsTestGeneral, Empty) {
   TypeParam box;
   LOG(INFO) << "Processing " << FourCCToString(box.BoxType());
@@ -1126,6 +1142,7 @@ REGISTER_TYPED_TEST_CASE_P(BoxDefinitionsTestGeneral,
                            WriteHeader,
                            WriteReadbackCompare,
                            WriteModifyWrite,
+                           WriteWithComputedSize,
                            Empty);
 
 INSTANTIATE_TYPED_TEST_CASE_P(BoxDefinitionTypedTests,
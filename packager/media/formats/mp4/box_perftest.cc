@@ -0,0 +1,58 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures MP4 box serialization speed for the boxes written per fragment.
+
+#include <gtest/gtest.h>
+
+#include "packager/base/time/time.h"
+#include "packager/media/base/buffer_writer.h"
+#include "packager/media/formats/mp4/box_definitions.h"
+#include "packager/testing/perf/perf_test.h"
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+
+namespace {
+
+const int kNumIterations = 2000;
+// A 10 second fragment of 60 fps video.
+const uint32_t kNumSamples = 600;
+
+}  // namespace
+
+TEST(BoxPerfTest, TrackFragmentRunWrite) {
+  TrackFragmentRun trun;
+  trun.flags = TrackFragmentRun::kDataOffsetPresentMask |
+               TrackFragmentRun::kSampleDurationPresentMask |
+               TrackFragmentRun::kSampleSizePresentMask |
+               TrackFragmentRun::kSampleFlagsPresentMask |
+               TrackFragmentRun::kSampleCompTimeOffsetsPresentMask;
+  trun.sample_count = kNumSamples;
+  for (uint32_t i = 0; i < kNumSamples; ++i) {
+    trun.sample_durations.push_back(1500);
+    trun.sample_sizes.push_back(20000 + i * 7 % 5000);
+    trun.sample_flags.push_back(i % 60 == 0 ? 0x02000000 : 0x01010000);
+    trun.sample_composition_time_offsets.push_back(i % 3 * 1500);
+  }
+
+  BufferWriter writer;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    writer.Clear();
+    trun.Write(&writer);
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  ASSERT_EQ(trun.ComputeSize(), writer.Size());
+  perf_test::PrintResult("box_write", "", "trun_600_samples",
+                         elapsed.InMicrosecondsF() / kNumIterations, "us",
+                         true);
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
@@ -10,7 +10,8 @@
 #include <limits>
 
 #include "packager/media/base/audio_stream_info.h"
-#include "packager/media/base/buffer_writer.h"
+#include "packager/media/base/buffer_list.h"
+#include "packager/media/base/decrypt_config.h"
 #include "packager/media/base/media_sample.h"
 #include "packager/media/formats/mp4/box_definitions.h"
 #include "packager/media/formats/mp4/key_frame_info.h"
@@ -31,20 +32,6 @@ int64_t GetSeekPreroll(const StreamInfo& stream_info) {
   return audio_stream_info.seek_preroll_ns();
 }
 
-void NewSampleEncryptionEntry(const DecryptConfig& decrypt_config,
-                              bool use_constant_iv,
-                              TrackFragment* traf) {
-  SampleEncryption& sample_encryption = traf->sample_encryption;
-  SampleEncryptionEntry sample_encryption_entry;
-  if (!use_constant_iv)
-    sample_encryption_entry.initialization_vector = decrypt_config.iv();
-  sample_encryption_entry.subsamples = decrypt_config.subsamples();
-  sample_encryption.sample_encryption_entries.push_back(
-      sample_encryption_entry);
-  traf->auxiliary_size.sample_info_sizes.push_back(
-      sample_encryption_entry.ComputeSize());
-}
-
 }  // namespace
 
 Fragmenter::Fragmenter(std::shared_ptr<const StreamInfo> stream_info,
@@ -55,7 +42,8 @@ Fragmenter::Fragmenter(std::shared_ptr<const StreamInfo> stream_info,
       edit_list_offset_(edit_list_offset),
       seek_preroll_(GetSeekPreroll(*stream_info_)),
       earliest_presentation_time_(kInvalidTime),
-      first_sap_time_(kInvalidTime) {
+      first_sap_time_(kInvalidTime),
+      data_(new BufferList()) {
   DCHECK(stream_info_);
   DCHECK(traf);
 }
@@ -82,11 +70,8 @@ Status Fragmenter::AddSample(const MediaSample& sample) {
   traf_->runs[0].sample_flags.push_back(
       sample.is_key_frame() ? 0 : TrackFragmentHeader::kNonKeySampleMask);
 
-  if (sample.decrypt_config()) {
-    NewSampleEncryptionEntry(
-        *sample.decrypt_config(),
-        !stream_info_->encryption_config().constant_iv.empty(), traf_);
-  }
+  if (sample.decrypt_config())
+    AddSampleEncryptionEntry(*sample.decrypt_config());
 
   if (stream_info_->stream_type() == StreamType::kStreamVideo &&
       sample.is_key_frame()) {
@@ -94,7 +79,7 @@ Status Fragmenter::AddSample(const MediaSample& sample) {
         {static_cast<uint64_t>(pts), data_->Size(), sample.data_size()});
   }
 
-  data_->AppendArray(sample.data(), sample.data_size());
+  data_->AppendSharedData(sample.shared_data(), sample.data_size());
 
   traf_->runs[0].sample_composition_time_offsets.push_back(pts - dts);
   if (pts != dts)
@@ -136,12 +121,30 @@ Status Fragmenter::InitializeFragment(int64_t first_sample_dts) {
   const int64_t dts_before_edit = first_sample_dts + edit_list_offset_;
   traf_->decode_time.decode_time = dts_before_edit;
 
-  traf_->runs.clear();
+  // The boxes of the previous fragment are cleared rather than recreated, so
+  // that their vectors keep their capacity and are not reallocated for every
+  // fragment. Every field set for the previous fragment must be reset here.
   traf_->runs.resize(1);
-  traf_->runs[0].flags = TrackFragmentRun::kDataOffsetPresentMask;
+  TrackFragmentRun& run = traf_->runs[0];
+  run.version = 0;
+  run.flags = TrackFragmentRun::kDataOffsetPresentMask;
+  run.sample_count = 0;
+  run.data_offset = 0;
+  run.sample_flags.clear();
+  run.sample_sizes.clear();
+  run.sample_durations.clear();
+  run.sample_composition_time_offsets.clear();
+  traf_->auxiliary_size.default_sample_info_size = 0;
+  traf_->auxiliary_size.sample_count = 0;
   traf_->auxiliary_size.sample_info_sizes.clear();
   traf_->auxiliary_offset.offsets.clear();
-  traf_->sample_encryption.sample_encryption_entries.clear();
+  traf_->sample_encryption.flags = 0;
+  traf_->sample_encryption.iv_size = SampleEncryption::kInvalidIvSize;
+  std::vector<SampleEncryptionEntry>& sample_encryption_entries =
+      traf_->sample_encryption.sample_encryption_entries;
+  spare_sample_encryption_entries_.swap(sample_encryption_entries);
+  sample_encryption_entries.clear();
+  num_spare_sample_encryption_entries_used_ = 0;
   traf_->sample_group_descriptions.clear();
   traf_->sample_to_groups.clear();
   traf_->header.sample_description_index = 1;  // 1-based.
@@ -151,7 +154,7 @@ Status Fragmenter::InitializeFragment(int64_t first_sample_dts) {
   fragment_duration_ = 0;
   earliest_presentation_time_ = kInvalidTime;
   first_sap_time_ = kInvalidTime;
-  data_.reset(new BufferWriter());
+  data_->Clear();
   key_frame_infos_.clear();
   return Status::OK;
 }
@@ -288,6 +291,34 @@ Status Fragmenter::FinalizeFragmentForEncryption() {
   return Status::OK;
 }
 
+void Fragmenter::AddSampleEncryptionEntry(
+    const DecryptConfig& decrypt_config) {
+  std::vector<SampleEncryptionEntry>& sample_encryption_entries =
+      traf_->sample_encryption.sample_encryption_entries;
+  if (num_spare_sample_encryption_entries_used_ <
+      spare_sample_encryption_entries_.size()) {
+    sample_encryption_entries.push_back(std::move(
+        spare_sample_encryption_entries_
+            [num_spare_sample_encryption_entries_used_++]));
+  } else {
+    sample_encryption_entries.emplace_back();
+  }
+
+  // Assign in place to reuse the capacity of the vectors.
+  SampleEncryptionEntry& sample_encryption_entry =
+      sample_encryption_entries.back();
+  if (stream_info_->encryption_config().constant_iv.empty()) {
+    sample_encryption_entry.initialization_vector.assign(
+        decrypt_config.iv().begin(), decrypt_config.iv().end());
+  } else {
+    sample_encryption_entry.initialization_vector.clear();
+  }
+  sample_encryption_entry.subsamples.assign(
+      decrypt_config.subsamples().begin(), decrypt_config.subsamples().end());
+  traf_->auxiliary_size.sample_info_sizes.push_back(
+      sample_encryption_entry.ComputeSize());
+}
+
 bool Fragmenter::StartsWithSAP() const {
   DCHECK(!traf_->runs.empty());
   uint32_t start_sample_flag;
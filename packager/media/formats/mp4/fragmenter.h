@@ -16,13 +16,15 @@
 namespace shaka {
 namespace media {
 
-class BufferWriter;
+class BufferList;
+class DecryptConfig;
 class MediaSample;
 class StreamInfo;
 
 namespace mp4 {
 
 struct KeyFrameInfo;
+struct SampleEncryptionEntry;
 struct SegmentReference;
 struct TrackFragment;
 
@@ -66,7 +68,7 @@ class Fragmenter {
   }
   bool fragment_initialized() const { return fragment_initialized_; }
   bool fragment_finalized() const { return fragment_finalized_; }
-  BufferWriter* data() { return data_.get(); }
+  BufferList* data() { return data_.get(); }
   const std::vector<KeyFrameInfo>& key_frame_infos() const {
     return key_frame_infos_;
   }
@@ -82,6 +84,7 @@ class Fragmenter {
 
  private:
   Status FinalizeFragmentForEncryption();
+  void AddSampleEncryptionEntry(const DecryptConfig& decrypt_config);
   // Check if the current fragment starts with SAP.
   bool StartsWithSAP() const;
 
@@ -94,9 +97,14 @@ class Fragmenter {
   int64_t fragment_duration_ = 0;
   int64_t earliest_presentation_time_ = 0;
   int64_t first_sap_time_ = 0;
-  std::unique_ptr<BufferWriter> data_;
+  // References the payloads of the samples in the fragment.
+  std::unique_ptr<BufferList> data_;
   // Saves key frames information, for Video.
   std::vector<KeyFrameInfo> key_frame_infos_;
+  // Sample encryption entries of the previous fragment. They are reused for
+  // the entries of the current fragment, so their vectors keep their capacity.
+  std::vector<SampleEncryptionEntry> spare_sample_encryption_entries_;
+  size_t num_spare_sample_encryption_entries_used_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(Fragmenter);
 };
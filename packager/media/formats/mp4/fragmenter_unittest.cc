@@ -0,0 +1,195 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/formats/mp4/fragmenter.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "packager/media/base/buffer_writer.h"
+#include "packager/media/base/decrypt_config.h"
+#include "packager/media/base/media_sample.h"
+#include "packager/media/base/video_stream_info.h"
+#include "packager/media/formats/mp4/box_definitions.h"
+
+namespace shaka {
+namespace media {
+namespace mp4 {
+namespace {
+
+const int kTrackId = 1;
+const uint32_t kTimeScale = 90000;
+const uint64_t kDuration = 180000;
+const char kCodecString[] = "avc1.64001e";
+const uint8_t kCodecConfig[] = {0x01, 0x64, 0x00, 0x1e};
+const uint16_t kWidth = 640;
+const uint16_t kHeight = 360;
+const uint8_t kNaluLengthSize = 4;
+const char kLanguage[] = "und";
+const bool kIsEncrypted = true;
+const int64_t kSampleDuration = 3000;
+const int64_t kNoEditListOffset = 0;
+
+const uint8_t kKeyId[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+const uint8_t kConstantIv[] = {
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+const size_t kPerSampleIvSize = 8;
+const uint16_t kClearBytes = 5;
+const uint32_t kCipherBytes = 16;
+const size_t kNoConstantIv = std::numeric_limits<size_t>::max();
+
+// The number of subsamples of each sample in a fragment. Samples without
+// subsamples use full sample encryption.
+using FragmentSpec = std::vector<size_t>;
+
+// Returns the bytes of |box| in the traf, which are empty if it is omitted.
+std::vector<uint8_t> Serialize(Box* box) {
+  if (box->ComputeSize() == 0)
+    return std::vector<uint8_t>();
+  BufferWriter writer;
+  box->Write(&writer);
+  return std::vector<uint8_t>(writer.Buffer(), writer.Buffer() + writer.Size());
+}
+
+}  // namespace
+
+class FragmenterTest : public ::testing::Test {
+ protected:
+  FragmenterTest()
+      : stream_info_(new VideoStreamInfo(
+            kTrackId, kTimeScale, kDuration, kCodecH264,
+            H26xStreamFormat::kNalUnitStreamWithoutParameterSetNalus,
+            kCodecString, kCodecConfig, sizeof(kCodecConfig), kWidth, kHeight,
+            1, 1, 0, kNaluLengthSize, kLanguage, kIsEncrypted)) {}
+
+  void UseConstantIv() {
+    EncryptionConfig encryption_config;
+    encryption_config.protection_scheme = FOURCC_cbcs;
+    encryption_config.constant_iv.assign(std::begin(kConstantIv),
+                                         std::end(kConstantIv));
+    stream_info_->set_encryption_config(encryption_config);
+  }
+
+  std::shared_ptr<MediaSample> GetSample(int64_t dts, size_t num_subsamples) {
+    std::vector<SubsampleEntry> subsamples(
+        num_subsamples, SubsampleEntry(kClearBytes, kCipherBytes));
+    const size_t sample_size =
+        num_subsamples == 0 ? kCipherBytes
+                            : num_subsamples * (kClearBytes + kCipherBytes);
+    const std::vector<uint8_t> data(sample_size);
+    std::shared_ptr<MediaSample> sample =
+        MediaSample::CopyFrom(data.data(), data.size(), dts == 0);
+    sample->set_dts(dts);
+    sample->set_pts(dts);
+    sample->set_duration(kSampleDuration);
+
+    std::vector<uint8_t> iv;
+    if (stream_info_->encryption_config().constant_iv.empty()) {
+      // A distinct IV per sample, so stale IVs in reused entries show up.
+      iv.assign(kPerSampleIvSize, static_cast<uint8_t>(dts / kSampleDuration));
+    } else {
+      iv = stream_info_->encryption_config().constant_iv;
+    }
+    sample->set_decrypt_config(std::unique_ptr<DecryptConfig>(new DecryptConfig(
+        std::vector<uint8_t>(std::begin(kKeyId), std::end(kKeyId)), iv,
+        subsamples)));
+    return sample;
+  }
+
+  // Adds the samples of |spec| to |fragmenter| and finalizes the fragment.
+  void WriteFragment(const FragmentSpec& spec,
+                     int64_t first_dts,
+                     Fragmenter* fragmenter) {
+    int64_t dts = first_dts;
+    for (size_t num_subsamples : spec) {
+      ASSERT_TRUE(fragmenter->AddSample(*GetSample(dts, num_subsamples)).ok());
+      dts += kSampleDuration;
+    }
+    ASSERT_TRUE(fragmenter->FinalizeFragment().ok());
+  }
+
+  // Writes every fragment of |specs| with one fragmenter, which reuses the
+  // boxes of the previous fragment, and checks that the senc and saiz boxes of
+  // each fragment are the same as the ones written by a new fragmenter.
+  void VerifyFragments(const std::vector<FragmentSpec>& specs,
+                       size_t constant_iv_from_fragment) {
+    TrackFragment traf;
+    Fragmenter fragmenter(stream_info_, &traf, kNoEditListOffset);
+    int64_t first_dts = 0;
+    for (size_t i = 0; i < specs.size(); ++i) {
+      SCOPED_TRACE(i);
+      if (i == constant_iv_from_fragment)
+        UseConstantIv();
+      const FragmentSpec& spec = specs[i];
+      WriteFragment(spec, first_dts, &fragmenter);
+      if (HasFatalFailure())
+        return;
+
+      TrackFragment new_traf;
+      Fragmenter new_fragmenter(stream_info_, &new_traf, kNoEditListOffset);
+      WriteFragment(spec, first_dts, &new_fragmenter);
+      if (HasFatalFailure())
+        return;
+
+      const std::vector<SampleEncryptionEntry>& entries =
+          traf.sample_encryption.sample_encryption_entries;
+      ASSERT_EQ(spec.size(), entries.size());
+      const bool use_constant_iv = i >= constant_iv_from_fragment;
+      EXPECT_EQ(use_constant_iv ? 0u : kPerSampleIvSize,
+                traf.sample_encryption.iv_size);
+      for (size_t j = 0; j < spec.size(); ++j) {
+        EXPECT_EQ(use_constant_iv ? 0u : kPerSampleIvSize,
+                  entries[j].initialization_vector.size());
+        EXPECT_EQ(spec[j], entries[j].subsamples.size());
+      }
+
+      EXPECT_EQ(Serialize(&new_traf.sample_encryption),
+                Serialize(&traf.sample_encryption));
+      EXPECT_EQ(Serialize(&new_traf.auxiliary_size),
+                Serialize(&traf.auxiliary_size));
+      EXPECT_EQ(new_traf.auxiliary_offset.offsets.size(),
+                traf.auxiliary_offset.offsets.size());
+
+      fragmenter.ClearFragmentFinalized();
+      first_dts += static_cast<int64_t>(spec.size()) * kSampleDuration;
+    }
+  }
+
+  std::shared_ptr<VideoStreamInfo> stream_info_;
+};
+
+TEST_F(FragmenterTest, ReusesEntriesWithDifferentSampleCounts) {
+  VerifyFragments({{1, 2, 3}, {4, 1}, {1, 1, 1, 1}, {2}}, kNoConstantIv);
+}
+
+TEST_F(FragmenterTest, ReusesEntriesWithFullSampleEncryption) {
+  VerifyFragments({{0, 0, 0}, {0}, {0, 0, 0, 0}}, kNoConstantIv);
+}
+
+TEST_F(FragmenterTest, ReusesEntriesFromPerSampleIvToConstantIv) {
+  const size_t kConstantIvFromFragment = 2;
+  VerifyFragments({{1, 2, 3}, {2, 2}, {1, 3, 2, 1}, {2}},
+                  kConstantIvFromFragment);
+}
+
+TEST_F(FragmenterTest, ResetsSaizWhenConstantIvOmitsIt) {
+  const size_t kConstantIvFromFragment = 1;
+  // The saiz box is omitted for full sample encryption with a constant IV, so
+  // it must not keep the sizes of the previous fragment.
+  VerifyFragments({{1, 2}, {0, 0, 0}, {2, 1}}, kConstantIvFromFragment);
+}
+
+}  // namespace mp4
+}  // namespace media
+}  // namespace shaka
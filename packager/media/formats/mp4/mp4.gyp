@@ -48,6 +48,7 @@
         '../../../third_party/boringssl/boringssl.gyp:boringssl',
         '../../../third_party/gflags/gflags.gyp:gflags',
         '../../base/media_base.gyp:media_base',
+        '../../../packager.gyp:trace_event',
         '../../codecs/codecs.gyp:codecs',
         '../../event/media_event.gyp:media_event',
       ],
@@ -61,6 +62,7 @@
         'chunk_info_iterator_unittest.cc',
         'composition_offset_iterator_unittest.cc',
         'decoding_time_iterator_unittest.cc',
+        'fragmenter_unittest.cc',
         'mp4_media_parser_unittest.cc',
         'sync_sample_iterator_unittest.cc',
         'track_run_iterator_unittest.cc',
@@ -74,5 +76,20 @@
         'mp4',
       ]
     },
+    {
+      'target_name': 'mp4_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'box_perftest.cc',
+        'mp4_media_parser_perftest.cc',
+      ],
+      'dependencies': [
+        '../../../base/base.gyp:base',
+        '../../../testing/gtest.gyp:gtest',
+        '../../../testing/perf/perf_test.gyp:perf_test',
+        '../../test/media_test.gyp:media_test_support',
+        'mp4',
+      ],
+    },
   ],
 }
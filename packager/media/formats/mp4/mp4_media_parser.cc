@@ -191,6 +191,34 @@ bool MP4MediaParser::Parse(const uint8_t* buf, int size) {
   return true;
 }
 
+void MP4MediaParser::SkipSamplesBefore(uint32_t track_id, int64_t dts) {
+  start_dts_[track_id] = dts;
+}
+
+bool MP4MediaParser::SkipSampleData() {
+  skip_sample_data_ = true;
+  return true;
+}
+
+bool MP4MediaParser::SkipInput(int64_t* position) {
+  DCHECK(position);
+  if (state_ != kEmittingSamples)
+    return false;
+
+  // The next bytes needed are the next sample or auxiliary information to
+  // read, or the box after the current 'mdat' box.
+  int64_t next_position = mdat_tail_;
+  if (runs_->IsRunValid()) {
+    next_position =
+        std::min(next_position, runs_->GetMaxClearOffset() + moof_head_);
+  }
+  if (next_position <= queue_.tail())
+    return false;
+  queue_.SkipTo(next_position);
+  *position = next_position;
+  return true;
+}
+
 bool MP4MediaParser::LoadMoov(const std::string& file_path) {
   std::unique_ptr<File, FileCloser> file(
       File::OpenWithNoBuffering(file_path.c_str(), "r"));
@@ -699,6 +727,22 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
 
   DCHECK(!(*err));
 
+  // The samples before the start of their track are skipped without being
+  // read, once their auxiliary information is cached, see below.
+  if (!runs_->AuxInfoNeedsToBeCached()) {
+    auto start_dts = start_dts_.find(runs_->track_id());
+    if (start_dts != start_dts_.end() && runs_->dts() < start_dts->second) {
+      runs_->AdvanceSample();
+      return true;
+    }
+  }
+  if (skip_sample_data_ && (runs_->is_audio() || runs_->is_video())) {
+    std::shared_ptr<MediaSample> stream_sample =
+        MediaSample::CreateEmptyMediaSample();
+    stream_sample->set_is_key_frame(runs_->is_keyframe());
+    return EmitSample(std::move(stream_sample), err);
+  }
+
   const uint8_t* buf;
   int buf_size;
   queue_.Peek(&buf, &buf_size);
@@ -773,10 +817,14 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
   } else {
     stream_sample->SetData(media_data, media_data_size);
   }
+  return EmitSample(std::move(stream_sample), err);
+}
 
-  stream_sample->set_dts(runs_->dts());
-  stream_sample->set_pts(runs_->cts());
-  stream_sample->set_duration(runs_->duration());
+bool MP4MediaParser::EmitSample(std::shared_ptr<MediaSample> sample,
+                                bool* err) {
+  sample->set_dts(runs_->dts());
+  sample->set_pts(runs_->cts());
+  sample->set_duration(runs_->duration());
 
   DVLOG(3) << "Pushing frame: "
            << ", key=" << runs_->is_keyframe()
@@ -785,7 +833,7 @@ bool MP4MediaParser::EnqueueSample(bool* err) {
            << ", cts=" << runs_->cts()
            << ", size=" << runs_->sample_size();
 
-  if (!new_sample_cb_.Run(runs_->track_id(), stream_sample)) {
+  if (!new_sample_cb_.Run(runs_->track_id(), sample)) {
     *err = true;
     LOG(ERROR) << "Failed to process the sample.";
     return false;
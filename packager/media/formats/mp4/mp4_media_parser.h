@@ -39,6 +39,9 @@ class MP4MediaParser : public MediaParser {
             KeySource* decryption_key_source) override;
   bool Flush() override WARN_UNUSED_RESULT;
   bool Parse(const uint8_t* buf, int size) override WARN_UNUSED_RESULT;
+  void SkipSamplesBefore(uint32_t track_id, int64_t dts) override;
+  bool SkipSampleData() override;
+  bool SkipInput(int64_t* position) override;
   /// @}
 
   /// Handles ISO-BMFF containers which have the 'moov' box trailing the
@@ -77,6 +80,9 @@ class MP4MediaParser : public MediaParser {
   bool EmitConfigs();
 
   bool EnqueueSample(bool* err);
+  // Emits |sample| with the timestamps of the current sample of |runs_| and
+  // advances to the next sample.
+  bool EmitSample(std::shared_ptr<MediaSample> sample, bool* err);
 
   void Reset();
 
@@ -101,6 +107,10 @@ class MP4MediaParser : public MediaParser {
   std::unique_ptr<Movie> moov_;
   std::unique_ptr<TrackRunIterator> runs_;
 
+  // Track id -> decoding timestamp of the first sample to emit.
+  std::map<uint32_t, int64_t> start_dts_;
+  bool skip_sample_data_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(MP4MediaParser);
 };
 
@@ -174,7 +174,16 @@ Status MP4Muxer::Finalize() {
 
 Status MP4Muxer::AddSample(size_t stream_id, const MediaSample& sample) {
   if (to_be_initialized_) {
-    RETURN_IF_ERROR(UpdateEditListOffsetFromSample(sample));
+    // The edit list offset of a chunk of the timeline is that of the whole
+    // timeline, as if the chunks were packaged by a single muxer.
+    const base::Optional<MuxerOptions::TimelineChunk>& timeline_chunk =
+        options().timeline_chunk;
+    if (timeline_chunk) {
+      RETURN_IF_ERROR(UpdateEditListOffset(timeline_chunk->first_sample_pts,
+                                           timeline_chunk->first_sample_dts));
+    } else {
+      RETURN_IF_ERROR(UpdateEditListOffset(sample.pts(), sample.dts()));
+    }
     RETURN_IF_ERROR(DelayInitializeMuxer());
     to_be_initialized_ = false;
   }
@@ -297,12 +306,10 @@ Status MP4Muxer::DelayInitializeMuxer() {
   return Status::OK;
 }
 
-Status MP4Muxer::UpdateEditListOffsetFromSample(const MediaSample& sample) {
+Status MP4Muxer::UpdateEditListOffset(int64_t pts, int64_t dts) {
   if (edit_list_offset_)
     return Status::OK;
 
-  const int64_t pts = sample.pts();
-  const int64_t dts = sample.dts();
   // An EditList entry is inserted if one of the below conditions occur [4]:
   // (1) pts > dts for the first sample. Due to Chrome's dts bug [1], dts is
   //     used in buffered range API, while pts is used elsewhere (players,
@@ -354,7 +361,7 @@ Status MP4Muxer::UpdateEditListOffsetFromSample(const MediaSample& sample) {
                << dts << ").";
     return Status(error::MUXER_FAILURE, "Not expecting pts < dts.");
   }
-  edit_list_offset_ = std::max(-sample.pts(), static_cast<int64_t>(0));
+  edit_list_offset_ = std::max(-pts, static_cast<int64_t>(0));
   return Status::OK;
 }
 
@@ -44,7 +44,7 @@ class MP4Muxer : public Muxer {
                          const SegmentInfo& segment_info) override;
 
   Status DelayInitializeMuxer();
-  Status UpdateEditListOffsetFromSample(const MediaSample& sample);
+  Status UpdateEditListOffset(int64_t pts, int64_t dts);
 
   // Generate Audio/Video Track box.
   void InitializeTrak(const StreamInfo* info, Track* trak);
@@ -29,7 +29,7 @@ MultiSegmentSegmenter::MultiSegmentSegmenter(const MuxerOptions& options,
                                              std::unique_ptr<Movie> moov)
     : Segmenter(options, std::move(ftyp), std::move(moov)),
       styp_(new SegmentType),
-      num_segments_(0) {
+      num_segments_(options.initial_segment_index) {
   // Use the same brands for styp as ftyp.
   styp_->major_brand = Segmenter::ftyp()->major_brand;
   styp_->compatible_brands = Segmenter::ftyp()->compatible_brands;
@@ -57,12 +57,18 @@ std::vector<Range> MultiSegmentSegmenter::GetSegmentRanges() {
 }
 
 Status MultiSegmentSegmenter::DoInitialize() {
+  const base::Optional<MuxerOptions::TimelineChunk>& timeline_chunk =
+      options().timeline_chunk;
+  if (timeline_chunk && !timeline_chunk->is_first_chunk)
+    return Status::OK;
   return WriteInitSegment();
 }
 
 Status MultiSegmentSegmenter::DoFinalize() {
-  // Update init segment with media duration set.
-  RETURN_IF_ERROR(WriteInitSegment());
+  // Update init segment with media duration set, unless the media duration
+  // is unknown as only a chunk of the timeline is muxed.
+  if (!options().timeline_chunk)
+    RETURN_IF_ERROR(WriteInitSegment());
   SetComplete();
   return Status::OK;
 }
@@ -9,6 +9,7 @@
 #include <algorithm>
 
 #include "packager/base/logging.h"
+#include "packager/media/base/buffer_list.h"
 #include "packager/media/base/buffer_writer.h"
 #include "packager/media/base/id3_tag.h"
 #include "packager/media/base/media_sample.h"
@@ -20,6 +21,7 @@
 #include "packager/media/formats/mp4/box_definitions.h"
 #include "packager/media/formats/mp4/fragmenter.h"
 #include "packager/media/formats/mp4/key_frame_info.h"
+#include "packager/trace_event.h"
 #include "packager/version/version.h"
 
 namespace shaka {
@@ -43,7 +45,7 @@ Segmenter::Segmenter(const MuxerOptions& options,
       ftyp_(std::move(ftyp)),
       moov_(std::move(moov)),
       moof_(new MovieFragment()),
-      fragment_buffer_(new BufferWriter()),
+      fragment_buffer_(new BufferList()),
       sidx_(new SegmentIndex()) {}
 
 Segmenter::~Segmenter() {}
@@ -90,7 +92,10 @@ Status Segmenter::Initialize(
 
   // Use the reference stream's time scale as movie time scale.
   moov_->header.timescale = sidx_->timescale;
-  moof_->header.sequence_number = 1;
+  // The fragments of a chunk of the timeline continue the numbering of the
+  // previous chunks, which have a fragment per segment.
+  moof_->header.sequence_number =
+      options_.timeline_chunk ? options_.initial_segment_index + 1 : 1;
 
   // Fill in version information.
   const std::string version = GetPackagerVersion();
@@ -146,6 +151,7 @@ Status Segmenter::AddSample(size_t stream_id, const MediaSample& sample) {
 
 Status Segmenter::FinalizeSegment(size_t stream_id,
                                   const SegmentInfo& segment_info) {
+  SHAKA_TRACE_EVENT("muxer", "MP4Segmenter::FinalizeSegment");
   if (segment_info.key_rotation_encryption_config) {
     FinalizeFragmentForKeyRotation(
         stream_id, segment_info.is_encrypted,
@@ -198,9 +204,14 @@ Status Segmenter::FinalizeSegment(size_t stream_id,
 
   const uint64_t moof_start_offset = fragment_buffer_->Size();
 
-  // Write the fragment to buffer.
-  moof_->Write(fragment_buffer_.get());
-  mdat.WriteHeader(fragment_buffer_.get());
+  // Write the fragment to buffer. The sample payloads are referenced rather
+  // than copied, see Fragmenter::data(). The offsets updated above do not
+  // affect the box sizes computed for |data_offset|, so there is no need to
+  // compute them again.
+  BufferWriter fragment_header(data_offset);
+  moof_->WriteWithComputedSize(&fragment_header);
+  mdat.WriteHeader(&fragment_header);
+  fragment_buffer_->AppendBuffer(fragment_header);
 
   bool first_key_frame = true;
   for (const std::unique_ptr<Fragmenter>& fragmenter : fragmenters_) {
@@ -216,7 +227,7 @@ Status Segmenter::FinalizeSegment(size_t stream_id,
           {key_frame_info.timestamp, moof_start_offset,
            fragment_buffer_->Size() - moof_start_offset + key_frame_info.size});
     }
-    fragment_buffer_->AppendBuffer(*fragmenter->data());
+    fragment_buffer_->AppendBufferList(fragmenter->data());
   }
 
   // Increase sequence_number for next fragment.
@@ -20,6 +20,7 @@
       ],
       'dependencies': [
         '../../base/media_base.gyp:media_base',
+        '../../../packager.gyp:trace_event',
         '../../codecs/codecs.gyp:codecs',
       ],
     },
@@ -13,6 +13,7 @@
 #include "packager/media/codecs/aac_audio_specific_config.h"
 #include "packager/media/codecs/hls_audio_util.h"
 #include "packager/status_macros.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 namespace media {
@@ -74,6 +75,7 @@ Status PackedAudioSegmenter::AddSample(const MediaSample& sample) {
 }
 
 Status PackedAudioSegmenter::FinalizeSegment() {
+  SHAKA_TRACE_EVENT("muxer", "PackedAudioSegmenter::FinalizeSegment");
   start_of_new_segment_ = true;
   return Status::OK;
 }
@@ -18,8 +18,8 @@ PackedAudioWriter::PackedAudioWriter(const MuxerOptions& muxer_options)
       transport_stream_timestamp_offset_(
           muxer_options.transport_stream_timestamp_offset_ms *
           kPackedAudioTimescale / 1000),
-      segmenter_(new PackedAudioSegmenter(transport_stream_timestamp_offset_)) {
-}
+      segmenter_(new PackedAudioSegmenter(transport_stream_timestamp_offset_)),
+      segment_number_(muxer_options.initial_segment_index) {}
 
 PackedAudioWriter::~PackedAudioWriter() = default;
 
@@ -18,7 +18,7 @@ namespace media {
 namespace webm {
 
 MultiSegmentSegmenter::MultiSegmentSegmenter(const MuxerOptions& options)
-    : Segmenter(options), num_segment_(0) {}
+    : Segmenter(options), num_segment_(options.initial_segment_index) {}
 
 MultiSegmentSegmenter::~MultiSegmentSegmenter() {}
 
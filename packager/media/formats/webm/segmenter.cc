@@ -21,6 +21,7 @@
 #include "packager/media/formats/webm/webm_constants.h"
 #include "packager/third_party/libwebm/src/mkvmuxerutil.hpp"
 #include "packager/third_party/libwebm/src/webmids.hpp"
+#include "packager/trace_event.h"
 #include "packager/version/version.h"
 
 using mkvmuxer::AudioTrack;
@@ -195,6 +196,7 @@ Status Segmenter::AddSample(const MediaSample& source_sample) {
 Status Segmenter::FinalizeSegment(uint64_t start_timestamp,
                                   uint64_t duration_timestamp,
                                   bool is_subsegment) {
+  SHAKA_TRACE_EVENT("muxer", "WebMSegmenter::FinalizeSegment");
   if (is_subsegment)
     new_subsegment_ = true;
   else
@@ -6,17 +6,89 @@
 
 #include "packager/media/formats/webm/single_segment_segmenter.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "packager/base/logging.h"
+#include "packager/file/file_util.h"
 #include "packager/media/base/muxer_options.h"
 #include "packager/media/event/muxer_listener.h"
 #include "packager/third_party/libwebm/src/mkvmuxer.hpp"
+#include "packager/third_party/libwebm/src/mkvmuxerutil.hpp"
+#include "packager/third_party/libwebm/src/webmids.hpp"
 
 namespace shaka {
 namespace media {
 namespace webm {
+namespace {
+// Cues ID (4 bytes) and the largest coded payload size (8 bytes).
+const uint64_t kMaxCuesHeaderSize = 12;
+// A CuePoint (2 bytes) with an 8-byte CueTime (10 bytes) and a
+// CueTrackPositions (2 bytes) holding a 1-byte CueTrack (3 bytes) and an
+// 8-byte CueClusterPosition (10 bytes).
+const uint64_t kMaxCuePointSize = 27;
+// A Void element needs at least its ID and a one byte size.
+const uint64_t kMinVoidSize = 2;
+// A new segment starts at the first key frame after each segment boundary, so
+// there is at most one segment per segment duration.  Leave some room for the
+// partial segments at either end, segments split on cue events and an
+// inaccurate stream duration.
+const double kCuePointsSlackFactor = 1.25;
+const uint64_t kExtraCuePoints = 2;
+
+// Cues will be inserted before clusters. All clusters will be shifted down by
+// the size of cues. However, cluster positions affect the size of cues. This
+// function adjusts cues size iteratively until it is stable.
+// Returns the size of updated Cues.
+uint64_t UpdateCues(mkvmuxer::Cues* cues) {
+  uint64_t cues_size = cues->Size();
+  uint64_t adjustment = cues_size;
+  while (adjustment != 0) {
+    for (int i = 0; i < cues->cue_entries_size(); ++i) {
+      mkvmuxer::CuePoint* cue = cues->GetCueByIndex(i);
+      cue->set_cluster_pos(cue->cluster_pos() + adjustment);
+    }
+    uint64_t new_cues_size = cues->Size();
+    DCHECK_LE(cues_size, new_cues_size);
+    adjustment = new_cues_size - cues_size;
+    cues_size = new_cues_size;
+  }
+  return cues_size;
+}
+
+// Skips a given number of bytes in a file by reading.  This allows
+// forward-seeking in non-seekable files.
+bool ReadSkip(File* file, int64_t byte_count) {
+  const int64_t kBufferSize = 0x40000;  // 256KB.
+  std::unique_ptr<char[]> buffer(new char[kBufferSize]);
+  int64_t bytes_read = 0;
+  while (bytes_read < byte_count) {
+    int64_t size = std::min(kBufferSize, byte_count - bytes_read);
+    int64_t result = file->Read(buffer.get(), size);
+    // Only give success if there are no errors, not at EOF, and read exactly
+    // byte_count bytes.
+    if (result <= 0)
+      return false;
+
+    bytes_read += result;
+  }
+
+  DCHECK_EQ(bytes_read, byte_count);
+  return true;
+}
+}  // namespace
 
 SingleSegmentSegmenter::SingleSegmentSegmenter(const MuxerOptions& options)
     : Segmenter(options), init_end_(0), index_start_(0) {}
 
+SingleSegmentSegmenter::SingleSegmentSegmenter(
+    const MuxerOptions& options,
+    std::unique_ptr<MkvWriter> writer)
+    : Segmenter(options),
+      writer_(std::move(writer)),
+      init_end_(0),
+      index_start_(0) {}
+
 SingleSegmentSegmenter::~SingleSegmentSegmenter() {}
 
 Status SingleSegmentSegmenter::FinalizeSegment(uint64_t start_timestamp,
@@ -87,28 +159,121 @@ Status SingleSegmentSegmenter::DoInitialize() {
     writer_ = std::move(writer);
   }
 
-  Status ret = WriteSegmentHeader(0, writer_.get());
-  init_end_ = writer_->Position() - 1;
-  seek_head()->set_cluster_pos(init_end_ + 1 - segment_payload_pos());
-  return ret;
+  Status status = WriteInitialSegmentHeader();
+  if (!status.ok())
+    return status;
+
+  // Reserve the space for the Cues so they can be written in place before the
+  // Clusters on finalize.
+  reserved_cues_size_ = writer_->Seekable() ? EstimateMaxCuesSize() : 0;
+  if (reserved_cues_size_ > 0) {
+    if (WriteVoidElement(writer_.get(), reserved_cues_size_) !=
+        reserved_cues_size_) {
+      return Status(error::FILE_FAILURE, "Error reserving space for Cues.");
+    }
+    seek_head()->set_cluster_pos(writer_->Position() - segment_payload_pos());
+  }
+  return Status::OK;
 }
 
 Status SingleSegmentSegmenter::DoFinalize() {
-  // Write the Cues to the end of the file.
-  index_start_ = writer_->Position();
+  // The Cues either fill the reserved space exactly or leave enough room for a
+  // Void element after them.
+  const uint64_t cues_size = cues()->Size();
+  if (reserved_cues_size_ > 0 && cues_size != reserved_cues_size_ &&
+      cues_size + kMinVoidSize > reserved_cues_size_) {
+    LOG(WARNING) << "Cues size " << cues_size << " exceeds the reserved size "
+                 << reserved_cues_size_
+                 << ". Rewriting the output with the Cues before the Clusters.";
+    return RewriteWithoutReservedSpace();
+  }
+
+  uint64_t file_size = writer_->Position();
+  if (reserved_cues_size_ > 0) {
+    index_start_ = init_end_ + 1;
+    if (writer_->Position(index_start_) != 0)
+      return Status(error::FILE_FAILURE, "Error seeking to Cues position.");
+  } else {
+    // Write the Cues to the end of the file.
+    index_start_ = file_size;
+  }
+
   seek_head()->set_cues_pos(index_start_ - segment_payload_pos());
   if (!cues()->Write(writer_.get()))
     return Status(error::FILE_FAILURE, "Error writing Cues data.");
-
-  // The WebM index is at the end of the file.
   index_end_ = writer_->Position() - 1;
+
+  if (reserved_cues_size_ > 0) {
+    const uint64_t void_size = reserved_cues_size_ - cues_size;
+    if (void_size > 0 &&
+        WriteVoidElement(writer_.get(), void_size) != void_size) {
+      return Status(error::FILE_FAILURE, "Error writing Void element.");
+    }
+  } else {
+    // The WebM index is at the end of the file.
+    file_size = index_end_ + 1;
+  }
   writer_->Position(0);
 
-  Status status = WriteSegmentHeader(index_end_ + 1, writer_.get());
+  Status status = WriteSegmentHeader(file_size, writer_.get());
   status.Update(writer_->Close());
   return status;
 }
 
+Status SingleSegmentSegmenter::WriteOutputWithCuesBeforeClusters(
+    const std::string& source_file_name,
+    uint64_t clusters_start,
+    uint64_t clusters_size) {
+  const uint64_t header_size = init_end_ + 1;
+  const uint64_t cues_pos = header_size - segment_payload_pos();
+  const uint64_t cues_size = UpdateCues(cues());
+  seek_head()->set_cues_pos(cues_pos);
+  seek_head()->set_cluster_pos(cues_pos + cues_size);
+
+  // Write the header to the real output file.
+  std::unique_ptr<MkvWriter> real_writer(new MkvWriter);
+  Status status = real_writer->Open(options().output_file_name);
+  if (!status.ok())
+    return status;
+
+  const uint64_t file_size = header_size + cues_size + clusters_size;
+  status = WriteSegmentHeader(file_size, real_writer.get());
+  if (!status.ok())
+    return status;
+  DCHECK_EQ(real_writer->Position(), static_cast<int64_t>(header_size));
+
+  // Write the cues to the real output file.
+  index_start_ = real_writer->Position();
+  if (!cues()->Write(real_writer.get()))
+    return Status(error::FILE_FAILURE, "Error writing Cues data.");
+  index_end_ = real_writer->Position() - 1;
+  DCHECK_EQ(real_writer->Position(),
+            static_cast<int64_t>(segment_payload_pos() + cues_pos + cues_size));
+
+  std::unique_ptr<File, FileCloser> source(
+      File::Open(source_file_name.c_str(), "r"));
+  if (!source)
+    return Status(error::FILE_FAILURE, "Error opening temp file.");
+
+  // Skip the data before the Clusters.
+  if (!ReadSkip(source.get(), clusters_start))
+    return Status(error::FILE_FAILURE, "Error reading temp file.");
+
+  // Copy the Clusters over.
+  if (!CopyFileWithClusterRewrite(source.get(), real_writer.get(),
+                                  cluster()->Size())) {
+    return Status(error::FILE_FAILURE, "Error copying temp file.");
+  }
+  return real_writer->Close();
+}
+
+Status SingleSegmentSegmenter::WriteInitialSegmentHeader() {
+  Status ret = WriteSegmentHeader(0, writer_.get());
+  init_end_ = writer_->Position() - 1;
+  seek_head()->set_cluster_pos(init_end_ + 1 - segment_payload_pos());
+  return ret;
+}
+
 Status SingleSegmentSegmenter::NewSegment(uint64_t start_timestamp,
                                           bool is_subsegment) {
   // No-op for subsegment in single segment mode.
@@ -128,6 +293,96 @@ Status SingleSegmentSegmenter::NewSegment(uint64_t start_timestamp,
   return SetCluster(start_timecode, position, writer_.get());
 }
 
+Status SingleSegmentSegmenter::RewriteWithoutReservedSpace() {
+  const uint64_t clusters_start = init_end_ + 1 + reserved_cues_size_;
+  const uint64_t clusters_size = writer_->Position() - clusters_start;
+  Status status = writer_->Close();
+  writer_.reset();
+  if (!status.ok())
+    return status;
+
+  // The Clusters are copied back from a copy of the output, as the two-pass
+  // segmenter does from its temporary file.
+  std::string temp_file_name;
+  if (!TempFilePath(options().temp_dir, &temp_file_name))
+    return Status(error::FILE_FAILURE, "Unable to create temporary file.");
+  if (!File::Copy(options().output_file_name.c_str(),
+                  temp_file_name.c_str())) {
+    return Status(error::FILE_FAILURE, "Error copying output to temp file.");
+  }
+
+  // The Clusters are positioned right after the header before making room
+  // for the Cues.
+  for (int i = 0; i < cues()->cue_entries_size(); ++i) {
+    mkvmuxer::CuePoint* cue = cues()->GetCueByIndex(i);
+    cue->set_cluster_pos(cue->cluster_pos() - reserved_cues_size_);
+  }
+  status = WriteOutputWithCuesBeforeClusters(temp_file_name, clusters_start,
+                                             clusters_size);
+  if (!File::Delete(temp_file_name.c_str()))
+    LOG(WARNING) << "Unable to delete temporary file " << temp_file_name;
+  return status;
+}
+
+bool SingleSegmentSegmenter::CopyFileWithClusterRewrite(File* source,
+                                                        MkvWriter* dest,
+                                                        uint64_t last_size) {
+  const int cluster_id_size = mkvmuxer::GetUIntSize(mkvmuxer::kMkvCluster);
+  const int cluster_size_size = 8;  // The size of the Cluster size integer.
+  const int cluster_header_size = cluster_id_size + cluster_size_size;
+
+  // We are at the start of a cluster, so copy the ID.
+  if (dest->WriteFromFile(source, cluster_id_size) != cluster_id_size)
+    return false;
+
+  for (int i = 0; i < cues()->cue_entries_size() - 1; ++i) {
+    // Write the size of the cluster.
+    const mkvmuxer::CuePoint* cue = cues()->GetCueByIndex(i);
+    const mkvmuxer::CuePoint* next_cue = cues()->GetCueByIndex(i + 1);
+    const int64_t cluster_payload_size =
+        next_cue->cluster_pos() - cue->cluster_pos() - cluster_header_size;
+    if (mkvmuxer::WriteUIntSize(dest, cluster_payload_size, cluster_size_size))
+      return false;
+    if (!ReadSkip(source, cluster_size_size))
+      return false;
+
+    // Copy the cluster and the next cluster's ID.
+    int64_t to_copy = cluster_payload_size + cluster_id_size;
+    if (dest->WriteFromFile(source, to_copy) != to_copy)
+      return false;
+
+    // Update the progress; need to convert from WebM timecode to ISO BMFF.
+    const uint64_t webm_delta_time = next_cue->time() - cue->time();
+    const uint64_t delta_time = FromWebMTimecode(webm_delta_time);
+    UpdateProgress(delta_time);
+  }
+
+  // The last cluster takes up until the cues.
+  const uint64_t last_cluster_payload_size = last_size - cluster_header_size;
+  if (mkvmuxer::WriteUIntSize(dest, last_cluster_payload_size,
+                              cluster_size_size))
+    return false;
+  if (!ReadSkip(source, cluster_size_size))
+    return false;
+
+  // Copy the last cluster.
+  return dest->WriteFromFile(source) ==
+         static_cast<int64_t>(last_cluster_payload_size);
+}
+
+uint64_t SingleSegmentSegmenter::EstimateMaxCuesSize() const {
+  const double segment_duration = options().segment_duration_in_seconds;
+  if (segment_duration <= 0 || duration() == 0 || time_scale() == 0)
+    return 0;
+  const double duration_in_seconds =
+      static_cast<double>(duration()) / time_scale();
+  const uint64_t max_cue_points =
+      static_cast<uint64_t>(std::ceil(duration_in_seconds / segment_duration *
+                                      kCuePointsSlackFactor)) +
+      kExtraCuePoints;
+  return kMaxCuesHeaderSize + max_cue_points * kMaxCuePointSize;
+}
+
 }  // namespace webm
 }  // namespace media
 }  // namespace shaka
@@ -10,6 +10,7 @@
 #include "packager/media/formats/webm/segmenter.h"
 
 #include <memory>
+#include <string>
 #include "packager/media/formats/webm/mkv_writer.h"
 #include "packager/status.h"
 
@@ -23,9 +24,20 @@ namespace webm {
 /// An implementation of a Segmenter for a single-segment.  This assumes that
 /// the output file is seekable.  For non-seekable files, use
 /// TwoPassSingleSegmentSegmenter.
+///
+/// The media is written in a single pass.  If the number of segments can be
+/// bounded from the stream duration and the target segment duration, space
+/// for the Cues is reserved (as a Void element) right after the header and the
+/// Cues are patched in place on finalize, so they precede the Clusters.  If the
+/// reservation turns out to be too small, the output is rewritten with the
+/// Clusters copied after the Cues, as TwoPassSingleSegmentSegmenter does.
+/// Without a reservation, the Cues are appended to the end of the file.
 class SingleSegmentSegmenter : public Segmenter {
  public:
   explicit SingleSegmentSegmenter(const MuxerOptions& options);
+  /// Create a segmenter writing to an already opened, seekable @a writer.
+  SingleSegmentSegmenter(const MuxerOptions& options,
+                         std::unique_ptr<MkvWriter> writer);
   ~SingleSegmentSegmenter() override;
 
   /// @name Segmenter implementation overrides.
@@ -48,6 +60,20 @@ class SingleSegmentSegmenter : public Segmenter {
     writer_ = std::move(writer);
   }
 
+  /// Writes the Segment header, with an unknown size, to writer() and sets
+  /// the end of the init range and the Cluster position accordingly.
+  Status WriteInitialSegmentHeader();
+
+  /// Writes the output file with the header and the Cues followed by the
+  /// Clusters, which are copied from another file.  The Cue positions must be
+  /// those of Clusters right after the header.
+  /// @param source_file_name is the file containing the Clusters.
+  /// @param clusters_start is the position of the first Cluster in the file.
+  /// @param clusters_size is the size of the Clusters.
+  Status WriteOutputWithCuesBeforeClusters(const std::string& source_file_name,
+                                           uint64_t clusters_start,
+                                           uint64_t clusters_size);
+
   // Segmenter implementation overrides.
   Status DoInitialize() override;
   Status DoFinalize() override;
@@ -56,10 +82,25 @@ class SingleSegmentSegmenter : public Segmenter {
   // Segmenter implementation overrides.
   Status NewSegment(uint64_t start_timestamp, bool is_subsegment) override;
 
+  // Returns an upper bound of the Cues size, or 0 if the number of segments
+  // cannot be bounded.
+  uint64_t EstimateMaxCuesSize() const;
+  // Rewrites the output with the Cues before the Clusters when they do not fit
+  // in the reserved space.
+  Status RewriteWithoutReservedSpace();
+  // Copies the data from source to destination while rewriting the Cluster
+  // sizes to the correct values.  This assumes that @a source is at the start
+  // of the Clusters and that the headers have already been written.
+  bool CopyFileWithClusterRewrite(File* source,
+                                  MkvWriter* dest,
+                                  uint64_t last_size);
+
   std::unique_ptr<MkvWriter> writer_;
   uint64_t init_end_;
   uint64_t index_start_;
-  uint64_t index_end_;
+  uint64_t index_end_ = 0;
+  // Size of the Void element reserved for the Cues after the header.
+  uint64_t reserved_cues_size_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(SingleSegmentSegmenter);
 };
@@ -6,7 +6,9 @@
 
 #include <gtest/gtest.h>
 #include <memory>
+#include "packager/file/file.h"
 #include "packager/media/formats/webm/segmenter_test_base.h"
+#include "packager/media/formats/webm/single_segment_segmenter.h"
 
 namespace shaka {
 namespace media {
@@ -289,5 +291,82 @@ TEST_F(SingleSegmentSegmenterTest, ReallyLargeTimestamp) {
   }
 }
 
+class SinglePassSingleSegmentSegmenterTest : public SegmentTestBase {
+ public:
+  SinglePassSingleSegmentSegmenterTest()
+      : info_(CreateVideoStreamInfo(kTimeScale)) {}
+
+ protected:
+  void InitializeSegmenter(const MuxerOptions& options) {
+    ASSERT_NO_FATAL_FAILURE(
+        CreateAndInitializeSegmenter<webm::SingleSegmentSegmenter>(
+            options, *info_, &segmenter_));
+  }
+
+  // Writes |num_segments| one-sample segments.
+  void WriteSegments(int num_segments) {
+    for (int i = 0; i < num_segments; i++) {
+      std::shared_ptr<MediaSample> sample =
+          CreateSample(kKeyFrame, kDuration, kNoSideData);
+      ASSERT_OK(segmenter_->AddSample(*sample));
+      ASSERT_OK(segmenter_->FinalizeSegment(i * kDuration, kDuration,
+                                            !kSubsegment));
+    }
+    ASSERT_OK(segmenter_->Finalize());
+  }
+
+  std::shared_ptr<StreamInfo> info_;
+  std::unique_ptr<webm::Segmenter> segmenter_;
+};
+
+TEST_F(SinglePassSingleSegmentSegmenterTest, CuesBeforeClusters) {
+  MuxerOptions options = CreateMuxerOptions();
+  options.segment_duration_in_seconds = 1;
+  ASSERT_NO_FATAL_FAILURE(InitializeSegmenter(options));
+  ASSERT_NO_FATAL_FAILURE(WriteSegments(8));
+
+  ClusterParser parser;
+  ASSERT_NO_FATAL_FAILURE(parser.PopulateFromSegment(OutputFileName()));
+  ASSERT_EQ(8u, parser.cluster_count());
+
+  uint64_t init_start, init_end, index_start, index_end;
+  ASSERT_TRUE(segmenter_->GetInitRangeStartAndEnd(&init_start, &init_end));
+  ASSERT_TRUE(segmenter_->GetIndexRangeStartAndEnd(&index_start, &index_end));
+  EXPECT_EQ(init_end + 1, index_start);
+
+  const std::vector<Range> ranges = segmenter_->GetSegmentRanges();
+  ASSERT_EQ(8u, ranges.size());
+  EXPECT_LT(index_end, ranges.front().start);
+  EXPECT_EQ(static_cast<int64_t>(ranges.back().end + 1),
+            File::GetFileSize(OutputFileName().c_str()));
+}
+
+TEST_F(SinglePassSingleSegmentSegmenterTest, RewritesIfReservationTooSmall) {
+  MuxerOptions options = CreateMuxerOptions();
+  // Only reserves space for a few cue points.
+  options.segment_duration_in_seconds = 100;
+  ASSERT_NO_FATAL_FAILURE(InitializeSegmenter(options));
+  ASSERT_NO_FATAL_FAILURE(WriteSegments(8));
+
+  ClusterParser parser;
+  ASSERT_NO_FATAL_FAILURE(parser.PopulateFromSegment(OutputFileName()));
+  ASSERT_EQ(8u, parser.cluster_count());
+  for (size_t i = 0; i < parser.cluster_count(); i++)
+    EXPECT_EQ(1u, parser.GetFrameCountForCluster(i));
+
+  // The output is rewritten as in two passes, with the Clusters right after
+  // the Cues.
+  uint64_t init_start, init_end, index_start, index_end;
+  ASSERT_TRUE(segmenter_->GetInitRangeStartAndEnd(&init_start, &init_end));
+  ASSERT_TRUE(segmenter_->GetIndexRangeStartAndEnd(&index_start, &index_end));
+  EXPECT_EQ(init_end + 1, index_start);
+
+  const std::vector<Range> ranges = segmenter_->GetSegmentRanges();
+  ASSERT_EQ(8u, ranges.size());
+  EXPECT_EQ(index_end + 1, ranges.front().start);
+  EXPECT_EQ(static_cast<int64_t>(ranges.back().end + 1),
+            File::GetFileSize(OutputFileName().c_str()));
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -33,14 +33,6 @@ class TwoPassSingleSegmentSegmenter : public SingleSegmentSegmenter {
   Status DoFinalize() override;
 
  private:
-  /// Copies the data from source to destination while rewriting the Cluster
-  /// sizes to the correct values.  This assumes that both @a source and
-  /// @a dest are at the same position and that the headers have already
-  /// been copied.
-  bool CopyFileWithClusterRewrite(File* source,
-                                  MkvWriter* dest,
-                                  uint64_t last_size);
-
   std::string temp_file_name_;
 
   DISALLOW_COPY_AND_ASSIGN(TwoPassSingleSegmentSegmenter);
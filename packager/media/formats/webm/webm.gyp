@@ -59,6 +59,7 @@
         '../../../third_party/gflags/gflags.gyp:gflags',
         '../../../third_party/libwebm/libwebm.gyp:mkvmuxer',
         '../../base/media_base.gyp:media_base',
+        '../../../packager.gyp:trace_event',
         '../../codecs/codecs.gyp:codecs'
       ],
     },
@@ -5,6 +5,7 @@
 #include "packager/media/formats/webm/webm_cluster_parser.h"
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "packager/base/logging.h"
@@ -83,6 +84,8 @@ void WebMClusterParser::Reset() {
   cluster_start_time_ = kNoTimestamp;
   cluster_ended_ = false;
   parser_.Reset();
+  use_list_parser_ = false;
+  cluster_bytes_remaining_ = -1;
   audio_.Reset();
   video_.Reset();
   ResetTextTracks();
@@ -97,14 +100,21 @@ bool WebMClusterParser::Flush() {
 }
 
 int WebMClusterParser::Parse(const uint8_t* buf, int size) {
-  int result = parser_.Parse(buf, size);
+  int result = 0;
+  if (!use_list_parser_)
+    result = ParseKnownSizeCluster(buf, size);
+  // ParseKnownSizeCluster() hands clusters of unknown size over to |parser_|
+  // without consuming any data.
+  if (use_list_parser_)
+    result = parser_.Parse(buf, size);
 
   if (result < 0) {
     cluster_ended_ = false;
     return result;
   }
 
-  cluster_ended_ = parser_.IsParsingComplete();
+  cluster_ended_ = use_list_parser_ ? parser_.IsParsingComplete()
+                                    : cluster_bytes_remaining_ == 0;
   if (cluster_ended_) {
     // If there were no buffers in this cluster, set the cluster start time to
     // be the |cluster_timecode_|.
@@ -121,6 +131,8 @@ int WebMClusterParser::Parse(const uint8_t* buf, int size) {
     // it is ready to accept another cluster on the next
     // call.
     parser_.Reset();
+    use_list_parser_ = false;
+    cluster_bytes_remaining_ = -1;
 
     last_block_timecode_ = -1;
     cluster_timecode_ = -1;
@@ -129,12 +141,115 @@ int WebMClusterParser::Parse(const uint8_t* buf, int size) {
   return result;
 }
 
+int WebMClusterParser::ParseKnownSizeCluster(const uint8_t* buf, int size) {
+  const uint8_t* cur = buf;
+  int cur_size = size;
+  int bytes_parsed = 0;
+
+  if (cluster_bytes_remaining_ < 0) {
+    int id = 0;
+    int64_t element_size = 0;
+    const int result =
+        WebMParseElementHeader(cur, cur_size, &id, &element_size);
+    if (result <= 0)
+      return result;
+    if (id != kWebMIdCluster)
+      return -1;
+    if (element_size == kWebMUnknownSize) {
+      use_list_parser_ = true;
+      return 0;
+    }
+    OnListStart(kWebMIdCluster);
+    cluster_bytes_remaining_ = element_size;
+    cur += result;
+    cur_size -= result;
+    bytes_parsed += result;
+  }
+
+  while (cluster_bytes_remaining_ > 0 && cur_size > 0) {
+    int id = 0;
+    int64_t element_size = 0;
+    const int header_size =
+        WebMParseElementHeader(cur, cur_size, &id, &element_size);
+    if (header_size < 0)
+      return -1;
+    if (header_size == 0)
+      break;
+
+    // Make sure the whole element can fit inside the cluster.
+    if (element_size == kWebMUnknownSize ||
+        header_size + element_size > cluster_bytes_remaining_) {
+      return -1;
+    }
+    // Only parse complete elements, so blocks can be referenced in place.
+    if (cur_size - header_size < element_size)
+      break;
+
+    const uint8_t* data = cur + header_size;
+    const int data_size = static_cast<int>(element_size);
+    const int total_size = header_size + data_size;
+    bool valid = false;
+    switch (id) {
+      case kWebMIdSimpleBlock:
+        valid = ParseBlock(true, data, data_size, NULL, 0, -1, 0, false);
+        break;
+      case kWebMIdTimecode:
+        valid = ParseClusterTimecode(data, data_size);
+        break;
+      case kWebMIdBlockGroup:
+        valid = ParseBlockGroup(cur, total_size);
+        break;
+      case kWebMIdSilentTracks:
+      case kWebMIdPosition:
+      case kWebMIdPrevSize:
+      case kWebMIdVoid:
+      case kWebMIdCRC32:
+        valid = true;
+        break;
+      default:
+        DVLOG(1) << "No ElementType info for ID 0x" << std::hex << id;
+        return -1;
+    }
+    if (!valid)
+      return -1;
+
+    cur += total_size;
+    cur_size -= total_size;
+    bytes_parsed += total_size;
+    cluster_bytes_remaining_ -= total_size;
+  }
+  return bytes_parsed;
+}
+
+bool WebMClusterParser::ParseClusterTimecode(const uint8_t* buf, int size) {
+  if (size <= 0 || size > 8 || cluster_timecode_ != -1)
+    return false;
+
+  // Read in the big-endian integer.
+  uint64_t value = 0;
+  for (int i = 0; i < size; ++i)
+    value = (value << 8) | buf[i];
+  if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+    return false;
+
+  cluster_timecode_ = static_cast<int64_t>(value);
+  return true;
+}
+
+bool WebMClusterParser::ParseBlockGroup(const uint8_t* buf, int size) {
+  WebMListParser block_group_parser(kWebMIdBlockGroup, this);
+  block_group_in_buffer_ = true;
+  const int result = block_group_parser.Parse(buf, size);
+  block_group_in_buffer_ = false;
+  return result == size && block_group_parser.IsParsingComplete();
+}
+
 WebMParserClient* WebMClusterParser::OnListStart(int id) {
   if (id == kWebMIdCluster) {
     cluster_timecode_ = -1;
     cluster_start_time_ = kNoTimestamp;
   } else if (id == kWebMIdBlockGroup) {
-    block_data_.reset();
+    block_data_ = nullptr;
     block_data_size_ = -1;
     block_duration_ = -1;
     discard_padding_ = -1;
@@ -160,10 +275,10 @@ bool WebMClusterParser::OnListEnd(int id) {
   }
 
   bool result = ParseBlock(
-      false, block_data_.get(), block_data_size_, block_additional_data_.get(),
+      false, block_data_, block_data_size_, block_additional_data_.get(),
       block_additional_data_size_, block_duration_,
       discard_padding_set_ ? discard_padding_ : 0, reference_block_set_);
-  block_data_.reset();
+  block_data_ = nullptr;
   block_data_size_ = -1;
   block_duration_ = -1;
   block_add_id_ = -1;
@@ -253,8 +368,15 @@ bool WebMClusterParser::OnBinary(int id, const uint8_t* data, int size) {
                       "supported.";
         return false;
       }
-      block_data_.reset(new uint8_t[size]);
-      memcpy(block_data_.get(), data, size);
+      if (block_group_in_buffer_) {
+        block_data_ = data;
+      } else {
+        // |data| is only valid during this call, but the BlockGroup may end
+        // in a later Parse() call.
+        block_data_storage_.reset(new uint8_t[size]);
+        memcpy(block_data_storage_.get(), data, size);
+        block_data_ = block_data_storage_.get();
+      }
       block_data_size_ = size;
       return true;
 
@@ -142,7 +142,11 @@ class WebMClusterParser : public WebMParserClient {
   /// @return true on success, false otherwise.
   bool Flush() WARN_UNUSED_RESULT;
 
-  /// Parses a WebM cluster element in |buf|.
+  /// Parses a WebM cluster element in |buf|. Clusters of known size are
+  /// parsed with a specialized parser which handles the Timecode, SimpleBlock
+  /// and BlockGroup elements directly and references complete blocks from
+  /// |buf| without intermediate copies; clusters of unknown size go through
+  /// the generic WebMListParser.
   /// @return -1 if the parse fails.
   /// @return 0 if more data is needed.
   /// @return The number of bytes parsed on success.
@@ -160,6 +164,14 @@ class WebMClusterParser : public WebMParserClient {
   bool OnUInt(int id, int64_t val) override;
   bool OnBinary(int id, const uint8_t* data, int size) override;
 
+  // Parses the children of a cluster of known size, one complete element at a
+  // time. Switches to |parser_| if the cluster size is unknown.
+  // Returns the number of bytes parsed, or -1 on error.
+  int ParseKnownSizeCluster(const uint8_t* buf, int size);
+  bool ParseClusterTimecode(const uint8_t* buf, int size);
+  // Parses a complete BlockGroup element, including its header, in |buf|.
+  bool ParseBlockGroup(const uint8_t* buf, int size);
+
   bool ParseBlock(bool is_simple_block,
                   const uint8_t* buf,
                   int size,
@@ -199,6 +211,11 @@ class WebMClusterParser : public WebMParserClient {
   std::string video_encryption_key_id_;
 
   WebMListParser parser_;
+  // True if the current cluster has unknown size and is parsed by |parser_|.
+  bool use_list_parser_ = false;
+  // Bytes left in the current cluster parsed by ParseKnownSizeCluster(), or -1
+  // if its header has not been parsed yet.
+  int64_t cluster_bytes_remaining_ = -1;
 
   // Indicates whether init_cb has been executed. |init_cb| is executed when we
   // have codec configuration of video stream, which is extracted from the first
@@ -207,8 +224,14 @@ class WebMClusterParser : public WebMParserClient {
   MediaParser::InitCB init_cb_;
 
   int64_t last_block_timecode_ = -1;
-  std::unique_ptr<uint8_t[]> block_data_;
+  // Points to the Block in the current BlockGroup. It references the input
+  // buffer if the whole BlockGroup is available in it, or
+  // |block_data_storage_| otherwise.
+  const uint8_t* block_data_ = nullptr;
+  std::unique_ptr<uint8_t[]> block_data_storage_;
   int block_data_size_ = -1;
+  // True while parsing a BlockGroup that is completely in the input buffer.
+  bool block_group_in_buffer_ = false;
   int64_t block_duration_ = -1;
   int64_t block_add_id_ = -1;
 
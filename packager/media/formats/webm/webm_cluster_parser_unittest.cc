@@ -634,6 +634,44 @@ TEST_F(WebMClusterParserTest, ParseClusterWithMultipleCalls) {
   ASSERT_TRUE(VerifyBuffers(kDefaultBlockInfo, block_count));
 }
 
+// Clusters of unknown size are parsed by the generic list parser, which may
+// see a BlockGroup across several Parse() calls.
+TEST_F(WebMClusterParserTest, ParseUnknownSizeClusterWithMultipleCalls) {
+  int block_count = arraysize(kDefaultBlockInfo);
+  ClusterBuilder cb;
+  cb.SetClusterTimecode(0);
+  const uint8_t kBlockData[] = {0x00, 0x0A, 0x01, 0x0D, 0x02};
+  for (int i = 0; i < block_count; i++) {
+    const BlockInfo& info = kDefaultBlockInfo[i];
+    if (info.use_simple_block) {
+      cb.AddSimpleBlock(info.track_num, info.timestamp,
+                        info.is_key_frame ? 0x80 : 0x00, kBlockData,
+                        arraysize(kBlockData));
+    } else {
+      cb.AddBlockGroup(info.track_num, info.timestamp, info.duration, 0,
+                       info.is_key_frame, kBlockData, arraysize(kBlockData));
+    }
+  }
+  std::unique_ptr<Cluster> cluster(cb.FinishWithUnknownSize());
+
+  const uint8_t* data = cluster->data();
+  int size = cluster->size();
+  const int kParseSize = 3;
+  int parse_size = std::min(kParseSize, size);
+  while (size > 0) {
+    int result = parser_->Parse(data, parse_size);
+    ASSERT_GE(result, 0);
+    if (result == 0) {
+      parse_size = std::min(parse_size + kParseSize, size);
+      continue;
+    }
+    parse_size = std::min(kParseSize, size - result);
+    data += result;
+    size -= result;
+  }
+  ASSERT_TRUE(VerifyBuffers(kDefaultBlockInfo, block_count));
+}
+
 // Verify that both BlockGroups with the BlockDuration before the Block
 // and BlockGroups with the BlockDuration after the Block are supported
 // correctly.
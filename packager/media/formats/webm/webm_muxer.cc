@@ -34,7 +34,9 @@ Status WebMMuxer::InitializeMuxer() {
   if (!options().segment_template.empty()) {
     segmenter_.reset(new MultiSegmentSegmenter(options()));
   } else {
-    segmenter_.reset(new TwoPassSingleSegmentSegmenter(options()));
+    Status status = CreateSingleSegmentSegmenter();
+    if (!status.ok())
+      return status;
   }
 
   Status initialized = segmenter_->Initialize(
@@ -46,6 +48,34 @@ Status WebMMuxer::InitializeMuxer() {
   return Status::OK;
 }
 
+Status WebMMuxer::CreateSingleSegmentSegmenter() {
+  // The Cues are only reserved up front if enabled and if the number of
+  // segments can be bounded; otherwise fall back to writing the clusters to a
+  // temporary file and copying them after the Cues.
+  if (!options().webm_single_pass ||
+      options().segment_duration_in_seconds <= 0 ||
+      streams()[0]->duration() == 0) {
+    segmenter_.reset(new TwoPassSingleSegmentSegmenter(options()));
+    return Status::OK;
+  }
+
+  std::unique_ptr<MkvWriter> writer(new MkvWriter);
+  Status status = writer->Open(options().output_file_name);
+  if (!status.ok())
+    return status;
+  if (writer->Seekable()) {
+    segmenter_.reset(new SingleSegmentSegmenter(options(), std::move(writer)));
+    return Status::OK;
+  }
+
+  // The two-pass segmenter opens the output again on finalize.
+  status = writer->Close();
+  if (!status.ok())
+    return status;
+  segmenter_.reset(new TwoPassSingleSegmentSegmenter(options()));
+  return Status::OK;
+}
+
 Status WebMMuxer::Finalize() {
   DCHECK(segmenter_);
   Status segmenter_finalized = segmenter_->Finalize();
@@ -30,6 +30,10 @@ class WebMMuxer : public Muxer {
   Status FinalizeSegment(size_t stream_id,
                          const SegmentInfo& segment_info) override;
 
+  // Creates a single-pass segmenter if enabled, the output is seekable and the
+  // Cues size can be bounded, or a two-pass segmenter otherwise.
+  Status CreateSingleSegmentSegmenter();
+
   void FireOnMediaStartEvent();
   void FireOnMediaEndEvent();
 
@@ -31,6 +31,7 @@ class TextPadder : public MediaHandler {
   TextPadder(const TextPadder&) = delete;
   TextPadder& operator=(const TextPadder&) = delete;
 
+  std::string name() const override { return "TextPadder"; }
   Status InitializeInternal() override;
 
   Status Process(std::unique_ptr<StreamData> data) override;
@@ -29,6 +29,7 @@ class WebVttParser : public OriginHandler {
   WebVttParser(const WebVttParser&) = delete;
   WebVttParser& operator=(const WebVttParser&) = delete;
 
+  std::string name() const override { return "WebVttParser"; }
   Status InitializeInternal() override;
   bool ValidateOutputStreamIndex(size_t stream_index) const override;
 
@@ -29,6 +29,7 @@ class WebVttTextOutputHandler : public MediaHandler {
   WebVttTextOutputHandler(const WebVttTextOutputHandler&) = delete;
   WebVttTextOutputHandler& operator=(const WebVttTextOutputHandler&) = delete;
 
+  std::string name() const override { return "WebVttTextOutputHandler"; }
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
   Status OnFlushRequest(size_t input_stream_index) override;
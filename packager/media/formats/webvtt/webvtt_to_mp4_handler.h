@@ -30,6 +30,7 @@ class WebVttToMp4Handler : public MediaHandler {
   WebVttToMp4Handler(const WebVttToMp4Handler&) = delete;
   WebVttToMp4Handler& operator=(const WebVttToMp4Handler&) = delete;
 
+  std::string name() const override { return "WebVttToMp4Handler"; }
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
 
@@ -61,6 +61,10 @@ struct WidevineEncryptionParams {
   std::vector<uint8_t> group_id;
   /// Enables entitlement license when set to true.
   bool enable_entitlement_license;
+  /// Number of crypto periods requested from the key server in a single key
+  /// rotation request. Keys are prefetched ahead of the crypto period being
+  /// encrypted. Only applicable if key rotation is enabled.
+  uint32_t crypto_period_count = 10;
 };
 
 /// PlayReady encryption parameters.
@@ -140,6 +144,13 @@ struct EncryptionParams {
   double crypto_period_duration_in_seconds = kNoKeyRotation;
   /// Enable/disable subsample encryption for VP9.
   bool vp9_subsample_encryption = true;
+  /// Derive the IVs from the key, the stream and the sample DTS instead of
+  /// generating a random IV which is incremented for every sample. The IVs
+  /// are then the same if the stream is packaged again, e.g. after a restart
+  /// or in parallel chunks. The DTS of the encrypted samples of a stream must
+  /// increase, as the IVs are unique only then; encryption fails otherwise.
+  /// Cannot be used with RawKeyParams::iv.
+  bool derive_iv = false;
 
   /// Encrypted stream information that is used to determine stream label.
   struct EncryptedStreamAttributes {
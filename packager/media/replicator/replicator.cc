@@ -6,9 +6,35 @@
 
 #include "packager/media/replicator/replicator.h"
 
+#include "packager/status_macros.h"
+
 namespace shaka {
 namespace media {
 
+void Replicator::AddHandlerAtSegmentBoundary(
+    std::shared_ptr<MediaHandler> handler) {
+  DCHECK(handler);
+  HandlerChange change;
+  change.handler_to_add = std::move(handler);
+
+  base::AutoLock auto_lock(handler_changes_lock_);
+  handler_changes_.push_back(std::move(change));
+  has_handler_changes_.store(true, std::memory_order_release);
+}
+
+void Replicator::RemoveHandlerAtSegmentBoundary(
+    const MediaHandler* handler,
+    std::function<void()> removed_callback) {
+  DCHECK(handler);
+  HandlerChange change;
+  change.handler_to_remove = handler;
+  change.removed_callback = std::move(removed_callback);
+
+  base::AutoLock auto_lock(handler_changes_lock_);
+  handler_changes_.push_back(std::move(change));
+  has_handler_changes_.store(true, std::memory_order_release);
+}
+
 Status Replicator::InitializeInternal() {
   return Status::OK;
 }
@@ -16,6 +42,12 @@ Status Replicator::InitializeInternal() {
 Status Replicator::Process(std::unique_ptr<StreamData> stream_data) {
   Status status;
 
+  const bool segment_boundary =
+      stream_data->stream_data_type == StreamDataType::kSegmentInfo &&
+      !stream_data->segment_info->is_subsegment;
+  if (stream_data->stream_data_type == StreamDataType::kStreamInfo)
+    stream_info_ = stream_data->stream_info;
+
   for (auto& out : output_handlers()) {
     std::unique_ptr<StreamData> copy(new StreamData(*stream_data));
     copy->stream_index = out.first;
@@ -23,6 +55,10 @@ Status Replicator::Process(std::unique_ptr<StreamData> stream_data) {
     status.Update(Dispatch(std::move(copy)));
   }
 
+  if (segment_boundary &&
+      has_handler_changes_.load(std::memory_order_acquire)) {
+    status.Update(ApplyHandlerChanges(false));
+  }
   return status;
 }
 
@@ -32,8 +68,51 @@ bool Replicator::ValidateOutputStreamIndex(size_t stream_index) const {
 
 Status Replicator::OnFlushRequest(size_t input_stream_index) {
   DCHECK_EQ(input_stream_index, 0u);
+  if (has_handler_changes_.load(std::memory_order_acquire))
+    RETURN_IF_ERROR(ApplyHandlerChanges(true));
   return FlushAllDownstreams();
 }
 
+Status Replicator::ApplyHandlerChanges(bool end_of_stream) {
+  std::list<HandlerChange> handler_changes;
+  {
+    base::AutoLock auto_lock(handler_changes_lock_);
+    handler_changes.swap(handler_changes_);
+    has_handler_changes_.store(false, std::memory_order_release);
+  }
+
+  for (HandlerChange& change : handler_changes) {
+    if (change.handler_to_remove) {
+      RETURN_IF_ERROR(RemoveOutputHandler(change.handler_to_remove));
+      if (change.removed_callback)
+        change.removed_callback();
+      continue;
+    }
+    if (end_of_stream)
+      continue;
+    if (!stream_info_) {
+      return Status(error::INTERNAL_ERROR,
+                    "Cannot add a handler before the stream info.");
+    }
+    const size_t output_stream_index = next_output_stream_index();
+    RETURN_IF_ERROR(
+        AttachHandler(output_stream_index, std::move(change.handler_to_add)));
+    RETURN_IF_ERROR(DispatchStreamInfo(output_stream_index, stream_info_));
+  }
+  return Status::OK;
+}
+
+Status Replicator::RemoveOutputHandler(const MediaHandler* handler) {
+  for (const auto& out : output_handlers()) {
+    if (out.second.first.get() == handler) {
+      const size_t output_stream_index = out.first;
+      RETURN_IF_ERROR(FlushDownstream(output_stream_index));
+      return DetachHandler(output_stream_index);
+    }
+  }
+  return Status(error::NOT_FOUND,
+                "The handler to remove is not connected to the replicator.");
+}
+
 }  // namespace media
 }  // namespace shaka
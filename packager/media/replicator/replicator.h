@@ -7,6 +7,11 @@
 #ifndef PACKAGER_MEDIA_REPLICATOR_HANDLER_H_
 #define PACKAGER_MEDIA_REPLICATOR_HANDLER_H_
 
+#include <atomic>
+#include <functional>
+#include <list>
+
+#include "packager/base/synchronization/lock.h"
 #include "packager/media/base/media_handler.h"
 
 namespace shaka {
@@ -16,12 +21,52 @@ namespace media {
 /// downstream handlers. The messages that are sent downstream are not copies,
 /// they are the original message. It is the responsibility of downstream
 /// handlers to make a copy before modifying the message.
+///
+/// Downstream handlers can also be added and removed while the graph is
+/// running. The changes take effect at the next segment boundary, so that
+/// every downstream handler sees whole segments.
 class Replicator : public MediaHandler {
+ public:
+  /// Adds @a handler as a downstream handler at the next segment boundary. It
+  /// receives the last stream info and then the samples of the next segment.
+  /// Can be called from any thread.
+  /// @param handler must not be connected to an upstream handler.
+  void AddHandlerAtSegmentBoundary(std::shared_ptr<MediaHandler> handler);
+
+  /// Flushes and removes the downstream handler @a handler at the next
+  /// segment boundary. Can be called from any thread.
+  /// @param removed_callback is called, on the thread running the replicator,
+  ///        once @a handler has been flushed and removed. Can be null.
+  void RemoveHandlerAtSegmentBoundary(const MediaHandler* handler,
+                                      std::function<void()> removed_callback);
+
  private:
+  struct HandlerChange {
+    // The handler to add. Null if this is a removal.
+    std::shared_ptr<MediaHandler> handler_to_add;
+    const MediaHandler* handler_to_remove = nullptr;
+    std::function<void()> removed_callback;
+  };
+
+  std::string name() const override { return "Replicator"; }
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
   bool ValidateOutputStreamIndex(size_t stream_index) const override;
   Status OnFlushRequest(size_t input_stream_index) override;
+
+  // Applies the pending handler changes. Additions are dropped at the end of
+  // the stream, i.e. if |end_of_stream| is true.
+  Status ApplyHandlerChanges(bool end_of_stream);
+  Status RemoveOutputHandler(const MediaHandler* handler);
+
+  // The last stream info, which is replayed to the added handlers.
+  std::shared_ptr<const StreamInfo> stream_info_;
+
+  base::Lock handler_changes_lock_;
+  std::list<HandlerChange> handler_changes_;
+  // Set if |handler_changes_| is not empty, so that the segment boundaries do
+  // not need to take the lock.
+  std::atomic<bool> has_handler_changes_{false};
 };
 
 }  // namespace media
@@ -0,0 +1,134 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/replicator/replicator.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "packager/media/base/media_handler_test_base.h"
+#include "packager/status_test_util.h"
+
+using ::testing::_;
+
+namespace shaka {
+namespace media {
+namespace {
+const size_t kInputCount = 1;
+const size_t kInputIndex = 0;
+const size_t kStreamIndex = 0;
+
+const uint32_t kTimescale = 1000u;
+const int64_t kSampleDuration = 100;
+const int64_t kSegmentDuration = 200;
+
+const bool kKeyFrame = true;
+const bool kSubsegment = true;
+const bool kEncrypted = true;
+}  // namespace
+
+class ReplicatorTest : public MediaHandlerTestBase {
+ protected:
+  void SetUpAndInitializeGraph(size_t output_count) {
+    replicator_ = std::make_shared<Replicator>();
+    ASSERT_OK(MediaHandlerTestBase::SetUpAndInitializeGraph(
+        replicator_, kInputCount, output_count));
+  }
+
+  Status DispatchStreamInfo() {
+    auto info = GetVideoStreamInfo(kTimescale);
+    auto data = StreamData::FromStreamInfo(kStreamIndex, std::move(info));
+    return Input(kInputIndex)->Dispatch(std::move(data));
+  }
+
+  Status DispatchSample(int64_t time) {
+    auto sample = GetMediaSample(time, kSampleDuration, kKeyFrame);
+    auto data = StreamData::FromMediaSample(kStreamIndex, std::move(sample));
+    return Input(kInputIndex)->Dispatch(std::move(data));
+  }
+
+  Status DispatchSegment(int64_t start_time, bool is_subsegment) {
+    auto info = GetSegmentInfo(start_time, kSegmentDuration, is_subsegment);
+    auto data = StreamData::FromSegmentInfo(kStreamIndex, std::move(info));
+    return Input(kInputIndex)->Dispatch(std::move(data));
+  }
+
+  Status Flush() { return Input(kInputIndex)->FlushAllDownstreams(); }
+
+  std::shared_ptr<Replicator> replicator_;
+};
+
+TEST_F(ReplicatorTest, AddsHandlerAtSegmentBoundary) {
+  SetUpAndInitializeGraph(1);
+  auto added_output = std::make_shared<MockOutputMediaHandler>();
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*added_output,
+                OnProcess(IsStreamInfo(kStreamIndex, kTimescale, !kEncrypted,
+                                       _)));
+    EXPECT_CALL(*added_output,
+                OnProcess(IsMediaSample(kStreamIndex, 400, kSampleDuration,
+                                        !kEncrypted, kKeyFrame)));
+    EXPECT_CALL(*added_output, OnFlush(kStreamIndex));
+  }
+  EXPECT_CALL(*Output(0), OnProcess(_)).Times(8);
+  EXPECT_CALL(*Output(0), OnFlush(kStreamIndex));
+
+  ASSERT_OK(DispatchStreamInfo());
+  ASSERT_OK(DispatchSample(0));
+  replicator_->AddHandlerAtSegmentBoundary(added_output);
+  ASSERT_OK(DispatchSample(100));
+  // Subsegments are not boundaries.
+  ASSERT_OK(DispatchSegment(0, kSubsegment));
+  ASSERT_OK(DispatchSample(200));
+  ASSERT_OK(DispatchSample(300));
+  ASSERT_OK(DispatchSegment(0, !kSubsegment));
+  ASSERT_OK(DispatchSample(400));
+  ASSERT_OK(Flush());
+}
+
+TEST_F(ReplicatorTest, RemovesHandlerAtSegmentBoundary) {
+  SetUpAndInitializeGraph(2);
+  bool removed = false;
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*Output(1), OnProcess(_)).Times(4);
+    EXPECT_CALL(*Output(1), OnFlush(kStreamIndex));
+  }
+  EXPECT_CALL(*Output(0), OnProcess(_)).Times(5);
+  EXPECT_CALL(*Output(0), OnFlush(kStreamIndex));
+
+  ASSERT_OK(DispatchStreamInfo());
+  ASSERT_OK(DispatchSample(0));
+  replicator_->RemoveHandlerAtSegmentBoundary(Output(1),
+                                              [&removed]() { removed = true; });
+  ASSERT_OK(DispatchSample(100));
+  EXPECT_FALSE(removed);
+  ASSERT_OK(DispatchSegment(0, !kSubsegment));
+  EXPECT_TRUE(removed);
+  ASSERT_OK(DispatchSample(200));
+  ASSERT_OK(Flush());
+}
+
+TEST_F(ReplicatorTest, DropsAdditionAtEndOfStream) {
+  SetUpAndInitializeGraph(1);
+  auto added_output = std::make_shared<MockOutputMediaHandler>();
+
+  EXPECT_CALL(*added_output, OnProcess(_)).Times(0);
+  EXPECT_CALL(*added_output, OnFlush(_)).Times(0);
+  EXPECT_CALL(*Output(0), OnProcess(_)).Times(2);
+  EXPECT_CALL(*Output(0), OnFlush(kStreamIndex));
+
+  ASSERT_OK(DispatchStreamInfo());
+  ASSERT_OK(DispatchSample(0));
+  replicator_->AddHandlerAtSegmentBoundary(added_output);
+  ASSERT_OK(Flush());
+}
+
+}  // namespace media
+}  // namespace shaka
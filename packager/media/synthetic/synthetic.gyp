@@ -0,0 +1,48 @@
+# Copyright 2020 Google LLC. All rights reserved.
+#
+# Use of this source code is governed by a BSD-style
+# license that can be found in the LICENSE file or at
+# https://developers.google.com/open-source/licenses/bsd
+
+{
+  'variables': {
+    'shaka_code': 1,
+  },
+  'targets': [
+    {
+      'target_name': 'synthetic',
+      'type': '<(component)',
+      'sources': [
+        'synthetic_es_generator.cc',
+        'synthetic_es_generator.h',
+        'synthetic_media_file.cc',
+        'synthetic_media_file.h',
+        'synthetic_media_options.cc',
+        'synthetic_media_options.h',
+        'synthetic_ts_generator.cc',
+        'synthetic_ts_generator.h',
+      ],
+      'dependencies': [
+        '../../file/file.gyp:file',
+        '../base/media_base.gyp:media_base',
+        '../codecs/codecs.gyp:codecs',
+        '../formats/mp2t/mp2t.gyp:mp2t',
+      ],
+    },
+    {
+      'target_name': 'synthetic_unittest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'synthetic_media_options_unittest.cc',
+        'synthetic_ts_generator_unittest.cc',
+      ],
+      'dependencies': [
+        '../../testing/gmock.gyp:gmock',
+        '../../testing/gtest.gyp:gtest',
+        '../formats/mp2t/mp2t.gyp:mp2t',
+        '../test/media_test.gyp:media_test_support',
+        'synthetic',
+      ]
+    },
+  ],
+}
@@ -0,0 +1,554 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/synthetic/synthetic_es_generator.h"
+
+#include <algorithm>
+
+#include "packager/base/logging.h"
+#include "packager/media/base/bit_writer.h"
+#include "packager/media/base/buffer_writer.h"
+#include "packager/media/codecs/nal_unit_to_byte_stream_converter.h"
+#include "packager/media/codecs/nalu_reader.h"
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+const uint8_t kStartCode[] = {0x00, 0x00, 0x00, 0x01};
+// Payload bytes are drawn from [kMinPayloadByte, kMinPayloadByte +
+// kPayloadByteRange), which excludes 0x00, 0x0B (AC-3 sync) and 0xFF (ADTS
+// sync).
+const uint8_t kMinPayloadByte = 0x10;
+const uint32_t kPayloadByteRange = 0x60;
+// rbsp_stop_one_bit followed by alignment zero bits.
+const uint8_t kRbspTrailingBits = 0x80;
+
+const uint32_t kAudioSamplingFrequency = 48000;
+const uint32_t kAacSamplesPerFrame = 1024;
+const uint32_t kAc3SamplesPerFrame = 1536;
+const size_t kAdtsHeaderSize = 7;
+// ADTS frame_length is a 13-bit field.
+const size_t kMaxAdtsFrameSize = (1 << 13) - 1;
+// Sampling frequency index of 48 kHz in ISO/IEC 14496-3 Table 1.18.
+const uint8_t kAdts48kHzFrequencyIndex = 3;
+const uint8_t kStereoChannelConfiguration = 2;
+// AC-3 bitrates in kbps, indexed by frmsizecod / 2. ATSC A/52 Table 5.18.
+const uint32_t kAc3BitratesInKbps[] = {32,  40,  48,  56,  64,  80,  96,
+                                       112, 128, 160, 192, 224, 256, 320,
+                                       384, 448, 512, 576, 640};
+
+// Writes Exp-Golomb coded syntax elements on top of BitWriter.
+class RbspWriter {
+ public:
+  explicit RbspWriter(std::vector<uint8_t>* storage) : writer_(storage) {}
+
+  void WriteBits(uint32_t bits, size_t number_of_bits) {
+    writer_.WriteBits(bits, number_of_bits);
+  }
+  void WriteFlag(bool flag) { writer_.WriteBits(flag ? 1 : 0, 1); }
+  // ue(v).
+  void WriteUe(uint32_t value) {
+    const uint64_t code_num = static_cast<uint64_t>(value) + 1;
+    size_t num_bits = 0;
+    while ((code_num >> num_bits) != 0)
+      ++num_bits;
+    if (num_bits > 1)
+      writer_.WriteBits(0, num_bits - 1);
+    writer_.WriteBits(static_cast<uint32_t>(code_num), num_bits);
+  }
+  // se(v).
+  void WriteSe(int32_t value) {
+    WriteUe(value > 0 ? 2 * value - 1 : -2 * value);
+  }
+  // Writes |bit| until the writer is byte aligned.
+  void Align(bool bit) {
+    const size_t remaining_bits = (8 - writer_.BitPos() % 8) % 8;
+    if (remaining_bits > 0)
+      writer_.WriteBits(bit ? (1 << remaining_bits) - 1 : 0, remaining_bits);
+    writer_.Flush();
+  }
+  // rbsp_trailing_bits().
+  void WriteTrailingBits() {
+    writer_.WriteBits(1, 1);
+    writer_.Flush();
+  }
+
+ private:
+  BitWriter writer_;
+};
+
+// Appends a start code, the NAL unit header and the escaped |rbsp|.
+void AppendNalu(const uint8_t* nalu_header,
+                size_t nalu_header_size,
+                const std::vector<uint8_t>& rbsp,
+                std::vector<uint8_t>* output) {
+  output->insert(output->end(), kStartCode, kStartCode + sizeof(kStartCode));
+  output->insert(output->end(), nalu_header, nalu_header + nalu_header_size);
+  BufferWriter escaped(rbsp.size() + rbsp.size() / 2);
+  EscapeNalByteSequence(rbsp.data(), rbsp.size(), &escaped);
+  output->insert(output->end(), escaped.Buffer(),
+                 escaped.Buffer() + escaped.Size());
+}
+
+void AppendH264Nalu(int nal_ref_idc,
+                    Nalu::H264NaluType type,
+                    const std::vector<uint8_t>& rbsp,
+                    std::vector<uint8_t>* output) {
+  const uint8_t nalu_header = static_cast<uint8_t>(nal_ref_idc << 5 | type);
+  AppendNalu(&nalu_header, 1, rbsp, output);
+}
+
+void AppendH265Nalu(Nalu::H265NaluType type,
+                    const std::vector<uint8_t>& rbsp,
+                    std::vector<uint8_t>* output) {
+  // nuh_layer_id = 0, nuh_temporal_id_plus1 = 1.
+  const uint8_t nalu_header[] = {static_cast<uint8_t>(type << 1), 0x01};
+  AppendNalu(nalu_header, sizeof(nalu_header), rbsp, output);
+}
+
+// profile_tier_level(1, 0) for the Main profile. H.265 7.3.3.
+void WriteH265ProfileTierLevel(uint8_t level_idc, RbspWriter* writer) {
+  writer->WriteBits(0, 2);  // general_profile_space
+  writer->WriteFlag(false);  // general_tier_flag
+  const uint8_t kMainProfile = 1;
+  writer->WriteBits(kMainProfile, 5);
+  // general_profile_compatibility_flag[1] and [2].
+  writer->WriteBits(0x60000000, 32);
+  writer->WriteFlag(true);   // general_progressive_source_flag
+  writer->WriteFlag(false);  // general_interlaced_source_flag
+  writer->WriteFlag(false);  // general_non_packed_constraint_flag
+  writer->WriteFlag(true);   // general_frame_only_constraint_flag
+  // general_reserved_zero_43bits and general_inbld_flag.
+  writer->WriteBits(0, 32);
+  writer->WriteBits(0, 12);
+  writer->WriteBits(level_idc, 8);
+}
+
+}  // namespace
+
+SyntheticRandom::SyntheticRandom(uint32_t seed)
+    // xorshift32 state must not be zero.
+    : state_(seed ^ 0x9E3779B9u) {
+  if (state_ == 0)
+    state_ = 0x9E3779B9u;
+}
+
+uint32_t SyntheticRandom::Next() {
+  state_ ^= state_ << 13;
+  state_ ^= state_ >> 17;
+  state_ ^= state_ << 5;
+  return state_;
+}
+
+void SyntheticRandom::AppendPayload(size_t size, std::vector<uint8_t>* output) {
+  const size_t offset = output->size();
+  output->resize(offset + size);
+  uint8_t* payload = output->data() + offset;
+  // One random number provides four bytes.
+  for (size_t i = 0; i < size; i += 4) {
+    uint32_t value = Next();
+    for (size_t j = i; j < std::min(size, i + 4); ++j) {
+      payload[j] = kMinPayloadByte + (value & 0xFF) % kPayloadByteRange;
+      value >>= 8;
+    }
+  }
+}
+
+SyntheticVideoGenerator::SyntheticVideoGenerator(Codec codec,
+                                                 uint32_t width,
+                                                 uint32_t height,
+                                                 uint32_t frame_rate)
+    : codec_(codec), width_(width), height_(height), frame_rate_(frame_rate) {
+  DCHECK(codec_ == kCodecH264 || codec_ == kCodecH265);
+  DCHECK_EQ(0u, width_ % 2);
+  DCHECK_EQ(0u, height_ % 2);
+  if (codec_ == kCodecH264)
+    GenerateH264ParameterSets();
+  else
+    GenerateH265ParameterSets();
+}
+
+void SyntheticVideoGenerator::GenerateAccessUnit(
+    bool is_key_frame,
+    size_t payload_size,
+    SyntheticRandom* random,
+    std::vector<uint8_t>* access_unit) {
+  DCHECK(random);
+  DCHECK(access_unit);
+  access_unit->clear();
+  if (is_key_frame) {
+    frame_index_ = 0;
+  } else {
+    ++frame_index_;
+  }
+
+  // primary_pic_type / pic_type: 0 for I slices only, 1 for P and I slices.
+  const std::vector<uint8_t> aud_rbsp = {
+      static_cast<uint8_t>((is_key_frame ? 0x00 : 0x20) | 0x10)};
+  if (codec_ == kCodecH264) {
+    AppendH264Nalu(0, Nalu::H264_AUD, aud_rbsp, access_unit);
+  } else {
+    AppendH265Nalu(Nalu::H265_AUD, aud_rbsp, access_unit);
+  }
+  if (is_key_frame) {
+    access_unit->insert(access_unit->end(), parameter_sets_.begin(),
+                        parameter_sets_.end());
+  }
+  if (codec_ == kCodecH264)
+    AppendH264Slice(is_key_frame, payload_size, random, access_unit);
+  else
+    AppendH265Slice(is_key_frame, payload_size, random, access_unit);
+  if (is_key_frame)
+    ++idr_pic_id_;
+}
+
+void SyntheticVideoGenerator::GenerateH264ParameterSets() {
+  const uint32_t width_in_mbs = (width_ + 15) / 16;
+  const uint32_t height_in_mbs = (height_ + 15) / 16;
+  const bool needs_cropping =
+      width_in_mbs * 16 != width_ || height_in_mbs * 16 != height_;
+
+  // seq_parameter_set_rbsp(). H.264 7.3.2.1.1.
+  std::vector<uint8_t> sps;
+  RbspWriter writer(&sps);
+  const uint8_t kMainProfile = 77;
+  writer.WriteBits(kMainProfile, 8);
+  // constraint_set1_flag for Main, the other constraint flags and
+  // reserved_zero_2bits.
+  writer.WriteBits(0x40, 8);
+  const uint8_t level_idc = width_ * height_ > 1920 * 1088 ? 51 : 40;
+  writer.WriteBits(level_idc, 8);
+  writer.WriteUe(0);  // seq_parameter_set_id
+  writer.WriteUe(4);  // log2_max_frame_num_minus4
+  // pic_order_cnt_type 2: output order equals decoding order, no B frames.
+  writer.WriteUe(2);
+  writer.WriteUe(1);  // max_num_ref_frames
+  writer.WriteFlag(false);  // gaps_in_frame_num_value_allowed_flag
+  writer.WriteUe(width_in_mbs - 1);
+  writer.WriteUe(height_in_mbs - 1);
+  writer.WriteFlag(true);  // frame_mbs_only_flag
+  writer.WriteFlag(true);  // direct_8x8_inference_flag
+  writer.WriteFlag(needs_cropping);
+  if (needs_cropping) {
+    // Crop units are two luma samples for 4:2:0.
+    writer.WriteUe(0);
+    writer.WriteUe((width_in_mbs * 16 - width_) / 2);
+    writer.WriteUe(0);
+    writer.WriteUe((height_in_mbs * 16 - height_) / 2);
+  }
+  writer.WriteFlag(true);  // vui_parameters_present_flag
+  writer.WriteFlag(true);  // aspect_ratio_info_present_flag
+  writer.WriteBits(1, 8);  // aspect_ratio_idc: 1:1
+  writer.WriteFlag(false);  // overscan_info_present_flag
+  writer.WriteFlag(false);  // video_signal_type_present_flag
+  writer.WriteFlag(false);  // chroma_loc_info_present_flag
+  writer.WriteFlag(true);  // timing_info_present_flag
+  writer.WriteBits(1, 32);  // num_units_in_tick
+  writer.WriteBits(frame_rate_ * 2, 32);  // time_scale
+  writer.WriteFlag(true);  // fixed_frame_rate_flag
+  writer.WriteFlag(false);  // nal_hrd_parameters_present_flag
+  writer.WriteFlag(false);  // vcl_hrd_parameters_present_flag
+  writer.WriteFlag(false);  // pic_struct_present_flag
+  writer.WriteFlag(false);  // bitstream_restriction_flag
+  writer.WriteTrailingBits();
+  AppendH264Nalu(3, Nalu::H264_SPS, sps, &parameter_sets_);
+
+  // pic_parameter_set_rbsp(). H.264 7.3.2.2.
+  std::vector<uint8_t> pps;
+  RbspWriter pps_writer(&pps);
+  pps_writer.WriteUe(0);  // pic_parameter_set_id
+  pps_writer.WriteUe(0);  // seq_parameter_set_id
+  pps_writer.WriteFlag(true);  // entropy_coding_mode_flag: CABAC
+  pps_writer.WriteFlag(false);  // bottom_field_pic_order_in_frame_present_flag
+  pps_writer.WriteUe(0);  // num_slice_groups_minus1
+  pps_writer.WriteUe(0);  // num_ref_idx_l0_default_active_minus1
+  pps_writer.WriteUe(0);  // num_ref_idx_l1_default_active_minus1
+  pps_writer.WriteFlag(false);  // weighted_pred_flag
+  pps_writer.WriteBits(0, 2);  // weighted_bipred_idc
+  pps_writer.WriteSe(0);  // pic_init_qp_minus26
+  pps_writer.WriteSe(0);  // pic_init_qs_minus26
+  pps_writer.WriteSe(0);  // chroma_qp_index_offset
+  pps_writer.WriteFlag(true);  // deblocking_filter_control_present_flag
+  pps_writer.WriteFlag(false);  // constrained_intra_pred_flag
+  pps_writer.WriteFlag(false);  // redundant_pic_cnt_present_flag
+  pps_writer.WriteTrailingBits();
+  AppendH264Nalu(3, Nalu::H264_PPS, pps, &parameter_sets_);
+}
+
+void SyntheticVideoGenerator::GenerateH265ParameterSets() {
+  // MinCbSizeY is 8.
+  const uint32_t coded_width = (width_ + 7) / 8 * 8;
+  const uint32_t coded_height = (height_ + 7) / 8 * 8;
+  const bool needs_cropping = coded_width != width_ || coded_height != height_;
+  const uint8_t level_idc = width_ * height_ > 1920 * 1088 ? 153 : 120;
+
+  // video_parameter_set_rbsp(). H.265 7.3.2.1.
+  std::vector<uint8_t> vps;
+  RbspWriter vps_writer(&vps);
+  vps_writer.WriteBits(0, 4);  // vps_video_parameter_set_id
+  vps_writer.WriteFlag(true);  // vps_base_layer_internal_flag
+  vps_writer.WriteFlag(true);  // vps_base_layer_available_flag
+  vps_writer.WriteBits(0, 6);  // vps_max_layers_minus1
+  vps_writer.WriteBits(0, 3);  // vps_max_sub_layers_minus1
+  vps_writer.WriteFlag(true);  // vps_temporal_id_nesting_flag
+  vps_writer.WriteBits(0xFFFF, 16);  // vps_reserved_0xffff_16bits
+  WriteH265ProfileTierLevel(level_idc, &vps_writer);
+  vps_writer.WriteFlag(true);  // vps_sub_layer_ordering_info_present_flag
+  vps_writer.WriteUe(1);  // vps_max_dec_pic_buffering_minus1
+  vps_writer.WriteUe(0);  // vps_max_num_reorder_pics
+  vps_writer.WriteUe(0);  // vps_max_latency_increase_plus1
+  vps_writer.WriteBits(0, 6);  // vps_max_layer_id
+  vps_writer.WriteUe(0);  // vps_num_layer_sets_minus1
+  vps_writer.WriteFlag(false);  // vps_timing_info_present_flag
+  vps_writer.WriteFlag(false);  // vps_extension_flag
+  vps_writer.WriteTrailingBits();
+  AppendH265Nalu(Nalu::H265_VPS, vps, &parameter_sets_);
+
+  // seq_parameter_set_rbsp(). H.265 7.3.2.2.
+  std::vector<uint8_t> sps;
+  RbspWriter writer(&sps);
+  writer.WriteBits(0, 4);  // sps_video_parameter_set_id
+  writer.WriteBits(0, 3);  // sps_max_sub_layers_minus1
+  writer.WriteFlag(true);  // sps_temporal_id_nesting_flag
+  WriteH265ProfileTierLevel(level_idc, &writer);
+  writer.WriteUe(0);  // sps_seq_parameter_set_id
+  writer.WriteUe(1);  // chroma_format_idc: 4:2:0
+  writer.WriteUe(coded_width);
+  writer.WriteUe(coded_height);
+  writer.WriteFlag(needs_cropping);  // conformance_window_flag
+  if (needs_cropping) {
+    // Offsets are in chroma samples for 4:2:0.
+    writer.WriteUe(0);
+    writer.WriteUe((coded_width - width_) / 2);
+    writer.WriteUe(0);
+    writer.WriteUe((coded_height - height_) / 2);
+  }
+  writer.WriteUe(0);  // bit_depth_luma_minus8
+  writer.WriteUe(0);  // bit_depth_chroma_minus8
+  writer.WriteUe(4);  // log2_max_pic_order_cnt_lsb_minus4
+  writer.WriteFlag(true);  // sps_sub_layer_ordering_info_present_flag
+  writer.WriteUe(1);  // sps_max_dec_pic_buffering_minus1
+  writer.WriteUe(0);  // sps_max_num_reorder_pics
+  writer.WriteUe(0);  // sps_max_latency_increase_plus1
+  writer.WriteUe(0);  // log2_min_luma_coding_block_size_minus3
+  writer.WriteUe(3);  // log2_diff_max_min_luma_coding_block_size
+  writer.WriteUe(0);  // log2_min_luma_transform_block_size_minus2
+  writer.WriteUe(3);  // log2_diff_max_min_luma_transform_block_size
+  writer.WriteUe(1);  // max_transform_hierarchy_depth_inter
+  writer.WriteUe(1);  // max_transform_hierarchy_depth_intra
+  writer.WriteFlag(false);  // scaling_list_enabled_flag
+  writer.WriteFlag(true);  // amp_enabled_flag
+  writer.WriteFlag(true);  // sample_adaptive_offset_enabled_flag
+  writer.WriteFlag(false);  // pcm_enabled_flag
+  // A single short term reference picture set referencing the previous
+  // picture.
+  writer.WriteUe(1);  // num_short_term_ref_pic_sets
+  writer.WriteUe(1);  // num_negative_pics
+  writer.WriteUe(0);  // num_positive_pics
+  writer.WriteUe(0);  // delta_poc_s0_minus1
+  writer.WriteFlag(true);  // used_by_curr_pic_s0_flag
+  writer.WriteFlag(false);  // long_term_ref_pics_present_flag
+  writer.WriteFlag(false);  // sps_temporal_mvp_enabled_flag
+  writer.WriteFlag(true);  // strong_intra_smoothing_enabled_flag
+  writer.WriteFlag(false);  // vui_parameters_present_flag
+  writer.WriteFlag(false);  // sps_extension_present_flag
+  writer.WriteTrailingBits();
+  AppendH265Nalu(Nalu::H265_SPS, sps, &parameter_sets_);
+
+  // pic_parameter_set_rbsp(). H.265 7.3.2.3.
+  std::vector<uint8_t> pps;
+  RbspWriter pps_writer(&pps);
+  pps_writer.WriteUe(0);  // pps_pic_parameter_set_id
+  pps_writer.WriteUe(0);  // pps_seq_parameter_set_id
+  pps_writer.WriteFlag(false);  // dependent_slice_segments_enabled_flag
+  pps_writer.WriteFlag(false);  // output_flag_present_flag
+  pps_writer.WriteBits(0, 3);  // num_extra_slice_header_bits
+  pps_writer.WriteFlag(false);  // sign_data_hiding_enabled_flag
+  pps_writer.WriteFlag(false);  // cabac_init_present_flag
+  pps_writer.WriteUe(0);  // num_ref_idx_l0_default_active_minus1
+  pps_writer.WriteUe(0);  // num_ref_idx_l1_default_active_minus1
+  pps_writer.WriteSe(0);  // init_qp_minus26
+  pps_writer.WriteFlag(false);  // constrained_intra_pred_flag
+  pps_writer.WriteFlag(false);  // transform_skip_enabled_flag
+  pps_writer.WriteFlag(false);  // cu_qp_delta_enabled_flag
+  pps_writer.WriteSe(0);  // pps_cb_qp_offset
+  pps_writer.WriteSe(0);  // pps_cr_qp_offset
+  pps_writer.WriteFlag(false);  // pps_slice_chroma_qp_offsets_present_flag
+  pps_writer.WriteFlag(false);  // weighted_pred_flag
+  pps_writer.WriteFlag(false);  // weighted_bipred_flag
+  pps_writer.WriteFlag(false);  // transquant_bypass_enabled_flag
+  pps_writer.WriteFlag(false);  // tiles_enabled_flag
+  pps_writer.WriteFlag(false);  // entropy_coding_sync_enabled_flag
+  pps_writer.WriteFlag(false);  // pps_loop_filter_across_slices_enabled_flag
+  pps_writer.WriteFlag(false);  // deblocking_filter_control_present_flag
+  pps_writer.WriteFlag(false);  // pps_scaling_list_data_present_flag
+  pps_writer.WriteFlag(false);  // lists_modification_present_flag
+  pps_writer.WriteUe(0);  // log2_parallel_merge_level_minus2
+  pps_writer.WriteFlag(false);  // slice_segment_header_extension_present_flag
+  pps_writer.WriteFlag(false);  // pps_extension_present_flag
+  pps_writer.WriteTrailingBits();
+  AppendH265Nalu(Nalu::H265_PPS, pps, &parameter_sets_);
+}
+
+void SyntheticVideoGenerator::AppendH264Slice(
+    bool is_key_frame,
+    size_t payload_size,
+    SyntheticRandom* random,
+    std::vector<uint8_t>* access_unit) {
+  // slice_header(). H.264 7.3.3.
+  std::vector<uint8_t> slice;
+  RbspWriter writer(&slice);
+  writer.WriteUe(0);  // first_mb_in_slice
+  const uint32_t kPSliceType = 5;
+  const uint32_t kISliceType = 7;
+  writer.WriteUe(is_key_frame ? kISliceType : kPSliceType);
+  writer.WriteUe(0);  // pic_parameter_set_id
+  // frame_num, log2_max_frame_num is 8.
+  writer.WriteBits(frame_index_ & 0xFF, 8);
+  if (is_key_frame) {
+    writer.WriteUe(idr_pic_id_ & 0xFFFF);
+  } else {
+    writer.WriteFlag(false);  // num_ref_idx_active_override_flag
+    writer.WriteFlag(false);  // ref_pic_list_modification_flag_l0
+  }
+  // dec_ref_pic_marking().
+  if (is_key_frame) {
+    writer.WriteFlag(false);  // no_output_of_prior_pics_flag
+    writer.WriteFlag(false);  // long_term_reference_flag
+  } else {
+    writer.WriteFlag(false);  // adaptive_ref_pic_marking_mode_flag
+  }
+  if (!is_key_frame)
+    writer.WriteUe(0);  // cabac_init_idc
+  writer.WriteSe(0);  // slice_qp_delta
+  writer.WriteUe(0);  // disable_deblocking_filter_idc
+  writer.WriteSe(0);  // slice_alpha_c0_offset_div2
+  writer.WriteSe(0);  // slice_beta_offset_div2
+  writer.Align(true);  // cabac_alignment_one_bit
+
+  // The filler payload needs no escaping, so it is appended after the header
+  // is escaped.
+  const int kNalRefIdcIdr = 3;
+  const int kNalRefIdcNonIdr = 2;
+  AppendH264Nalu(is_key_frame ? kNalRefIdcIdr : kNalRefIdcNonIdr,
+                 is_key_frame ? Nalu::H264_IDRSlice : Nalu::H264_NonIDRSlice,
+                 slice, access_unit);
+  random->AppendPayload(payload_size, access_unit);
+  access_unit->push_back(kRbspTrailingBits);
+}
+
+void SyntheticVideoGenerator::AppendH265Slice(
+    bool is_key_frame,
+    size_t payload_size,
+    SyntheticRandom* random,
+    std::vector<uint8_t>* access_unit) {
+  // slice_segment_header(). H.265 7.3.6.1.
+  std::vector<uint8_t> slice;
+  RbspWriter writer(&slice);
+  writer.WriteFlag(true);  // first_slice_segment_in_pic_flag
+  if (is_key_frame)
+    writer.WriteFlag(false);  // no_output_of_prior_pics_flag
+  writer.WriteUe(0);  // slice_pic_parameter_set_id
+  const uint32_t kPSliceType = 1;
+  const uint32_t kISliceType = 2;
+  writer.WriteUe(is_key_frame ? kISliceType : kPSliceType);
+  if (!is_key_frame) {
+    // slice_pic_order_cnt_lsb, log2_max_pic_order_cnt_lsb is 8.
+    writer.WriteBits(frame_index_ & 0xFF, 8);
+    writer.WriteFlag(true);  // short_term_ref_pic_set_sps_flag
+  }
+  writer.WriteFlag(false);  // slice_sao_luma_flag
+  writer.WriteFlag(false);  // slice_sao_chroma_flag
+  if (!is_key_frame) {
+    writer.WriteFlag(false);  // num_ref_idx_active_override_flag
+    writer.WriteUe(0);  // five_minus_max_num_merge_cand
+  }
+  writer.WriteSe(0);  // slice_qp_delta
+  // byte_alignment().
+  writer.WriteBits(1, 1);
+  writer.Align(false);
+
+  AppendH265Nalu(is_key_frame ? Nalu::H265_IDR_W_RADL : Nalu::H265_TRAIL_R,
+                 slice, access_unit);
+  random->AppendPayload(payload_size, access_unit);
+  access_unit->push_back(kRbspTrailingBits);
+}
+
+SyntheticAudioGenerator::SyntheticAudioGenerator(Codec codec, uint32_t bitrate)
+    : codec_(codec) {
+  DCHECK(codec_ == kCodecAAC || codec_ == kCodecAC3);
+  if (codec_ == kCodecAAC) {
+    const size_t payload_size =
+        static_cast<uint64_t>(bitrate) * kAacSamplesPerFrame /
+        kAudioSamplingFrequency / 8;
+    frame_size_ = std::min(kMaxAdtsFrameSize,
+                           kAdtsHeaderSize + std::max<size_t>(payload_size, 1));
+  } else {
+    size_t index = 0;
+    while (index + 1 < arraysize(kAc3BitratesInKbps) &&
+           kAc3BitratesInKbps[index + 1] * 1000 <= bitrate) {
+      ++index;
+    }
+    frame_size_code_ = static_cast<uint8_t>(index * 2);
+    // Frame size in bytes at 48 kHz, i.e. 1536 samples at the bitrate.
+    frame_size_ = kAc3BitratesInKbps[index] * 4;
+  }
+}
+
+void SyntheticAudioGenerator::GenerateFrame(SyntheticRandom* random,
+                                            std::vector<uint8_t>* frame) {
+  DCHECK(random);
+  DCHECK(frame);
+  frame->clear();
+  RbspWriter writer(frame);
+  if (codec_ == kCodecAAC) {
+    // adts_fixed_header() and adts_variable_header(). ISO/IEC 13818-7 6.2.
+    writer.WriteBits(0xFFF, 12);  // syncword
+    writer.WriteBits(0, 1);  // ID: MPEG-4
+    writer.WriteBits(0, 2);  // layer
+    writer.WriteFlag(true);  // protection_absent
+    const uint8_t kAacLcProfile = 1;
+    writer.WriteBits(kAacLcProfile, 2);
+    writer.WriteBits(kAdts48kHzFrequencyIndex, 4);
+    writer.WriteFlag(false);  // private_bit
+    writer.WriteBits(kStereoChannelConfiguration, 3);
+    // original_copy, home, copyright_identification_bit and
+    // copyright_identification_start.
+    writer.WriteBits(0, 4);
+    writer.WriteBits(static_cast<uint32_t>(frame_size_), 13);
+    writer.WriteBits(0x7FF, 11);  // adts_buffer_fullness: VBR
+    writer.WriteBits(0, 2);  // number_of_raw_data_blocks_in_frame
+  } else {
+    // syncinfo() and the start of bsi(). ATSC A/52 5.3.
+    writer.WriteBits(0x0B77, 16);  // syncword
+    writer.WriteBits(0, 16);  // crc1
+    writer.WriteBits(0, 2);  // fscod: 48 kHz
+    writer.WriteBits(frame_size_code_, 6);
+    const uint8_t kAc3Bsid = 8;
+    writer.WriteBits(kAc3Bsid, 5);
+    writer.WriteBits(0, 3);  // bsmod: complete main
+    const uint8_t kStereoAcmod = 2;
+    writer.WriteBits(kStereoAcmod, 3);
+    writer.WriteBits(0, 2);  // dsurmod
+    writer.WriteFlag(false);  // lfeon
+  }
+  writer.Align(false);
+  DCHECK_LE(frame->size(), frame_size_);
+  random->AppendPayload(frame_size_ - frame->size(), frame);
+}
+
+uint32_t SyntheticAudioGenerator::sampling_frequency() const {
+  return kAudioSamplingFrequency;
+}
+
+uint32_t SyntheticAudioGenerator::samples_per_frame() const {
+  return codec_ == kCodecAAC ? kAacSamplesPerFrame : kAc3SamplesPerFrame;
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -0,0 +1,113 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_ES_GENERATOR_H_
+#define PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_ES_GENERATOR_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "packager/base/macros.h"
+#include "packager/media/base/stream_info.h"
+
+namespace shaka {
+namespace media {
+
+/// A small deterministic pseudo-random number generator (xorshift32), so that
+/// the same options always generate the same bytes on every platform.
+class SyntheticRandom {
+ public:
+  explicit SyntheticRandom(uint32_t seed);
+
+  /// @return the next pseudo-random number.
+  uint32_t Next();
+
+  /// Appends @a size payload bytes to @a output. The bytes never contain the
+  /// zero, AC-3 or ADTS sync bytes, so they need no emulation prevention and
+  /// never produce false sync words.
+  void AppendPayload(size_t size, std::vector<uint8_t>* output);
+
+ private:
+  uint32_t state_;
+};
+
+/// Generates H.264 or H.265 Annex B access units with valid parameter sets and
+/// slice headers. Slice data is filler, so the output parses but does not
+/// decode. Frames are either IDR or P frames, so PTS always equals DTS.
+class SyntheticVideoGenerator {
+ public:
+  /// @param codec is kCodecH264 or kCodecH265.
+  SyntheticVideoGenerator(Codec codec,
+                          uint32_t width,
+                          uint32_t height,
+                          uint32_t frame_rate);
+
+  /// Generates the next access unit. Key frames include the parameter sets.
+  /// @param is_key_frame indicates whether to start a new GOP with an IDR.
+  /// @param payload_size is the number of filler bytes in the slice.
+  /// @param random provides the filler bytes.
+  /// @param access_unit is replaced with the access unit in Annex B format.
+  void GenerateAccessUnit(bool is_key_frame,
+                          size_t payload_size,
+                          SyntheticRandom* random,
+                          std::vector<uint8_t>* access_unit);
+
+ private:
+  void GenerateH264ParameterSets();
+  void GenerateH265ParameterSets();
+  void AppendH264Slice(bool is_key_frame,
+                       size_t payload_size,
+                       SyntheticRandom* random,
+                       std::vector<uint8_t>* access_unit);
+  void AppendH265Slice(bool is_key_frame,
+                       size_t payload_size,
+                       SyntheticRandom* random,
+                       std::vector<uint8_t>* access_unit);
+
+  const Codec codec_;
+  const uint32_t width_;
+  const uint32_t height_;
+  const uint32_t frame_rate_;
+  // Escaped parameter set NAL units with start codes, emitted before every
+  // key frame.
+  std::vector<uint8_t> parameter_sets_;
+  // Frame index since the last key frame.
+  uint32_t frame_index_ = 0;
+  uint32_t idr_pic_id_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SyntheticVideoGenerator);
+};
+
+/// Generates AAC-LC ADTS frames or AC-3 sync frames, stereo at 48 kHz, with
+/// valid headers and filler payload.
+class SyntheticAudioGenerator {
+ public:
+  /// @param codec is kCodecAAC or kCodecAC3.
+  /// @param bitrate is the target bitrate in bits per second. AC-3 bitrates are
+  ///        rounded down to the nearest bitrate the format allows.
+  SyntheticAudioGenerator(Codec codec, uint32_t bitrate);
+
+  /// Generates the next audio frame, replacing the content of @a frame.
+  void GenerateFrame(SyntheticRandom* random, std::vector<uint8_t>* frame);
+
+  uint32_t sampling_frequency() const;
+  uint32_t samples_per_frame() const;
+
+ private:
+  const Codec codec_;
+  // Total frame size, including the header.
+  size_t frame_size_ = 0;
+  // AC-3 frmsizecod, i.e. the bitrate code.
+  uint8_t frame_size_code_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SyntheticAudioGenerator);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_ES_GENERATOR_H_
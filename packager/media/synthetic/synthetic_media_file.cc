@@ -0,0 +1,90 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/synthetic/synthetic_media_file.h"
+
+#include "packager/base/logging.h"
+#include "packager/base/threading/platform_thread.h"
+#include "packager/media/synthetic/synthetic_media_options.h"
+#include "packager/media/synthetic/synthetic_ts_generator.h"
+
+namespace shaka {
+namespace media {
+
+File* SyntheticMediaFile::Create(const std::string& file_name) {
+  SyntheticMediaFile* file = new SyntheticMediaFile(file_name);
+  if (!file->Open()) {
+    delete file;
+    return nullptr;
+  }
+  return file;
+}
+
+SyntheticMediaFile::SyntheticMediaFile(const std::string& file_name)
+    : File(file_name) {}
+
+SyntheticMediaFile::~SyntheticMediaFile() {}
+
+bool SyntheticMediaFile::Close() {
+  delete this;
+  return true;
+}
+
+int64_t SyntheticMediaFile::Read(void* buffer, uint64_t length) {
+  DCHECK(generator_);
+  DCHECK(buffer);
+  if (realtime_) {
+    // Do not run ahead of the wall clock, like a live source would.
+    const base::TimeDelta ahead =
+        base::TimeDelta::FromSecondsD(generator_->current_time_in_seconds()) -
+        (base::TimeTicks::Now() - start_time_);
+    if (ahead > base::TimeDelta())
+      base::PlatformThread::Sleep(ahead);
+  }
+  const uint64_t bytes_read =
+      generator_->Read(reinterpret_cast<uint8_t*>(buffer), length);
+  position_ += bytes_read;
+  return static_cast<int64_t>(bytes_read);
+}
+
+int64_t SyntheticMediaFile::Write(const void* buffer, uint64_t length) {
+  NOTIMPLEMENTED() << "SyntheticMediaFile is read only.";
+  return -1;
+}
+
+int64_t SyntheticMediaFile::Size() {
+  // The size is not known until the content is generated.
+  return -1;
+}
+
+bool SyntheticMediaFile::Flush() {
+  return true;
+}
+
+bool SyntheticMediaFile::Seek(uint64_t position) {
+  NOTIMPLEMENTED() << "SyntheticMediaFile does not support Seek().";
+  return false;
+}
+
+bool SyntheticMediaFile::Tell(uint64_t* position) {
+  DCHECK(position);
+  *position = position_;
+  return true;
+}
+
+bool SyntheticMediaFile::Open() {
+  std::unique_ptr<SyntheticMediaOptions> options =
+      SyntheticMediaOptions::ParseFromString(file_name());
+  if (!options)
+    return false;
+  generator_.reset(new SyntheticTsGenerator(*options));
+  realtime_ = options->realtime();
+  start_time_ = base::TimeTicks::Now();
+  return true;
+}
+
+}  // namespace media
+}  // namespace shaka
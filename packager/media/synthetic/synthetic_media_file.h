@@ -0,0 +1,63 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_MEDIA_FILE_H_
+#define PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_MEDIA_FILE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "packager/base/time/time.h"
+#include "packager/file/file.h"
+
+namespace shaka {
+namespace media {
+
+class SyntheticTsGenerator;
+
+/// Implements a read-only File which generates a synthetic MPEG-2 TS stream
+/// in memory from a synth:// url. See SyntheticMediaOptions for the format.
+/// This allows feeding long live-like inputs through Demuxer without disk or
+/// network.
+class SyntheticMediaFile : public File {
+ public:
+  /// Creates and opens a SyntheticMediaFile.
+  /// @param file_name is the synth:// url.
+  /// @return the opened file on success, nullptr if the url is invalid. The
+  ///         file is released with Close().
+  static File* Create(const std::string& file_name);
+
+  /// @name File implementation overrides.
+  /// @{
+  bool Close() override;
+  int64_t Read(void* buffer, uint64_t length) override;
+  int64_t Write(const void* buffer, uint64_t length) override;
+  int64_t Size() override;
+  bool Flush() override;
+  bool Seek(uint64_t position) override;
+  bool Tell(uint64_t* position) override;
+  /// @}
+
+ protected:
+  explicit SyntheticMediaFile(const std::string& file_name);
+  ~SyntheticMediaFile() override;
+  bool Open() override;
+
+ private:
+  std::unique_ptr<SyntheticTsGenerator> generator_;
+  bool realtime_ = false;
+  base::TimeTicks start_time_;
+  uint64_t position_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SyntheticMediaFile);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_MEDIA_FILE_H_
@@ -0,0 +1,249 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/synthetic/synthetic_media_options.h"
+
+#include <string.h>
+
+#include "packager/base/logging.h"
+#include "packager/base/macros.h"
+#include "packager/base/strings/string_number_conversions.h"
+#include "packager/base/strings/string_split.h"
+#include "packager/base/strings/string_util.h"
+
+namespace shaka {
+namespace media {
+
+const char kSyntheticFilePrefix[] = "synth://";
+
+namespace {
+
+// Limits that keep the generated streams within what the codecs and the
+// MPEG-2 TS timestamps can express.
+const uint32_t kMaxFrameRate = 120;
+const uint32_t kMaxDimension = 8192;
+
+enum FieldType {
+  kUnknownField = 0,
+  kAudioBitrateField,
+  kDurationField,
+  kFrameRateField,
+  kGopField,
+  kHeightField,
+  kRealtimeField,
+  kScte35DurationField,
+  kScte35IntervalField,
+  kSeedField,
+  kVideoBitrateField,
+  kWidthField,
+};
+
+struct FieldNameToTypeMapping {
+  const char* field_name;
+  FieldType field_type;
+};
+
+const FieldNameToTypeMapping kFieldNameTypeMappings[] = {
+    {"audio_bitrate", kAudioBitrateField},
+    {"duration", kDurationField},
+    {"frame_rate", kFrameRateField},
+    {"gop", kGopField},
+    {"height", kHeightField},
+    {"realtime", kRealtimeField},
+    {"scte35_duration", kScte35DurationField},
+    {"scte35_interval", kScte35IntervalField},
+    {"seed", kSeedField},
+    {"video_bitrate", kVideoBitrateField},
+    {"width", kWidthField},
+};
+
+FieldType GetFieldType(const std::string& field_name) {
+  for (size_t idx = 0; idx < arraysize(kFieldNameTypeMappings); ++idx) {
+    if (field_name == kFieldNameTypeMappings[idx].field_name)
+      return kFieldNameTypeMappings[idx].field_type;
+  }
+  return kUnknownField;
+}
+
+bool ParseNonNegativeDouble(const std::string& field_name,
+                            const std::string& value_str,
+                            double* value) {
+  if (!base::StringToDouble(value_str, value) || *value < 0) {
+    LOG(ERROR) << "Invalid synthetic media option for " << field_name
+               << " field " << value_str;
+    return false;
+  }
+  return true;
+}
+
+bool ParseUint(const std::string& field_name,
+               const std::string& value_str,
+               uint32_t* value) {
+  unsigned parsed_value = 0;
+  if (!base::StringToUint(value_str, &parsed_value)) {
+    LOG(ERROR) << "Invalid synthetic media option for " << field_name
+               << " field " << value_str;
+    return false;
+  }
+  *value = parsed_value;
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<SyntheticMediaOptions> SyntheticMediaOptions::ParseFromString(
+    base::StringPiece synthetic_url) {
+  std::unique_ptr<SyntheticMediaOptions> options(new SyntheticMediaOptions);
+
+  if (base::StartsWith(synthetic_url, kSyntheticFilePrefix,
+                       base::CompareCase::SENSITIVE)) {
+    synthetic_url = synthetic_url.substr(strlen(kSyntheticFilePrefix));
+  }
+
+  const size_t question_mark_pos = synthetic_url.find('?');
+  base::StringPiece streams_str = synthetic_url.substr(0, question_mark_pos);
+
+  for (const std::string& stream :
+       base::SplitString(streams_str, "+", base::TRIM_WHITESPACE,
+                         base::SPLIT_WANT_NONEMPTY)) {
+    Codec* codec = nullptr;
+    Codec stream_codec = kUnknownCodec;
+    if (stream == "h264") {
+      codec = &options->video_codec_;
+      stream_codec = kCodecH264;
+    } else if (stream == "h265") {
+      codec = &options->video_codec_;
+      stream_codec = kCodecH265;
+    } else if (stream == "aac") {
+      codec = &options->audio_codec_;
+      stream_codec = kCodecAAC;
+    } else if (stream == "ac3") {
+      codec = &options->audio_codec_;
+      stream_codec = kCodecAC3;
+    } else if (stream == "scte35") {
+      options->has_scte35_ = true;
+      continue;
+    } else {
+      LOG(ERROR) << "Unknown synthetic media stream (\"" << stream
+                 << "\"). Expecting h264, h265, aac, ac3 or scte35.";
+      return nullptr;
+    }
+    if (*codec != kUnknownCodec) {
+      LOG(ERROR) << "Only one video and one audio synthetic media stream are "
+                    "supported.";
+      return nullptr;
+    }
+    *codec = stream_codec;
+  }
+  if (options->video_codec_ == kUnknownCodec &&
+      options->audio_codec_ == kUnknownCodec) {
+    LOG(ERROR) << "Synthetic media requires at least one audio or video "
+                  "stream: "
+               << synthetic_url;
+    return nullptr;
+  }
+
+  if (question_mark_pos != base::StringPiece::npos) {
+    base::StringPiece options_str = synthetic_url.substr(question_mark_pos + 1);
+
+    base::StringPairs pairs;
+    if (!base::SplitStringIntoKeyValuePairs(options_str, '=', '&', &pairs)) {
+      LOG(ERROR) << "Invalid synthetic media options name/value pairs "
+                 << options_str;
+      return nullptr;
+    }
+    for (const auto& pair : pairs) {
+      switch (GetFieldType(pair.first)) {
+        case kAudioBitrateField:
+          if (!ParseUint(pair.first, pair.second, &options->audio_bitrate_))
+            return nullptr;
+          break;
+        case kDurationField:
+          if (!ParseNonNegativeDouble(pair.first, pair.second,
+                                      &options->duration_in_seconds_)) {
+            return nullptr;
+          }
+          break;
+        case kFrameRateField:
+          if (!ParseUint(pair.first, pair.second, &options->frame_rate_))
+            return nullptr;
+          break;
+        case kGopField:
+          if (!ParseNonNegativeDouble(pair.first, pair.second,
+                                      &options->gop_duration_in_seconds_)) {
+            return nullptr;
+          }
+          break;
+        case kHeightField:
+          if (!ParseUint(pair.first, pair.second, &options->height_))
+            return nullptr;
+          break;
+        case kRealtimeField: {
+          uint32_t realtime_value = 0;
+          if (!ParseUint(pair.first, pair.second, &realtime_value))
+            return nullptr;
+          options->realtime_ = realtime_value > 0;
+          break;
+        }
+        case kScte35DurationField:
+          if (!ParseNonNegativeDouble(pair.first, pair.second,
+                                      &options->scte35_duration_in_seconds_)) {
+            return nullptr;
+          }
+          break;
+        case kScte35IntervalField:
+          if (!ParseNonNegativeDouble(pair.first, pair.second,
+                                      &options->scte35_interval_in_seconds_)) {
+            return nullptr;
+          }
+          break;
+        case kSeedField:
+          if (!ParseUint(pair.first, pair.second, &options->seed_))
+            return nullptr;
+          break;
+        case kVideoBitrateField:
+          if (!ParseUint(pair.first, pair.second, &options->video_bitrate_))
+            return nullptr;
+          break;
+        case kWidthField:
+          if (!ParseUint(pair.first, pair.second, &options->width_))
+            return nullptr;
+          break;
+        default:
+          LOG(ERROR) << "Unknown field in synthetic media options (\""
+                     << pair.first << "\").";
+          return nullptr;
+      }
+    }
+  }
+
+  if (options->frame_rate_ == 0 || options->frame_rate_ > kMaxFrameRate) {
+    LOG(ERROR) << "Synthetic media frame_rate should be in range (0, "
+               << kMaxFrameRate << "].";
+    return nullptr;
+  }
+  // 4:2:0 chroma subsampling requires even dimensions.
+  if (options->width_ == 0 || options->width_ > kMaxDimension ||
+      options->width_ % 2 != 0 || options->height_ == 0 ||
+      options->height_ > kMaxDimension || options->height_ % 2 != 0) {
+    LOG(ERROR) << "Synthetic media width and height should be even and in "
+                  "range (0, "
+               << kMaxDimension << "].";
+    return nullptr;
+  }
+  if (options->gop_duration_in_seconds_ <= 0) {
+    LOG(ERROR) << "Synthetic media gop should be positive.";
+    return nullptr;
+  }
+  if (options->has_scte35_ && options->scte35_interval_in_seconds_ <= 0) {
+    LOG(ERROR) << "Synthetic media scte35_interval should be positive.";
+    return nullptr;
+  }
+  return options;
+}
+
+}  // namespace media
+}  // namespace shaka
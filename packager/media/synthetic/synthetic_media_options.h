@@ -0,0 +1,85 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_MEDIA_OPTIONS_H_
+#define PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_MEDIA_OPTIONS_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "packager/base/strings/string_piece.h"
+#include "packager/media/base/stream_info.h"
+
+namespace shaka {
+namespace media {
+
+/// Prefix of synthetic media urls, i.e. "synth://".
+extern const char kSyntheticFilePrefix[];
+
+/// Options parsed from synthetic media url string of the form:
+///   synth://<stream>[+<stream>]...[?<option>[&<option>]...]
+/// where <stream> is one of h264, h265, aac, ac3 and scte35.
+class SyntheticMediaOptions {
+ public:
+  ~SyntheticMediaOptions() = default;
+
+  /// Parse from synthetic media url, with or without the synth:// prefix.
+  /// @returns a SyntheticMediaOptions object on success, nullptr otherwise.
+  static std::unique_ptr<SyntheticMediaOptions> ParseFromString(
+      base::StringPiece synthetic_url);
+
+  /// @return kCodecH264, kCodecH265 or kUnknownCodec if there is no video.
+  Codec video_codec() const { return video_codec_; }
+  /// @return kCodecAAC, kCodecAC3 or kUnknownCodec if there is no audio.
+  Codec audio_codec() const { return audio_codec_; }
+  bool has_scte35() const { return has_scte35_; }
+
+  /// @return the duration of the generated content in seconds. 0 means the
+  ///         content never ends.
+  double duration_in_seconds() const { return duration_in_seconds_; }
+  double gop_duration_in_seconds() const { return gop_duration_in_seconds_; }
+  uint32_t frame_rate() const { return frame_rate_; }
+  uint32_t width() const { return width_; }
+  uint32_t height() const { return height_; }
+  uint32_t video_bitrate() const { return video_bitrate_; }
+  uint32_t audio_bitrate() const { return audio_bitrate_; }
+  double scte35_interval_in_seconds() const {
+    return scte35_interval_in_seconds_;
+  }
+  double scte35_duration_in_seconds() const {
+    return scte35_duration_in_seconds_;
+  }
+  /// @return true if the content should be delivered no faster than real time.
+  bool realtime() const { return realtime_; }
+  uint32_t seed() const { return seed_; }
+
+ private:
+  SyntheticMediaOptions() = default;
+
+  Codec video_codec_ = kUnknownCodec;
+  Codec audio_codec_ = kUnknownCodec;
+  bool has_scte35_ = false;
+  double duration_in_seconds_ = 60;
+  double gop_duration_in_seconds_ = 2;
+  uint32_t frame_rate_ = 30;
+  uint32_t width_ = 1280;
+  uint32_t height_ = 720;
+  // In bits per second.
+  uint32_t video_bitrate_ = 2000000;
+  uint32_t audio_bitrate_ = 128000;
+  double scte35_interval_in_seconds_ = 60;
+  double scte35_duration_in_seconds_ = 30;
+  bool realtime_ = false;
+  // Seeds the generator for sample sizes and payload bytes. The same options
+  // always generate the same bytes.
+  uint32_t seed_ = 0;
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_MEDIA_OPTIONS_H_
@@ -0,0 +1,88 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/synthetic/synthetic_media_options.h"
+
+#include <gtest/gtest.h>
+
+namespace shaka {
+namespace media {
+
+TEST(SyntheticMediaOptionsTest, Defaults) {
+  auto options = SyntheticMediaOptions::ParseFromString("synth://h264+aac");
+  ASSERT_TRUE(options);
+  EXPECT_EQ(kCodecH264, options->video_codec());
+  EXPECT_EQ(kCodecAAC, options->audio_codec());
+  EXPECT_FALSE(options->has_scte35());
+  EXPECT_EQ(60, options->duration_in_seconds());
+  EXPECT_EQ(2, options->gop_duration_in_seconds());
+  EXPECT_EQ(30u, options->frame_rate());
+  EXPECT_EQ(1280u, options->width());
+  EXPECT_EQ(720u, options->height());
+  EXPECT_EQ(2000000u, options->video_bitrate());
+  EXPECT_EQ(128000u, options->audio_bitrate());
+  EXPECT_FALSE(options->realtime());
+  EXPECT_EQ(0u, options->seed());
+}
+
+TEST(SyntheticMediaOptionsTest, WithoutPrefix) {
+  auto options = SyntheticMediaOptions::ParseFromString("h265");
+  ASSERT_TRUE(options);
+  EXPECT_EQ(kCodecH265, options->video_codec());
+  EXPECT_EQ(kUnknownCodec, options->audio_codec());
+}
+
+TEST(SyntheticMediaOptionsTest, AllOptions) {
+  auto options = SyntheticMediaOptions::ParseFromString(
+      "synth://h265+ac3+scte35?duration=7200&gop=4&frame_rate=60&width=1920&"
+      "height=1080&video_bitrate=6000000&audio_bitrate=384000&"
+      "scte35_interval=120&scte35_duration=60.5&realtime=1&seed=7");
+  ASSERT_TRUE(options);
+  EXPECT_EQ(kCodecH265, options->video_codec());
+  EXPECT_EQ(kCodecAC3, options->audio_codec());
+  EXPECT_TRUE(options->has_scte35());
+  EXPECT_EQ(7200, options->duration_in_seconds());
+  EXPECT_EQ(4, options->gop_duration_in_seconds());
+  EXPECT_EQ(60u, options->frame_rate());
+  EXPECT_EQ(1920u, options->width());
+  EXPECT_EQ(1080u, options->height());
+  EXPECT_EQ(6000000u, options->video_bitrate());
+  EXPECT_EQ(384000u, options->audio_bitrate());
+  EXPECT_EQ(120, options->scte35_interval_in_seconds());
+  EXPECT_EQ(60.5, options->scte35_duration_in_seconds());
+  EXPECT_TRUE(options->realtime());
+  EXPECT_EQ(7u, options->seed());
+}
+
+TEST(SyntheticMediaOptionsTest, EndlessDuration) {
+  auto options = SyntheticMediaOptions::ParseFromString("aac?duration=0");
+  ASSERT_TRUE(options);
+  EXPECT_EQ(0, options->duration_in_seconds());
+}
+
+TEST(SyntheticMediaOptionsTest, InvalidStreams) {
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("synth://"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("synth://scte35"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("synth://vp9"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("synth://h264+h265"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("synth://aac+ac3"));
+}
+
+TEST(SyntheticMediaOptionsTest, InvalidOptions) {
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?unknown=1"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?duration=-1"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?gop=0"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?frame_rate=0"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?frame_rate=121"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?width=641"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?height=0"));
+  EXPECT_FALSE(SyntheticMediaOptions::ParseFromString("h264?seed=abc"));
+  EXPECT_FALSE(
+      SyntheticMediaOptions::ParseFromString("h264+scte35?scte35_interval=0"));
+}
+
+}  // namespace media
+}  // namespace shaka
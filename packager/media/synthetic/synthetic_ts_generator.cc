@@ -0,0 +1,400 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/synthetic/synthetic_ts_generator.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "packager/base/logging.h"
+#include "packager/media/formats/mp2t/program_map_table_writer.h"
+#include "packager/media/formats/mp2t/ts_packet_writer_util.h"
+#include "packager/media/formats/mp2t/ts_stream_type.h"
+
+namespace shaka {
+namespace media {
+
+namespace {
+
+const int64_t kTimescale = 90000;
+// Start timestamps away from zero like a real broadcast feed would.
+const int64_t kStartTimestamp = 10 * kTimescale;
+const int64_t kTimestampMask = (INT64_C(1) << 33) - 1;
+// PAT and PMT are repeated every 500ms.
+const int64_t kPsiInterval = kTimescale / 2;
+// Splice points are signaled ahead of time.
+const int64_t kScte35PrerollInTicks = 2 * kTimescale;
+const int64_t kNoMoreData = std::numeric_limits<int64_t>::max();
+
+const int kPatPid = 0x00;
+const int kVideoPid = 0x100;
+const int kAudioPid = 0x101;
+const int kScte35Pid = 0x102;
+const uint8_t kProgramNumber = 0x01;
+
+const uint8_t kVideoStreamId = 0xE0;
+const uint8_t kAudioStreamId = 0xC0;
+const uint8_t kPrivateStream1 = 0xBD;
+
+const uint8_t kProgramAssociationTableId = 0x00;
+const uint8_t kProgramMapTableId = 0x02;
+const uint8_t kSpliceInfoTableId = 0xFC;
+const uint8_t kRegistrationDescriptorTag = 0x05;
+const uint8_t kSegmentationDescriptorTag = 0x02;
+// SCTE 35 segmentation_type_id of Provider Placement Opportunity Start.
+const uint8_t kProviderPlacementOpportunityStart = 0x34;
+const uint8_t kTimeSignalCommand = 0x06;
+
+const bool kPayloadUnitStartIndicator = true;
+const bool kHasPcr = true;
+
+// Appends section_length and the remaining section, then the CRC32. |section|
+// starts with the pointer field, table_id and the first nibble of the flags.
+void FinalizeSection(uint8_t flags_nibble, std::vector<uint8_t>* section) {
+  // The pointer field, table_id and the two section_length bytes.
+  const size_t kSectionHeaderSize = 4;
+  const size_t kCrcSize = 4;
+  DCHECK_GE(section->size(), kSectionHeaderSize);
+  const size_t section_length =
+      section->size() - kSectionHeaderSize + kCrcSize;
+  DCHECK_LE(section_length, 0x3FDu);
+  (*section)[2] = static_cast<uint8_t>(flags_nibble << 4 |
+                                       (section_length >> 8 & 0x0F));
+  (*section)[3] = static_cast<uint8_t>(section_length & 0xFF);
+  // CRC covers the section from table_id, i.e. excluding the pointer field.
+  const uint32_t crc = mp2t::Crc32Mpeg2(section->data() + 1,
+                                        section->size() - 1);
+  for (int shift = 24; shift >= 0; shift -= 8)
+    section->push_back(static_cast<uint8_t>(crc >> shift));
+}
+
+void AppendPid(uint8_t reserved_bits, int pid, std::vector<uint8_t>* output) {
+  output->push_back(static_cast<uint8_t>(reserved_bits | (pid >> 8 & 0x1F)));
+  output->push_back(static_cast<uint8_t>(pid & 0xFF));
+}
+
+// The only difference between writing PTS or DTS is the leading bits.
+void WritePtsOrDts(uint8_t leading_bits,
+                   uint64_t pts_or_dts,
+                   BufferWriter* writer) {
+  writer->AppendInt(static_cast<uint8_t>(
+      leading_bits << 4 | (((pts_or_dts >> 30) & 0x07) << 1) | 1));
+  writer->AppendInt(static_cast<uint8_t>((pts_or_dts >> 22) & 0xFF));
+  writer->AppendInt(
+      static_cast<uint8_t>((((pts_or_dts >> 15) & 0x7F) << 1) | 1));
+  writer->AppendInt(static_cast<uint8_t>((pts_or_dts >> 7) & 0xFF));
+  writer->AppendInt(static_cast<uint8_t>(((pts_or_dts & 0x7F) << 1) | 1));
+}
+
+uint8_t GetVideoStreamType(Codec codec) {
+  return static_cast<uint8_t>(codec == kCodecH264 ? mp2t::TsStreamType::kAvc
+                                                  : mp2t::TsStreamType::kHevc);
+}
+
+uint8_t GetAudioStreamType(Codec codec) {
+  return static_cast<uint8_t>(codec == kCodecAAC
+                                  ? mp2t::TsStreamType::kAdtsAac
+                                  : mp2t::TsStreamType::kAc3);
+}
+
+int64_t SecondsToTicks(double seconds) {
+  return static_cast<int64_t>(std::llround(seconds * kTimescale));
+}
+
+}  // namespace
+
+SyntheticTsGenerator::SyntheticTsGenerator(const SyntheticMediaOptions& options)
+    : options_(options), random_(options.seed()) {
+  const bool has_video = options_.video_codec() != kUnknownCodec;
+  const bool has_audio = options_.audio_codec() != kUnknownCodec;
+  DCHECK(has_video || has_audio);
+  if (has_video) {
+    video_generator_.reset(new SyntheticVideoGenerator(
+        options_.video_codec(), options_.width(), options_.height(),
+        options_.frame_rate()));
+    frames_per_gop_ = std::max<uint32_t>(
+        1, static_cast<uint32_t>(std::lround(
+               options_.gop_duration_in_seconds() * options_.frame_rate())));
+    // A GOP has one key frame five times the size of a P frame.
+    const double gop_size_in_bytes = static_cast<double>(
+        options_.video_bitrate()) * frames_per_gop_ / options_.frame_rate() / 8;
+    const size_t kMinFrameSize = 16;
+    p_frame_size_ = std::max(
+        kMinFrameSize,
+        static_cast<size_t>(gop_size_in_bytes / (frames_per_gop_ + 4)));
+  }
+  if (has_audio) {
+    audio_generator_.reset(new SyntheticAudioGenerator(
+        options_.audio_codec(), options_.audio_bitrate()));
+  }
+  end_time_ = options_.duration_in_seconds() > 0
+                  ? SecondsToTicks(options_.duration_in_seconds())
+                  : kNoMoreData;
+
+  pat_ = {
+      0x00,  // pointer field
+      kProgramAssociationTableId,
+      0x00, 0x00,  // section_length, filled in by FinalizeSection.
+      0x00, 0x00,  // transport_stream_id
+      0xC1,        // version number 0, current next indicator 1.
+      0x00,        // section number
+      0x00,        // last section number
+      0x00, kProgramNumber,
+  };
+  AppendPid(0xE0, mp2t::ProgramMapTableWriter::kPmtPid, &pat_);
+  FinalizeSection(0xB, &pat_);
+
+  pmt_ = {
+      0x00,  // pointer field
+      kProgramMapTableId,
+      0x00, 0x00,  // section_length, filled in by FinalizeSection.
+      0x00, kProgramNumber,
+      0xC1,  // version number 0, current next indicator 1.
+      0x00,  // section number
+      0x00,  // last section number
+  };
+  AppendPid(0xE0, has_video ? kVideoPid : kAudioPid, &pmt_);  // PCR_PID
+  if (options_.has_scte35()) {
+    // program_info_length, followed by a registration descriptor which
+    // identifies SCTE-35 cue messages.
+    const uint8_t kProgramInfoLength = 6;
+    pmt_.insert(pmt_.end(), {0xF0, kProgramInfoLength,
+                             kRegistrationDescriptorTag, 4,
+                             'C', 'U', 'E', 'I'});
+  } else {
+    pmt_.insert(pmt_.end(), {0xF0, 0x00});
+  }
+  // stream_type, elementary_PID and an empty ES_info.
+  if (has_video) {
+    pmt_.push_back(GetVideoStreamType(options_.video_codec()));
+    AppendPid(0xE0, kVideoPid, &pmt_);
+    pmt_.insert(pmt_.end(), {0xF0, 0x00});
+  }
+  if (has_audio) {
+    pmt_.push_back(GetAudioStreamType(options_.audio_codec()));
+    AppendPid(0xE0, kAudioPid, &pmt_);
+    pmt_.insert(pmt_.end(), {0xF0, 0x00});
+  }
+  if (options_.has_scte35()) {
+    pmt_.push_back(static_cast<uint8_t>(mp2t::TsStreamType::kScte35));
+    AppendPid(0xE0, kScte35Pid, &pmt_);
+    pmt_.insert(pmt_.end(), {0xF0, 0x00});
+  }
+  FinalizeSection(0xB, &pmt_);
+}
+
+SyntheticTsGenerator::~SyntheticTsGenerator() {}
+
+uint64_t SyntheticTsGenerator::Read(uint8_t* buffer, uint64_t size) {
+  uint64_t bytes_read = 0;
+  while (bytes_read < size) {
+    if (pending_offset_ == pending_.Size()) {
+      pending_.Clear();
+      pending_offset_ = 0;
+      if (!GenerateNext())
+        break;
+    }
+    const size_t bytes_to_copy = static_cast<size_t>(std::min<uint64_t>(
+        size - bytes_read, pending_.Size() - pending_offset_));
+    memcpy(buffer + bytes_read, pending_.Buffer() + pending_offset_,
+           bytes_to_copy);
+    pending_offset_ += bytes_to_copy;
+    bytes_read += bytes_to_copy;
+  }
+  return bytes_read;
+}
+
+double SyntheticTsGenerator::current_time_in_seconds() const {
+  return static_cast<double>(current_time_) / kTimescale;
+}
+
+bool SyntheticTsGenerator::GenerateNext() {
+  const int64_t psi_time = next_psi_time();
+  const int64_t scte35_time = next_scte35_time();
+  const int64_t video_time = next_video_time();
+  const int64_t audio_time = next_audio_time();
+  const int64_t next_time =
+      std::min(std::min(video_time, audio_time), scte35_time);
+  if (next_time >= end_time_)
+    return false;
+
+  // Ties go to the tables first so that PSI and cues precede the media they
+  // apply to.
+  if (psi_time <= next_time) {
+    current_time_ = psi_time;
+    WritePsi();
+  } else if (scte35_time == next_time) {
+    current_time_ = scte35_time;
+    WriteScte35Section();
+  } else if (video_time == next_time) {
+    current_time_ = video_time;
+    WriteVideoAccessUnit();
+  } else {
+    current_time_ = audio_time;
+    WriteAudioFrame();
+  }
+  return true;
+}
+
+void SyntheticTsGenerator::WritePsi() {
+  mp2t::WritePayloadToBufferWriter(
+      pat_.data(), pat_.size(), kPayloadUnitStartIndicator, kPatPid, !kHasPcr,
+      0, &pat_continuity_counter_, &pending_);
+  mp2t::WritePayloadToBufferWriter(
+      pmt_.data(), pmt_.size(), kPayloadUnitStartIndicator,
+      mp2t::ProgramMapTableWriter::kPmtPid, !kHasPcr, 0,
+      &pmt_continuity_counter_, &pending_);
+  ++psi_index_;
+}
+
+void SyntheticTsGenerator::WriteVideoAccessUnit() {
+  const bool is_key_frame = video_frame_index_ % frames_per_gop_ == 0;
+  size_t payload_size = is_key_frame ? 5 * p_frame_size_ : p_frame_size_;
+  // +/- 10% variation.
+  payload_size = payload_size * (90 + random_.Next() % 21) / 100;
+  video_generator_->GenerateAccessUnit(is_key_frame, payload_size, &random_,
+                                       &frame_);
+  WritePes(kVideoPid, kVideoStreamId, kHasPcr, current_time_, frame_,
+           &video_continuity_counter_);
+  ++video_frame_index_;
+}
+
+void SyntheticTsGenerator::WriteAudioFrame() {
+  audio_generator_->GenerateFrame(&random_, &frame_);
+  const uint8_t stream_id = options_.audio_codec() == kCodecAAC
+                                ? kAudioStreamId
+                                : kPrivateStream1;
+  // Audio carries the PCR if there is no video.
+  WritePes(kAudioPid, stream_id, !video_generator_, current_time_, frame_,
+           &audio_continuity_counter_);
+  ++audio_frame_index_;
+}
+
+void SyntheticTsGenerator::WriteScte35Section() {
+  const uint64_t pts_time =
+      (kStartTimestamp + current_time_ + kScte35PrerollInTicks) &
+      kTimestampMask;
+  const uint64_t duration = static_cast<uint64_t>(
+      SecondsToTicks(options_.scte35_duration_in_seconds()));
+  const uint32_t event_id = static_cast<uint32_t>(scte35_index_);
+
+  // splice_info_section(). SCTE 35 9.6.
+  std::vector<uint8_t> section = {
+      0x00,  // pointer field
+      kSpliceInfoTableId,
+      0x00, 0x00,  // section_length, filled in by FinalizeSection.
+      0x00,  // protocol_version
+      // encrypted_packet 0, encryption_algorithm 0, pts_adjustment 0.
+      0x00, 0x00, 0x00, 0x00, 0x00,
+      0xFF,  // cw_index
+      // tier 0xFFF and splice_command_length 5.
+      0xFF, 0xF0, 0x05,
+      kTimeSignalCommand,
+      // splice_time(): time_specified_flag 1, reserved, pts_time.
+      static_cast<uint8_t>(0xFE | (pts_time >> 32 & 0x01)),
+      static_cast<uint8_t>(pts_time >> 24),
+      static_cast<uint8_t>(pts_time >> 16),
+      static_cast<uint8_t>(pts_time >> 8),
+      static_cast<uint8_t>(pts_time),
+      // descriptor_loop_length.
+      0x00, 22,
+      // segmentation_descriptor(). SCTE 35 10.3.3.
+      kSegmentationDescriptorTag,
+      20,  // descriptor_length
+      'C', 'U', 'E', 'I',  // identifier
+      static_cast<uint8_t>(event_id >> 24),
+      static_cast<uint8_t>(event_id >> 16),
+      static_cast<uint8_t>(event_id >> 8),
+      static_cast<uint8_t>(event_id),
+      0x7F,  // segmentation_event_cancel_indicator 0, reserved.
+      // program_segmentation_flag 1, segmentation_duration_flag 1,
+      // delivery_not_restricted_flag 1, reserved.
+      0xFF,
+      static_cast<uint8_t>(duration >> 32),
+      static_cast<uint8_t>(duration >> 24),
+      static_cast<uint8_t>(duration >> 16),
+      static_cast<uint8_t>(duration >> 8),
+      static_cast<uint8_t>(duration),
+      0x00,  // segmentation_upid_type: not used.
+      0x00,  // segmentation_upid_length
+      kProviderPlacementOpportunityStart,
+      0x00,  // segment_num
+      0x00,  // segments_expected
+  };
+  // section_syntax_indicator 0, private_indicator 0, reserved '11'.
+  FinalizeSection(0x3, &section);
+  mp2t::WritePayloadToBufferWriter(
+      section.data(), section.size(), kPayloadUnitStartIndicator, kScte35Pid,
+      !kHasPcr, 0, &scte35_continuity_counter_, &pending_);
+  ++scte35_index_;
+}
+
+void SyntheticTsGenerator::WritePes(
+    int pid,
+    uint8_t stream_id,
+    bool has_pcr,
+    int64_t time_in_ticks,
+    const std::vector<uint8_t>& data,
+    mp2t::ContinuityCounter* continuity_counter) {
+  // Frames are all I or P frames, so PTS is always equal to DTS and only PTS
+  // is written.
+  const uint64_t pts = (kStartTimestamp + time_in_ticks) & kTimestampMask;
+  const uint8_t kPtsHeaderDataLength = 5;
+  const size_t kPesHeaderSizeAfterLength = 3 + kPtsHeaderDataLength;
+  const size_t kMaxPesPacketLengthValue = 0xFFFF;
+
+  BufferWriter pes(data.size() + 14);
+  pes.AppendNBytes(static_cast<uint64_t>(0x000001), 3);
+  pes.AppendInt(stream_id);
+  const size_t pes_packet_length = data.size() + kPesHeaderSizeAfterLength;
+  pes.AppendInt(static_cast<uint16_t>(
+      pes_packet_length > kMaxPesPacketLengthValue ? 0 : pes_packet_length));
+  // '10' marker bits, then PTS_DTS_flags '10'.
+  pes.AppendInt(static_cast<uint8_t>(0x80));
+  pes.AppendInt(static_cast<uint8_t>(0x80));
+  pes.AppendInt(kPtsHeaderDataLength);
+  WritePtsOrDts(0x02, pts, &pes);
+  pes.AppendVector(data);
+
+  mp2t::WritePayloadToBufferWriter(pes.Buffer(), pes.Size(),
+                                   kPayloadUnitStartIndicator, pid, has_pcr,
+                                   pts, continuity_counter, &pending_);
+}
+
+int64_t SyntheticTsGenerator::next_video_time() const {
+  if (!video_generator_)
+    return kNoMoreData;
+  // Computed from the frame index so that timestamps do not drift.
+  return static_cast<int64_t>(video_frame_index_ * kTimescale /
+                              options_.frame_rate());
+}
+
+int64_t SyntheticTsGenerator::next_audio_time() const {
+  if (!audio_generator_)
+    return kNoMoreData;
+  return static_cast<int64_t>(audio_frame_index_ *
+                              audio_generator_->samples_per_frame() *
+                              kTimescale /
+                              audio_generator_->sampling_frequency());
+}
+
+int64_t SyntheticTsGenerator::next_scte35_time() const {
+  if (!options_.has_scte35())
+    return kNoMoreData;
+  // The first cue is sent one interval into the stream.
+  return SecondsToTicks((scte35_index_ + 1) *
+                        options_.scte35_interval_in_seconds());
+}
+
+int64_t SyntheticTsGenerator::next_psi_time() const {
+  return static_cast<int64_t>(psi_index_) * kPsiInterval;
+}
+
+}  // namespace media
+}  // namespace shaka
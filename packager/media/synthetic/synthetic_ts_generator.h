@@ -0,0 +1,100 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_TS_GENERATOR_H_
+#define PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_TS_GENERATOR_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "packager/base/macros.h"
+#include "packager/media/base/buffer_writer.h"
+#include "packager/media/formats/mp2t/continuity_counter.h"
+#include "packager/media/synthetic/synthetic_es_generator.h"
+#include "packager/media/synthetic/synthetic_media_options.h"
+
+namespace shaka {
+namespace media {
+
+/// Generates a single program MPEG-2 TS stream from SyntheticMediaOptions. The
+/// stream contains the requested audio and video elementary streams, an
+/// optional SCTE-35 PID carrying time_signal splice info sections, and PAT/PMT
+/// repeated regularly so that it looks like a live broadcast feed.
+class SyntheticTsGenerator {
+ public:
+  explicit SyntheticTsGenerator(const SyntheticMediaOptions& options);
+  ~SyntheticTsGenerator();
+
+  /// Reads the next TS packets into @a buffer.
+  /// @return the number of bytes read, which is less than @a size only at the
+  ///         end of the stream, or 0 if there is nothing left to read.
+  uint64_t Read(uint8_t* buffer, uint64_t size);
+
+  /// @return the media time, in seconds since the start of the stream, of the
+  ///         last generated access unit or section.
+  double current_time_in_seconds() const;
+
+ private:
+  // Generates the next access unit or table into |pending_|.
+  // @return false at the end of the stream.
+  bool GenerateNext();
+  void WritePsi();
+  void WriteVideoAccessUnit();
+  void WriteAudioFrame();
+  void WriteScte35Section();
+  void WritePes(int pid,
+                uint8_t stream_id,
+                bool has_pcr,
+                int64_t time_in_ticks,
+                const std::vector<uint8_t>& data,
+                mp2t::ContinuityCounter* continuity_counter);
+
+  int64_t next_video_time() const;
+  int64_t next_audio_time() const;
+  int64_t next_scte35_time() const;
+  int64_t next_psi_time() const;
+
+  const SyntheticMediaOptions options_;
+  SyntheticRandom random_;
+  std::unique_ptr<SyntheticVideoGenerator> video_generator_;
+  std::unique_ptr<SyntheticAudioGenerator> audio_generator_;
+
+  // Complete PAT and PMT sections, starting from the pointer field.
+  std::vector<uint8_t> pat_;
+  std::vector<uint8_t> pmt_;
+
+  mp2t::ContinuityCounter pat_continuity_counter_;
+  mp2t::ContinuityCounter pmt_continuity_counter_;
+  mp2t::ContinuityCounter video_continuity_counter_;
+  mp2t::ContinuityCounter audio_continuity_counter_;
+  mp2t::ContinuityCounter scte35_continuity_counter_;
+
+  // Timing, in 90 kHz ticks since the start of the stream.
+  int64_t end_time_ = 0;
+  int64_t current_time_ = 0;
+  uint32_t frames_per_gop_ = 1;
+  // Size of a P frame slice payload. Key frames are five times larger.
+  size_t p_frame_size_ = 0;
+  uint64_t video_frame_index_ = 0;
+  uint64_t audio_frame_index_ = 0;
+  uint64_t scte35_index_ = 0;
+  uint64_t psi_index_ = 0;
+
+  // Scratch buffer reused for access units and frames.
+  std::vector<uint8_t> frame_;
+  // Generated TS packets not yet read.
+  BufferWriter pending_;
+  size_t pending_offset_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SyntheticTsGenerator);
+};
+
+}  // namespace media
+}  // namespace shaka
+
+#endif  // PACKAGER_MEDIA_SYNTHETIC_SYNTHETIC_TS_GENERATOR_H_
@@ -0,0 +1,204 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/media/synthetic/synthetic_ts_generator.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <vector>
+
+#include "packager/base/bind.h"
+#include "packager/base/bind_helpers.h"
+#include "packager/media/base/audio_stream_info.h"
+#include "packager/media/base/media_sample.h"
+#include "packager/media/base/video_stream_info.h"
+#include "packager/media/formats/mp2t/mp2t_media_parser.h"
+
+namespace shaka {
+namespace media {
+namespace {
+
+const size_t kTsPacketSize = 188;
+// Odd sized reads to exercise partial packets.
+const size_t kReadSize = 1000;
+const uint64_t kTimescale = 90000;
+const uint64_t kStartTimestamp = 10 * kTimescale;
+
+std::unique_ptr<SyntheticMediaOptions> ParseOptions(const std::string& url) {
+  std::unique_ptr<SyntheticMediaOptions> options =
+      SyntheticMediaOptions::ParseFromString(url);
+  EXPECT_TRUE(options);
+  return options;
+}
+
+std::vector<uint8_t> GenerateAll(const SyntheticMediaOptions& options) {
+  SyntheticTsGenerator generator(options);
+  std::vector<uint8_t> output;
+  uint8_t buffer[kReadSize];
+  while (true) {
+    const uint64_t bytes_read = generator.Read(buffer, sizeof(buffer));
+    if (bytes_read == 0)
+      break;
+    output.insert(output.end(), buffer, buffer + bytes_read);
+  }
+  return output;
+}
+
+}  // namespace
+
+class SyntheticTsGeneratorTest : public testing::Test {
+ protected:
+  void Parse(const std::vector<uint8_t>& ts) {
+    ASSERT_EQ(0u, ts.size() % kTsPacketSize);
+    mp2t::Mp2tMediaParser parser;
+    parser.Init(base::Bind(&SyntheticTsGeneratorTest::OnInit,
+                           base::Unretained(this)),
+                base::Bind(&SyntheticTsGeneratorTest::OnNewSample,
+                           base::Unretained(this)),
+                nullptr);
+    parser.SetSignalCallback(base::Bind(&SyntheticTsGeneratorTest::OnSignal,
+                                        base::Unretained(this)));
+    ASSERT_TRUE(parser.Parse(ts.data(), static_cast<int>(ts.size())));
+    ASSERT_TRUE(parser.Flush());
+  }
+
+  void OnInit(const std::vector<std::shared_ptr<StreamInfo>>& stream_infos) {
+    for (const auto& stream_info : stream_infos) {
+      if (stream_info->stream_type() == kStreamVideo) {
+        video_info_ = static_cast<const VideoStreamInfo*>(stream_info.get());
+        video_track_id_ = stream_info->track_id();
+      } else if (stream_info->stream_type() == kStreamAudio) {
+        audio_info_ = static_cast<const AudioStreamInfo*>(stream_info.get());
+        audio_track_id_ = stream_info->track_id();
+      }
+      stream_infos_.push_back(stream_info);
+    }
+  }
+
+  bool OnNewSample(uint32_t track_id,
+                   const std::shared_ptr<MediaSample>& sample) {
+    if (track_id == video_track_id_) {
+      ++video_sample_count_;
+      video_bytes_ += sample->data_size();
+      if (sample->is_key_frame())
+        ++video_key_frame_count_;
+    } else if (track_id == audio_track_id_) {
+      ++audio_sample_count_;
+    } else {
+      ADD_FAILURE() << "Unexpected track " << track_id;
+    }
+    return true;
+  }
+
+  void OnSignal(const std::shared_ptr<Scte35Event>& signal) {
+    signals_.push_back(signal);
+  }
+
+  std::vector<std::shared_ptr<StreamInfo>> stream_infos_;
+  const VideoStreamInfo* video_info_ = nullptr;
+  const AudioStreamInfo* audio_info_ = nullptr;
+  uint32_t video_track_id_ = 0;
+  uint32_t audio_track_id_ = 0;
+  int video_sample_count_ = 0;
+  int video_key_frame_count_ = 0;
+  size_t video_bytes_ = 0;
+  int audio_sample_count_ = 0;
+  std::vector<std::shared_ptr<Scte35Event>> signals_;
+};
+
+TEST_F(SyntheticTsGeneratorTest, H264Aac) {
+  auto options = ParseOptions(
+      "synth://h264+aac?duration=10&gop=2&frame_rate=30&width=854&height=480&"
+      "video_bitrate=1000000");
+  ASSERT_NO_FATAL_FAILURE(Parse(GenerateAll(*options)));
+
+  ASSERT_EQ(2u, stream_infos_.size());
+  ASSERT_TRUE(video_info_);
+  EXPECT_EQ(kCodecH264, video_info_->codec());
+  EXPECT_EQ(854u, video_info_->width());
+  EXPECT_EQ(480u, video_info_->height());
+  ASSERT_TRUE(audio_info_);
+  EXPECT_EQ(kCodecAAC, audio_info_->codec());
+  EXPECT_EQ(48000u, audio_info_->sampling_frequency());
+  EXPECT_EQ(2u, audio_info_->num_channels());
+
+  EXPECT_EQ(300, video_sample_count_);
+  EXPECT_EQ(5, video_key_frame_count_);
+  // 10 seconds of 1024 sample frames at 48 kHz.
+  EXPECT_EQ(469, audio_sample_count_);
+  // Within 10% of the requested bitrate.
+  EXPECT_NEAR(1000000 * 10 / 8, video_bytes_, 125000);
+}
+
+TEST_F(SyntheticTsGeneratorTest, H265Ac3) {
+  auto options = ParseOptions(
+      "synth://h265+ac3?duration=4&gop=1&frame_rate=25&width=854&height=480&"
+      "audio_bitrate=192000");
+  ASSERT_NO_FATAL_FAILURE(Parse(GenerateAll(*options)));
+
+  ASSERT_EQ(2u, stream_infos_.size());
+  ASSERT_TRUE(video_info_);
+  EXPECT_EQ(kCodecH265, video_info_->codec());
+  EXPECT_EQ(854u, video_info_->width());
+  EXPECT_EQ(480u, video_info_->height());
+  ASSERT_TRUE(audio_info_);
+  EXPECT_EQ(kCodecAC3, audio_info_->codec());
+  EXPECT_EQ(48000u, audio_info_->sampling_frequency());
+  EXPECT_EQ(2u, audio_info_->num_channels());
+
+  EXPECT_EQ(100, video_sample_count_);
+  EXPECT_EQ(4, video_key_frame_count_);
+  // 4 seconds of 1536 sample frames at 48 kHz.
+  EXPECT_EQ(125, audio_sample_count_);
+}
+
+TEST_F(SyntheticTsGeneratorTest, AudioOnly) {
+  auto options = ParseOptions("synth://aac?duration=2");
+  ASSERT_NO_FATAL_FAILURE(Parse(GenerateAll(*options)));
+
+  ASSERT_EQ(1u, stream_infos_.size());
+  ASSERT_TRUE(audio_info_);
+  EXPECT_EQ(94, audio_sample_count_);
+}
+
+TEST_F(SyntheticTsGeneratorTest, Scte35) {
+  auto options = ParseOptions(
+      "synth://h264+scte35?duration=10&scte35_interval=4&scte35_duration=30");
+  ASSERT_NO_FATAL_FAILURE(Parse(GenerateAll(*options)));
+
+  ASSERT_EQ(2u, signals_.size());
+  // Cues are sent every 4 seconds and signal a splice point 2 seconds later.
+  EXPECT_EQ(kStartTimestamp + 6 * kTimescale, signals_[0]->start_time_pts);
+  EXPECT_EQ(kStartTimestamp + 10 * kTimescale, signals_[1]->start_time_pts);
+  EXPECT_EQ(30 * kTimescale, signals_[0]->duration);
+  EXPECT_EQ(0x34u, signals_[0]->descriptor.segmentation_type_id);
+  EXPECT_EQ(0u, signals_[0]->descriptor.segmentation_event_id);
+  EXPECT_EQ(1u, signals_[1]->descriptor.segmentation_event_id);
+}
+
+TEST_F(SyntheticTsGeneratorTest, Deterministic) {
+  auto options = ParseOptions("synth://h264+aac?duration=2&seed=3");
+  const std::vector<uint8_t> output = GenerateAll(*options);
+  EXPECT_EQ(output, GenerateAll(*options));
+
+  auto other_options = ParseOptions("synth://h264+aac?duration=2&seed=4");
+  const std::vector<uint8_t> other_output = GenerateAll(*other_options);
+  EXPECT_NE(output, other_output);
+}
+
+TEST_F(SyntheticTsGeneratorTest, Endless) {
+  auto options = ParseOptions("synth://h264?duration=0&video_bitrate=100000");
+  SyntheticTsGenerator generator(*options);
+  std::vector<uint8_t> buffer(kReadSize);
+  // Keep reading past what a finite stream would contain.
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(kReadSize, generator.Read(buffer.data(), buffer.size()));
+  EXPECT_GT(generator.current_time_in_seconds(), 0);
+}
+
+}  // namespace media
+}  // namespace shaka
@@ -18,6 +18,7 @@
       ],
       'dependencies': [
         '../base/media_base.gyp:media_base',
+        '../../packager.gyp:memory_tracker',
       ],
     },
     {
@@ -16,7 +16,10 @@ const size_t kStreamIndexIn = 0;
 const size_t kStreamIndexOut = 0;
 }  // namespace
 
-TrickPlayHandler::TrickPlayHandler(uint32_t factor) : factor_(factor) {
+TrickPlayHandler::TrickPlayHandler(uint32_t factor)
+    : factor_(factor),
+      delayed_messages_memory_tracker_("TrickPlayHandler",
+                                       "factor " + std::to_string(factor)) {
   DCHECK_GE(factor, 1u)
       << "Trick Play Handles must have a factor of 1 or higher.";
 }
@@ -53,8 +56,7 @@ Status TrickPlayHandler::OnFlushRequest(size_t input_stream_index) {
   // anything.
   Status s;
   while (s.ok() && delayed_messages_.size()) {
-    s.Update(Dispatch(std::move(delayed_messages_.front())));
-    delayed_messages_.pop_front();
+    s.Update(DispatchDelayedMessage());
   }
 
   return s.ok() ? MediaHandler::FlushAllDownstreams() : s;
@@ -82,8 +84,7 @@ Status TrickPlayHandler::OnStreamInfo(const StreamInfo& info) {
   // Add video info to the message queue so that it can be sent out with all
   // other messages. It won't be sent until the second trick play frame comes
   // through. Until then, it can be updated via the |video_info_| member.
-  delayed_messages_.push_back(
-      StreamData::FromStreamInfo(kStreamIndexOut, video_info_));
+  DelayMessage(StreamData::FromStreamInfo(kStreamIndexOut, video_info_));
 
   return Status::OK;
 }
@@ -117,7 +118,7 @@ Status TrickPlayHandler::OnSegmentInfo(
       // not get sent downstream until the next trick play frame comes through
       // or flush is called.
       previous_segment_ = std::make_shared<SegmentInfo>(*info);
-      delayed_messages_.push_back(
+      DelayMessage(
           StreamData::FromSegmentInfo(kStreamIndexOut, previous_segment_));
       return Status::OK;
 
@@ -167,7 +168,7 @@ Status TrickPlayHandler::OnTrickFrame(const MediaSample& sample) {
   previous_trick_frame_ = sample.Clone();
 
   // Add the message to our queue so that it will be ready to go out.
-  delayed_messages_.push_back(
+  DelayMessage(
       StreamData::FromMediaSample(kStreamIndexOut, previous_trick_frame_));
 
   // We need two trick play frames before we can send out our stream info, so we
@@ -181,11 +182,24 @@ Status TrickPlayHandler::OnTrickFrame(const MediaSample& sample) {
   // added.
   Status s;
   while (s.ok() && delayed_messages_.size() > 1) {
-    s.Update(Dispatch(std::move(delayed_messages_.front())));
-    delayed_messages_.pop_front();
+    s.Update(DispatchDelayedMessage());
   }
   return s;
 }
 
+void TrickPlayHandler::DelayMessage(std::unique_ptr<StreamData> stream_data) {
+  delayed_messages_memory_tracker_.Add(stream_data->EstimateMemoryUsage());
+  delayed_messages_.push_back(std::move(stream_data));
+}
+
+Status TrickPlayHandler::DispatchDelayedMessage() {
+  DCHECK(!delayed_messages_.empty());
+  std::unique_ptr<StreamData> stream_data =
+      std::move(delayed_messages_.front());
+  delayed_messages_.pop_front();
+  delayed_messages_memory_tracker_.Release(stream_data->EstimateMemoryUsage());
+  return Dispatch(std::move(stream_data));
+}
+
 }  // namespace media
 }  // namespace shaka
@@ -10,6 +10,7 @@
 #include <list>
 
 #include "packager/media/base/media_handler.h"
+#include "packager/memory_tracker.h"
 
 namespace shaka {
 namespace media {
@@ -29,6 +30,7 @@ class TrickPlayHandler : public MediaHandler {
   TrickPlayHandler(const TrickPlayHandler&) = delete;
   TrickPlayHandler& operator=(const TrickPlayHandler&) = delete;
 
+  std::string name() const override { return "TrickPlayHandler"; }
   Status InitializeInternal() override;
   Status Process(std::unique_ptr<StreamData> stream_data) override;
   Status OnFlushRequest(size_t input_stream_index) override;
@@ -38,6 +40,11 @@ class TrickPlayHandler : public MediaHandler {
   Status OnMediaSample(const MediaSample& sample);
   Status OnTrickFrame(const MediaSample& sample);
 
+  // Adds a message to the end of |delayed_messages_|.
+  void DelayMessage(std::unique_ptr<StreamData> stream_data);
+  // Dispatches the message at the front of |delayed_messages_|.
+  Status DispatchDelayedMessage();
+
   const uint32_t factor_;
 
   uint64_t total_frames_ = 0;
@@ -66,6 +73,8 @@ class TrickPlayHandler : public MediaHandler {
   // kept in order, messages are only dispatched through this queue and never
   // directly.
   std::list<std::unique_ptr<StreamData>> delayed_messages_;
+  // Tracks the memory of |delayed_messages_|.
+  MemoryTracker delayed_messages_memory_tracker_;
 };
 
 }  // namespace media
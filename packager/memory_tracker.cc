@@ -0,0 +1,242 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/memory_tracker.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "packager/base/logging.h"
+#include "packager/base/synchronization/lock.h"
+#include "packager/base/threading/platform_thread.h"
+
+namespace shaka {
+
+struct MemoryAccount {
+  MemoryAccount(const std::string& job_name,
+                const std::string& buffer_name,
+                const std::string& stream_name)
+      : job_name(job_name),
+        buffer_name(buffer_name),
+        stream_name(stream_name) {}
+
+  const std::string job_name;
+  const std::string buffer_name;
+  const std::string stream_name;
+  std::atomic<int64_t> current_bytes{0};
+  std::atomic<int64_t> peak_bytes{0};
+};
+
+struct MemoryRegistry {
+  // Job, buffer and stream names.
+  typedef std::tuple<std::string, std::string, std::string> AccountKey;
+
+  base::Lock lock;
+  // Accounts are never deleted, so that the peaks of finished jobs are kept
+  // and trackers can hold pointers to them without locking.
+  std::map<AccountKey, std::unique_ptr<MemoryAccount>> accounts;
+  std::atomic<int64_t> total_bytes{0};
+  std::atomic<int64_t> peak_total_bytes{0};
+  // Part of |total_bytes| tracked by MemoryTracker::kReserved trackers.
+  std::atomic<int64_t> reserved_bytes{0};
+  std::atomic<int64_t> soft_limit{0};
+  std::atomic<int64_t> total_wait_us{0};
+};
+
+namespace {
+
+// The interval to check the total bytes in WaitForSoftLimit().
+const int64_t kSoftLimitPollIntervalInMilliseconds = 10;
+
+thread_local const std::shared_ptr<MemoryRegistry>* g_registry = nullptr;
+thread_local const std::string* g_job_name = nullptr;
+thread_local const std::string* g_input_name = nullptr;
+
+const std::shared_ptr<MemoryRegistry>& GetDefaultRegistry() {
+  static const std::shared_ptr<MemoryRegistry>* default_registry =
+      new std::shared_ptr<MemoryRegistry>(new MemoryRegistry);
+  return *default_registry;
+}
+
+// Returns the registry of the current thread.
+const std::shared_ptr<MemoryRegistry>& GetRegistry() {
+  return g_registry ? *g_registry : GetDefaultRegistry();
+}
+
+// Returns the bytes of |registry| which count towards its soft limit.
+int64_t GetLimitedBytes(const MemoryRegistry& registry) {
+  return registry.total_bytes.load(std::memory_order_relaxed) -
+         registry.reserved_bytes.load(std::memory_order_relaxed);
+}
+
+void UpdatePeak(int64_t value, std::atomic<int64_t>* peak) {
+  int64_t current_peak = peak->load(std::memory_order_relaxed);
+  while (value > current_peak &&
+         !peak->compare_exchange_weak(current_peak, value,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+MemoryAccount* GetAccount(MemoryRegistry* registry,
+                          const std::string& buffer_name,
+                          const std::string& tracker_stream_name) {
+  const std::string job_name = g_job_name ? *g_job_name : std::string();
+  const std::string stream_name =
+      tracker_stream_name.empty() && g_input_name ? *g_input_name
+                                                  : tracker_stream_name;
+  base::AutoLock auto_lock(registry->lock);
+  std::unique_ptr<MemoryAccount>& account =
+      registry->accounts[MemoryRegistry::AccountKey(job_name, buffer_name,
+                                                    stream_name)];
+  if (!account)
+    account.reset(new MemoryAccount(job_name, buffer_name, stream_name));
+  return account.get();
+}
+
+}  // namespace
+
+MemoryAccounting::ScopedJob::ScopedJob(MemoryAccounting* accounting,
+                                       const std::string& job_name)
+    : previous_registry_(g_registry),
+      previous_job_name_(g_job_name),
+      registry_(accounting ? accounting->registry_ : GetDefaultRegistry()),
+      job_name_(job_name) {
+  g_registry = &registry_;
+  g_job_name = &job_name_;
+}
+
+MemoryAccounting::ScopedJob::~ScopedJob() {
+  g_registry = previous_registry_;
+  g_job_name = previous_job_name_;
+}
+
+MemoryAccounting::ScopedInput::ScopedInput(const std::string& input_name)
+    : previous_input_name_(g_input_name), input_name_(input_name) {
+  g_input_name = &input_name_;
+}
+
+MemoryAccounting::ScopedInput::~ScopedInput() {
+  g_input_name = previous_input_name_;
+}
+
+MemoryAccounting::MemoryAccounting() : registry_(new MemoryRegistry) {}
+
+MemoryAccounting::MemoryAccounting(std::shared_ptr<MemoryRegistry> registry)
+    : registry_(std::move(registry)) {}
+
+MemoryAccounting::~MemoryAccounting() {}
+
+MemoryAccounting* MemoryAccounting::GetDefault() {
+  static MemoryAccounting* default_accounting =
+      new MemoryAccounting(GetDefaultRegistry());
+  return default_accounting;
+}
+
+void MemoryAccounting::GetUsage(std::vector<MemoryAccountUsage>* usage) const {
+  DCHECK(usage);
+  usage->clear();
+  base::AutoLock auto_lock(registry_->lock);
+  for (const auto& entry : registry_->accounts) {
+    const MemoryAccount& account = *entry.second;
+    MemoryAccountUsage account_usage;
+    account_usage.job_name = account.job_name;
+    account_usage.buffer_name = account.buffer_name;
+    account_usage.stream_name = account.stream_name;
+    account_usage.current_bytes =
+        account.current_bytes.load(std::memory_order_relaxed);
+    account_usage.peak_bytes =
+        account.peak_bytes.load(std::memory_order_relaxed);
+    usage->push_back(account_usage);
+  }
+}
+
+int64_t MemoryAccounting::total_bytes() const {
+  return registry_->total_bytes.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryAccounting::peak_total_bytes() const {
+  return registry_->peak_total_bytes.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryAccounting::reserved_bytes() const {
+  return registry_->reserved_bytes.load(std::memory_order_relaxed);
+}
+
+void MemoryAccounting::SetSoftLimit(int64_t soft_limit_in_bytes) {
+  DCHECK_GE(soft_limit_in_bytes, 0);
+  registry_->soft_limit.store(soft_limit_in_bytes, std::memory_order_relaxed);
+}
+
+int64_t MemoryAccounting::soft_limit() const {
+  return registry_->soft_limit.load(std::memory_order_relaxed);
+}
+
+base::TimeDelta MemoryAccounting::total_wait_time() const {
+  return base::TimeDelta::FromMicroseconds(
+      registry_->total_wait_us.load(std::memory_order_relaxed));
+}
+
+bool MemoryAccounting::WaitForSoftLimit(base::TimeDelta max_wait) {
+  MemoryRegistry* registry = GetRegistry().get();
+  const int64_t limit = registry->soft_limit.load(std::memory_order_relaxed);
+  if (limit == 0 || GetLimitedBytes(*registry) <= limit)
+    return true;
+
+  const base::TimeTicks start = base::TimeTicks::Now();
+  const base::TimeTicks deadline = start + max_wait;
+  bool below_limit = false;
+  while (!below_limit && base::TimeTicks::Now() < deadline) {
+    base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(
+        kSoftLimitPollIntervalInMilliseconds));
+    below_limit = GetLimitedBytes(*registry) <=
+                  registry->soft_limit.load(std::memory_order_relaxed);
+  }
+  registry->total_wait_us.fetch_add(
+      (base::TimeTicks::Now() - start).InMicroseconds(),
+      std::memory_order_relaxed);
+  VLOG_IF(1, !below_limit) << "Memory soft limit " << limit
+                           << " is still exceeded after waiting "
+                           << max_wait.InMillisecondsF() << "ms.";
+  return below_limit;
+}
+
+MemoryTracker::MemoryTracker(const std::string& buffer_name,
+                             const std::string& stream_name,
+                             Kind kind)
+    : buffer_name_(buffer_name), stream_name_(stream_name), kind_(kind) {}
+
+MemoryTracker::~MemoryTracker() {
+  Set(0);
+}
+
+void MemoryTracker::Add(int64_t bytes) {
+  if (bytes == 0)
+    return;
+  DCHECK_GE(bytes_ + bytes, 0);
+  if (!account_) {
+    registry_ = GetRegistry();
+    account_ = GetAccount(registry_.get(), buffer_name_, stream_name_);
+  }
+  bytes_ += bytes;
+
+  const int64_t current_bytes =
+      account_->current_bytes.fetch_add(bytes, std::memory_order_relaxed) +
+      bytes;
+  if (kind_ == kReserved)
+    registry_->reserved_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  const int64_t total_bytes =
+      registry_->total_bytes.fetch_add(bytes, std::memory_order_relaxed) +
+      bytes;
+  if (bytes > 0) {
+    UpdatePeak(current_bytes, &account_->peak_bytes);
+    UpdatePeak(total_bytes, &registry_->peak_total_bytes);
+  }
+}
+
+}  // namespace shaka
@@ -0,0 +1,186 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_MEMORY_TRACKER_H_
+#define PACKAGER_MEMORY_TRACKER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "packager/base/time/time.h"
+
+namespace shaka {
+
+struct MemoryAccount;
+struct MemoryRegistry;
+
+/// Memory used by a kind of buffer of a stream in a job.
+struct MemoryAccountUsage {
+  /// Name of the job which allocated the memory. Empty if the memory is not
+  /// allocated by a job, e.g. by the thread calling Packager::Run().
+  std::string job_name;
+  /// Name of the buffer, e.g. "ByteQueue".
+  std::string buffer_name;
+  /// Name of the stream, or of the input for the buffers of an input which are
+  /// not associated with a specific stream, e.g. parser buffers. Can be empty
+  /// if neither is known.
+  std::string stream_name;
+  /// Bytes currently used.
+  int64_t current_bytes = 0;
+  /// The largest number of bytes used at any time.
+  int64_t peak_bytes = 0;
+};
+
+/// Accounting of the memory used by the major buffers of a packaging
+/// pipeline, e.g. of a Packager instance. Buffers report their sizes through
+/// MemoryTracker. The memory tracked by threads outside of any ScopedJob is
+/// attributed to a process wide default accounting.
+class MemoryAccounting {
+ public:
+  /// Attributes the memory tracked by the current thread to a job of an
+  /// accounting while in scope.
+  class ScopedJob {
+   public:
+    /// @param accounting is the accounting of the job. Null means the default
+    ///        accounting.
+    /// @param job_name is the name of the job.
+    ScopedJob(MemoryAccounting* accounting, const std::string& job_name);
+    ~ScopedJob();
+
+   private:
+    ScopedJob(const ScopedJob&) = delete;
+    ScopedJob& operator=(const ScopedJob&) = delete;
+
+    const std::shared_ptr<MemoryRegistry>* const previous_registry_;
+    const std::string* const previous_job_name_;
+    const std::shared_ptr<MemoryRegistry> registry_;
+    const std::string job_name_;
+  };
+
+  /// Attributes the memory tracked by the current thread without a stream
+  /// name, e.g. by the parser of an input, to an input while in scope.
+  class ScopedInput {
+   public:
+    explicit ScopedInput(const std::string& input_name);
+    ~ScopedInput();
+
+   private:
+    ScopedInput(const ScopedInput&) = delete;
+    ScopedInput& operator=(const ScopedInput&) = delete;
+
+    const std::string* const previous_input_name_;
+    const std::string input_name_;
+  };
+
+  MemoryAccounting();
+  /// The accounts are kept alive until the trackers using them are
+  /// destroyed.
+  ~MemoryAccounting();
+
+  /// @return The accounting of the memory tracked outside of any ScopedJob.
+  static MemoryAccounting* GetDefault();
+
+  /// @param usage[out] is filled with the memory used by every buffer kind of
+  ///        every stream of every job which has tracked memory so far,
+  ///        including buffers which have since been released.
+  void GetUsage(std::vector<MemoryAccountUsage>* usage) const;
+
+  /// @return The total bytes currently tracked.
+  int64_t total_bytes() const;
+  /// @return The largest total bytes tracked at any time.
+  int64_t peak_total_bytes() const;
+
+  /// @return The bytes currently tracked as reservations, see
+  ///         MemoryTracker::kReserved. They are part of total_bytes().
+  int64_t reserved_bytes() const;
+
+  /// Sets a soft limit on the total bytes tracked, excluding the reserved
+  /// bytes, enforced by producers calling WaitForSoftLimit(). Zero, which is
+  /// the default, disables the limit.
+  void SetSoftLimit(int64_t soft_limit_in_bytes);
+  /// @return The soft limit set by SetSoftLimit().
+  int64_t soft_limit() const;
+
+  /// @return The total time spent blocked in WaitForSoftLimit().
+  base::TimeDelta total_wait_time() const;
+
+  /// Blocks while the total bytes tracked by the accounting of the current
+  /// thread, excluding the reserved bytes, exceed its soft limit, so the
+  /// consumers of the buffers can catch up. The memory may be held by buffers
+  /// which are only drained by more input, so the wait is bounded by
+  /// @a max_wait to make progress in any case.
+  /// @return false if the soft limit is still exceeded after @a max_wait.
+  static bool WaitForSoftLimit(base::TimeDelta max_wait);
+
+ private:
+  MemoryAccounting(const MemoryAccounting&) = delete;
+  MemoryAccounting& operator=(const MemoryAccounting&) = delete;
+
+  explicit MemoryAccounting(std::shared_ptr<MemoryRegistry> registry);
+
+  // Shared with the trackers, which may outlive the accounting.
+  const std::shared_ptr<MemoryRegistry> registry_;
+};
+
+/// Tracks the bytes used by a buffer. The bytes are attributed to the
+/// accounting and the job of the thread which first updates them. Not thread
+/// safe: a tracker should be updated by one thread at a time, like the buffer
+/// it tracks.
+class MemoryTracker {
+ public:
+  /// How the bytes tracked relate to the soft limit of the accounting.
+  enum Kind {
+    /// The bytes follow the data buffered, which the consumers of the buffer
+    /// release, so they count towards the soft limit.
+    kBuffered,
+    /// The bytes are a fixed capacity reserved while the buffer exists. Waiting
+    /// for the consumers cannot release them, so they are excluded from the
+    /// soft limit.
+    kReserved,
+  };
+
+  /// @param buffer_name is the kind of buffer tracked, e.g. "ByteQueue".
+  /// @param stream_name identifies the stream of the buffer. Trackers with the
+  ///        same buffer and stream names in the same job share their usage.
+  ///        If empty, the input of the updating thread, if any, is used, see
+  ///        MemoryAccounting::ScopedInput.
+  /// @param kind specifies whether the bytes count towards the soft limit.
+  MemoryTracker(const std::string& buffer_name,
+                const std::string& stream_name,
+                Kind kind = kBuffered);
+  /// Releases the bytes still tracked.
+  ~MemoryTracker();
+
+  /// Adds @a bytes to the bytes tracked.
+  void Add(int64_t bytes);
+  /// Removes @a bytes from the bytes tracked.
+  void Release(int64_t bytes) { Add(-bytes); }
+  /// Sets the bytes tracked to @a bytes.
+  void Set(int64_t bytes) { Add(bytes - bytes_); }
+
+  /// @return The bytes tracked.
+  int64_t bytes() const { return bytes_; }
+
+ private:
+  MemoryTracker(const MemoryTracker&) = delete;
+  MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+  const std::string buffer_name_;
+  const std::string stream_name_;
+  const Kind kind_;
+  // Bound on the first update, to get the accounting and the job of the
+  // updating thread.
+  std::shared_ptr<MemoryRegistry> registry_;
+  MemoryAccount* account_ = nullptr;
+  int64_t bytes_ = 0;
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_MEMORY_TRACKER_H_
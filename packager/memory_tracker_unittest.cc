@@ -0,0 +1,217 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/memory_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include "packager/base/threading/simple_thread.h"
+
+namespace shaka {
+namespace {
+
+// Returns the usage of the given account, which is zero if not found.
+MemoryAccountUsage GetAccountUsage(const MemoryAccounting& accounting,
+                                   const std::string& job_name,
+                                   const std::string& buffer_name,
+                                   const std::string& stream_name) {
+  std::vector<MemoryAccountUsage> usage;
+  accounting.GetUsage(&usage);
+  for (const MemoryAccountUsage& account_usage : usage) {
+    if (account_usage.job_name == job_name &&
+        account_usage.buffer_name == buffer_name &&
+        account_usage.stream_name == stream_name) {
+      return account_usage;
+    }
+  }
+  return MemoryAccountUsage();
+}
+
+class TrackMemoryDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  TrackMemoryDelegate(MemoryAccounting* accounting,
+                      const std::string& job_name,
+                      int64_t bytes)
+      : accounting_(accounting), job_name_(job_name), bytes_(bytes) {}
+
+  void Run() override {
+    MemoryAccounting::ScopedJob scoped_job(accounting_, job_name_);
+    MemoryTracker tracker("ThreadBuffer", "stream");
+    tracker.Add(bytes_);
+
+    // Buffers without a stream name are attributed to the input.
+    MemoryAccounting::ScopedInput scoped_input(job_name_ + ".mp4");
+    MemoryTracker input_tracker("InputBuffer", "");
+    input_tracker.Add(bytes_);
+  }
+
+ private:
+  MemoryAccounting* const accounting_;
+  const std::string job_name_;
+  const int64_t bytes_;
+};
+
+}  // namespace
+
+TEST(MemoryTrackerTest, TracksCurrentAndPeakBytes) {
+  MemoryAccounting accounting;
+  MemoryAccounting::ScopedJob scoped_job(&accounting, "");
+  {
+    MemoryTracker tracker("Buffer", "stream");
+    tracker.Add(100);
+    tracker.Add(50);
+    tracker.Release(120);
+    EXPECT_EQ(30, tracker.bytes());
+    EXPECT_EQ(30, accounting.total_bytes());
+    EXPECT_EQ(150, accounting.peak_total_bytes());
+
+    MemoryAccountUsage usage =
+        GetAccountUsage(accounting, "", "Buffer", "stream");
+    EXPECT_EQ(30, usage.current_bytes);
+    EXPECT_EQ(150, usage.peak_bytes);
+
+    tracker.Set(80);
+    EXPECT_EQ(80, tracker.bytes());
+  }
+  // Released on destruction, but the peak is kept.
+  MemoryAccountUsage usage =
+      GetAccountUsage(accounting, "", "Buffer", "stream");
+  EXPECT_EQ(0, usage.current_bytes);
+  EXPECT_EQ(150, usage.peak_bytes);
+  EXPECT_EQ(0, accounting.total_bytes());
+}
+
+TEST(MemoryTrackerTest, TrackersShareAccount) {
+  MemoryAccounting accounting;
+  MemoryAccounting::ScopedJob scoped_job(&accounting, "");
+  MemoryTracker tracker1("Buffer", "stream");
+  MemoryTracker tracker2("Buffer", "stream");
+  tracker1.Add(10);
+  tracker2.Add(20);
+  tracker1.Release(10);
+
+  MemoryAccountUsage usage =
+      GetAccountUsage(accounting, "", "Buffer", "stream");
+  EXPECT_EQ(20, usage.current_bytes);
+  EXPECT_EQ(30, usage.peak_bytes);
+}
+
+TEST(MemoryTrackerTest, DefaultAccounting) {
+  MemoryAccounting* accounting = MemoryAccounting::GetDefault();
+  const int64_t total_bytes = accounting->total_bytes();
+  MemoryTracker tracker("Buffer", "DefaultAccounting");
+  tracker.Add(10);
+  EXPECT_EQ(total_bytes + 10, accounting->total_bytes());
+  EXPECT_EQ(
+      10,
+      GetAccountUsage(*accounting, "", "Buffer", "DefaultAccounting")
+          .current_bytes);
+}
+
+TEST(MemoryTrackerTest, AttributesToJob) {
+  MemoryAccounting accounting;
+  TrackMemoryDelegate delegate1(&accounting, "job1", 100);
+  TrackMemoryDelegate delegate2(&accounting, "job2", 200);
+  base::DelegateSimpleThread thread1(&delegate1, "Job1");
+  base::DelegateSimpleThread thread2(&delegate2, "Job2");
+  thread1.Start();
+  thread2.Start();
+  thread1.Join();
+  thread2.Join();
+
+  EXPECT_EQ(100, GetAccountUsage(accounting, "job1", "ThreadBuffer", "stream")
+                     .peak_bytes);
+  EXPECT_EQ(200, GetAccountUsage(accounting, "job2", "ThreadBuffer", "stream")
+                     .peak_bytes);
+  EXPECT_EQ(
+      0, GetAccountUsage(accounting, "", "ThreadBuffer", "stream").peak_bytes);
+
+  EXPECT_EQ(100,
+            GetAccountUsage(accounting, "job1", "InputBuffer", "job1.mp4")
+                .peak_bytes);
+  EXPECT_EQ(200,
+            GetAccountUsage(accounting, "job2", "InputBuffer", "job2.mp4")
+                .peak_bytes);
+  EXPECT_EQ(
+      0, GetAccountUsage(accounting, "job1", "InputBuffer", "").peak_bytes);
+}
+
+TEST(MemoryTrackerTest, SeparateAccountings) {
+  MemoryAccounting accounting1;
+  MemoryAccounting accounting2;
+  TrackMemoryDelegate delegate1(&accounting1, "job", 100);
+  TrackMemoryDelegate delegate2(&accounting2, "job", 200);
+  base::DelegateSimpleThread thread1(&delegate1, "Job1");
+  base::DelegateSimpleThread thread2(&delegate2, "Job2");
+  thread1.Start();
+  thread2.Start();
+  thread1.Join();
+  thread2.Join();
+
+  // Both accountings have a job with the same name, but do not share usage.
+  EXPECT_EQ(200, accounting1.peak_total_bytes());
+  EXPECT_EQ(400, accounting2.peak_total_bytes());
+  EXPECT_EQ(100, GetAccountUsage(accounting1, "job", "ThreadBuffer", "stream")
+                     .peak_bytes);
+  EXPECT_EQ(200, GetAccountUsage(accounting2, "job", "ThreadBuffer", "stream")
+                     .peak_bytes);
+}
+
+TEST(MemoryTrackerTest, WaitForSoftLimit) {
+  const base::TimeDelta kMaxWait = base::TimeDelta::FromMilliseconds(50);
+  MemoryAccounting accounting;
+  MemoryAccounting other_accounting;
+  MemoryAccounting::ScopedJob scoped_job(&accounting, "");
+  // No limit.
+  EXPECT_TRUE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+
+  MemoryTracker tracker("Buffer", "stream");
+  tracker.Add(1000);
+  accounting.SetSoftLimit(1001);
+  EXPECT_TRUE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+
+  accounting.SetSoftLimit(999);
+  EXPECT_FALSE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+  EXPECT_LE(kMaxWait, accounting.total_wait_time());
+  EXPECT_EQ(base::TimeDelta(), other_accounting.total_wait_time());
+
+  // The limit of another accounting does not apply.
+  {
+    MemoryAccounting::ScopedJob other_scoped_job(&other_accounting, "");
+    EXPECT_TRUE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+    other_accounting.SetSoftLimit(1);
+    EXPECT_TRUE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+  }
+
+  accounting.SetSoftLimit(0);
+  EXPECT_TRUE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+}
+
+TEST(MemoryTrackerTest, ReservedBytesAreExcludedFromSoftLimit) {
+  const base::TimeDelta kMaxWait = base::TimeDelta::FromMilliseconds(50);
+  MemoryAccounting accounting;
+  MemoryAccounting::ScopedJob scoped_job(&accounting, "");
+  accounting.SetSoftLimit(100);
+
+  MemoryTracker reserved_tracker("Cache", "stream", MemoryTracker::kReserved);
+  reserved_tracker.Add(1000);
+  EXPECT_EQ(1000, accounting.total_bytes());
+  EXPECT_EQ(1000, accounting.reserved_bytes());
+  EXPECT_TRUE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+  EXPECT_EQ(base::TimeDelta(), accounting.total_wait_time());
+
+  MemoryTracker tracker("Buffer", "stream");
+  tracker.Add(101);
+  EXPECT_FALSE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+  tracker.Set(100);
+  EXPECT_TRUE(MemoryAccounting::WaitForSoftLimit(kMaxWait));
+
+  reserved_tracker.Set(0);
+  EXPECT_EQ(0, accounting.reserved_bytes());
+  EXPECT_EQ(100, accounting.total_bytes());
+}
+
+}  // namespace shaka
@@ -213,6 +213,14 @@ Representation* AdaptationSet::CopyRepresentation(
   return representation_ptr;
 }
 
+bool AdaptationSet::RemoveRepresentation(uint32_t representation_id) {
+  if (representation_map_.erase(representation_id) == 0)
+    return false;
+  representation_segment_start_times_.erase(representation_id);
+  has_removed_representations_ = true;
+  return true;
+}
+
 void AdaptationSet::AddContentProtectionElement(
     const ContentProtectionElement& content_protection_element) {
   content_protection_elements_.push_back(content_protection_element);
@@ -68,6 +68,13 @@ class AdaptationSet {
   virtual Representation* CopyRepresentation(
       const Representation& representation);
 
+  /// Remove a Representation, e.g. when a rendition is dropped while packaging
+  /// live content. An AdaptationSet whose Representations have all been
+  /// removed is not output.
+  /// @param representation_id is the ID of the Representation to remove.
+  /// @return true on success, false if there is no such Representation.
+  bool RemoveRepresentation(uint32_t representation_id);
+
   /// Add a ContenProtection element to the adaptation set.
   /// AdaptationSet does not add <ContentProtection> elements
   /// automatically to itself even if @a media_info.protected_content is
@@ -287,6 +294,9 @@ class AdaptationSet {
   // entire timeline is not reasonable and may cause an out-of-memory problem.
   RepresentationTimeline representation_segment_start_times_;
 
+  // Set once a Representation is removed by RemoveRepresentation().
+  bool has_removed_representations_ = false;
+
   // Record the original AdaptationSets the trick play stream belongs to. There
   // can be more than one reference AdaptationSets as multiple streams e.g. SD
   // and HD videos in different AdaptationSets can share the same trick play
@@ -633,6 +633,31 @@ TEST_F(AdaptationSetTest, GetRepresentations) {
               ElementsAre(new_representation1, new_representation2));
 }
 
+TEST_F(AdaptationSetTest, RemoveRepresentation) {
+  const char kVideoMediaInfo[] =
+      "video_info {\n"
+      "  codec: 'avc1'\n"
+      "  width: 1280\n"
+      "  height: 720\n"
+      "  time_scale: 10\n"
+      "  frame_duration: 10\n"
+      "  pixel_width: 1\n"
+      "  pixel_height: 1\n"
+      "}\n"
+      "container_type: CONTAINER_MP4\n";
+
+  auto adaptation_set = CreateAdaptationSet(kNoLanguage);
+  Representation* representation1 =
+      adaptation_set->AddRepresentation(ConvertToMediaInfo(kVideoMediaInfo));
+  Representation* representation2 =
+      adaptation_set->AddRepresentation(ConvertToMediaInfo(kVideoMediaInfo));
+
+  EXPECT_TRUE(adaptation_set->RemoveRepresentation(representation1->id()));
+  EXPECT_THAT(adaptation_set->GetRepresentations(),
+              ElementsAre(representation2));
+  EXPECT_FALSE(adaptation_set->RemoveRepresentation(representation1->id()));
+}
+
 // Verify that subsegmentAlignment is set to true if all the Representations'
 // segments are aligned and the DASH profile is OnDemand.
 // Also checking that not all Representations have to be added before calling
@@ -0,0 +1,244 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/mpd/base/binary_media_info.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include "packager/base/logging.h"
+#include "packager/file/file.h"
+#include "packager/mpd/base/media_info.pb.h"
+
+namespace shaka {
+
+namespace {
+
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::io::StringOutputStream;
+using google::protobuf::internal::WireFormatLite;
+
+enum RecordType {
+  kSegmentIndexRecord = 1,
+  kMediaInfoRecord = 2,
+};
+
+// Number of segments batched into one segment index record.
+const size_t kSegmentsPerRecord = 128;
+
+// Reads a base 128 varint from |file| and advances |position| past it.
+bool ReadVarint(File* file, uint64_t* value, uint64_t* position) {
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte = 0;
+    if (file->Read(&byte, 1) != 1)
+      return false;
+    ++*position;
+    *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+const char kBinaryMediaInfoSuffix[] = ".media_info.pb";
+
+BinaryMediaInfoWriter::BinaryMediaInfoWriter() {}
+
+BinaryMediaInfoWriter::~BinaryMediaInfoWriter() {}
+
+bool BinaryMediaInfoWriter::Open(const std::string& file_name) {
+  file_.reset(File::Open(file_name.c_str(), "w"));
+  if (!file_) {
+    LOG(ERROR) << "Failed to open " << file_name;
+    return false;
+  }
+  pending_segments_.clear();
+  num_pending_segments_ = 0;
+  previous_segment_end_ = 0;
+  return true;
+}
+
+bool BinaryMediaInfoWriter::AddSegment(int64_t start_time,
+                                       int64_t duration,
+                                       uint64_t size) {
+  DCHECK(file_);
+  {
+    StringOutputStream string_stream(&pending_segments_);
+    CodedOutputStream output(&string_stream);
+    output.WriteVarint64(
+        WireFormatLite::ZigZagEncode64(start_time - previous_segment_end_));
+    output.WriteVarint64(static_cast<uint64_t>(duration));
+    output.WriteVarint64(size);
+  }
+  previous_segment_end_ = start_time + duration;
+  if (++num_pending_segments_ < kSegmentsPerRecord)
+    return true;
+  return FlushSegments();
+}
+
+bool BinaryMediaInfoWriter::Finalize(const MediaInfo& media_info) {
+  DCHECK(file_);
+  if (!FlushSegments())
+    return false;
+
+  std::string payload;
+  if (!media_info.SerializeToString(&payload)) {
+    LOG(ERROR) << "Failed to serialize MediaInfo to string.";
+    return false;
+  }
+  if (!WriteRecord(kMediaInfoRecord, payload))
+    return false;
+
+  if (!file_.release()->Close()) {
+    LOG(ERROR) << "Failed to close binary MediaInfo file.";
+    return false;
+  }
+  return true;
+}
+
+bool BinaryMediaInfoWriter::FlushSegments() {
+  if (num_pending_segments_ == 0)
+    return true;
+  if (!WriteRecord(kSegmentIndexRecord, pending_segments_))
+    return false;
+  pending_segments_.clear();
+  num_pending_segments_ = 0;
+  return true;
+}
+
+bool BinaryMediaInfoWriter::WriteRecord(int record_type,
+                                        const std::string& payload) {
+  std::string record;
+  {
+    StringOutputStream string_stream(&record);
+    CodedOutputStream output(&string_stream);
+    output.WriteVarint32(record_type);
+    output.WriteVarint64(payload.size());
+    output.WriteRaw(payload.data(), payload.size());
+  }
+  if (file_->Write(record.data(), record.size()) !=
+      static_cast<int64_t>(record.size())) {
+    LOG(ERROR) << "Failed to write binary MediaInfo record.";
+    return false;
+  }
+  return true;
+}
+
+BinaryMediaInfoReader::BinaryMediaInfoReader() {}
+
+BinaryMediaInfoReader::~BinaryMediaInfoReader() {}
+
+bool BinaryMediaInfoReader::Open(const std::string& file_name) {
+  segment_index_records_.clear();
+  file_.reset(File::Open(file_name.c_str(), "r"));
+  const int64_t file_size = file_ ? file_->Size() : -1;
+  if (file_size < 0) {
+    LOG(ERROR) << "Failed to open " << file_name;
+    return false;
+  }
+
+  bool has_media_info = false;
+  uint64_t position = 0;
+  while (position < static_cast<uint64_t>(file_size)) {
+    uint64_t record_type = 0;
+    uint64_t payload_size = 0;
+    if (!ReadVarint(file_.get(), &record_type, &position) ||
+        !ReadVarint(file_.get(), &payload_size, &position) ||
+        payload_size > file_size - position) {
+      LOG(ERROR) << "Malformed binary MediaInfo record in " << file_name;
+      return false;
+    }
+    RecordLocation location;
+    location.offset = position;
+    location.size = payload_size;
+    switch (record_type) {
+      case kSegmentIndexRecord:
+        segment_index_records_.push_back(location);
+        break;
+      case kMediaInfoRecord:
+        media_info_record_ = location;
+        has_media_info = true;
+        break;
+      default:
+        // Unknown records are skipped for forward compatibility.
+        break;
+    }
+    position += payload_size;
+    if (!file_->Seek(position)) {
+      LOG(ERROR) << "Failed to seek in " << file_name;
+      return false;
+    }
+  }
+
+  if (!has_media_info) {
+    LOG(ERROR) << "No MediaInfo in " << file_name;
+    return false;
+  }
+  return true;
+}
+
+bool BinaryMediaInfoReader::ReadMediaInfo(MediaInfo* media_info) {
+  DCHECK(media_info);
+  std::string payload;
+  return ReadPayload(media_info_record_, &payload) &&
+         media_info->ParseFromString(payload);
+}
+
+bool BinaryMediaInfoReader::ReadSegments(std::vector<Segment>* segments) {
+  DCHECK(segments);
+  segments->clear();
+  int64_t previous_segment_end = 0;
+  std::string payload;
+  for (const RecordLocation& location : segment_index_records_) {
+    if (!ReadPayload(location, &payload))
+      return false;
+    CodedInputStream input(reinterpret_cast<const uint8_t*>(payload.data()),
+                           static_cast<int>(payload.size()));
+    while (static_cast<size_t>(input.CurrentPosition()) < payload.size()) {
+      uint64_t start_delta = 0;
+      uint64_t duration = 0;
+      Segment segment;
+      if (!input.ReadVarint64(&start_delta) ||
+          !input.ReadVarint64(&duration) ||
+          !input.ReadVarint64(&segment.size)) {
+        LOG(ERROR) << "Malformed segment index record.";
+        return false;
+      }
+      segment.start_time =
+          previous_segment_end + WireFormatLite::ZigZagDecode64(start_delta);
+      segment.duration = static_cast<int64_t>(duration);
+      previous_segment_end = segment.start_time + segment.duration;
+      segments->push_back(segment);
+    }
+  }
+  return true;
+}
+
+bool BinaryMediaInfoReader::ReadPayload(const RecordLocation& location,
+                                        std::string* payload) {
+  DCHECK(file_) << "BinaryMediaInfoReader is not opened.";
+  payload->resize(location.size);
+  if (!file_->Seek(location.offset))
+    return false;
+  uint64_t bytes_read = 0;
+  while (bytes_read < location.size) {
+    const int64_t result =
+        file_->Read(&(*payload)[bytes_read], location.size - bytes_read);
+    if (result <= 0) {
+      LOG(ERROR) << "Failed to read binary MediaInfo record.";
+      return false;
+    }
+    bytes_read += result;
+  }
+  return true;
+}
+
+}  // namespace shaka
@@ -0,0 +1,120 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Compact binary MediaInfo dump. A dump is a sequence of length-delimited
+// records:
+//   record := varint(record type) varint(payload size) payload
+// There are two record types:
+//   - Segment index: segments completed since the previous segment index
+//     record. Each segment is stored as three varints: the zigzag-encoded
+//     difference between its start time and the end of the previous segment
+//     (0 for contiguous segments), its duration and its size in bytes.
+//   - MediaInfo: MediaInfo in protobuf binary wire format. It is the last
+//     record in a complete dump.
+// Segment index records are appended as segments complete, so the segment
+// index never has to be serialized, or held in memory, at once.
+
+#ifndef MPD_BASE_BINARY_MEDIA_INFO_H_
+#define MPD_BASE_BINARY_MEDIA_INFO_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "packager/file/file_closer.h"
+
+namespace shaka {
+
+class MediaInfo;
+
+/// Suffix of binary MediaInfo dump files.
+extern const char kBinaryMediaInfoSuffix[];
+
+/// Writes a binary MediaInfo dump, streaming the segment index.
+class BinaryMediaInfoWriter {
+ public:
+  BinaryMediaInfoWriter();
+  ~BinaryMediaInfoWriter();
+
+  /// Opens @a file_name for writing. Existing content is overwritten.
+  /// @return true on success, false otherwise.
+  bool Open(const std::string& file_name);
+
+  /// Adds a completed segment to the segment index. The segments are written
+  /// out in batches.
+  /// @return true on success, false otherwise.
+  bool AddSegment(int64_t start_time, int64_t duration, uint64_t size);
+
+  /// Writes the pending segments and @a media_info, then closes the file.
+  /// @return true on success, false otherwise.
+  bool Finalize(const MediaInfo& media_info);
+
+ private:
+  BinaryMediaInfoWriter(const BinaryMediaInfoWriter&) = delete;
+  BinaryMediaInfoWriter& operator=(const BinaryMediaInfoWriter&) = delete;
+
+  bool FlushSegments();
+  bool WriteRecord(int record_type, const std::string& payload);
+
+  std::unique_ptr<File, FileCloser> file_;
+  // Encoded segments not written out yet.
+  std::string pending_segments_;
+  size_t num_pending_segments_ = 0;
+  // End time of the previous segment.
+  int64_t previous_segment_end_ = 0;
+};
+
+/// Reads a binary MediaInfo dump. Opening reads the record headers and seeks
+/// past the payloads; a payload is only read from the file when it is
+/// decoded, so the segment index is not read when only the MediaInfo is
+/// needed.
+class BinaryMediaInfoReader {
+ public:
+  struct Segment {
+    int64_t start_time = 0;
+    int64_t duration = 0;
+    uint64_t size = 0;
+  };
+
+  BinaryMediaInfoReader();
+  ~BinaryMediaInfoReader();
+
+  /// Opens @a file_name and locates its records. The file is kept open until
+  /// the reader is destroyed.
+  /// @return true on success, false if the file cannot be read or is not a
+  ///         complete dump.
+  bool Open(const std::string& file_name);
+
+  /// Reads and decodes the MediaInfo record into @a media_info.
+  /// @return true on success, false otherwise.
+  bool ReadMediaInfo(MediaInfo* media_info);
+
+  /// Reads and decodes the segment index into @a segments. The whole segment
+  /// index is held in @a segments. MpdWriter does not read the segment index.
+  /// @return true on success, false otherwise.
+  bool ReadSegments(std::vector<Segment>* segments);
+
+ private:
+  BinaryMediaInfoReader(const BinaryMediaInfoReader&) = delete;
+  BinaryMediaInfoReader& operator=(const BinaryMediaInfoReader&) = delete;
+
+  struct RecordLocation {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+  };
+
+  bool ReadPayload(const RecordLocation& location, std::string* payload);
+
+  std::unique_ptr<File, FileCloser> file_;
+  RecordLocation media_info_record_;
+  std::vector<RecordLocation> segment_index_records_;
+};
+
+}  // namespace shaka
+
+#endif  // MPD_BASE_BINARY_MEDIA_INFO_H_
@@ -0,0 +1,122 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/mpd/base/binary_media_info.h"
+
+#include <gtest/gtest.h>
+
+#include "packager/base/files/file_path.h"
+#include "packager/base/files/file_util.h"
+#include "packager/file/file.h"
+#include "packager/mpd/base/media_info.pb.h"
+
+namespace shaka {
+
+class BinaryMediaInfoTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    base::FilePath temp_file_path;
+    ASSERT_TRUE(base::CreateTemporaryFile(&temp_file_path));
+    file_name_ = temp_file_path.AsUTF8Unsafe();
+  }
+
+  void TearDown() override { File::Delete(file_name_.c_str()); }
+
+  std::string file_name_;
+};
+
+TEST_F(BinaryMediaInfoTest, RoundTrip) {
+  MediaInfo media_info;
+  media_info.set_media_file_name("test.mp4");
+  media_info.set_bandwidth(1000000);
+
+  BinaryMediaInfoWriter writer;
+  ASSERT_TRUE(writer.Open(file_name_));
+  // Enough segments to span several segment index records, with a gap and an
+  // overlap.
+  const int kNumSegments = 300;
+  int64_t start_time = 0;
+  for (int i = 0; i < kNumSegments; ++i) {
+    if (i == 100)
+      start_time += 50;
+    if (i == 200)
+      start_time -= 20;
+    ASSERT_TRUE(writer.AddSegment(start_time, 900 + i % 3, 1000 + i));
+    start_time += 900 + i % 3;
+  }
+  ASSERT_TRUE(writer.Finalize(media_info));
+
+  BinaryMediaInfoReader reader;
+  ASSERT_TRUE(reader.Open(file_name_));
+  MediaInfo read_media_info;
+  ASSERT_TRUE(reader.ReadMediaInfo(&read_media_info));
+  EXPECT_EQ(media_info.SerializeAsString(),
+            read_media_info.SerializeAsString());
+
+  std::vector<BinaryMediaInfoReader::Segment> segments;
+  ASSERT_TRUE(reader.ReadSegments(&segments));
+  ASSERT_EQ(static_cast<size_t>(kNumSegments), segments.size());
+  start_time = 0;
+  for (int i = 0; i < kNumSegments; ++i) {
+    if (i == 100)
+      start_time += 50;
+    if (i == 200)
+      start_time -= 20;
+    EXPECT_EQ(start_time, segments[i].start_time);
+    EXPECT_EQ(900 + i % 3, segments[i].duration);
+    EXPECT_EQ(static_cast<uint64_t>(1000 + i), segments[i].size);
+    start_time += 900 + i % 3;
+  }
+}
+
+TEST_F(BinaryMediaInfoTest, NoSegments) {
+  MediaInfo media_info;
+  media_info.set_media_file_name("test.mp4");
+
+  BinaryMediaInfoWriter writer;
+  ASSERT_TRUE(writer.Open(file_name_));
+  ASSERT_TRUE(writer.Finalize(media_info));
+
+  BinaryMediaInfoReader reader;
+  ASSERT_TRUE(reader.Open(file_name_));
+  MediaInfo read_media_info;
+  ASSERT_TRUE(reader.ReadMediaInfo(&read_media_info));
+  EXPECT_EQ("test.mp4", read_media_info.media_file_name());
+  std::vector<BinaryMediaInfoReader::Segment> segments;
+  ASSERT_TRUE(reader.ReadSegments(&segments));
+  EXPECT_TRUE(segments.empty());
+}
+
+// A dump without MediaInfo, e.g. from an interrupted run, is rejected.
+TEST_F(BinaryMediaInfoTest, IncompleteDump) {
+  {
+    BinaryMediaInfoWriter writer;
+    ASSERT_TRUE(writer.Open(file_name_));
+    for (int i = 0; i < 200; ++i)
+      ASSERT_TRUE(writer.AddSegment(i * 1000, 1000, 100));
+  }
+
+  BinaryMediaInfoReader reader;
+  EXPECT_FALSE(reader.Open(file_name_));
+}
+
+TEST_F(BinaryMediaInfoTest, TruncatedDump) {
+  MediaInfo media_info;
+  media_info.set_media_file_name("test.mp4");
+  BinaryMediaInfoWriter writer;
+  ASSERT_TRUE(writer.Open(file_name_));
+  ASSERT_TRUE(writer.Finalize(media_info));
+
+  std::string content;
+  ASSERT_TRUE(File::ReadFileToString(file_name_.c_str(), &content));
+  content.resize(content.size() - 1);
+  ASSERT_TRUE(File::WriteStringToFile(file_name_.c_str(), content));
+
+  BinaryMediaInfoReader reader;
+  EXPECT_FALSE(reader.Open(file_name_));
+}
+
+}  // namespace shaka
@@ -154,6 +154,13 @@ Period* MpdBuilder::GetOrCreatePeriod(double start_time_in_seconds) {
   return periods_.back().get();
 }
 
+const std::list<Period*> MpdBuilder::GetPeriods() const {
+  std::list<Period*> periods;
+  for (const auto& period : periods_)
+    periods.push_back(period.get());
+  return periods;
+}
+
 bool MpdBuilder::ToString(std::string* output) {
   DCHECK(output);
   static LibXmlInitializer lib_xml_initializer;
@@ -53,6 +53,21 @@ class MpdBuilder {
   ///         return a new Period.
   virtual Period* GetOrCreatePeriod(double start_time_in_seconds);
 
+  /// @return The Periods in the MPD.
+  const std::list<Period*> GetPeriods() const;
+
+  /// @return availabilityStartTime of a dynamic MPD. It is empty until the
+  ///         MPD is generated for the first time.
+  const std::string& availability_start_time() const {
+    return availability_start_time_;
+  }
+
+  /// Sets availabilityStartTime of a dynamic MPD, e.g. to the one before the
+  /// packager restarted, so that the segment availability does not change.
+  void set_availability_start_time(const std::string& availability_start_time) {
+    availability_start_time_ = availability_start_time;
+  }
+
   /// Writes the MPD to the given string.
   /// @param[out] output is an output string where the MPD gets written.
   /// @return true on success, false otherwise.
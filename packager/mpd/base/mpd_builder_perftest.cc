@@ -0,0 +1,95 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures MpdBuilder::ToString for a large live-profile MPD, i.e. one with
+// many Representations each holding a long SegmentTimeline.
+
+#include <gtest/gtest.h>
+
+#include "packager/base/strings/string_number_conversions.h"
+#include "packager/base/time/time.h"
+#include "packager/mpd/base/adaptation_set.h"
+#include "packager/mpd/base/mpd_builder.h"
+#include "packager/mpd/base/period.h"
+#include "packager/mpd/base/representation.h"
+#include "packager/testing/perf/perf_test.h"
+#include "packager/version/version.h"
+
+namespace shaka {
+
+namespace {
+
+const int kNumIterations = 10;
+const int kNumRepresentations = 8;
+// Two hours of 2 second segments.
+const int kNumSegments = 3600;
+const uint32_t kTimeScale = 90000;
+
+MediaInfo CreateVideoMediaInfo(int index) {
+  MediaInfo media_info;
+  MediaInfo::VideoInfo* video_info = media_info.mutable_video_info();
+  video_info->set_codec("avc1.64001f");
+  video_info->set_time_scale(kTimeScale);
+  video_info->set_frame_duration(3000);
+  video_info->set_width(1280);
+  video_info->set_height(720);
+  video_info->set_pixel_width(1);
+  video_info->set_pixel_height(1);
+  media_info.set_bandwidth(1000000 * (index + 1));
+  media_info.set_reference_time_scale(kTimeScale);
+  media_info.set_container_type(MediaInfo::CONTAINER_MP4);
+  media_info.set_init_segment_url("init-" + base::IntToString(index) + ".mp4");
+  media_info.set_segment_template_url("seg-" + base::IntToString(index) +
+                                      "-$Number$.mp4");
+  return media_info;
+}
+
+}  // namespace
+
+TEST(MpdBuilderPerfTest, ToString) {
+  SetPackagerVersionForTesting("perftest");
+
+  MpdOptions mpd_options;
+  mpd_options.dash_profile = DashProfile::kLive;
+  MpdBuilder mpd_builder(mpd_options);
+  const double kPeriodStartTimeSeconds = 0.0;
+  Period* period = mpd_builder.GetOrCreatePeriod(kPeriodStartTimeSeconds);
+  ASSERT_TRUE(period);
+
+  for (int i = 0; i < kNumRepresentations; ++i) {
+    const MediaInfo media_info = CreateVideoMediaInfo(i);
+    const bool kContentProtectionInAdaptationSet = true;
+    AdaptationSet* adaptation_set = period->GetOrCreateAdaptationSet(
+        media_info, kContentProtectionInAdaptationSet);
+    ASSERT_TRUE(adaptation_set);
+    Representation* representation =
+        adaptation_set->AddRepresentation(media_info);
+    ASSERT_TRUE(representation);
+
+    // Alternate segment durations so SegmentTimeline entries do not collapse
+    // into a single repeated S element.
+    int64_t start_time = 0;
+    for (int j = 0; j < kNumSegments; ++j) {
+      const int64_t duration = kTimeScale * 2 + (j % 2 ? 3000 : -3000);
+      representation->AddNewSegment(start_time, duration,
+                                    250000 + j % 100 * 100);
+      start_time += duration;
+    }
+  }
+
+  std::string mpd;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i)
+    ASSERT_TRUE(mpd_builder.ToString(&mpd));
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  perf_test::PrintResult("mpd_to_string", "", "8_reps_3600_segments",
+                         elapsed.InMillisecondsF() / kNumIterations, "ms",
+                         true);
+  perf_test::PrintResult("mpd_size", "", "8_reps_3600_segments",
+                         static_cast<double>(mpd.size()), "bytes", false);
+}
+
+}  // namespace shaka
@@ -11,17 +11,36 @@
 #define MPD_BASE_MPD_NOTIFIER_H_
 
 #include <stdint.h>
+#include <list>
 #include <string>
 #include <vector>
 
 #include "packager/base/macros.h"
 #include "packager/mpd/base/mpd_options.h"
+#include "packager/mpd/base/segment_info.h"
 
 namespace shaka {
 
 class MediaInfo;
 struct ContentProtectionElement;
 
+/// State of a live MPD which is saved in checkpoints, so that the MPD can be
+/// resumed after the packager restarts.
+struct MpdState {
+  /// State of a Representation in a Period.
+  struct RepresentationState {
+    /// Identifies the Representation across restarts. It is the segment
+    /// template of the Representation.
+    std::string key;
+    double period_start_time_seconds = 0;
+    uint32_t start_number = 1;
+    std::list<SegmentInfo> segment_infos;
+  };
+
+  std::string availability_start_time;
+  std::vector<RepresentationState> representations;
+};
+
 /// Interface for publish/subscribe publisher class which notifies MpdBuilder
 /// of media-related events.
 class MpdNotifier {
@@ -99,6 +118,26 @@ class MpdNotifier {
   virtual bool NotifyMediaInfoUpdate(uint32_t container_id,
                                      const MediaInfo& media_info) = 0;
 
+  /// Notifies MpdBuilder that the container is removed, e.g. when a rendition
+  /// is dropped while packaging live content. The container is removed from
+  /// the last Period; earlier Periods still reference it.
+  /// @param container_id Container ID obtained from calling
+  ///        NotifyNewContainer(). It cannot be used after this call.
+  /// @return true on success, false otherwise.
+  virtual bool NotifyContainerRemoved(uint32_t container_id) = 0;
+
+  /// Saves the state of the live Representations to a checkpoint, so that
+  /// live packaging can resume after a restart. No-op by default.
+  /// @param state[out] gets the state of the MPD.
+  virtual void SaveState(MpdState* state) {}
+
+  /// Restores the MPD state saved by SaveState(). A Representation, including
+  /// its copies in the later Periods, is restored when its container is added
+  /// by NotifyNewContainer(), so this should be called before adding any
+  /// container. No-op by default.
+  /// @param state is the state of the MPD.
+  virtual void RestoreState(const MpdState& state) {}
+
   /// Call this method to force a flush. Implementations might not write out
   /// the MPD to a stream (file, stdout, etc.) when the MPD is updated, this
   /// forces a flush.
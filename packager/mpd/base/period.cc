@@ -123,6 +123,11 @@ xml::scoped_xml_ptr<xmlNode> Period::GetXml(bool output_period_duration) {
   period.SetId(id_);
   // Iterate thru AdaptationSets and add them to one big Period element.
   for (const auto& adaptation_set : adaptation_sets_) {
+    // An AdaptationSet without Representations is invalid.
+    if (adaptation_set->has_removed_representations_ &&
+        adaptation_set->representation_map_.empty()) {
+      continue;
+    }
     xml::scoped_xml_ptr<xmlNode> child(adaptation_set->GetXml());
     if (!child || !period.AddChild(std::move(child)))
       return nullptr;
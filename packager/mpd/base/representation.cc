@@ -114,6 +114,8 @@ Representation::Representation(
     uint32_t id,
     std::unique_ptr<RepresentationStateChangeListener> state_change_listener)
     : media_info_(media_info),
+      segment_infos_memory_tracker_("Representation",
+                                    "representation " + std::to_string(id)),
       id_(id),
       bandwidth_estimator_(mpd_options.mpd_params.target_segment_duration),
       mpd_options_(mpd_options),
@@ -213,6 +215,17 @@ void Representation::AddNewSegment(int64_t start_time,
 
   SlideWindow();
   DCHECK_GE(segment_infos_.size(), 1u);
+  segment_infos_memory_tracker_.Set(segment_infos_.size() *
+                                    sizeof(segment_infos_.front()));
+}
+
+void Representation::RestoreSegmentInfos(
+    uint32_t start_number,
+    const std::list<SegmentInfo>& segment_infos) {
+  start_number_ = start_number;
+  segment_infos_ = segment_infos;
+  segment_infos_memory_tracker_.Set(segment_infos_.size() *
+                                    sizeof(SegmentInfo));
 }
 
 void Representation::SetSampleDuration(uint32_t frame_duration) {
@@ -9,6 +9,7 @@
 #ifndef PACKAGER_MPD_BASE_REPRESENTATION_H_
 #define PACKAGER_MPD_BASE_REPRESENTATION_H_
 
+#include "packager/memory_tracker.h"
 #include "packager/mpd/base/bandwidth_estimator.h"
 #include "packager/mpd/base/media_info.pb.h"
 #include "packager/mpd/base/segment_info.h"
@@ -145,6 +146,22 @@ class Representation {
   /// @return ID number for <Representation>.
   uint32_t id() const { return id_; }
 
+  /// @return startNumber attribute of the SegmentTemplate.
+  uint32_t start_number() const { return start_number_; }
+
+  /// @return The segments in the SegmentTimeline.
+  const std::list<SegmentInfo>& segment_infos() const {
+    return segment_infos_;
+  }
+
+  /// Restores the SegmentTimeline of a live Representation, e.g. the one
+  /// before the packager restarted. New segments are added after the
+  /// restored ones.
+  /// @param start_number is the startNumber of the restored timeline.
+  /// @param segment_infos are the segments of the restored timeline.
+  void RestoreSegmentInfos(uint32_t start_number,
+                           const std::list<SegmentInfo>& segment_infos);
+
   void set_media_info(const MediaInfo& media_info) { media_info_ = media_info; }
 
  protected:
@@ -214,6 +231,8 @@ class Representation {
   std::list<ContentProtectionElement> content_protection_elements_;
   // TODO(kqyang): Address sliding window issue with multiple periods.
   std::list<SegmentInfo> segment_infos_;
+  // Tracks the memory of |segment_infos_|.
+  MemoryTracker segment_infos_memory_tracker_;
   // A list to hold the file names of the segments to be removed temporarily.
   // Once a file is actually removed, it is removed from the list.
   std::list<std::string> segments_to_be_removed_;
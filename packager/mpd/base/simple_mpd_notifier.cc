@@ -14,9 +14,15 @@
 #include "packager/mpd/base/mpd_utils.h"
 #include "packager/mpd/base/period.h"
 #include "packager/mpd/base/representation.h"
+#include "packager/trace_event.h"
 
 namespace shaka {
 
+namespace {
+// The containers are added to the first Period.
+const double kPeriodStartTimeSeconds = 0.0;
+}  // namespace
+
 SimpleMpdNotifier::SimpleMpdNotifier(const MpdOptions& mpd_options)
     : MpdNotifier(mpd_options),
       output_path_(mpd_options.mpd_params.mpd_output),
@@ -45,7 +51,6 @@ bool SimpleMpdNotifier::NotifyNewContainer(const MediaInfo& media_info,
   MpdBuilder::MakePathsRelativeToMpd(output_path_, &adjusted_media_info);
 
   base::AutoLock auto_lock(lock_);
-  const double kPeriodStartTimeSeconds = 0.0;
   Period* period = mpd_builder_->GetOrCreatePeriod(kPeriodStartTimeSeconds);
   DCHECK(period);
   AdaptationSet* adaptation_set = period->GetOrCreateAdaptationSet(
@@ -59,16 +64,16 @@ bool SimpleMpdNotifier::NotifyNewContainer(const MediaInfo& media_info,
     return false;
 
   *container_id = representation->id();
-  if (content_protection_in_adaptation_set_) {
-    // ContentProtection elements are already added to AdaptationSet above.
-    // Use RepresentationId to AdaptationSet map to update ContentProtection
-    // in AdaptationSet in NotifyEncryptionUpdate.
-    representation_id_to_adaptation_set_[representation->id()] = adaptation_set;
-  } else {
+  // ContentProtection elements are already added to AdaptationSet above if
+  // |content_protection_in_adaptation_set_|. Use RepresentationId to
+  // AdaptationSet map to update ContentProtection in AdaptationSet in
+  // NotifyEncryptionUpdate, and to remove the Representation in
+  // NotifyContainerRemoved.
+  representation_id_to_adaptation_set_[representation->id()] = adaptation_set;
+  if (!content_protection_in_adaptation_set_)
     AddContentProtectionElements(media_info, representation);
-  }
   representation_map_[representation->id()] = representation;
-  return true;
+  return RestoreRepresentation(representation);
 }
 
 bool SimpleMpdNotifier::NotifySampleDuration(uint32_t container_id,
@@ -105,13 +110,20 @@ bool SimpleMpdNotifier::NotifyCueEvent(uint32_t container_id,
     LOG(ERROR) << "Unexpected container_id: " << container_id;
     return false;
   }
-  Representation* original_representation = it->second;
+  const MediaInfo& media_info = it->second->GetMediaInfo();
+  const double period_start_time_seconds =
+      static_cast<double>(timestamp) / media_info.reference_time_scale();
+  return CopyRepresentationToPeriod(container_id, period_start_time_seconds) !=
+         nullptr;
+}
+
+Representation* SimpleMpdNotifier::CopyRepresentationToPeriod(
+    uint32_t container_id,
+    double period_start_time_seconds) {
+  Representation* original_representation = representation_map_[container_id];
   AdaptationSet* original_adaptation_set =
       representation_id_to_adaptation_set_[container_id];
-
   const MediaInfo& media_info = original_representation->GetMediaInfo();
-  const double period_start_time_seconds =
-      static_cast<double>(timestamp) / media_info.reference_time_scale();
 
   Period* period = mpd_builder_->GetOrCreatePeriod(period_start_time_seconds);
   DCHECK(period);
@@ -127,18 +139,18 @@ bool SimpleMpdNotifier::NotifyCueEvent(uint32_t container_id,
   Representation* representation =
       adaptation_set->CopyRepresentation(*original_representation);
   if (!representation)
-    return false;
+    return nullptr;
 
-  if (content_protection_in_adaptation_set_) {
-    // ContentProtection elements are already added to AdaptationSet above.
-    // Use RepresentationId to AdaptationSet map to update ContentProtection
-    // in AdaptationSet in NotifyEncryptionUpdate.
-    representation_id_to_adaptation_set_[representation->id()] = adaptation_set;
-  } else {
+  // ContentProtection elements are already added to AdaptationSet above if
+  // |content_protection_in_adaptation_set_|. Use RepresentationId to
+  // AdaptationSet map to update ContentProtection in AdaptationSet in
+  // NotifyEncryptionUpdate, and to remove the Representation in
+  // NotifyContainerRemoved.
+  representation_id_to_adaptation_set_[representation->id()] = adaptation_set;
+  if (!content_protection_in_adaptation_set_)
     AddContentProtectionElements(media_info, representation);
-  }
   representation_map_[representation->id()] = representation;
-  return true;
+  return representation;
 }
 
 bool SimpleMpdNotifier::NotifyEncryptionUpdate(
@@ -181,7 +193,95 @@ bool SimpleMpdNotifier::NotifyMediaInfoUpdate(uint32_t container_id,
   return true;
 }
 
+bool SimpleMpdNotifier::NotifyContainerRemoved(uint32_t container_id) {
+  base::AutoLock auto_lock(lock_);
+  auto it = representation_map_.find(container_id);
+  if (it == representation_map_.end()) {
+    LOG(ERROR) << "Unexpected container_id: " << container_id;
+    return false;
+  }
+  // |representation_map_| points to the Representations in the last Period,
+  // see NotifyCueEvent().
+  auto adaptation_set_it =
+      representation_id_to_adaptation_set_.find(container_id);
+  if (adaptation_set_it == representation_id_to_adaptation_set_.end() ||
+      !adaptation_set_it->second->RemoveRepresentation(container_id)) {
+    LOG(ERROR) << "Failed to remove Representation " << container_id;
+    return false;
+  }
+  representation_map_.erase(it);
+  representation_id_to_adaptation_set_.erase(adaptation_set_it);
+  return true;
+}
+
+void SimpleMpdNotifier::SaveState(MpdState* state) {
+  DCHECK(state);
+  base::AutoLock auto_lock(lock_);
+  state->availability_start_time = mpd_builder_->availability_start_time();
+  // Keep the state of the containers which are not added yet, e.g. if their
+  // input is late after a restart.
+  state->representations = representation_states_to_restore_;
+  for (const Period* period : mpd_builder_->GetPeriods()) {
+    for (const AdaptationSet* adaptation_set : period->GetAdaptationSets()) {
+      for (const Representation* representation :
+           adaptation_set->GetRepresentations()) {
+        const MediaInfo& media_info = representation->GetMediaInfo();
+        // Only live Representations, which use segment templates, need to
+        // be resumed.
+        if (media_info.segment_template().empty())
+          continue;
+        MpdState::RepresentationState representation_state;
+        representation_state.key = media_info.segment_template();
+        representation_state.period_start_time_seconds =
+            period->start_time_in_seconds();
+        representation_state.start_number = representation->start_number();
+        representation_state.segment_infos = representation->segment_infos();
+        state->representations.push_back(std::move(representation_state));
+      }
+    }
+  }
+}
+
+void SimpleMpdNotifier::RestoreState(const MpdState& state) {
+  base::AutoLock auto_lock(lock_);
+  if (!state.availability_start_time.empty())
+    mpd_builder_->set_availability_start_time(state.availability_start_time);
+  representation_states_to_restore_ = state.representations;
+}
+
+bool SimpleMpdNotifier::RestoreRepresentation(Representation* representation) {
+  const std::string& key = representation->GetMediaInfo().segment_template();
+  if (key.empty())
+    return true;
+
+  // The states are saved in Period order.
+  std::vector<MpdState::RepresentationState> states;
+  auto iter = representation_states_to_restore_.begin();
+  while (iter != representation_states_to_restore_.end()) {
+    if (iter->key == key) {
+      states.push_back(std::move(*iter));
+      iter = representation_states_to_restore_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  for (const MpdState::RepresentationState& state : states) {
+    Representation* restored_representation = representation;
+    if (state.period_start_time_seconds != kPeriodStartTimeSeconds) {
+      restored_representation = CopyRepresentationToPeriod(
+          representation->id(), state.period_start_time_seconds);
+      if (!restored_representation)
+        return false;
+    }
+    restored_representation->RestoreSegmentInfos(state.start_number,
+                                                 state.segment_infos);
+  }
+  return true;
+}
+
 bool SimpleMpdNotifier::Flush() {
+  SHAKA_TRACE_EVENT("notifier", "SimpleMpdNotifier::Flush");
   base::AutoLock auto_lock(lock_);
   return WriteMpdToFile(output_path_, mpd_builder_.get());
 }
@@ -49,6 +49,9 @@ class SimpleMpdNotifier : public MpdNotifier {
                               const std::vector<uint8_t>& new_pssh) override;
   bool NotifyMediaInfoUpdate(uint32_t container_id,
                              const MediaInfo& media_info) override;
+  bool NotifyContainerRemoved(uint32_t container_id) override;
+  void SaveState(MpdState* state) override;
+  void RestoreState(const MpdState& state) override;
   bool Flush() override;
   /// @}
 
@@ -58,6 +61,16 @@ class SimpleMpdNotifier : public MpdNotifier {
 
   friend class SimpleMpdNotifierTest;
 
+  // Copies the Representation of |container_id| to the Period starting at
+  // |period_start_time_seconds|, which then receives the new segments of the
+  // container. |lock_| must be held.
+  Representation* CopyRepresentationToPeriod(uint32_t container_id,
+                                             double period_start_time_seconds);
+
+  // Restores |representation| and its copies in the later Periods if they are
+  // in |representation_states_to_restore_|. |lock_| must be held.
+  bool RestoreRepresentation(Representation* representation);
+
   // Testing only method. Returns a pointer to MpdBuilder.
   MpdBuilder* MpdBuilderForTesting() const { return mpd_builder_.get(); }
 
@@ -75,8 +88,12 @@ class SimpleMpdNotifier : public MpdNotifier {
   uint32_t next_adaptation_set_id_ = 0;
   // Maps Representation ID to Representation.
   std::map<uint32_t, Representation*> representation_map_;
-  // Maps Representation ID to AdaptationSet. This is for updating the PSSH.
+  // Maps Representation ID to AdaptationSet. This is for updating the PSSH and
+  // removing Representations.
   std::map<uint32_t, AdaptationSet*> representation_id_to_adaptation_set_;
+  // Restored state of the Representations whose containers are not added
+  // yet.
+  std::vector<MpdState::RepresentationState> representation_states_to_restore_;
 };
 
 }  // namespace shaka
@@ -165,6 +165,77 @@ TEST_F(SimpleMpdNotifierTest, NotifyNewContainerAndSampleDurationNoMock) {
   EXPECT_TRUE(notifier.Flush());
 }
 
+TEST_F(SimpleMpdNotifierTest, NotifyContainerRemovedNoMock) {
+  SimpleMpdNotifier notifier(empty_mpd_option_);
+  uint32_t container_id1;
+  uint32_t container_id2;
+  EXPECT_TRUE(notifier.NotifyNewContainer(valid_media_info1_, &container_id1));
+  EXPECT_TRUE(notifier.NotifyNewContainer(valid_media_info2_, &container_id2));
+
+  EXPECT_TRUE(notifier.NotifyContainerRemoved(container_id1));
+  // The container cannot be used once removed.
+  EXPECT_FALSE(notifier.NotifyContainerRemoved(container_id1));
+  const uint32_t kAnySampleDuration = 1000;
+  EXPECT_FALSE(
+      notifier.NotifySampleDuration(container_id1, kAnySampleDuration));
+  EXPECT_TRUE(notifier.NotifySampleDuration(container_id2, kAnySampleDuration));
+  EXPECT_TRUE(notifier.Flush());
+}
+
+TEST_F(SimpleMpdNotifierTest, SaveAndRestoreStateNoMock) {
+  MediaInfo live_media_info = valid_media_info1_;
+  live_media_info.set_segment_template("video-$Number$.m4s");
+  const uint64_t kSegmentDuration = 10;
+  const uint64_t kSegmentSize = 1000;
+
+  SimpleMpdNotifier notifier(empty_mpd_option_);
+  uint32_t container_id;
+  EXPECT_TRUE(notifier.NotifyNewContainer(live_media_info, &container_id));
+  EXPECT_TRUE(notifier.NotifyNewSegment(container_id, 0, kSegmentDuration,
+                                        kSegmentSize));
+  EXPECT_TRUE(notifier.NotifyNewSegment(container_id, 10, kSegmentDuration,
+                                        kSegmentSize));
+  // A new Period starting at 2 seconds.
+  EXPECT_TRUE(notifier.NotifyCueEvent(container_id, 20));
+  EXPECT_TRUE(notifier.NotifyNewSegment(container_id, 20, kSegmentDuration,
+                                        kSegmentSize));
+  // Containers without segment templates are not saved.
+  uint32_t vod_container_id;
+  EXPECT_TRUE(
+      notifier.NotifyNewContainer(valid_media_info2_, &vod_container_id));
+
+  MpdState state;
+  notifier.SaveState(&state);
+  ASSERT_EQ(2u, state.representations.size());
+  EXPECT_EQ(0.0, state.representations[0].period_start_time_seconds);
+  EXPECT_EQ(1u, state.representations[0].start_number);
+  ASSERT_EQ(1u, state.representations[0].segment_infos.size());
+  EXPECT_EQ(1u, state.representations[0].segment_infos.front().repeat);
+  EXPECT_EQ(2.0, state.representations[1].period_start_time_seconds);
+  EXPECT_EQ(3u, state.representations[1].start_number);
+
+  // Resume the MPD as if the packager restarted.
+  SimpleMpdNotifier restored_notifier(empty_mpd_option_);
+  restored_notifier.RestoreState(state);
+  EXPECT_TRUE(
+      restored_notifier.NotifyNewContainer(live_media_info, &container_id));
+  // The new segments are added to the last Period.
+  EXPECT_TRUE(restored_notifier.NotifyNewSegment(
+      container_id, 30, kSegmentDuration, kSegmentSize));
+
+  MpdState restored_state;
+  restored_notifier.SaveState(&restored_state);
+  ASSERT_EQ(2u, restored_state.representations.size());
+  EXPECT_EQ(1u, restored_state.representations[0].segment_infos.size());
+  EXPECT_EQ(3u, restored_state.representations[1].start_number);
+  ASSERT_EQ(1u, restored_state.representations[1].segment_infos.size());
+  const SegmentInfo& segment_info =
+      restored_state.representations[1].segment_infos.front();
+  EXPECT_EQ(20, segment_info.start_time);
+  EXPECT_EQ(1u, segment_info.repeat);
+  EXPECT_TRUE(restored_notifier.Flush());
+}
+
 TEST_F(SimpleMpdNotifierTest, NotifyNewSegment) {
   SimpleMpdNotifier notifier(empty_mpd_option_);
 
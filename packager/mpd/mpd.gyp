@@ -23,6 +23,22 @@
       },
       'includes': ['../protoc.gypi'],
     },
+    {
+      'target_name': 'binary_media_info',
+      'type': 'static_library',
+      'sources': [
+        'base/binary_media_info.cc',
+        'base/binary_media_info.h',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../file/file.gyp:file',
+        'media_info_proto',
+      ],
+      'export_dependent_settings': [
+        'media_info_proto',
+      ],
+    },
     {
       # Used by both MPD and HLS. It should really be moved to a common
       # directory shared by MPD and HLS.
@@ -70,6 +86,8 @@
         '../media/base/media_base.gyp:media_base',
         '../third_party/gflags/gflags.gyp:gflags',
         '../third_party/libxml/libxml.gyp:libxml',
+        '../packager.gyp:memory_tracker',
+        '../packager.gyp:trace_event',
         '../version/version.gyp:version',
         'manifest_base',
         'media_info_proto',
@@ -99,6 +117,7 @@
       'sources': [
         'base/adaptation_set_unittest.cc',
         'base/bandwidth_estimator_unittest.cc',
+        'base/binary_media_info_unittest.cc',
         'base/mpd_builder_unittest.cc',
         'base/mpd_utils_unittest.cc',
         'base/period_unittest.cc',
@@ -118,6 +137,7 @@
         '../testing/gmock.gyp:gmock',
         '../testing/gtest.gyp:gtest',
         '../third_party/gflags/gflags.gyp:gflags',
+        'binary_media_info',
         'mpd_builder',
         'mpd_mocks',
         'mpd_util',
@@ -133,9 +153,25 @@
       'dependencies': [
         '../file/file.gyp:file',
         '../third_party/gflags/gflags.gyp:gflags',
+        'binary_media_info',
         'mpd_builder',
         'mpd_mocks',
       ],
     },
+    {
+      'target_name': 'mpd_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'base/mpd_builder_perftest.cc',
+      ],
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../media/test/media_test.gyp:run_tests_with_atexit_manager',
+        '../testing/gtest.gyp:gtest',
+        '../testing/perf/perf_test.gyp:perf_test',
+        '../version/version.gyp:version',
+        'mpd_builder',
+      ],
+    },
   ],
 }
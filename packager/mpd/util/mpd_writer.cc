@@ -12,7 +12,9 @@
 
 #include "packager/base/files/file_path.h"
 #include "packager/base/files/file_util.h"
+#include "packager/base/strings/string_util.h"
 #include "packager/file/file.h"
+#include "packager/mpd/base/binary_media_info.h"
 #include "packager/mpd/base/mpd_builder.h"
 #include "packager/mpd/base/mpd_notifier.h"
 #include "packager/mpd/base/mpd_utils.h"
@@ -38,29 +40,50 @@ class SimpleMpdNotifierFactory : public MpdNotifierFactory {
   }
 };
 
-}  // namespace
-
-MpdWriter::MpdWriter() : notifier_factory_(new SimpleMpdNotifierFactory()) {}
-MpdWriter::~MpdWriter() {}
-
-bool MpdWriter::AddFile(const std::string& media_info_path) {
+bool ReadTextMediaInfo(const std::string& media_info_path,
+                       MediaInfo* media_info) {
   std::string file_content;
   if (!File::ReadFileToString(media_info_path.c_str(), &file_content)) {
     LOG(ERROR) << "Failed to read " << media_info_path << " to string.";
     return false;
   }
+  return ::google::protobuf::TextFormat::ParseFromString(file_content,
+                                                         media_info);
+}
+
+// Only the MediaInfo record is read; the segment index records are skipped as
+// they are not needed to generate the MPD.
+bool ReadBinaryMediaInfo(const std::string& media_info_path,
+                         MediaInfo* media_info) {
+  BinaryMediaInfoReader reader;
+  return reader.Open(media_info_path) && reader.ReadMediaInfo(media_info);
+}
 
-  MediaInfo media_info;
-  if (!::google::protobuf::TextFormat::ParseFromString(file_content,
-                                                       &media_info)) {
-    LOG(ERROR) << "Failed to parse " << file_content << " to MediaInfo.";
+}  // namespace
+
+MpdWriter::MpdWriter() : notifier_factory_(new SimpleMpdNotifierFactory()) {}
+MpdWriter::~MpdWriter() {}
+
+bool MpdWriter::AddFile(const std::string& media_info_path) {
+  // Reuses a cleared MediaInfo if there is one.
+  MediaInfo* media_info = media_infos_.Add();
+  const bool parsed =
+      base::EndsWith(media_info_path, kBinaryMediaInfoSuffix,
+                     base::CompareCase::SENSITIVE)
+          ? ReadBinaryMediaInfo(media_info_path, media_info)
+          : ReadTextMediaInfo(media_info_path, media_info);
+  if (!parsed) {
+    LOG(ERROR) << "Failed to parse " << media_info_path << " to MediaInfo.";
+    media_infos_.RemoveLast();
     return false;
   }
-
-  media_infos_.push_back(media_info);
   return true;
 }
 
+void MpdWriter::ClearFiles() {
+  media_infos_.Clear();
+}
+
 void MpdWriter::AddBaseUrl(const std::string& base_url) {
   base_urls_.push_back(base_url);
 }
@@ -9,12 +9,14 @@
 #ifndef MPD_UTIL_MPD_WRITER_H_
 #define MPD_UTIL_MPD_WRITER_H_
 
-#include <list>
+#include <google/protobuf/repeated_field.h>
+
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "packager/base/macros.h"
+#include "packager/mpd/base/media_info.pb.h"
 #include "packager/mpd/base/mpd_notifier.h"
 #include "packager/mpd/base/mpd_options.h"
 
@@ -24,8 +26,6 @@ namespace media {
 class File;
 }  // namespace media
 
-class MediaInfo;
-
 /// This is mainly for testing, and is implementation detail. No need to worry
 /// about this class if you are just using the API.
 /// Inject a factory and mock MpdNotifier to test the MpdWriter implementation.
@@ -53,10 +53,18 @@ class MpdWriter {
   // Add |media_info_path| for MPD generation.
   // The content of |media_info_path| should be a string representation of
   // MediaInfo, i.e. the content should be a result of using
-  // google::protobuf::TestFormat::Print*() methods.
+  // google::protobuf::TestFormat::Print*() methods. If |media_info_path| ends
+  // with kBinaryMediaInfoSuffix, the content should be MediaInfo in protobuf
+  // binary wire format instead, which is faster to parse.
   // If necessary, this method can be called after WriteMpd*() methods.
   bool AddFile(const std::string& media_info_path);
 
+  // Removes all the MediaInfo added with AddFile(). The MediaInfo messages are
+  // kept around and reused by subsequent AddFile() calls, so a single
+  // MpdWriter can generate MPDs for many titles without reallocating them.
+  // BaseURLs are kept.
+  void ClearFiles();
+
   // |base_url| will be used for <BaseURL> element for the MPD. The BaseURL
   // element will be a direct child element of the <MPD> element.
   void AddBaseUrl(const std::string& base_url);
@@ -76,7 +84,7 @@ class MpdWriter {
   void SetMpdNotifierFactoryForTest(
       std::unique_ptr<MpdNotifierFactory> factory);
 
-  std::list<MediaInfo> media_infos_;
+  ::google::protobuf::RepeatedPtrField<MediaInfo> media_infos_;
   std::vector<std::string> base_urls_;
 
   std::unique_ptr<MpdNotifierFactory> notifier_factory_;
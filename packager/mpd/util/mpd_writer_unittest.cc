@@ -5,10 +5,13 @@
 // https://developers.google.com/open-source/licenses/bsd
 
 #include <gmock/gmock.h>
+#include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 
 #include "packager/base/files/file_util.h"
 #include "packager/base/path_service.h"
+#include "packager/file/file.h"
+#include "packager/mpd/base/binary_media_info.h"
 #include "packager/mpd/base/mock_mpd_notifier.h"
 #include "packager/mpd/base/mpd_options.h"
 #include "packager/mpd/test/mpd_builder_test_helper.h"
@@ -98,4 +101,54 @@ TEST_F(MpdWriterTest, WriteMpdToFile) {
   EXPECT_TRUE(mpd_writer_.WriteMpdToFile(mpd_file_path.AsUTF8Unsafe().c_str()));
 }
 
+// Verify that binary MediaInfo dumps can be mixed with MediaInfo in text
+// format.
+TEST_F(MpdWriterTest, WriteMpdToFileWithBinaryMediaInfo) {
+  std::string media_info_text;
+  ASSERT_TRUE(File::ReadFileToString(
+      GetTestDataFilePath(kFileNameVideoMediaInfo1).AsUTF8Unsafe().c_str(),
+      &media_info_text));
+  MediaInfo media_info;
+  ASSERT_TRUE(::google::protobuf::TextFormat::ParseFromString(media_info_text,
+                                                              &media_info));
+
+  base::FilePath temp_file_path;
+  ASSERT_TRUE(base::CreateTemporaryFile(&temp_file_path));
+  const std::string binary_media_info_file =
+      temp_file_path.AsUTF8Unsafe() + kBinaryMediaInfoSuffix;
+  BinaryMediaInfoWriter writer;
+  ASSERT_TRUE(writer.Open(binary_media_info_file));
+  ASSERT_TRUE(writer.AddSegment(0, 90000, 1000));
+  ASSERT_TRUE(writer.Finalize(media_info));
+
+  SetMpdNotifierFactoryForTest();
+  EXPECT_TRUE(mpd_writer_.AddFile(binary_media_info_file));
+  EXPECT_TRUE(mpd_writer_.AddFile(
+      GetTestDataFilePath(kFileNameVideoMediaInfo2).AsUTF8Unsafe()));
+
+  base::FilePath mpd_file_path;
+  ASSERT_TRUE(base::CreateTemporaryFile(&mpd_file_path));
+  EXPECT_TRUE(mpd_writer_.WriteMpdToFile(mpd_file_path.AsUTF8Unsafe().c_str()));
+  File::Delete(binary_media_info_file.c_str());
+}
+
+// Verify that files added before ClearFiles() are not in the MPD.
+TEST_F(MpdWriterTest, ClearFiles) {
+  base::FilePath media_info_file1 =
+      GetTestDataFilePath(kFileNameVideoMediaInfo1);
+  base::FilePath media_info_file2 =
+      GetTestDataFilePath(kFileNameVideoMediaInfo2);
+
+  SetMpdNotifierFactoryForTest();
+  EXPECT_TRUE(mpd_writer_.AddFile(media_info_file1.AsUTF8Unsafe()));
+  mpd_writer_.ClearFiles();
+  // The notifier expects exactly two MediaInfo.
+  EXPECT_TRUE(mpd_writer_.AddFile(media_info_file1.AsUTF8Unsafe()));
+  EXPECT_TRUE(mpd_writer_.AddFile(media_info_file2.AsUTF8Unsafe()));
+
+  base::FilePath mpd_file_path;
+  ASSERT_TRUE(base::CreateTemporaryFile(&mpd_file_path));
+  EXPECT_TRUE(mpd_writer_.WriteMpdToFile(mpd_file_path.AsUTF8Unsafe().c_str()));
+}
+
 }  // namespace shaka
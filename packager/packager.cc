@@ -7,12 +7,14 @@
 #include "packager/packager.h"
 
 #include <algorithm>
+#include <functional>
 
 #include "packager/app/job_manager.h"
 #include "packager/app/libcrypto_threading.h"
 #include "packager/app/muxer_factory.h"
 #include "packager/app/packager_util.h"
 #include "packager/app/stream_descriptor.h"
+#include "packager/app/vod_chunk_planner.h"
 #include "packager/base/at_exit.h"
 #include "packager/base/files/file_path.h"
 #include "packager/base/logging.h"
@@ -20,8 +22,13 @@
 #include "packager/base/path_service.h"
 #include "packager/base/strings/string_util.h"
 #include "packager/base/strings/stringprintf.h"
+#include "packager/base/synchronization/lock.h"
+#include "packager/base/synchronization/read_write_lock.h"
+#include "packager/base/synchronization/waitable_event.h"
 #include "packager/base/threading/simple_thread.h"
 #include "packager/base/time/clock.h"
+#include "packager/base/time/time.h"
+#include "packager/checkpoint.h"
 #include "packager/file/file.h"
 #include "packager/hls/base/hls_notifier.h"
 #include "packager/hls/base/simple_hls_notifier.h"
@@ -29,14 +36,18 @@
 #include "packager/media/base/fourccs.h"
 #include "packager/media/base/key_source.h"
 #include "packager/media/base/language_utils.h"
+#include "packager/media/base/latency_histogram.h"
 #include "packager/media/base/muxer.h"
 #include "packager/media/base/muxer_options.h"
 #include "packager/media/base/muxer_util.h"
 #include "packager/media/chunking/chunking_handler.h"
 #include "packager/media/chunking/cue_alignment_handler.h"
 #include "packager/media/chunking/text_chunker.h"
+#include "packager/media/crypto/encryption_config_cache.h"
 #include "packager/media/crypto/encryption_handler.h"
 #include "packager/media/demuxer/demuxer.h"
+#include "packager/media/event/chunked_muxer_listener.h"
+#include "packager/media/event/latency_muxer_listener.h"
 #include "packager/media/event/muxer_listener_factory.h"
 #include "packager/media/event/vod_media_info_dump_muxer_listener.h"
 #include "packager/media/formats/webvtt/text_padder.h"
@@ -46,10 +57,13 @@
 #include "packager/media/formats/webvtt/webvtt_to_mp4_handler.h"
 #include "packager/media/replicator/replicator.h"
 #include "packager/media/trick_play/trick_play_handler.h"
+#include "packager/memory_tracker.h"
+#include "packager/mpd/base/binary_media_info.h"
 #include "packager/mpd/base/media_info.pb.h"
 #include "packager/mpd/base/mpd_builder.h"
 #include "packager/mpd/base/simple_mpd_notifier.h"
 #include "packager/status_macros.h"
+#include "packager/trace_event.h"
 #include "packager/version/version.h"
 
 namespace shaka {
@@ -68,6 +82,10 @@ const char kMediaInfoSuffix[] = ".media_info";
 
 const int64_t kDefaultTextZeroBiasMs = 10 * 60 * 1000;  // 10 minutes
 
+// Maximum number of EncryptionConfigs shared by the encryption handlers of a
+// job.
+const size_t kEncryptionConfigCacheSize = 64;
+
 MuxerOptions CreateMuxerOptions(const StreamDescriptor& stream,
                                 const PackagingParams& params) {
   MuxerOptions options;
@@ -79,6 +97,9 @@ MuxerOptions CreateMuxerOptions(const StreamDescriptor& stream,
   options.bandwidth = stream.bandwidth;
   options.output_file_name = stream.output;
   options.segment_template = stream.segment_template;
+  options.segment_duration_in_seconds =
+      params.chunking_params.segment_duration_in_seconds;
+  options.webm_single_pass = params.webm_single_pass;
 
   return options;
 }
@@ -92,6 +113,8 @@ MuxerListenerFactory::StreamData ToMuxerListenerData(
   data.hls_playlist_name = stream.hls_playlist_name;
   data.hls_iframe_playlist_name = stream.hls_iframe_playlist_name;
   data.hls_characteristics = stream.hls_characteristics;
+  data.latency_stats_name =
+      stream.segment_template.empty() ? stream.output : stream.segment_template;
   return data;
 };
 
@@ -261,6 +284,55 @@ Status ValidateStreamDescriptor(bool dump_stream_info,
   return Status::OK;
 }
 
+Status ValidateParallelVodParams(
+    const PackagingParams& packaging_params,
+    const std::vector<StreamDescriptor>& stream_descriptors) {
+  if (packaging_params.hls_params.playlist_type != HlsPlaylistType::kVod) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Parallel VOD packaging requires HLS playlist type VOD.");
+  }
+  if (!packaging_params.ad_cue_generator_params.cue_points.empty()) {
+    return Status(error::UNIMPLEMENTED,
+                  "Parallel VOD packaging does not support ad cues.");
+  }
+  if (!packaging_params.checkpoint_params.checkpoint_file.empty()) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Parallel VOD packaging does not support checkpoints.");
+  }
+  // The fragment sequence numbers of a chunk are derived from its first
+  // segment index, assuming a fragment per segment.
+  if (packaging_params.chunking_params.subsegment_duration_in_seconds > 0) {
+    return Status(error::UNIMPLEMENTED,
+                  "Parallel VOD packaging does not support subsegments.");
+  }
+  // Every chunk must produce the IVs of the whole stream, including the
+  // constant IV in the init segment written by the first chunk. Random IVs
+  // would differ between the chunks.
+  if (packaging_params.encryption_params.key_provider != KeyProvider::kNone &&
+      !packaging_params.encryption_params.derive_iv) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Parallel VOD packaging with encryption requires derived "
+                  "IVs.");
+  }
+  for (const StreamDescriptor& descriptor : stream_descriptors) {
+    if (descriptor.stream_selector == "text")
+      continue;
+    if (descriptor.segment_template.empty() ||
+        GetOutputFormat(descriptor) != CONTAINER_MOV) {
+      return Status(error::UNIMPLEMENTED,
+                    "Parallel VOD packaging only supports MP4 output with "
+                    "segment_template, but not for " +
+                        descriptor.input + ":" + descriptor.stream_selector);
+    }
+    // The trick play handler of a chunk would pick different frames.
+    if (descriptor.trick_play_factor > 0) {
+      return Status(error::UNIMPLEMENTED,
+                    "Parallel VOD packaging does not support trick play.");
+    }
+  }
+  return Status::OK;
+}
+
 Status ValidateParams(const PackagingParams& packaging_params,
                       const std::vector<StreamDescriptor>& stream_descriptors) {
   if (!packaging_params.chunking_params.segment_sap_aligned &&
@@ -329,6 +401,12 @@ Status ValidateParams(const PackagingParams& packaging_params,
     }
   }
 
+  if (packaging_params.output_binary_media_info &&
+      !packaging_params.output_media_info) {
+    return Status(error::INVALID_ARGUMENT,
+                  "--output_binary_media_info requires --output_media_info.");
+  }
+
   if (packaging_params.output_media_info && !on_demand_dash_profile) {
     // TODO(rkuroiwa, kqyang): Support partial media info dump for live.
     return Status(error::UNIMPLEMENTED,
@@ -336,6 +414,36 @@ Status ValidateParams(const PackagingParams& packaging_params,
                   "(not using segment_template).");
   }
 
+  const CheckpointParams& checkpoint_params =
+      packaging_params.checkpoint_params;
+  if (!checkpoint_params.checkpoint_file.empty()) {
+    if (on_demand_dash_profile) {
+      return Status(error::INVALID_ARGUMENT,
+                    "Checkpoints require segment_template, i.e. live "
+                    "packaging.");
+    }
+    // The callback file names are not stable across restarts.
+    if (packaging_params.buffer_callback_params.write_func) {
+      return Status(error::UNIMPLEMENTED,
+                    "Checkpoints are not supported with buffer callbacks.");
+    }
+    if (checkpoint_params.checkpoint_interval_in_seconds <= 0) {
+      return Status(error::INVALID_ARGUMENT,
+                    "Checkpoint interval must be positive.");
+    }
+  }
+
+  if (packaging_params.encryption_params.derive_iv &&
+      !packaging_params.encryption_params.raw_key.iv.empty()) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Derived IVs cannot be used with a fixed IV.");
+  }
+
+  if (packaging_params.parallel_vod_params.num_chunks > 1) {
+    RETURN_IF_ERROR(
+        ValidateParallelVodParams(packaging_params, stream_descriptors));
+  }
+
   return Status::OK;
 }
 
@@ -407,6 +515,8 @@ Status CreateDemuxer(const StreamDescriptor& stream,
                      std::shared_ptr<Demuxer>* new_demuxer) {
   std::shared_ptr<Demuxer> demuxer = std::make_shared<Demuxer>(stream.input);
   demuxer->set_dump_stream_info(packaging_params.test_params.dump_stream_info);
+  demuxer->set_lazy_stream_initialization(
+      packaging_params.lazy_stream_initialization);
 
   if (packaging_params.decryption_params.key_provider != KeyProvider::kNone) {
     std::unique_ptr<KeySource> decryption_key_source(
@@ -423,10 +533,11 @@ Status CreateDemuxer(const StreamDescriptor& stream,
   return Status::OK;
 }
 
-std::shared_ptr<MediaHandler> CreateEncryptionHandler(
+std::shared_ptr<EncryptionHandler> CreateEncryptionHandler(
     const PackagingParams& packaging_params,
     const StreamDescriptor& stream,
-    KeySource* key_source) {
+    KeySource* key_source,
+    std::shared_ptr<EncryptionConfigCache> encryption_config_cache) {
   if (stream.skip_encryption) {
     return nullptr;
   }
@@ -464,7 +575,11 @@ std::shared_ptr<MediaHandler> CreateEncryptionHandler(
         kDefaultMaxHdPixels, kDefaultMaxUhd1Pixels, std::placeholders::_1);
   }
 
-  return std::make_shared<EncryptionHandler>(encryption_params, key_source);
+  auto encryption_handler = std::make_shared<EncryptionHandler>(
+      encryption_params, key_source, encryption_config_cache);
+  encryption_handler->set_stream_id(stream.input + ":" +
+                                    stream.stream_selector);
+  return encryption_handler;
 }
 
 std::unique_ptr<TextChunker> CreateTextChunker(
@@ -653,6 +768,10 @@ Status CreateTextJobs(
         if (packaging_params.output_media_info) {
           VodMediaInfoDumpMuxerListener::WriteMediaInfoToFile(
               text_media_info, stream.output + kMediaInfoSuffix);
+          if (packaging_params.output_binary_media_info) {
+            VodMediaInfoDumpMuxerListener::WriteMediaInfoToBinaryFile(
+                text_media_info, stream.output + kBinaryMediaInfoSuffix);
+          }
         }
       }
     }
@@ -661,6 +780,101 @@ Status CreateTextJobs(
   return Status::OK;
 }
 
+// Copies |descriptor| for CreateAllJobs(), with the callback file names and
+// the language code used by the jobs.
+Status CopyStreamDescriptorForJobs(
+    const BufferCallbackParams& buffer_callback_params,
+    const StreamDescriptor& descriptor,
+    StreamDescriptor* copy) {
+  *copy = descriptor;
+
+  if (buffer_callback_params.read_func) {
+    copy->input =
+        File::MakeCallbackFileName(buffer_callback_params, descriptor.input);
+  }
+
+  if (buffer_callback_params.write_func) {
+    copy->output =
+        File::MakeCallbackFileName(buffer_callback_params, descriptor.output);
+    copy->segment_template = File::MakeCallbackFileName(
+        buffer_callback_params, descriptor.segment_template);
+  }
+
+  // Update language to ISO_639_2 code if set.
+  if (!copy->language.empty()) {
+    copy->language = LanguageToISO_639_2(descriptor.language);
+    if (copy->language == "und") {
+      return Status(
+          error::INVALID_ARGUMENT,
+          "Unknown/invalid language specified: " + descriptor.language);
+    }
+  }
+  return Status::OK;
+}
+
+// A branch of the audio / video handler graph, from a replicator to a muxer.
+struct OutputBranch {
+  std::shared_ptr<Replicator> replicator;
+  // The handler connected to the replicator, i.e. the trick play handler or
+  // the muxer.
+  std::shared_ptr<MediaHandler> head;
+  std::shared_ptr<Muxer> muxer;
+  // Owned by |muxer|.
+  MuxerListener* muxer_listener = nullptr;
+  // Set once the removal of the branch is requested. The branch is kept until
+  // the replicator has detached it at the next segment boundary.
+  bool removing = false;
+};
+
+// The parts of the audio / video handler graph which can be changed while
+// packaging, see Packager::AddStream() and Packager::RemoveStream().
+struct OutputBranches {
+  // Replicators keyed by input and stream selector.
+  std::map<std::pair<std::string, std::string>, std::shared_ptr<Replicator>>
+      replicators;
+  // Branches keyed by output name, see GetOutputName().
+  std::map<std::string, OutputBranch> branches;
+};
+
+// @return The name identifying the output of |stream|, i.e. its segment
+//         template if set, otherwise its output.
+std::string GetOutputName(const StreamDescriptor& stream) {
+  return stream.segment_template.empty() ? stream.output
+                                         : stream.segment_template;
+}
+
+// Creates the muxer, with its listener, and the optional trick play handler of
+// |stream|. The branch is not connected to a replicator.
+Status CreateOutputBranch(const StreamDescriptor& stream,
+                          MuxerListenerFactory* muxer_listener_factory,
+                          MuxerFactory* muxer_factory,
+                          OutputBranch* branch) {
+  // Create the muxer (output) for this track.
+  std::shared_ptr<Muxer> muxer =
+      muxer_factory->CreateMuxer(GetOutputFormat(stream), stream);
+  if (!muxer) {
+    return Status(error::INVALID_ARGUMENT, "Failed to create muxer for " +
+                                               stream.input + ":" +
+                                               stream.stream_selector);
+  }
+
+  std::unique_ptr<MuxerListener> muxer_listener =
+      muxer_listener_factory->CreateListener(ToMuxerListenerData(stream));
+  branch->muxer_listener = muxer_listener.get();
+  muxer->SetMuxerListener(std::move(muxer_listener));
+
+  // Trick play is optional.
+  std::shared_ptr<MediaHandler> trick_play =
+      stream.trick_play_factor
+          ? std::make_shared<TrickPlayHandler>(stream.trick_play_factor)
+          : nullptr;
+
+  RETURN_IF_ERROR(MediaHandler::Chain({trick_play, muxer}));
+  branch->head = trick_play ? trick_play : muxer;
+  branch->muxer = muxer;
+  return Status::OK;
+}
+
 Status CreateAudioVideoJobs(
     const std::vector<std::reference_wrapper<const StreamDescriptor>>& streams,
     const PackagingParams& packaging_params,
@@ -668,10 +882,12 @@ Status CreateAudioVideoJobs(
     SyncPointQueue* sync_points,
     MuxerListenerFactory* muxer_listener_factory,
     MuxerFactory* muxer_factory,
-    JobManager* job_manager) {
+    JobManager* job_manager,
+    OutputBranches* output_branches) {
   DCHECK(muxer_listener_factory);
   DCHECK(muxer_factory);
   DCHECK(job_manager);
+  DCHECK(output_branches);
   // Store all the demuxers in a map so that we can look up a stream's demuxer.
   // This is step one in making this part of the pipeline less dependant on
   // order.
@@ -693,12 +909,16 @@ Status CreateAudioVideoJobs(
   }
 
   for (auto& source : sources) {
-    job_manager->Add("RemuxJob", source.second);
+    job_manager->Add("RemuxJob " + source.first, source.second);
   }
 
   // Replicators are shared among all streams with the same input and stream
   // selector.
-  std::shared_ptr<MediaHandler> replicator;
+  std::shared_ptr<Replicator> replicator;
+
+  // Streams encrypted with the same key share the same EncryptionConfig.
+  auto encryption_config_cache =
+      std::make_shared<EncryptionConfigCache>(kEncryptionConfigCacheSize);
 
   std::string previous_input;
   std::string previous_selector;
@@ -731,8 +951,9 @@ Status CreateAudioVideoJobs(
       replicator = std::make_shared<Replicator>();
       auto chunker =
           std::make_shared<ChunkingHandler>(packaging_params.chunking_params);
-      auto encryptor = CreateEncryptionHandler(packaging_params, stream,
-                                               encryption_key_source);
+      auto encryptor = CreateEncryptionHandler(
+          packaging_params, stream, encryption_key_source,
+          encryption_config_cache);
 
       // TODO(vaage) : Create a nicer way to connect handlers to demuxers.
 
@@ -745,28 +966,186 @@ Status CreateAudioVideoJobs(
         RETURN_IF_ERROR(MediaHandler::Chain({cue_aligner, chunker, encryptor, replicator}));
         RETURN_IF_ERROR(demuxer->SetHandler(stream.stream_selector, cue_aligner));
       }
+      output_branches->replicators[std::make_pair(
+          stream.input, stream.stream_selector)] = replicator;
     }
 
-    // Create the muxer (output) for this track.
-    std::shared_ptr<Muxer> muxer =
-        muxer_factory->CreateMuxer(GetOutputFormat(stream), stream);
-    if (!muxer) {
-      return Status(error::INVALID_ARGUMENT, "Failed to create muxer for " +
-                                                 stream.input + ":" +
-                                                 stream.stream_selector);
+    OutputBranch branch;
+    RETURN_IF_ERROR(CreateOutputBranch(stream, muxer_listener_factory,
+                                       muxer_factory, &branch));
+    RETURN_IF_ERROR(replicator->AddHandler(branch.head));
+    branch.replicator = replicator;
+    output_branches->branches[GetOutputName(stream)] = branch;
+  }
+
+  return Status::OK;
+}
+
+// Creates the jobs of the audio / video streams of a VOD title like
+// CreateAudioVideoJobs(), but the timeline of every input is split into chunks
+// of whole segments, which are packaged by separate jobs in parallel, see
+// ParallelVodParams. Every chunk has its own demuxer and handlers. The
+// listeners of the muxers of an output are stitched by a ChunkedMuxerListener,
+// which is appended to |chunked_muxer_listeners| and must be flushed after
+// the jobs complete. The chunks are planned by |vod_chunk_planner|.
+Status CreateParallelVodJobs(
+    const std::vector<std::reference_wrapper<const StreamDescriptor>>& streams,
+    const PackagingParams& packaging_params,
+    KeySource* encryption_key_source,
+    MuxerListenerFactory* muxer_listener_factory,
+    MuxerFactory* muxer_factory,
+    VodChunkPlanner* vod_chunk_planner,
+    JobManager* job_manager,
+    std::vector<std::unique_ptr<ChunkedMuxerListener>>*
+        chunked_muxer_listeners) {
+  DCHECK(vod_chunk_planner);
+  DCHECK(muxer_listener_factory);
+  DCHECK(muxer_factory);
+  DCHECK(job_manager);
+  DCHECK(chunked_muxer_listeners);
+
+  // The streams of an input keep their sorted order.
+  std::map<std::string,
+           std::vector<std::reference_wrapper<const StreamDescriptor>>>
+      streams_by_input;
+  for (const StreamDescriptor& stream : streams) {
+    // If the stream has no output, then there is no reason setting-up the rest
+    // of the pipeline.
+    if (stream.output.empty() && stream.segment_template.empty())
+      continue;
+    streams_by_input[stream.input].push_back(stream);
+  }
+
+  // Streams encrypted with the same key share the same EncryptionConfig.
+  auto encryption_config_cache =
+      std::make_shared<EncryptionConfigCache>(kEncryptionConfigCacheSize);
+
+  for (const auto& entry : streams_by_input) {
+    const std::string& input = entry.first;
+    const std::vector<std::reference_wrapper<const StreamDescriptor>>&
+        input_streams = entry.second;
+
+    std::vector<std::string> stream_selectors;
+    for (const StreamDescriptor& stream : input_streams) {
+      if (stream_selectors.empty() ||
+          stream_selectors.back() != stream.stream_selector) {
+        stream_selectors.push_back(stream.stream_selector);
+      }
+    }
+    std::shared_ptr<Demuxer> probe_demuxer;
+    RETURN_IF_ERROR(
+        CreateDemuxer(input_streams.front(), packaging_params, &probe_demuxer));
+    VodChunkPlan plan;
+    RETURN_IF_ERROR(vod_chunk_planner->Plan(
+        probe_demuxer, stream_selectors, packaging_params.chunking_params,
+        packaging_params.parallel_vod_params.num_chunks, &plan));
+    if (plan.num_chunks > 1) {
+      LOG(INFO) << "Packaging " << input << " in " << plan.num_chunks
+                << " chunks of " << plan.segments_per_chunk << " segments.";
+      for (const auto& ranges : plan.chunk_ranges) {
+        for (size_t chunk = 0; chunk < ranges.second.size(); ++chunk) {
+          VLOG(1) << "Chunk " << chunk << " of " << input << ":"
+                  << ranges.first << " has the samples with DTS in ["
+                  << ranges.second[chunk].start_dts << ", "
+                  << ranges.second[chunk].end_dts << ").";
+        }
+      }
+    } else {
+      LOG(WARNING) << "Packaging " << input
+                   << " sequentially as its duration is unknown or it has too "
+                      "few segments to be split.";
     }
+    const bool chunked = plan.num_chunks > 1;
+
+    // The listeners of the outputs of the input, in the order of
+    // |input_streams|.
+    std::vector<std::unique_ptr<ChunkedMuxerListener>> listeners;
+    for (uint32_t chunk = 0; chunk < plan.num_chunks; ++chunk) {
+      const uint32_t first_segment_index = chunk * plan.segments_per_chunk;
+
+      std::shared_ptr<Demuxer> demuxer;
+      RETURN_IF_ERROR(
+          CreateDemuxer(input_streams.front(), packaging_params, &demuxer));
+      job_manager->Add(
+          base::StringPrintf("RemuxJob %s chunk %u", input.c_str(), chunk),
+          demuxer);
+
+      std::shared_ptr<Replicator> replicator;
+      for (size_t i = 0; i < input_streams.size(); ++i) {
+        const StreamDescriptor& stream = input_streams[i];
+        const bool new_stream =
+            i == 0 || input_streams[i - 1].get().stream_selector !=
+                          stream.stream_selector;
+        if (new_stream) {
+          if (!stream.language.empty()) {
+            demuxer->SetLanguageOverride(stream.stream_selector,
+                                         stream.language);
+          }
 
-    std::unique_ptr<MuxerListener> muxer_listener =
-        muxer_listener_factory->CreateListener(ToMuxerListenerData(stream));
-    muxer->SetMuxerListener(std::move(muxer_listener));
+          replicator = std::make_shared<Replicator>();
+          auto chunker = std::make_shared<ChunkingHandler>(
+              packaging_params.chunking_params);
+          auto encryptor = CreateEncryptionHandler(
+              packaging_params, stream, encryption_key_source,
+              encryption_config_cache);
+          if (chunked) {
+            // The demuxer only reads the samples of the chunk. The clear lead
+            // of the encryptor continues from the segments before the chunk,
+            // and its crypto periods follow from the timestamps.
+            const VodChunkPlan::ChunkRange& chunk_range =
+                plan.chunk_ranges[stream.stream_selector][chunk];
+            RETURN_IF_ERROR(demuxer->SetSampleRange(stream.stream_selector,
+                                                    chunk_range.start_dts,
+                                                    chunk_range.end_dts));
+            if (encryptor)
+              encryptor->set_preceding_duration(chunk_range.preceding_duration);
+          }
+          RETURN_IF_ERROR(
+              MediaHandler::Chain({chunker, encryptor, replicator}));
+          RETURN_IF_ERROR(demuxer->SetHandler(stream.stream_selector, chunker));
+        }
 
-    // Trick play is optional.
-    std::shared_ptr<MediaHandler> trick_play =
-        stream.trick_play_factor
-            ? std::make_shared<TrickPlayHandler>(stream.trick_play_factor)
-            : nullptr;
+        std::shared_ptr<Muxer> muxer;
+        if (chunked) {
+          MuxerOptions::TimelineChunk timeline_chunk;
+          timeline_chunk.is_first_chunk = chunk == 0;
+          auto first_sample_it =
+              plan.first_samples.find(stream.stream_selector);
+          if (first_sample_it != plan.first_samples.end()) {
+            timeline_chunk.first_sample_pts = first_sample_it->second.pts;
+            timeline_chunk.first_sample_dts = first_sample_it->second.dts;
+          }
+          muxer = muxer_factory->CreateChunkMuxer(
+              GetOutputFormat(stream), stream, first_segment_index,
+              timeline_chunk);
+        } else {
+          muxer = muxer_factory->CreateMuxer(GetOutputFormat(stream), stream);
+        }
+        if (!muxer) {
+          return Status(error::INVALID_ARGUMENT, "Failed to create muxer for " +
+                                                     stream.input + ":" +
+                                                     stream.stream_selector);
+        }
+
+        std::unique_ptr<MuxerListener> muxer_listener;
+        if (chunk == 0) {
+          muxer_listener = muxer_listener_factory->CreateListener(
+              ToMuxerListenerData(stream));
+          if (chunked) {
+            listeners.emplace_back(new ChunkedMuxerListener(
+                std::move(muxer_listener), plan.num_chunks));
+          }
+        }
+        if (chunked)
+          muxer_listener = listeners[i]->CreateChunkListener(chunk);
+        muxer->SetMuxerListener(std::move(muxer_listener));
 
-    RETURN_IF_ERROR(MediaHandler::Chain({replicator, trick_play, muxer}));
+        RETURN_IF_ERROR(replicator->AddHandler(muxer));
+      }
+    }
+
+    for (auto& listener : listeners)
+      chunked_muxer_listeners->push_back(std::move(listener));
   }
 
   return Status::OK;
@@ -779,7 +1158,11 @@ Status CreateAllJobs(const std::vector<StreamDescriptor>& stream_descriptors,
                      SyncPointQueue* sync_points,
                      MuxerListenerFactory* muxer_listener_factory,
                      MuxerFactory* muxer_factory,
-                     JobManager* job_manager) {
+                     VodChunkPlanner* vod_chunk_planner,
+                     JobManager* job_manager,
+                     OutputBranches* output_branches,
+                     std::vector<std::unique_ptr<ChunkedMuxerListener>>*
+                         chunked_muxer_listeners) {
   DCHECK(muxer_factory);
   DCHECK(muxer_listener_factory);
   DCHECK(job_manager);
@@ -840,24 +1223,208 @@ Status CreateAllJobs(const std::vector<StreamDescriptor>& stream_descriptors,
                                    muxer_factory, mpd_notifier, job_manager));
   }
 
-  RETURN_IF_ERROR(CreateAudioVideoJobs(
-      audio_video_streams, packaging_params, encryption_key_source, sync_points,
-      muxer_listener_factory, muxer_factory, job_manager));
+  if (packaging_params.parallel_vod_params.num_chunks > 1) {
+    RETURN_IF_ERROR(CreateParallelVodJobs(
+        audio_video_streams, packaging_params, encryption_key_source,
+        muxer_listener_factory, muxer_factory, vod_chunk_planner, job_manager,
+        chunked_muxer_listeners));
+  } else {
+    RETURN_IF_ERROR(CreateAudioVideoJobs(
+        audio_video_streams, packaging_params, encryption_key_source,
+        sync_points, muxer_listener_factory, muxer_factory, job_manager,
+        output_branches));
+  }
 
   // Initialize processing graph.
   return job_manager->InitializeJobs();
 }
 
+void LogHandlerStats(const std::vector<HandlerStats>& stats) {
+  for (const HandlerStats& handler_stats : stats) {
+    LOG(INFO) << handler_stats.job_name << " " << handler_stats.handler_name
+              << "[" << handler_stats.stream_index
+              << "]: " << handler_stats.samples_per_second << " samples/s, "
+              << handler_stats.bytes_per_second << " bytes/s, self time "
+              << handler_stats.self_time_in_seconds << "s";
+  }
+}
+
+std::string LatencyDistributionToString(const LatencyDistribution& latency) {
+  return base::StringPrintf(
+      "%llu segments, mean %.3fs, p50 %.3fs, p90 %.3fs, p99 %.3fs, "
+      "max %.3fs",
+      static_cast<unsigned long long>(latency.count),
+      latency.mean_in_seconds, latency.p50_in_seconds, latency.p90_in_seconds,
+      latency.p99_in_seconds, latency.max_in_seconds);
+}
+
+void LogLatencyStats(const std::vector<LatencyStats>& stats) {
+  for (const LatencyStats& latency_stats : stats) {
+    LOG(INFO) << latency_stats.stream_name << " ingest to segment: "
+              << LatencyDistributionToString(latency_stats.ingest_to_segment);
+    LOG(INFO) << latency_stats.stream_name << " segment to manifest: "
+              << LatencyDistributionToString(
+                     latency_stats.segment_to_manifest);
+    LOG(INFO) << latency_stats.stream_name << " ingest to manifest: "
+              << LatencyDistributionToString(latency_stats.ingest_to_manifest);
+  }
+}
+
+void LogMemoryUsage(const std::vector<MemoryUsage>& usage,
+                    const MemoryAccounting& memory_accounting) {
+  for (const MemoryUsage& memory_usage : usage) {
+    LOG(INFO) << memory_usage.job_name << " " << memory_usage.buffer_name
+              << "[" << memory_usage.stream_name
+              << "]: " << memory_usage.current_bytes << " bytes, peak "
+              << memory_usage.peak_bytes << " bytes";
+  }
+  LOG(INFO) << "Total buffer memory: " << memory_accounting.total_bytes()
+            << " bytes, peak " << memory_accounting.peak_total_bytes()
+            << " bytes, waited "
+            << memory_accounting.total_wait_time().InSecondsF()
+            << "s for the soft limit";
+}
+
+// Logs statistics, or writes checkpoints, periodically until stopped.
+class StatsDumper : public base::SimpleThread {
+ public:
+  StatsDumper(const std::string& name,
+              base::TimeDelta interval,
+              std::function<void()> log_stats)
+      : SimpleThread(name),
+        interval_(interval),
+        log_stats_(std::move(log_stats)),
+        stop_(base::WaitableEvent::ResetPolicy::MANUAL,
+              base::WaitableEvent::InitialState::NOT_SIGNALED) {}
+
+  // Stops the thread and logs the final statistics.
+  void Stop() {
+    stop_.Signal();
+    Join();
+    log_stats_();
+  }
+
+ private:
+  StatsDumper(const StatsDumper&) = delete;
+  StatsDumper& operator=(const StatsDumper&) = delete;
+
+  void Run() override {
+    while (!stop_.TimedWait(interval_))
+      log_stats_();
+  }
+
+  const base::TimeDelta interval_;
+  const std::function<void()> log_stats_;
+  base::WaitableEvent stop_;
+};
+
+LatencyDistribution ToLatencyDistribution(const LatencyHistogram& histogram) {
+  LatencyDistribution latency;
+  latency.count = histogram.count();
+  if (latency.count > 0)
+    latency.mean_in_seconds = histogram.sum().InSecondsF() / latency.count;
+  latency.max_in_seconds = histogram.max().InSecondsF();
+  latency.p50_in_seconds = histogram.Percentile(50).InSecondsF();
+  latency.p90_in_seconds = histogram.Percentile(90).InSecondsF();
+  latency.p99_in_seconds = histogram.Percentile(99).InSecondsF();
+  for (size_t i = 0; i < LatencyHistogram::kNumBuckets; ++i) {
+    if (i + 1 < LatencyHistogram::kNumBuckets) {
+      latency.bucket_upper_bounds_in_seconds.push_back(
+          LatencyHistogram::BucketUpperBound(i).InSecondsF());
+    }
+    latency.bucket_counts.push_back(histogram.bucket_count(i));
+  }
+  return latency;
+}
+
+// Records trace events while in scope and writes them to |trace_file|.
+class ScopedTraceFileWriter {
+ public:
+  explicit ScopedTraceFileWriter(const std::string& trace_file)
+      : trace_file_(trace_file) {
+    if (!TraceLog::StartTracing()) {
+      LOG(WARNING) << "Tracing is already enabled. Not writing trace events to "
+                   << trace_file_;
+      trace_file_.clear();
+    }
+  }
+
+  ~ScopedTraceFileWriter() {
+    if (trace_file_.empty())
+      return;
+    std::string json;
+    TraceLog::StopTracing(&json);
+    if (!File::WriteStringToFile(trace_file_.c_str(), json))
+      LOG(ERROR) << "Failed to write trace events to " << trace_file_;
+  }
+
+ private:
+  ScopedTraceFileWriter(const ScopedTraceFileWriter&) = delete;
+  ScopedTraceFileWriter& operator=(const ScopedTraceFileWriter&) = delete;
+
+  std::string trace_file_;
+};
+
 }  // namespace
 }  // namespace media
 
 struct Packager::PackagerInternal {
+  // Creates the jobs of |streams_for_jobs|.
+  Status CreateJobs(const PackagingParams& packaging_params,
+                    const std::vector<StreamDescriptor>& streams_for_jobs);
+
+  // Accounts the memory of the buffers of this Packager only.
+  MemoryAccounting memory_accounting;
   media::FakeClock fake_clock;
   std::unique_ptr<KeySource> encryption_key_source;
   std::unique_ptr<MpdNotifier> mpd_notifier;
   std::unique_ptr<hls::HlsNotifier> hls_notifier;
   BufferCallbackParams buffer_callback_params;
   std::unique_ptr<media::JobManager> job_manager;
+  // Planning the chunks of parallel VOD packaging scans the inputs, so the
+  // jobs are created by Run() then, where Cancel() can interrupt the planning.
+  // The parameters are kept until then.
+  std::unique_ptr<PackagingParams> deferred_packaging_params;
+  std::vector<StreamDescriptor> deferred_streams_for_jobs;
+  media::VodChunkPlanner vod_chunk_planner;
+  // Protects |jobs_created| and |jobs_cancelled|, so that the jobs are not
+  // cancelled, or their stats read, while Run() creates them.
+  base::Lock jobs_lock;
+  bool jobs_created = false;
+  bool jobs_cancelled = false;
+  HandlerStatsParams handler_stats_params;
+  LatencyStatsParams latency_stats_params;
+  MemoryStatsParams memory_stats_params;
+  std::string trace_file;
+  CheckpointParams checkpoint_params;
+  // Serializes the checkpoint writes, so that an older checkpoint never
+  // overwrites a newer one.
+  base::Lock checkpoint_lock;
+  // Held for reading by the muxers while they count and notify a segment, and
+  // for writing while a checkpoint is taken, see Muxer::set_segment_lock().
+  base::subtle::ReadWriteLock segment_lock;
+
+  // Protects |run_start_time|, which is read by GetHandlerStats from other
+  // threads.
+  mutable base::Lock run_start_time_lock;
+  base::TimeTicks run_start_time;
+
+  std::unique_ptr<media::MuxerFactory> muxer_factory;
+  std::unique_ptr<media::MuxerListenerFactory> muxer_listener_factory;
+
+  // Protects |output_branches| and |latency_stats|, which change when streams
+  // are added or removed while packaging, and |next_segment_indices|.
+  mutable base::Lock output_branches_lock;
+  media::OutputBranches output_branches;
+  std::vector<std::shared_ptr<media::SegmentLatencyStats>> latency_stats;
+  // Stitch the manifest events of the chunks of the outputs in parallel VOD
+  // packaging, see ParallelVodParams.
+  std::vector<std::unique_ptr<media::ChunkedMuxerListener>>
+      chunked_muxer_listeners;
+  // The next segment indices of the last checkpoint, keyed by segment
+  // template. Keeps the indices of the outputs which are not packaged
+  // currently, e.g. removed ones, in the later checkpoints.
+  std::map<std::string, uint32_t> next_segment_indices;
 };
 
 Packager::Packager() {}
@@ -944,6 +1511,25 @@ Status Packager::Initialize(
     internal->hls_notifier.reset(new hls::SimpleHlsNotifier(hls_params));
   }
 
+  // Resume from the last checkpoint if there is one. The state is restored
+  // before any stream is notified to the manifests.
+  internal->checkpoint_params = packaging_params.checkpoint_params;
+  const std::string& checkpoint_file =
+      internal->checkpoint_params.checkpoint_file;
+  if (!checkpoint_file.empty()) {
+    PackagerCheckpoint checkpoint;
+    bool found = false;
+    RETURN_IF_ERROR(ReadCheckpoint(checkpoint_file, &checkpoint, &found));
+    if (found) {
+      LOG(INFO) << "Resuming from checkpoint " << checkpoint_file;
+      if (internal->hls_notifier)
+        internal->hls_notifier->RestoreState(checkpoint.media_playlists);
+      if (internal->mpd_notifier)
+        internal->mpd_notifier->RestoreState(checkpoint.mpd_state);
+      internal->next_segment_indices = checkpoint.next_segment_indices;
+    }
+  }
+
   std::unique_ptr<SyncPointQueue> sync_points;
   if (!packaging_params.ad_cue_generator_params.cue_points.empty()) {
 
@@ -961,63 +1547,149 @@ Status Packager::Initialize(
     sync_points.reset(nullptr);
   }
 
-  internal->job_manager.reset(new JobManager(std::move(sync_points)));
+  internal->job_manager.reset(
+      new JobManager(std::move(sync_points), &internal->memory_accounting));
 
   std::vector<StreamDescriptor> streams_for_jobs;
 
   for (const StreamDescriptor& descriptor : stream_descriptors) {
     // We may need to overwrite some values, so make a copy first.
-    StreamDescriptor copy = descriptor;
-
-    if (internal->buffer_callback_params.read_func) {
-      copy.input = File::MakeCallbackFileName(internal->buffer_callback_params,
-                                              descriptor.input);
-    }
-
-    if (internal->buffer_callback_params.write_func) {
-      copy.output = File::MakeCallbackFileName(internal->buffer_callback_params,
-                                               descriptor.output);
-      copy.segment_template = File::MakeCallbackFileName(
-          internal->buffer_callback_params, descriptor.segment_template);
-    }
-
-    // Update language to ISO_639_2 code if set.
-    if (!copy.language.empty()) {
-      copy.language = LanguageToISO_639_2(descriptor.language);
-      if (copy.language == "und") {
-        return Status(
-            error::INVALID_ARGUMENT,
-            "Unknown/invalid language specified: " + descriptor.language);
-      }
-    }
-
+    StreamDescriptor copy;
+    RETURN_IF_ERROR(media::CopyStreamDescriptorForJobs(
+        internal->buffer_callback_params, descriptor, &copy));
     streams_for_jobs.push_back(copy);
   }
 
-  media::MuxerFactory muxer_factory(packaging_params);
+  // The factories are kept to create the streams added while packaging.
+  internal->muxer_factory.reset(new media::MuxerFactory(packaging_params));
   if (packaging_params.test_params.inject_fake_clock) {
-    muxer_factory.OverrideClock(&internal->fake_clock);
+    internal->muxer_factory->OverrideClock(&internal->fake_clock);
   }
+  internal->muxer_factory->SetInitialSegmentIndices(
+      internal->next_segment_indices);
+  if (!checkpoint_file.empty())
+    internal->muxer_factory->SetSegmentLock(&internal->segment_lock);
+
+  internal->muxer_listener_factory.reset(new media::MuxerListenerFactory(
+      packaging_params.output_media_info,
+      packaging_params.output_binary_media_info, internal->mpd_notifier.get(),
+      internal->hls_notifier.get()));
+  if (packaging_params.latency_stats_params.enable_latency_stats)
+    internal->muxer_listener_factory->EnableLatencyStats();
+
+  internal->handler_stats_params = packaging_params.handler_stats_params;
+  if (packaging_params.parallel_vod_params.num_chunks > 1) {
+    internal->deferred_packaging_params.reset(
+        new PackagingParams(packaging_params));
+    internal->deferred_streams_for_jobs = std::move(streams_for_jobs);
+  } else {
+    RETURN_IF_ERROR(internal->CreateJobs(packaging_params, streams_for_jobs));
+  }
+  internal->latency_stats_params = packaging_params.latency_stats_params;
+  internal->memory_stats_params = packaging_params.memory_stats_params;
+  internal->trace_file = packaging_params.trace_file;
 
-  media::MuxerListenerFactory muxer_listener_factory(
-      packaging_params.output_media_info, internal->mpd_notifier.get(),
-      internal->hls_notifier.get());
+  internal_ = std::move(internal);
+  return Status::OK;
+}
 
+Status Packager::PackagerInternal::CreateJobs(
+    const PackagingParams& packaging_params,
+    const std::vector<StreamDescriptor>& streams_for_jobs) {
   RETURN_IF_ERROR(media::CreateAllJobs(
-      streams_for_jobs, packaging_params, internal->mpd_notifier.get(),
-      internal->encryption_key_source.get(),
-      internal->job_manager->sync_points(), &muxer_listener_factory,
-      &muxer_factory, internal->job_manager.get()));
+      streams_for_jobs, packaging_params, mpd_notifier.get(),
+      encryption_key_source.get(), job_manager->sync_points(),
+      muxer_listener_factory.get(), muxer_factory.get(), &vod_chunk_planner,
+      job_manager.get(), &output_branches, &chunked_muxer_listeners));
+  if (handler_stats_params.enable_handler_stats)
+    job_manager->EnableHandlerStats();
+  {
+    base::AutoLock auto_lock(output_branches_lock);
+    latency_stats = muxer_listener_factory->latency_stats();
+  }
 
-  internal_ = std::move(internal);
+  base::AutoLock auto_lock(jobs_lock);
+  jobs_created = true;
+  if (jobs_cancelled)
+    return Status(error::CANCELLED, "Packaging cancelled.");
   return Status::OK;
 }
 
 Status Packager::Run() {
   if (!internal_)
     return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
+  // The memory tracked by this thread, e.g. when flushing the manifests,
+  // belongs to this Packager too.
+  MemoryAccounting::ScopedJob scoped_job(&internal_->memory_accounting, "");
+
+  if (internal_->deferred_packaging_params) {
+    std::unique_ptr<PackagingParams> packaging_params =
+        std::move(internal_->deferred_packaging_params);
+    RETURN_IF_ERROR(internal_->CreateJobs(
+        *packaging_params, internal_->deferred_streams_for_jobs));
+  }
+
+  {
+    base::AutoLock auto_lock(internal_->run_start_time_lock);
+    internal_->run_start_time = base::TimeTicks::Now();
+  }
+
+  std::unique_ptr<media::ScopedTraceFileWriter> trace_file_writer;
+  if (!internal_->trace_file.empty()) {
+    trace_file_writer.reset(
+        new media::ScopedTraceFileWriter(internal_->trace_file));
+  }
+
+  std::vector<std::unique_ptr<media::StatsDumper>> stats_dumpers;
+  const HandlerStatsParams& stats_params = internal_->handler_stats_params;
+  if (stats_params.enable_handler_stats &&
+      stats_params.dump_interval_in_seconds > 0) {
+    stats_dumpers.emplace_back(new media::StatsDumper(
+        "HandlerStatsDumper",
+        base::TimeDelta::FromSecondsD(stats_params.dump_interval_in_seconds),
+        [this]() { media::LogHandlerStats(GetHandlerStats()); }));
+  }
+  const LatencyStatsParams& latency_params = internal_->latency_stats_params;
+  if (latency_params.enable_latency_stats &&
+      latency_params.dump_interval_in_seconds > 0) {
+    stats_dumpers.emplace_back(new media::StatsDumper(
+        "LatencyStatsDumper",
+        base::TimeDelta::FromSecondsD(latency_params.dump_interval_in_seconds),
+        [this]() { media::LogLatencyStats(GetLatencyStats()); }));
+  }
+  const MemoryStatsParams& memory_params = internal_->memory_stats_params;
+  if (memory_params.dump_interval_in_seconds > 0) {
+    stats_dumpers.emplace_back(new media::StatsDumper(
+        "MemoryStatsDumper",
+        base::TimeDelta::FromSecondsD(memory_params.dump_interval_in_seconds),
+        [this]() {
+          media::LogMemoryUsage(GetMemoryUsage(), internal_->memory_accounting);
+        }));
+  }
+  const CheckpointParams& checkpoint_params = internal_->checkpoint_params;
+  if (!checkpoint_params.checkpoint_file.empty()) {
+    stats_dumpers.emplace_back(new media::StatsDumper(
+        "CheckpointWriter",
+        base::TimeDelta::FromSecondsD(
+            checkpoint_params.checkpoint_interval_in_seconds),
+        [this]() {
+          const Status status = WriteCheckpoint();
+          LOG_IF(ERROR, !status.ok()) << status;
+        }));
+  }
+  for (auto& stats_dumper : stats_dumpers)
+    stats_dumper->Start();
+
+  internal_->memory_accounting.SetSoftLimit(
+      std::max<int64_t>(memory_params.soft_limit_in_bytes, 0));
 
-  RETURN_IF_ERROR(internal_->job_manager->RunJobs());
+  const Status status = internal_->job_manager->RunJobs();
+  for (auto& stats_dumper : stats_dumpers)
+    stats_dumper->Stop();
+  RETURN_IF_ERROR(status);
+
+  for (auto& chunked_muxer_listener : internal_->chunked_muxer_listeners)
+    chunked_muxer_listener->Flush();
 
   if (internal_->hls_notifier) {
     if (!internal_->hls_notifier->Flush())
@@ -1035,9 +1707,210 @@ void Packager::Cancel() {
     LOG(INFO) << "Not yet initialized. Return directly.";
     return;
   }
+  internal_->vod_chunk_planner.Cancel();
+  {
+    base::AutoLock auto_lock(internal_->jobs_lock);
+    // The jobs are cancelled once created otherwise.
+    internal_->jobs_cancelled = true;
+    if (!internal_->jobs_created)
+      return;
+  }
   internal_->job_manager->CancelJobs();
 }
 
+Status Packager::AddStream(const StreamDescriptor& stream_descriptor) {
+  if (!internal_)
+    return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
+  if (stream_descriptor.stream_selector == "text") {
+    return Status(error::UNIMPLEMENTED,
+                  "Text streams cannot be added while packaging.");
+  }
+  if (stream_descriptor.segment_template.empty()) {
+    return Status(error::INVALID_ARGUMENT,
+                  "Only streams with 'segment_template' can be added while "
+                  "packaging.");
+  }
+  // The stream has an output, so dump_stream_info does not matter.
+  RETURN_IF_ERROR(media::ValidateStreamDescriptor(false, stream_descriptor));
+
+  StreamDescriptor stream;
+  RETURN_IF_ERROR(media::CopyStreamDescriptorForJobs(
+      internal_->buffer_callback_params, stream_descriptor, &stream));
+
+  base::AutoLock auto_lock(internal_->output_branches_lock);
+  media::OutputBranches& output_branches = internal_->output_branches;
+  const std::string output_name = media::GetOutputName(stream);
+  if (output_branches.branches.find(output_name) !=
+      output_branches.branches.end()) {
+    return Status(error::ALREADY_EXISTS,
+                  "Seeing duplicated outputs '" + output_name + "'.");
+  }
+  auto replicator_it = output_branches.replicators.find(
+      std::make_pair(stream.input, stream.stream_selector));
+  if (replicator_it == output_branches.replicators.end()) {
+    return Status(error::NOT_FOUND,
+                  "Stream " + stream_descriptor.input + ":" +
+                      stream_descriptor.stream_selector +
+                      " is not being packaged. Only streams of packaged "
+                      "inputs and stream selectors can be added.");
+  }
+
+  media::OutputBranch branch;
+  RETURN_IF_ERROR(media::CreateOutputBranch(
+      stream, internal_->muxer_listener_factory.get(),
+      internal_->muxer_factory.get(), &branch));
+  branch.replicator = replicator_it->second;
+  branch.replicator->AddHandlerAtSegmentBoundary(branch.head);
+  output_branches.branches[output_name] = branch;
+  internal_->latency_stats = internal_->muxer_listener_factory->latency_stats();
+  return Status::OK;
+}
+
+Status Packager::RemoveStream(const std::string& output) {
+  if (!internal_)
+    return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
+
+  std::string output_name = output;
+  if (internal_->buffer_callback_params.write_func) {
+    output_name =
+        File::MakeCallbackFileName(internal_->buffer_callback_params, output);
+  }
+
+  base::AutoLock auto_lock(internal_->output_branches_lock);
+  auto& branches = internal_->output_branches.branches;
+  auto branch_it = branches.find(output_name);
+  if (branch_it == branches.end() || branch_it->second.removing) {
+    return Status(error::NOT_FOUND,
+                  "There is no stream with output '" + output + "'.");
+  }
+  // The branch, which holds the muxer owning the listener, is erased only
+  // after the replicator has detached it, so the output is not reused, and
+  // its segment index is checkpointed, while the muxer still writes it.
+  branch_it->second.removing = true;
+  PackagerInternal* internal = internal_.get();
+  media::MuxerListener* muxer_listener = branch_it->second.muxer_listener;
+  branch_it->second.replicator->RemoveHandlerAtSegmentBoundary(
+      branch_it->second.head.get(),
+      [internal, output_name, muxer_listener]() {
+        muxer_listener->OnMediaRemoved();
+        base::AutoLock branches_lock(internal->output_branches_lock);
+        auto& removed_branches = internal->output_branches.branches;
+        auto removed_it = removed_branches.find(output_name);
+        DCHECK(removed_it != removed_branches.end());
+        internal->next_segment_indices[output_name] =
+            removed_it->second.muxer->next_segment_index();
+        removed_branches.erase(removed_it);
+      });
+  return Status::OK;
+}
+
+Status Packager::WriteCheckpoint() {
+  if (!internal_)
+    return Status(error::INVALID_ARGUMENT, "Not yet initialized.");
+  if (internal_->checkpoint_params.checkpoint_file.empty())
+    return Status(error::INVALID_ARGUMENT, "Checkpoint file not specified.");
+
+  base::AutoLock checkpoint_lock(internal_->checkpoint_lock);
+  PackagerCheckpoint checkpoint;
+  {
+    // No segment is being counted or notified meanwhile, so the segment
+    // indices match the segments in the manifests. The numbering of the
+    // segments in a DASH SegmentTimeline is implicit and must not skip any.
+    base::subtle::AutoWriteLock segment_lock(internal_->segment_lock);
+    if (internal_->hls_notifier)
+      internal_->hls_notifier->SaveState(&checkpoint.media_playlists);
+    if (internal_->mpd_notifier)
+      internal_->mpd_notifier->SaveState(&checkpoint.mpd_state);
+    base::AutoLock auto_lock(internal_->output_branches_lock);
+    for (const auto& entry : internal_->output_branches.branches) {
+      internal_->next_segment_indices[entry.first] =
+          entry.second.muxer->next_segment_index();
+    }
+    checkpoint.next_segment_indices = internal_->next_segment_indices;
+  }
+  return shaka::WriteCheckpoint(checkpoint,
+                                internal_->checkpoint_params.checkpoint_file);
+}
+
+std::vector<HandlerStats> Packager::GetHandlerStats() const {
+  std::vector<HandlerStats> stats;
+  if (!internal_ || !internal_->handler_stats_params.enable_handler_stats)
+    return stats;
+
+  base::TimeDelta elapsed;
+  {
+    base::AutoLock auto_lock(internal_->run_start_time_lock);
+    if (!internal_->run_start_time.is_null())
+      elapsed = base::TimeTicks::Now() - internal_->run_start_time;
+  }
+  const double elapsed_in_seconds = elapsed.InSecondsF();
+
+  {
+    base::AutoLock auto_lock(internal_->jobs_lock);
+    if (!internal_->jobs_created)
+      return stats;
+  }
+  std::vector<media::HandlerStreamStats> stream_stats;
+  internal_->job_manager->GetHandlerStats(&stream_stats);
+  for (const media::HandlerStreamStats& entry : stream_stats) {
+    HandlerStats handler_stats;
+    handler_stats.job_name = entry.job_name;
+    handler_stats.handler_name = entry.handler_name;
+    handler_stats.stream_index = entry.stream_index;
+    handler_stats.num_samples = entry.num_samples;
+    handler_stats.num_bytes = entry.num_bytes;
+    handler_stats.self_time_in_seconds = entry.self_time_ns / 1e9;
+    if (elapsed_in_seconds > 0) {
+      handler_stats.samples_per_second =
+          entry.num_samples / elapsed_in_seconds;
+      handler_stats.bytes_per_second = entry.num_bytes / elapsed_in_seconds;
+    }
+    stats.push_back(handler_stats);
+  }
+  return stats;
+}
+
+std::vector<LatencyStats> Packager::GetLatencyStats() const {
+  std::vector<LatencyStats> stats;
+  if (!internal_)
+    return stats;
+  std::vector<std::shared_ptr<media::SegmentLatencyStats>> all_latency_stats;
+  {
+    base::AutoLock auto_lock(internal_->output_branches_lock);
+    all_latency_stats = internal_->latency_stats;
+  }
+  for (const auto& segment_latency_stats : all_latency_stats) {
+    LatencyStats latency_stats;
+    latency_stats.stream_name = segment_latency_stats->stream_name;
+    latency_stats.ingest_to_segment =
+        media::ToLatencyDistribution(segment_latency_stats->ingest_to_segment);
+    latency_stats.segment_to_manifest = media::ToLatencyDistribution(
+        segment_latency_stats->segment_to_manifest);
+    latency_stats.ingest_to_manifest =
+        media::ToLatencyDistribution(segment_latency_stats->ingest_to_manifest);
+    stats.push_back(latency_stats);
+  }
+  return stats;
+}
+
+std::vector<MemoryUsage> Packager::GetMemoryUsage() const {
+  if (!internal_)
+    return std::vector<MemoryUsage>();
+  std::vector<MemoryAccountUsage> account_usage;
+  internal_->memory_accounting.GetUsage(&account_usage);
+  std::vector<MemoryUsage> usage;
+  for (const MemoryAccountUsage& entry : account_usage) {
+    MemoryUsage memory_usage;
+    memory_usage.job_name = entry.job_name;
+    memory_usage.buffer_name = entry.buffer_name;
+    memory_usage.stream_name = entry.stream_name;
+    memory_usage.current_bytes = entry.current_bytes;
+    memory_usage.peak_bytes = entry.peak_bytes;
+    usage.push_back(memory_usage);
+  }
+  return usage;
+}
+
 std::string Packager::GetLibraryVersion() {
   return GetPackagerVersion();
 }
@@ -22,10 +22,15 @@
         'app/libcrypto_threading.h',
         'app/packager_util.cc',
         'app/packager_util.h',
+        'app/vod_chunk_planner.cc',
+        'app/vod_chunk_planner.h',
         'packager.cc',
         'packager.h',
+        'packager_service.cc',
+        'packager_service.h',
       ],
       'dependencies': [
+        'checkpoint',
         'file/file.gyp:file',
         'hls/hls.gyp:hls_builder',
         'media/chunking/chunking.gyp:chunking',
@@ -42,6 +47,8 @@
         'media/public/public.gyp:public',
         'media/replicator/replicator.gyp:replicator',
         'media/trick_play/trick_play.gyp:trick_play',
+        'memory_tracker',
+        'mpd/mpd.gyp:binary_media_info',
         'mpd/mpd.gyp:mpd_builder',
         'third_party/boringssl/boringssl.gyp:boringssl',
         'version/version.gyp:version',
@@ -120,6 +127,7 @@
       ],
       'dependencies': [
         'base/base.gyp:base',
+        'mpd/mpd.gyp:binary_media_info',
         'mpd/mpd.gyp:mpd_util',
         'third_party/gflags/gflags.gyp:gflags',
         'tools/license_notice.gyp:license_notice',
@@ -132,12 +140,26 @@
         'packager_test.cc',
       ],
       'dependencies': [
+        'file/file.gyp:file',
         'libpackager',
         'testing/gmock.gyp:gmock',
         'testing/gtest.gyp:gtest',
         'testing/gtest.gyp:gtest_main',
       ],
     },
+    {
+      'target_name': 'packager_perftest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'packager_perftest.cc',
+      ],
+      'dependencies': [
+        'libpackager',
+        'testing/gtest.gyp:gtest',
+        'testing/gtest.gyp:gtest_main',
+        'testing/perf/perf_test.gyp:perf_test',
+      ],
+    },
     {
       'target_name': 'packager_test_py_copy',
       'type': 'none',
@@ -184,10 +206,99 @@
         'testing/gtest.gyp:gtest_main',
       ]
     },
+    {
+      'target_name': 'trace_event',
+      'type': 'static_library',
+      'sources': [
+        'trace_event.cc',
+        'trace_event.h',
+      ],
+      'dependencies': [
+        'base/base.gyp:base',
+      ],
+    },
+    {
+      'target_name': 'trace_event_unittest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'trace_event_unittest.cc',
+      ],
+      'dependencies': [
+        'trace_event',
+        'base/base.gyp:base',
+        'testing/gtest.gyp:gtest',
+        'testing/gtest.gyp:gtest_main',
+      ]
+    },
+    {
+      'target_name': 'memory_tracker',
+      'type': 'static_library',
+      'sources': [
+        'memory_tracker.cc',
+        'memory_tracker.h',
+      ],
+      'dependencies': [
+        'base/base.gyp:base',
+      ],
+    },
+    {
+      'target_name': 'memory_tracker_unittest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'memory_tracker_unittest.cc',
+      ],
+      'dependencies': [
+        'memory_tracker',
+        'base/base.gyp:base',
+        'testing/gtest.gyp:gtest',
+        'testing/gtest.gyp:gtest_main',
+      ]
+    },
+    {
+      'target_name': 'checkpoint_proto',
+      'type': 'static_library',
+      'sources': [
+        'checkpoint.proto',
+      ],
+      'variables': {
+        'proto_in_dir': '.',
+        'proto_out_dir': 'packager',
+      },
+      'includes': ['protoc.gypi'],
+    },
+    {
+      'target_name': 'checkpoint',
+      'type': 'static_library',
+      'sources': [
+        'checkpoint.cc',
+        'checkpoint.h',
+      ],
+      'dependencies': [
+        'checkpoint_proto',
+        'file/file.gyp:file',
+        'hls/hls.gyp:hls_builder',
+        'mpd/mpd.gyp:mpd_builder',
+        'status',
+      ],
+    },
+    {
+      'target_name': 'checkpoint_unittest',
+      'type': '<(gtest_target_type)',
+      'sources': [
+        'checkpoint_unittest.cc',
+      ],
+      'dependencies': [
+        'checkpoint',
+        'file/file.gyp:file',
+        'testing/gtest.gyp:gtest',
+        'testing/gtest.gyp:gtest_main',
+      ]
+    },
     {
       'target_name': 'packager_builder_tests',
       'type': 'none',
       'dependencies': [
+        'checkpoint_unittest',
         'file/file.gyp:file_unittest',
         'hls/hls.gyp:hls_unittest',
         'media/base/media_base.gyp:media_base_unittest',
@@ -202,10 +313,30 @@
         'media/formats/webm/webm.gyp:webm_unittest',
         'media/formats/webvtt/webvtt.gyp:webvtt_unittest',
         'media/formats/wvm/wvm.gyp:wvm_unittest',
+        'media/replicator/replicator.gyp:replicator_unittest',
+        'media/synthetic/synthetic.gyp:synthetic_unittest',
         'media/trick_play/trick_play.gyp:trick_play_unittest',
+        'memory_tracker_unittest',
         'mpd/mpd.gyp:mpd_unittest',
         'packager_test',
         'status_unittest',
+        'trace_event_unittest',
+      ],
+    },
+    {
+      # Benchmarks print perf_test RESULT lines; they are not run as part of
+      # packager_builder_tests.
+      'target_name': 'packager_benchmarks',
+      'type': 'none',
+      'dependencies': [
+        'hls/hls.gyp:hls_perftest',
+        'media/base/media_base.gyp:media_base_perftest',
+        'media/codecs/codecs.gyp:codecs_perftest',
+        'media/crypto/crypto.gyp:crypto_perftest',
+        'media/formats/mp2t/mp2t.gyp:mp2t_perftest',
+        'media/formats/mp4/mp4.gyp:mp4_perftest',
+        'mpd/mpd.gyp:mpd_perftest',
+        'packager_perftest',
       ],
     },
   ],
@@ -34,6 +34,76 @@ struct TestParams {
   std::string injected_library_version;
 };
 
+/// Media handler statistics parameters.
+struct HandlerStatsParams {
+  /// Collect per media handler statistics, which are available through
+  /// Packager::GetHandlerStats(). There is no overhead when disabled.
+  bool enable_handler_stats = false;
+  /// If positive, the statistics are logged every this many seconds while
+  /// packaging, and once more when packaging completes.
+  double dump_interval_in_seconds = 0;
+};
+
+/// Live latency statistics parameters.
+struct LatencyStatsParams {
+  /// Measure how long every segment takes from the ingest of its earliest
+  /// sample to the segment being written and to the manifests being updated.
+  /// The statistics are available through Packager::GetLatencyStats().
+  bool enable_latency_stats = false;
+  /// If positive, the statistics are logged every this many seconds while
+  /// packaging, and once more when packaging completes.
+  double dump_interval_in_seconds = 0;
+};
+
+/// Memory accounting parameters.
+struct MemoryStatsParams {
+  /// If positive, the memory used by the major buffers of every job and
+  /// stream is logged every this many seconds while packaging, and once more
+  /// when packaging completes. The usage is also available through
+  /// Packager::GetMemoryUsage().
+  double dump_interval_in_seconds = 0;
+  /// If positive, reading the inputs is held off while the memory used by the
+  /// buffers of the Packager exceeds this many bytes, so that the pipeline can
+  /// drain them. The limit of a Packager does not apply to other instances.
+  /// The limit is soft: reading resumes after a short wait regardless, as some
+  /// buffers are only released with more input. Fixed capacities, e.g. the
+  /// I/O caches of the open files, are reported but excluded from the limit,
+  /// as waiting does not release them.
+  int64_t soft_limit_in_bytes = 0;
+};
+
+/// Live packaging checkpoint parameters.
+struct CheckpointParams {
+  /// If not empty, the segment numbers of the outputs and the state of the
+  /// live manifests are saved to this file periodically while packaging, and
+  /// once more when packaging completes. If the file exists on
+  /// initialization, the state is restored from it, so that a restarted
+  /// packager continues the segment numbers, the HLS media sequence numbers
+  /// and the DASH segment timelines instead of starting over. The timestamps
+  /// of the live inputs are expected to continue across the restart. Not
+  /// supported with buffer callbacks.
+  std::string checkpoint_file;
+  /// Interval between checkpoints in seconds.
+  double checkpoint_interval_in_seconds = 5;
+};
+
+/// Parallel VOD packaging parameters.
+struct ParallelVodParams {
+  /// If greater than 1, the timeline of every input is split into up to this
+  /// many chunks of whole segments, which are demuxed, encrypted and muxed in
+  /// parallel. The segments are found from the key frames of the input in a
+  /// scan at the start of Packager::Run(), and every chunk only reads its part
+  /// of the input if the input is MP4. The media segments and the manifests
+  /// are the same as when packaging sequentially, but the init segments omit
+  /// the movie duration, which is unknown until every chunk is packaged. Only
+  /// VOD packaging of audio and video to MP4 with segment_template is
+  /// supported; text streams are packaged sequentially. Inputs whose duration
+  /// is unknown and which are scanned with their sample data, e.g. MPEG-2 TS,
+  /// are packaged sequentially too. Encryption requires
+  /// EncryptionParams::derive_iv.
+  int num_chunks = 0;
+};
+
 /// Packaging parameters.
 struct PackagingParams {
   /// Specify temporary directory for intermediate temporary files.
@@ -44,8 +114,21 @@ struct PackagingParams {
   /// audio) timestamps to compensate for possible negative timestamps in the
   /// input.
   uint32_t transport_stream_timestamp_offset_ms = 0;
+  /// Write single-segment WebM outputs in a single pass if the number of
+  /// segments can be bounded from the stream duration, by reserving space for
+  /// the Cues before the Clusters, instead of writing the Clusters to a
+  /// temporary file and copying them after the Cues. Falls back to copying if
+  /// the reserved space turns out to be too small. The output differs
+  /// byte-wise from the default two-pass output.
+  bool webm_single_pass = false;
   /// Chunking (segmentation) related parameters.
   ChunkingParams chunking_params;
+  /// Start the streams of an input as soon as their own stream info is
+  /// available, instead of waiting for the stream info of every stream in the
+  /// input, e.g. of a sparse audio stream in a live MPEG-2 TS input. The
+  /// streams whose stream info comes later are started afterwards. Only
+  /// MPEG-2 TS inputs support it.
+  bool lazy_stream_initialization = false;
 
   /// Out of band cuepoint parameters.
   AdCueGeneratorParams ad_cue_generator_params;
@@ -53,6 +136,10 @@ struct PackagingParams {
   /// Create a human readable format of MediaInfo. The output file name will be
   /// the name specified by output flag, suffixed with `.media_info`.
   bool output_media_info = false;
+  /// Also write MediaInfo in protobuf binary wire format, which is faster to
+  /// parse, when output_media_info is set. The output file name is suffixed
+  /// with `.media_info.pb`.
+  bool output_binary_media_info = false;
   /// DASH MPD related parameters.
   MpdParams mpd_params;
   /// HLS related parameters.
@@ -65,6 +152,27 @@ struct PackagingParams {
   /// Buffer callback params.
   BufferCallbackParams buffer_callback_params;
 
+  /// Media handler statistics parameters.
+  HandlerStatsParams handler_stats_params;
+
+  /// Live latency statistics parameters.
+  LatencyStatsParams latency_stats_params;
+
+  /// Memory accounting parameters.
+  MemoryStatsParams memory_stats_params;
+
+  /// Live packaging checkpoint parameters.
+  CheckpointParams checkpoint_params;
+
+  /// Parallel VOD packaging parameters.
+  ParallelVodParams parallel_vod_params;
+
+  /// If not empty, timing events of the packaging pipeline are recorded while
+  /// Packager::Run() executes and written to this file in Chrome trace event
+  /// JSON format, which can be viewed in chrome://tracing or
+  /// https://ui.perfetto.dev.
+  std::string trace_file;
+
   // Parameters for testing. Do not use in production.
   TestParams test_params;
 };
@@ -125,6 +233,75 @@ struct StreamDescriptor {
   std::vector<std::string> hls_characteristics;
 };
 
+/// Statistics of one input stream of a media handler.
+struct HandlerStats {
+  /// Name of the job running the handler.
+  std::string job_name;
+  /// Name of the handler, e.g. "EncryptionHandler".
+  std::string handler_name;
+  /// Input stream index of the handler.
+  size_t stream_index = 0;
+  /// Number of media and text samples received.
+  uint64_t num_samples = 0;
+  /// Number of media sample bytes received.
+  uint64_t num_bytes = 0;
+  /// Time spent in the handler itself, excluding downstream handlers.
+  double self_time_in_seconds = 0;
+  /// Samples received per second since packaging started.
+  double samples_per_second = 0;
+  /// Bytes received per second since packaging started.
+  double bytes_per_second = 0;
+};
+
+/// Distribution of latencies, from a histogram with fixed buckets.
+struct LatencyDistribution {
+  /// Number of latencies measured.
+  uint64_t count = 0;
+  double mean_in_seconds = 0;
+  double max_in_seconds = 0;
+  /// Percentiles, estimated by the upper bound of the containing bucket.
+  double p50_in_seconds = 0;
+  double p90_in_seconds = 0;
+  double p99_in_seconds = 0;
+  /// Exclusive upper bounds of the buckets, except for the last bucket which
+  /// is unbounded.
+  std::vector<double> bucket_upper_bounds_in_seconds;
+  /// Number of latencies in each bucket. It has one more entry than
+  /// @a bucket_upper_bounds_in_seconds.
+  std::vector<uint64_t> bucket_counts;
+};
+
+/// Per segment latencies of an output stream.
+struct LatencyStats {
+  /// Segment template, or output if there is no segment template, of the
+  /// stream.
+  std::string stream_name;
+  /// From the ingest of the earliest sample of a segment to the segment being
+  /// written.
+  LatencyDistribution ingest_to_segment;
+  /// From the segment being written to the manifests being updated. Only
+  /// meaningful for live manifests, which are updated for every segment.
+  LatencyDistribution segment_to_manifest;
+  /// From the ingest of the earliest sample of a segment to the manifests
+  /// being updated.
+  LatencyDistribution ingest_to_manifest;
+};
+
+/// Memory used by a kind of buffer of a stream in a job.
+struct MemoryUsage {
+  /// Name of the job which allocated the memory, if any.
+  std::string job_name;
+  /// Name of the buffer, e.g. "ByteQueue" or "CueAlignmentHandler".
+  std::string buffer_name;
+  /// Name of the stream, if the buffer is associated with one, or else the
+  /// name of the input, for buffers of an input such as parser buffers.
+  std::string stream_name;
+  /// Bytes currently used.
+  int64_t current_bytes = 0;
+  /// The largest number of bytes used at any time.
+  int64_t peak_bytes = 0;
+};
+
 class SHAKA_EXPORT Packager {
  public:
   Packager();
@@ -146,6 +323,53 @@ class SHAKA_EXPORT Packager {
   /// Cancel packaging. Note that it has to be called from another thread.
   void Cancel();
 
+  /// Add an output stream while packaging live content, e.g. a new rung of
+  /// the bitrate ladder. The stream shares the demuxer, chunker and encryptor
+  /// of the streams with the same input and stream selector, which must be
+  /// packaged already. Its muxer starts at the next segment boundary, and it
+  /// is added to the manifests with its first segment. It can be called from
+  /// another thread while packaging.
+  /// @param stream_descriptor describes the stream. It must have a segment
+  ///        template which is not used by another stream.
+  /// @return OK on success, an appropriate error code on failure.
+  Status AddStream(const StreamDescriptor& stream_descriptor);
+
+  /// Remove an output stream while packaging live content. The stream is
+  /// finalized at the next segment boundary and then removed from the
+  /// manifests. Its output cannot be added again before then. It can be
+  /// called from another thread while packaging.
+  /// @param output is the segment template, or the output if there is no
+  ///        segment template, of the stream.
+  /// @return OK on success, an appropriate error code on failure.
+  Status RemoveStream(const std::string& output);
+
+  /// Write a checkpoint now, in addition to the periodic checkpoints, e.g.
+  /// before a planned restart. It can be called from another thread while
+  /// packaging.
+  /// @return OK on success, an appropriate error code on failure, e.g. if
+  ///         CheckpointParams::checkpoint_file is not set.
+  Status WriteCheckpoint();
+
+  /// Get a snapshot of the media handler statistics. It can be called from
+  /// another thread while packaging.
+  /// @return The statistics of every input stream of every handler, or an
+  ///         empty list if HandlerStatsParams::enable_handler_stats is not
+  ///         set.
+  std::vector<HandlerStats> GetHandlerStats() const;
+
+  /// Get a snapshot of the live latency statistics. It can be called from
+  /// another thread while packaging.
+  /// @return The statistics of every output stream, or an empty list if
+  ///         LatencyStatsParams::enable_latency_stats is not set.
+  std::vector<LatencyStats> GetLatencyStats() const;
+
+  /// Get a snapshot of the memory used by the major buffers of the packaging
+  /// pipeline of this Packager. It can be called from another thread while
+  /// packaging.
+  /// @return The usage of every buffer kind of every stream of every job,
+  ///         including buffers which have since been released.
+  std::vector<MemoryUsage> GetMemoryUsage() const;
+
   /// @return The version of the library.
   static std::string GetLibraryVersion();
 
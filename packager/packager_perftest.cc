@@ -0,0 +1,142 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+//
+// Measures end-to-end Packager::Run throughput. Inputs are either checked-in
+// test content or generated in-process into memory files, and all outputs go
+// to memory files so that disk speed does not affect the results.
+
+#include <gtest/gtest.h>
+
+#include "packager/base/strings/stringprintf.h"
+#include "packager/base/time/time.h"
+#include "packager/file/file.h"
+#include "packager/packager.h"
+#include "packager/testing/perf/perf_test.h"
+
+namespace shaka {
+namespace {
+
+const char kTestFile[] = "packager/media/test/data/bear-640x360.mp4";
+const int kNumIterations = 5;
+// Two hours of text with a cue every two seconds.
+const int kNumCues = 3600;
+const double kSegmentDurationInSeconds = 2.0;
+
+const uint8_t kKeyId[] = {
+    0xe5, 0x00, 0x7e, 0x6e, 0x9d, 0xcd, 0x5a, 0xc0,
+    0x95, 0x20, 0x2e, 0xd3, 0x75, 0x83, 0x82, 0xcd,
+};
+const uint8_t kKey[] = {
+    0x6f, 0xc9, 0x6f, 0xe6, 0x28, 0xa2, 0x65, 0xb1,
+    0x3a, 0xed, 0xde, 0xc0, 0xbc, 0x42, 0x1f, 0x4d,
+};
+
+std::string FormatWebVttTime(int64_t ms) {
+  return base::StringPrintf("%02d:%02d:%02d.%03d",
+                            static_cast<int>(ms / 3600000),
+                            static_cast<int>(ms / 60000 % 60),
+                            static_cast<int>(ms / 1000 % 60),
+                            static_cast<int>(ms % 1000));
+}
+
+// Writes a WebVTT file with |kNumCues| cues to |file_name|.
+bool GenerateWebVttFile(const std::string& file_name) {
+  std::string content = "WEBVTT\n\n";
+  for (int i = 0; i < kNumCues; ++i) {
+    const int64_t start_ms = i * 2000;
+    content += FormatWebVttTime(start_ms) + " --> " +
+               FormatWebVttTime(start_ms + 1500) + "\n";
+    content += base::StringPrintf("Cue number %d\n\n", i);
+  }
+  return File::WriteStringToFile(file_name.c_str(), content);
+}
+
+PackagingParams SetupPackagingParams(const std::string& output_directory,
+                                     bool encrypt) {
+  PackagingParams packaging_params;
+  packaging_params.temp_dir = output_directory;
+  packaging_params.chunking_params.segment_duration_in_seconds =
+      kSegmentDurationInSeconds;
+  packaging_params.mpd_params.mpd_output = output_directory + "output.mpd";
+  if (encrypt) {
+    packaging_params.encryption_params.key_provider = KeyProvider::kRawKey;
+    packaging_params.encryption_params.raw_key.key_map[""].key_id.assign(
+        std::begin(kKeyId), std::end(kKeyId));
+    packaging_params.encryption_params.raw_key.key_map[""].key.assign(
+        std::begin(kKey), std::end(kKey));
+  }
+  return packaging_params;
+}
+
+// Packages |stream_descriptors| |kNumIterations| times and reports the input
+// throughput. |input_size| is the total size of the inputs in bytes.
+void RunPackager(const std::string& trace,
+                 const std::string& output_directory,
+                 bool encrypt,
+                 const std::vector<StreamDescriptor>& stream_descriptors,
+                 int64_t input_size) {
+  const base::TimeTicks start = base::TimeTicks::Now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    Packager packager;
+    ASSERT_EQ(Status::OK,
+              packager.Initialize(
+                  SetupPackagingParams(output_directory, encrypt),
+                  stream_descriptors));
+    ASSERT_EQ(Status::OK, packager.Run());
+  }
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  perf_test::PrintResult(
+      "packager_run_throughput", "", trace,
+      input_size * kNumIterations / elapsed.InSecondsF() / (1024 * 1024),
+      "MB/s", true);
+  perf_test::PrintResult("packager_run_time", "", trace,
+                         elapsed.InMillisecondsF() / kNumIterations, "ms",
+                         false);
+}
+
+}  // namespace
+
+TEST(PackagerPerfTest, Mp4ToSegmentedMp4) {
+  const int64_t input_size = File::GetFileSize(kTestFile);
+  ASSERT_GT(input_size, 0)
+      << "The test is expected to run from packager repository root.";
+
+  const std::string kOutputDirectory = "memory://perf/mp4/";
+  std::vector<StreamDescriptor> stream_descriptors(2);
+  stream_descriptors[0].input = kTestFile;
+  stream_descriptors[0].stream_selector = "video";
+  stream_descriptors[0].output = kOutputDirectory + "video.mp4";
+  stream_descriptors[1].input = kTestFile;
+  stream_descriptors[1].stream_selector = "audio";
+  stream_descriptors[1].output = kOutputDirectory + "audio.mp4";
+
+  // Both streams read the input once each.
+  const bool kClear = false;
+  RunPackager("bear_640x360_clear", kOutputDirectory, kClear,
+              stream_descriptors, input_size * 2);
+  const bool kEncrypt = true;
+  RunPackager("bear_640x360_cenc", kOutputDirectory, kEncrypt,
+              stream_descriptors, input_size * 2);
+}
+
+TEST(PackagerPerfTest, SyntheticWebVttToMp4) {
+  const std::string kOutputDirectory = "memory://perf/text/";
+  const std::string input = kOutputDirectory + "input.vtt";
+  ASSERT_TRUE(GenerateWebVttFile(input));
+  const int64_t input_size = File::GetFileSize(input.c_str());
+  ASSERT_GT(input_size, 0);
+
+  std::vector<StreamDescriptor> stream_descriptors(1);
+  stream_descriptors[0].input = input;
+  stream_descriptors[0].stream_selector = "text";
+  stream_descriptors[0].output = kOutputDirectory + "text.mp4";
+
+  const bool kClear = false;
+  RunPackager("synthetic_webvtt_2h", kOutputDirectory, kClear,
+              stream_descriptors, input_size);
+}
+
+}  // namespace shaka
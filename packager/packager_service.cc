@@ -0,0 +1,139 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/packager_service.h"
+
+#include <map>
+
+#include "packager/base/logging.h"
+#include "packager/base/synchronization/lock.h"
+#include "packager/base/threading/simple_thread.h"
+
+namespace shaka {
+namespace {
+
+// Packages a channel on its own thread.
+class Channel : public base::SimpleThread {
+ public:
+  explicit Channel(const std::string& channel_id)
+      : SimpleThread("Channel " + channel_id), channel_id_(channel_id) {}
+
+  Packager* packager() { return &packager_; }
+
+  ChannelStatus GetStatus() const {
+    ChannelStatus channel_status;
+    channel_status.channel_id = channel_id_;
+    channel_status.memory_usage = packager_.GetMemoryUsage();
+    base::AutoLock auto_lock(lock_);
+    channel_status.running = running_;
+    channel_status.status = status_;
+    return channel_status;
+  }
+
+ private:
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  void Run() override {
+    const Status status = packager_.Run();
+    LOG_IF(WARNING, !status.ok() && status.error_code() != error::CANCELLED)
+        << "Channel " << channel_id_ << " failed: " << status;
+    base::AutoLock auto_lock(lock_);
+    running_ = false;
+    status_ = status;
+  }
+
+  const std::string channel_id_;
+  Packager packager_;
+
+  mutable base::Lock lock_;
+  bool running_ = true;
+  Status status_;
+};
+
+}  // namespace
+
+struct PackagerService::PackagerServiceInternal {
+  mutable base::Lock lock;
+  // A channel is null while it is being added, which reserves its id.
+  std::map<std::string, std::unique_ptr<Channel>> channels;
+};
+
+PackagerService::PackagerService() : internal_(new PackagerServiceInternal) {}
+
+PackagerService::~PackagerService() {
+  std::vector<std::string> channel_ids;
+  {
+    base::AutoLock auto_lock(internal_->lock);
+    for (const auto& entry : internal_->channels) {
+      DCHECK(entry.second) << "Channel " << entry.first
+                           << " is still being added.";
+      channel_ids.push_back(entry.first);
+    }
+  }
+  for (const std::string& channel_id : channel_ids)
+    RemoveChannel(channel_id);
+}
+
+Status PackagerService::AddChannel(
+    const std::string& channel_id,
+    const PackagingParams& packaging_params,
+    const std::vector<StreamDescriptor>& stream_descriptors) {
+  {
+    base::AutoLock auto_lock(internal_->lock);
+    if (internal_->channels.find(channel_id) != internal_->channels.end()) {
+      return Status(error::ALREADY_EXISTS,
+                    "Channel " + channel_id + " already exists.");
+    }
+    internal_->channels[channel_id] = nullptr;
+  }
+
+  // Initialization may fetch keys, so it is done without holding the lock to
+  // not block the other channels.
+  std::unique_ptr<Channel> channel(new Channel(channel_id));
+  const Status status =
+      channel->packager()->Initialize(packaging_params, stream_descriptors);
+
+  base::AutoLock auto_lock(internal_->lock);
+  if (!status.ok()) {
+    internal_->channels.erase(channel_id);
+    return status;
+  }
+  channel->Start();
+  internal_->channels[channel_id] = std::move(channel);
+  return Status::OK;
+}
+
+Status PackagerService::RemoveChannel(const std::string& channel_id) {
+  std::unique_ptr<Channel> channel;
+  {
+    base::AutoLock auto_lock(internal_->lock);
+    auto iter = internal_->channels.find(channel_id);
+    if (iter == internal_->channels.end() || !iter->second) {
+      return Status(error::NOT_FOUND,
+                    "Channel " + channel_id + " does not exist.");
+    }
+    channel = std::move(iter->second);
+    internal_->channels.erase(iter);
+  }
+
+  // Other channels can be added or removed while waiting for this one.
+  channel->packager()->Cancel();
+  channel->Join();
+  return channel->GetStatus().status;
+}
+
+std::vector<ChannelStatus> PackagerService::GetChannelStatuses() const {
+  std::vector<ChannelStatus> channel_statuses;
+  base::AutoLock auto_lock(internal_->lock);
+  for (const auto& entry : internal_->channels) {
+    if (entry.second)
+      channel_statuses.push_back(entry.second->GetStatus());
+  }
+  return channel_statuses;
+}
+
+}  // namespace shaka
@@ -0,0 +1,80 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_PACKAGER_SERVICE_H_
+#define PACKAGER_PACKAGER_SERVICE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "packager/packager.h"
+
+namespace shaka {
+
+/// Status of a channel hosted by PackagerService.
+struct ChannelStatus {
+  std::string channel_id;
+  /// True until packaging of the channel completes, fails or is cancelled.
+  bool running = false;
+  /// The result of packaging the channel. Only meaningful once the channel is
+  /// no longer running.
+  Status status;
+  /// The memory used by the buffers of the channel, see
+  /// Packager::GetMemoryUsage().
+  std::vector<MemoryUsage> memory_usage;
+};
+
+/// Hosts many independent packaging pipelines, called channels, in a single
+/// long running process. Every channel has its own Packager, with its own
+/// memory accounting and memory soft limit. Channels share the process wide
+/// resources of the library: the worker pool used for threaded file I/O, the
+/// connection, TLS session and DNS cache of the key fetchers, and the libcurl,
+/// libxml and BoringSSL initialization. Adding a channel only costs the threads
+/// of its own pipeline.
+///
+/// Channels can be added and removed at any time from any thread without
+/// disturbing the other channels.
+class SHAKA_EXPORT PackagerService {
+ public:
+  PackagerService();
+  /// Cancels the channels which are still running and waits for them.
+  ~PackagerService();
+
+  /// Initializes a channel and starts packaging it in the background.
+  /// @param channel_id identifies the channel. It must not be used by another
+  ///        channel hosted by this service.
+  /// @param packaging_params contains the packaging parameters of the
+  ///        channel. The output files and manifests must not be shared with
+  ///        other channels.
+  /// @param stream_descriptors a list of stream descriptors of the channel.
+  /// @return OK on success, an appropriate error code on failure, in which
+  ///         case the channel is not added.
+  Status AddChannel(const std::string& channel_id,
+                    const PackagingParams& packaging_params,
+                    const std::vector<StreamDescriptor>& stream_descriptors);
+
+  /// Removes a channel, cancelling it if it is still running. Blocks until
+  /// the pipeline of the channel has stopped.
+  /// @return The result of packaging the channel, i.e. error::CANCELLED if it
+  ///         was cancelled, or error::NOT_FOUND if there is no such channel.
+  Status RemoveChannel(const std::string& channel_id);
+
+  /// @return The status of every channel hosted, including the channels which
+  ///         have completed but are not removed yet.
+  std::vector<ChannelStatus> GetChannelStatuses() const;
+
+ private:
+  PackagerService(const PackagerService&) = delete;
+  PackagerService& operator=(const PackagerService&) = delete;
+
+  struct PackagerServiceInternal;
+  std::unique_ptr<PackagerServiceInternal> internal_;
+};
+
+}  // namespace shaka
+
+#endif  // PACKAGER_PACKAGER_SERVICE_H_
@@ -7,7 +7,15 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "packager/file/file.h"
 #include "packager/packager.h"
+#include "packager/packager_service.h"
 
 using testing::_;
 using testing::HasSubstr;
@@ -23,11 +31,21 @@ namespace shaka {
 namespace {
 
 const char kTestFile[] = "packager/media/test/data/bear-640x360.mp4";
+const char kOtherTestFile[] =
+    "packager/media/test/data/bear-640x360-av_frag.mp4";
 const char kOutputVideo[] = "output_video.mp4";
 const char kOutputVideoTemplate[] = "output_video_$Number$.m4s";
 const char kOutputAudio[] = "output_audio.mp4";
 const char kOutputAudioTemplate[] = "output_audio_$Number$.m4s";
 const char kOutputMpd[] = "output.mpd";
+// Synthetic live input which never ends.
+const char kLiveInput[] = "synth://h264?duration=0&realtime=1";
+const char kLiveOutputInit[] = "live_init.mp4";
+const char kLiveOutputTemplate[] = "live_$Number$.m4s";
+const char kLiveOutputMpd[] = "live.mpd";
+const char kLiveTrickPlayOutputInit[] = "live_trick_play_init.mp4";
+const char kLiveTrickPlayOutputTemplate[] = "live_trick_play_$Number$.m4s";
+const char kCheckpointFile[] = "checkpoint";
 
 const double kSegmentDurationInSeconds = 1.0;
 const uint8_t kKeyId[] = {
@@ -39,6 +57,65 @@ const uint8_t kKey[]{
     0x3a, 0xed, 0xde, 0xc0, 0xbc, 0x42, 0x1f, 0x4d,
 };
 const double kClearLeadInSeconds = 1.0;
+// Bounds the waits for the outputs of the live inputs, which are paced in real
+// time.
+const int kMaxLiveWaitInSeconds = 30;
+
+// Waits until |condition| holds.
+bool WaitUntil(const std::function<bool()>& condition) {
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::seconds(kMaxLiveWaitInSeconds);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+bool FileExists(const std::string& file_name) {
+  return File::GetFileSize(file_name.c_str()) >= 0;
+}
+
+// Returns the number of segments of |segment_template|, which are numbered
+// from 1.
+int CountSegments(const std::string& segment_template) {
+  const std::string kNumber = "$Number$";
+  const size_t number_pos = segment_template.find(kNumber);
+  int count = 0;
+  while (FileExists(std::string(segment_template)
+                        .replace(number_pos, kNumber.size(),
+                                 std::to_string(count + 1)))) {
+    ++count;
+  }
+  return count;
+}
+
+std::string ReadFile(const std::string& file_name) {
+  std::string content;
+  File::ReadFileToString(file_name.c_str(), &content);
+  return content;
+}
+
+// Returns the $Number$ of the last segment in the SegmentTimeline of |mpd|,
+// which has a single Representation, or 0 if there is none.
+int GetLastSegmentNumber(const std::string& mpd) {
+  const std::string kStartNumber = "startNumber=\"";
+  const size_t start_number_pos = mpd.find(kStartNumber);
+  if (start_number_pos == std::string::npos)
+    return 0;
+  int number =
+      std::stoi(mpd.substr(start_number_pos + kStartNumber.size())) - 1;
+  for (size_t pos = mpd.find("<S "); pos != std::string::npos;
+       pos = mpd.find("<S ", pos + 1)) {
+    ++number;
+    const size_t end_pos = mpd.find("/>", pos);
+    const size_t repeat_pos = mpd.find(" r=\"", pos);
+    if (repeat_pos < end_pos)
+      number += std::stoi(mpd.substr(repeat_pos + 4));
+  }
+  return number;
+}
 
 }  // namespace
 
@@ -112,6 +189,28 @@ TEST_F(PackagerTest, Success) {
   ASSERT_EQ(Status::OK, packager.Run());
 }
 
+TEST_F(PackagerTest, MemoryUsagePerInput) {
+  std::vector<StreamDescriptor> stream_descriptors = SetupStreamDescriptors();
+  stream_descriptors[1].input = kOtherTestFile;
+  Packager packager;
+  ASSERT_EQ(Status::OK,
+            packager.Initialize(SetupPackagingParams(), stream_descriptors));
+  ASSERT_EQ(Status::OK, packager.Run());
+
+  // The parser buffers of each input are accounted to its own job and input.
+  for (const std::string input : {kTestFile, kOtherTestFile}) {
+    bool found = false;
+    for (const MemoryUsage& usage : packager.GetMemoryUsage()) {
+      if (usage.buffer_name == "ByteQueue" && usage.stream_name == input) {
+        EXPECT_EQ("RemuxJob " + input, usage.job_name);
+        EXPECT_LT(0, usage.peak_bytes);
+        found = true;
+      }
+    }
+    EXPECT_TRUE(found) << "No ByteQueue memory usage for " << input;
+  }
+}
+
 TEST_F(PackagerTest, MissingStreamDescriptors) {
   std::vector<StreamDescriptor> stream_descriptors;
   Packager packager;
@@ -119,6 +218,20 @@ TEST_F(PackagerTest, MissingStreamDescriptors) {
   ASSERT_EQ(error::INVALID_ARGUMENT, status.error_code());
 }
 
+TEST_F(PackagerTest, BinaryMediaInfoRequiresMediaInfo) {
+  PackagingParams packaging_params = SetupPackagingParams();
+  packaging_params.output_binary_media_info = true;
+  Packager packager;
+  auto status =
+      packager.Initialize(packaging_params, SetupStreamDescriptors());
+  ASSERT_EQ(error::INVALID_ARGUMENT, status.error_code());
+
+  packaging_params.output_media_info = true;
+  Packager other_packager;
+  ASSERT_EQ(Status::OK, other_packager.Initialize(packaging_params,
+                                                  SetupStreamDescriptors()));
+}
+
 TEST_F(PackagerTest, MixingSegmentTemplateAndSingleSegment) {
   std::vector<StreamDescriptor> stream_descriptors;
   StreamDescriptor stream_descriptor;
@@ -266,6 +379,369 @@ TEST_F(PackagerTest, ReadFromBufferFailed) {
   ASSERT_EQ(error::FILE_FAILURE, packager.Run().error_code());
 }
 
+TEST_F(PackagerTest, AddAndRemoveStreamsWhilePackaging) {
+  auto packaging_params = SetupPackagingParams();
+  packaging_params.mpd_params.mpd_output = GetFullPath(kLiveOutputMpd);
+  StreamDescriptor stream_descriptor;
+  stream_descriptor.input = kLiveInput;
+  stream_descriptor.stream_selector = "video";
+  stream_descriptor.output = GetFullPath(kLiveOutputInit);
+  stream_descriptor.segment_template = GetFullPath(kLiveOutputTemplate);
+
+  Packager packager;
+  ASSERT_EQ(Status::OK, packager.Initialize(packaging_params,
+                                            {stream_descriptor}));
+
+  // The output is already used.
+  EXPECT_EQ(error::ALREADY_EXISTS,
+            packager.AddStream(stream_descriptor).error_code());
+
+  StreamDescriptor trick_play_stream_descriptor = stream_descriptor;
+  trick_play_stream_descriptor.trick_play_factor = 1;
+  trick_play_stream_descriptor.output = GetFullPath(kLiveTrickPlayOutputInit);
+  trick_play_stream_descriptor.segment_template =
+      GetFullPath(kLiveTrickPlayOutputTemplate);
+
+  // The stream selected is not packaged.
+  StreamDescriptor audio_stream_descriptor = trick_play_stream_descriptor;
+  audio_stream_descriptor.stream_selector = "audio";
+  EXPECT_EQ(error::NOT_FOUND,
+            packager.AddStream(audio_stream_descriptor).error_code());
+  EXPECT_EQ(error::NOT_FOUND,
+            packager.RemoveStream(GetFullPath(kLiveTrickPlayOutputTemplate))
+                .error_code());
+
+  std::thread packaging_thread([&packager]() {
+    EXPECT_EQ(error::CANCELLED, packager.Run().error_code());
+  });
+  ASSERT_EQ(Status::OK, packager.AddStream(trick_play_stream_descriptor));
+
+  // The added stream starts at a segment boundary and is announced in the MPD.
+  const std::string live_template = GetFullPath(kLiveOutputTemplate);
+  const std::string trick_play_template =
+      GetFullPath(kLiveTrickPlayOutputTemplate);
+  const std::string mpd_path = GetFullPath(kLiveOutputMpd);
+  EXPECT_TRUE(WaitUntil(
+      [&]() { return CountSegments(trick_play_template) >= 2; }));
+  EXPECT_TRUE(WaitUntil([&]() {
+    return ReadFile(mpd_path).find(kLiveTrickPlayOutputTemplate) !=
+           std::string::npos;
+  }));
+
+  EXPECT_EQ(Status::OK, packager.RemoveStream(trick_play_template));
+  // It cannot be removed twice.
+  EXPECT_EQ(error::NOT_FOUND,
+            packager.RemoveStream(trick_play_template).error_code());
+  // The removed stream is finalized at the next segment boundary and then
+  // removed from the MPD.
+  EXPECT_TRUE(WaitUntil([&]() {
+    return ReadFile(mpd_path).find(kLiveTrickPlayOutputTemplate) ==
+           std::string::npos;
+  }));
+  const int num_trick_play_segments = CountSegments(trick_play_template);
+  // The other stream goes on without the removed one.
+  const int num_live_segments = CountSegments(live_template);
+  EXPECT_TRUE(WaitUntil([&]() {
+    return CountSegments(live_template) >= num_live_segments + 2;
+  }));
+  EXPECT_EQ(num_trick_play_segments, CountSegments(trick_play_template));
+  EXPECT_THAT(ReadFile(mpd_path), HasSubstr(kLiveOutputTemplate));
+
+  packager.Cancel();
+  packaging_thread.join();
+}
+
+TEST_F(PackagerTest, ParallelVodEncryptionRequiresDerivedIvs) {
+  auto packaging_params = SetupPackagingParams();
+  packaging_params.parallel_vod_params.num_chunks = 3;
+  auto stream_descriptors = SetupStreamDescriptors();
+  stream_descriptors[0].segment_template = GetFullPath(kOutputVideoTemplate);
+  stream_descriptors[1].segment_template = GetFullPath(kOutputAudioTemplate);
+
+  // Each chunk would pick its own random IVs.
+  Packager packager;
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            packager.Initialize(packaging_params, stream_descriptors)
+                .error_code());
+
+  packaging_params.encryption_params.derive_iv = true;
+  Packager derived_iv_packager;
+  EXPECT_EQ(Status::OK,
+            derived_iv_packager.Initialize(packaging_params,
+                                           stream_descriptors));
+
+  packaging_params.encryption_params.key_provider = KeyProvider::kNone;
+  packaging_params.encryption_params.derive_iv = false;
+  Packager clear_packager;
+  EXPECT_EQ(Status::OK,
+            clear_packager.Initialize(packaging_params, stream_descriptors));
+}
+
+TEST_F(PackagerTest, ParallelVodMatchesSequential) {
+  const char* kRunDirectories[] = {"sequential/", "parallel/"};
+  const int kNumChunks[] = {0, 3};
+  for (int run = 0; run < 2; ++run) {
+    auto packaging_params = SetupPackagingParams();
+    // Parallel packaging requires derived IVs. Deriving them sequentially too
+    // gives the same encrypted outputs.
+    packaging_params.encryption_params.derive_iv = true;
+    packaging_params.test_params.inject_fake_clock = true;
+    packaging_params.parallel_vod_params.num_chunks = kNumChunks[run];
+    const std::string directory = kRunDirectories[run];
+    packaging_params.mpd_params.mpd_output =
+        GetFullPath(directory + kOutputMpd);
+
+    auto stream_descriptors = SetupStreamDescriptors();
+    stream_descriptors[0].segment_template =
+        GetFullPath(directory + kOutputVideoTemplate);
+    stream_descriptors[0].output = GetFullPath(directory + kOutputVideo);
+    stream_descriptors[1].segment_template =
+        GetFullPath(directory + kOutputAudioTemplate);
+    stream_descriptors[1].output = GetFullPath(directory + kOutputAudio);
+
+    Packager packager;
+    ASSERT_EQ(Status::OK,
+              packager.Initialize(packaging_params, stream_descriptors));
+    ASSERT_EQ(Status::OK, packager.Run());
+  }
+
+  // The init segments differ in the movie duration, which is omitted in
+  // parallel packaging. The media segments, numbered from 1, are the same.
+  for (const char* init_segment : {kOutputVideo, kOutputAudio}) {
+    EXPECT_LT(0, File::GetFileSize(
+                     GetFullPath(std::string("parallel/") + init_segment)
+                         .c_str()));
+  }
+  std::vector<std::string> file_names;
+  for (const std::string prefix : {"output_video_", "output_audio_"}) {
+    for (int number = 1;; ++number) {
+      const std::string file_name = prefix + std::to_string(number) + ".m4s";
+      if (File::GetFileSize(
+              GetFullPath("sequential/" + file_name).c_str()) < 0) {
+        EXPECT_LT(2, number) << "Expecting multiple chunks of " << prefix;
+        break;
+      }
+      file_names.push_back(file_name);
+    }
+  }
+  for (const std::string& file_name : file_names) {
+    std::string sequential;
+    std::string parallel;
+    ASSERT_TRUE(File::ReadFileToString(
+        GetFullPath("sequential/" + file_name).c_str(), &sequential));
+    ASSERT_TRUE(File::ReadFileToString(
+        GetFullPath("parallel/" + file_name).c_str(), &parallel));
+    EXPECT_EQ(sequential, parallel) << file_name;
+  }
+}
+
+TEST_F(PackagerTest, ParallelVodSplitsInputWithoutDuration) {
+  auto packaging_params = SetupPackagingParams();
+  packaging_params.encryption_params.derive_iv = true;
+  packaging_params.parallel_vod_params.num_chunks = 3;
+  packaging_params.handler_stats_params.enable_handler_stats = true;
+  // The fragmented input has no 'mehd' box, so its duration is unknown, but
+  // its segments are found without reading the sample data.
+  auto stream_descriptors = SetupStreamDescriptors();
+  for (StreamDescriptor& stream_descriptor : stream_descriptors)
+    stream_descriptor.input = kOtherTestFile;
+  stream_descriptors[0].segment_template = GetFullPath(kOutputVideoTemplate);
+  stream_descriptors[1].segment_template = GetFullPath(kOutputAudioTemplate);
+
+  Packager packager;
+  ASSERT_EQ(Status::OK,
+            packager.Initialize(packaging_params, stream_descriptors));
+  ASSERT_EQ(Status::OK, packager.Run());
+
+  std::set<std::string> job_names;
+  for (const HandlerStats& handler_stats : packager.GetHandlerStats())
+    job_names.insert(handler_stats.job_name);
+  EXPECT_EQ(1u, job_names.count(std::string("RemuxJob ") + kOtherTestFile +
+                                " chunk 1"));
+}
+
+TEST_F(PackagerTest, ParallelVodCancelledBeforeChunksArePlanned) {
+  auto packaging_params = SetupPackagingParams();
+  packaging_params.encryption_params.derive_iv = true;
+  packaging_params.parallel_vod_params.num_chunks = 3;
+  auto stream_descriptors = SetupStreamDescriptors();
+  stream_descriptors[0].segment_template = GetFullPath(kOutputVideoTemplate);
+  stream_descriptors[1].segment_template = GetFullPath(kOutputAudioTemplate);
+
+  // The inputs are scanned to plan the chunks in Run(), which Cancel() stops.
+  Packager packager;
+  ASSERT_EQ(Status::OK,
+            packager.Initialize(packaging_params, stream_descriptors));
+  packager.Cancel();
+  EXPECT_EQ(error::CANCELLED, packager.Run().error_code());
+  EXPECT_FALSE(FileExists(GetFullPath("output_video_1.m4s")));
+}
+
+TEST_F(PackagerTest, ResumeFromCheckpoint) {
+  auto packaging_params = SetupPackagingParams();
+  packaging_params.mpd_params.mpd_output = GetFullPath(kLiveOutputMpd);
+  packaging_params.checkpoint_params.checkpoint_file =
+      GetFullPath(kCheckpointFile);
+  StreamDescriptor stream_descriptor;
+  stream_descriptor.input = kLiveInput;
+  stream_descriptor.stream_selector = "video";
+  stream_descriptor.output = GetFullPath(kLiveOutputInit);
+  stream_descriptor.segment_template = GetFullPath(kLiveOutputTemplate);
+
+  auto get_segment_name = [this](int number) {
+    return GetFullPath("live_" + std::to_string(number) + ".m4s");
+  };
+
+  int last_segment_number = 0;
+  for (int run = 0; run < 2; ++run) {
+    Packager packager;
+    ASSERT_EQ(Status::OK,
+              packager.Initialize(packaging_params, {stream_descriptor}));
+    std::thread packaging_thread([&packager]() {
+      EXPECT_EQ(error::CANCELLED, packager.Run().error_code());
+    });
+    // Take a checkpoint while the segments are written.
+    EXPECT_TRUE(WaitUntil([&]() {
+      return FileExists(get_segment_name(last_segment_number + 2));
+    }));
+    EXPECT_EQ(Status::OK, packager.WriteCheckpoint());
+    packager.Cancel();
+    packaging_thread.join();
+    // A final checkpoint is written when packaging stops.
+    EXPECT_LT(0, File::GetFileSize(GetFullPath(kCheckpointFile).c_str()));
+
+    // The resumed run continues the numbering of the segments, both in the
+    // MPD and in the file names, without a gap.
+    std::string mpd;
+    ASSERT_TRUE(File::ReadFileToString(GetFullPath(kLiveOutputMpd).c_str(),
+                                       &mpd));
+    EXPECT_THAT(mpd, HasSubstr("startNumber=\"1\""));
+    const int previous_last_segment_number = last_segment_number;
+    last_segment_number = GetLastSegmentNumber(mpd);
+    EXPECT_LT(previous_last_segment_number + 1, last_segment_number);
+    for (int number = 1; number <= last_segment_number; ++number) {
+      EXPECT_TRUE(FileExists(get_segment_name(number))) << "Segment " << number;
+    }
+    EXPECT_FALSE(FileExists(get_segment_name(last_segment_number + 1)));
+  }
+}
+
+TEST_F(PackagerTest, CorruptedCheckpoint) {
+  auto packaging_params = SetupPackagingParams();
+  packaging_params.mpd_params.mpd_output = GetFullPath(kLiveOutputMpd);
+  packaging_params.checkpoint_params.checkpoint_file =
+      GetFullPath(kCheckpointFile);
+  ASSERT_TRUE(File::WriteStringToFile(GetFullPath(kCheckpointFile).c_str(),
+                                      "not a checkpoint"));
+  StreamDescriptor stream_descriptor;
+  stream_descriptor.input = kLiveInput;
+  stream_descriptor.stream_selector = "video";
+  stream_descriptor.output = GetFullPath(kLiveOutputInit);
+  stream_descriptor.segment_template = GetFullPath(kLiveOutputTemplate);
+
+  Packager packager;
+  EXPECT_EQ(error::PARSER_FAILURE,
+            packager.Initialize(packaging_params, {stream_descriptor})
+                .error_code());
+}
+
+TEST_F(PackagerTest, ServiceHostsChannels) {
+  auto live_packaging_params = SetupPackagingParams();
+  live_packaging_params.mpd_params.mpd_output = GetFullPath(kLiveOutputMpd);
+  StreamDescriptor live_stream_descriptor;
+  live_stream_descriptor.input = kLiveInput;
+  live_stream_descriptor.stream_selector = "video";
+  live_stream_descriptor.output = GetFullPath(kLiveOutputInit);
+  live_stream_descriptor.segment_template = GetFullPath(kLiveOutputTemplate);
+  const std::vector<StreamDescriptor> live_stream_descriptors = {
+      live_stream_descriptor};
+
+  PackagerService service;
+  ASSERT_EQ(Status::OK, service.AddChannel("live", live_packaging_params,
+                                           live_stream_descriptors));
+  EXPECT_EQ(error::ALREADY_EXISTS,
+            service
+                .AddChannel("live", live_packaging_params,
+                            live_stream_descriptors)
+                .error_code());
+  ASSERT_EQ(Status::OK, service.AddChannel("vod", SetupPackagingParams(),
+                                           SetupStreamDescriptors()));
+  EXPECT_EQ(2u, service.GetChannelStatuses().size());
+
+  // The VOD channel completes on its own while the live channel keeps going.
+  bool vod_running = true;
+  while (vod_running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    vod_running = false;
+    for (const ChannelStatus& channel_status : service.GetChannelStatuses()) {
+      if (channel_status.channel_id == "vod")
+        vod_running = channel_status.running;
+      else
+        EXPECT_TRUE(channel_status.running);
+    }
+  }
+  EXPECT_EQ(Status::OK, service.RemoveChannel("vod"));
+
+  EXPECT_EQ(error::CANCELLED, service.RemoveChannel("live").error_code());
+  EXPECT_EQ(error::NOT_FOUND, service.RemoveChannel("live").error_code());
+  EXPECT_TRUE(service.GetChannelStatuses().empty());
+}
+
+TEST_F(PackagerTest, ServiceFailsToAddChannel) {
+  PackagerService service;
+  EXPECT_EQ(error::INVALID_ARGUMENT,
+            service
+                .AddChannel("channel", SetupPackagingParams(),
+                            std::vector<StreamDescriptor>())
+                .error_code());
+  // The id is not taken by the failed channel.
+  EXPECT_EQ(Status::OK, service.AddChannel("channel", SetupPackagingParams(),
+                                           SetupStreamDescriptors()));
+}
+
+TEST_F(PackagerTest, ServiceAccountsMemoryPerChannel) {
+  PackagingParams other_packaging_params = SetupPackagingParams();
+  other_packaging_params.mpd_params.mpd_output = GetFullPath("other.mpd");
+  // The soft limit of a channel does not apply to the other channel.
+  other_packaging_params.memory_stats_params.soft_limit_in_bytes = 1 << 30;
+  std::vector<StreamDescriptor> other_stream_descriptors =
+      SetupStreamDescriptors();
+  other_stream_descriptors[0].input = kOtherTestFile;
+  other_stream_descriptors[0].output = GetFullPath("other_video.mp4");
+  other_stream_descriptors[1].input = kOtherTestFile;
+  other_stream_descriptors[1].output = GetFullPath("other_audio.mp4");
+
+  PackagerService service;
+  ASSERT_EQ(Status::OK, service.AddChannel("channel", SetupPackagingParams(),
+                                           SetupStreamDescriptors()));
+  ASSERT_EQ(Status::OK, service.AddChannel("other", other_packaging_params,
+                                           other_stream_descriptors));
+
+  bool running = true;
+  while (running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    running = false;
+    for (const ChannelStatus& channel_status : service.GetChannelStatuses())
+      running |= channel_status.running;
+  }
+
+  // Every channel only reports the buffers of its own input.
+  for (const ChannelStatus& channel_status : service.GetChannelStatuses()) {
+    const std::string input =
+        channel_status.channel_id == "other" ? kOtherTestFile : kTestFile;
+    bool has_input_buffers = false;
+    for (const MemoryUsage& usage : channel_status.memory_usage) {
+      if (usage.buffer_name == "ByteQueue") {
+        EXPECT_EQ(input, usage.stream_name);
+        has_input_buffers = true;
+      }
+    }
+    EXPECT_TRUE(has_input_buffers) << channel_status.channel_id;
+  }
+  EXPECT_EQ(Status::OK, service.RemoveChannel("channel"));
+  EXPECT_EQ(Status::OK, service.RemoveChannel("other"));
+}
+
 // TODO(kqyang): Add more tests.
 
 }  // namespace shaka
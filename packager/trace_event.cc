@@ -0,0 +1,244 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/trace_event.h"
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "packager/base/logging.h"
+#include "packager/base/strings/stringprintf.h"
+#include "packager/base/synchronization/lock.h"
+#include "packager/base/threading/platform_thread.h"
+
+namespace shaka {
+
+namespace {
+
+// Events are dropped once a thread has recorded this many events in a
+// session, which bounds the memory used by long running sessions to 32MB per
+// thread.
+const size_t kMaxEventsPerThread = 1 << 20;
+const size_t kEventsPerChunk = 1024;
+
+// Appends |str| to |json| as the contents of a JSON string.
+void AppendEscaped(const char* str, std::string* json) {
+  for (; *str; ++str) {
+    const char c = *str;
+    if (c == '"' || c == '\\') {
+      json->push_back('\\');
+      json->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      base::StringAppendF(json, "\\u%04x", c);
+    } else {
+      json->push_back(c);
+    }
+  }
+}
+
+struct TraceEvent {
+  const char* category;
+  const char* name;
+  int64_t start_us;
+  int64_t duration_us;
+};
+
+// Events recorded by a single thread. Only the owning thread appends events.
+// Other threads may read the events committed so far at any time.
+class ThreadTraceBuffer {
+ public:
+  ThreadTraceBuffer()
+      : thread_id_(base::PlatformThread::CurrentId()),
+        thread_name_(base::PlatformThread::GetName()
+                         ? base::PlatformThread::GetName()
+                         : ""),
+        tail_(&head_) {}
+
+  ~ThreadTraceBuffer() {
+    Chunk* chunk = head_.next.load(std::memory_order_relaxed);
+    while (chunk) {
+      Chunk* next = chunk->next.load(std::memory_order_relaxed);
+      delete chunk;
+      chunk = next;
+    }
+  }
+
+  void Add(const TraceEvent& event) {
+    if (num_events_ >= kMaxEventsPerThread) {
+      num_dropped_events_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    size_t size = tail_->size.load(std::memory_order_relaxed);
+    if (size == kEventsPerChunk) {
+      Chunk* chunk = new Chunk;
+      tail_->next.store(chunk, std::memory_order_release);
+      tail_ = chunk;
+      size = 0;
+    }
+    tail_->events[size] = event;
+    // Publishes the event to readers.
+    tail_->size.store(size + 1, std::memory_order_release);
+    ++num_events_;
+  }
+
+  void AppendJson(int64_t session_start_us, std::string* json) const {
+    if (!thread_name_.empty()) {
+      base::StringAppendF(json,
+                          ",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                          "\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+                          static_cast<int>(thread_id_));
+      AppendEscaped(thread_name_.c_str(), json);
+      json->append("\"}}");
+    }
+    for (const Chunk* chunk = &head_; chunk;
+         chunk = chunk->next.load(std::memory_order_acquire)) {
+      const size_t size = chunk->size.load(std::memory_order_acquire);
+      for (size_t i = 0; i < size; ++i) {
+        const TraceEvent& event = chunk->events[i];
+        json->append(",\n{\"name\":\"");
+        AppendEscaped(event.name, json);
+        json->append("\",\"cat\":\"");
+        AppendEscaped(event.category, json);
+        base::StringAppendF(
+            json,
+            "\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%d}",
+            static_cast<long long>(event.start_us - session_start_us),
+            static_cast<long long>(event.duration_us),
+            static_cast<int>(thread_id_));
+      }
+    }
+  }
+
+  size_t num_dropped_events() const {
+    return num_dropped_events_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  ThreadTraceBuffer(const ThreadTraceBuffer&) = delete;
+  ThreadTraceBuffer& operator=(const ThreadTraceBuffer&) = delete;
+
+  struct Chunk {
+    TraceEvent events[kEventsPerChunk];
+    std::atomic<size_t> size{0};
+    std::atomic<Chunk*> next{nullptr};
+  };
+
+  const base::PlatformThreadId thread_id_;
+  const std::string thread_name_;
+  Chunk head_;
+  // Accessed by the owning thread only.
+  Chunk* tail_;
+  size_t num_events_ = 0;
+  std::atomic<size_t> num_dropped_events_{0};
+};
+
+struct TraceSession {
+  base::Lock lock;
+  // Incremented for every session, so that threads register new buffers.
+  std::atomic<uint32_t> generation{0};
+  int64_t start_us = 0;
+  // The buffers of the current session. They are shared with the recording
+  // threads, so the buffers of a previous session are deleted once their
+  // threads have moved to a newer session, or have exited.
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+  std::set<std::string> interned_names;
+};
+
+TraceSession* GetSession() {
+  static TraceSession* session = new TraceSession;
+  return session;
+}
+
+thread_local std::shared_ptr<ThreadTraceBuffer> g_thread_buffer;
+thread_local uint32_t g_thread_buffer_generation = 0;
+
+ThreadTraceBuffer* GetThreadBuffer() {
+  TraceSession* session = GetSession();
+  const uint32_t generation =
+      session->generation.load(std::memory_order_acquire);
+  if (g_thread_buffer && g_thread_buffer_generation == generation)
+    return g_thread_buffer.get();
+
+  // Registration happens once per thread per session. Releases the buffer of
+  // the previous session, which is deleted here if the session is over.
+  g_thread_buffer = std::make_shared<ThreadTraceBuffer>();
+  g_thread_buffer_generation = generation;
+  base::AutoLock auto_lock(session->lock);
+  session->buffers.push_back(g_thread_buffer);
+  return g_thread_buffer.get();
+}
+
+}  // namespace
+
+std::atomic<bool> TraceLog::enabled_{false};
+
+bool TraceLog::StartTracing() {
+  TraceSession* session = GetSession();
+  base::AutoLock auto_lock(session->lock);
+  if (enabled_.load(std::memory_order_relaxed))
+    return false;
+  // The buffers still in use by their threads are deleted when the threads
+  // move to the new session.
+  session->buffers.clear();
+  session->generation.fetch_add(1, std::memory_order_release);
+  session->start_us = NowInMicroseconds();
+  enabled_.store(true, std::memory_order_relaxed);
+  return true;
+}
+
+bool TraceLog::StopTracing(std::string* json) {
+  TraceSession* session = GetSession();
+  base::AutoLock auto_lock(session->lock);
+  if (!enabled_.load(std::memory_order_relaxed))
+    return false;
+  enabled_.store(false, std::memory_order_relaxed);
+
+  if (json) {
+    json->assign("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    // A leading metadata event, so that every other event can be appended
+    // with a leading comma.
+    json->append(
+        "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+        "\"args\":{\"name\":\"packager\"}}");
+    size_t num_dropped_events = 0;
+    for (const auto& buffer : session->buffers) {
+      buffer->AppendJson(session->start_us, json);
+      num_dropped_events += buffer->num_dropped_events();
+    }
+    json->append("\n]}\n");
+    LOG_IF(WARNING, num_dropped_events > 0)
+        << "Dropped " << num_dropped_events
+        << " trace events after reaching the per thread limit of "
+        << kMaxEventsPerThread << " events.";
+  }
+  return true;
+}
+
+const char* TraceLog::InternName(const std::string& name) {
+  TraceSession* session = GetSession();
+  base::AutoLock auto_lock(session->lock);
+  return session->interned_names.insert(name).first->c_str();
+}
+
+int64_t TraceLog::NowInMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void TraceLog::AddCompleteEvent(const char* category,
+                                const char* name,
+                                int64_t start_us) {
+  // Events ending after tracing is stopped are dropped.
+  if (!IsEnabled())
+    return;
+  const int64_t end_us = NowInMicroseconds();
+  GetThreadBuffer()->Add({category, name, start_us, end_us - start_us});
+}
+
+}  // namespace shaka
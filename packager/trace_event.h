@@ -0,0 +1,98 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef PACKAGER_TRACE_EVENT_H_
+#define PACKAGER_TRACE_EVENT_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+namespace shaka {
+
+/// Records timing events of the packaging pipeline, which are exported in the
+/// Chrome trace event JSON format and can be loaded in chrome://tracing or
+/// https://ui.perfetto.dev.
+///
+/// Events are appended to per-thread buffers without locking. When tracing is
+/// disabled, recording an event costs a single relaxed atomic load.
+class TraceLog {
+ public:
+  /// Starts recording trace events, discarding events from any previous
+  /// session.
+  /// @return false if tracing is already enabled.
+  static bool StartTracing();
+
+  /// Stops recording trace events.
+  /// @param json[out] is set to the recorded events in Chrome trace event JSON
+  ///        format. Can be nullptr if the events are not needed.
+  /// @return false if tracing is not enabled.
+  static bool StopTracing(std::string* json);
+
+  /// @return true if trace events are being recorded.
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /// Returns a copy of @a name which lives until the process exits, so it can
+  /// be used as the name of trace events. The same pointer is returned for the
+  /// same name.
+  static const char* InternName(const std::string& name);
+
+  /// @return the current time in microseconds on the trace clock.
+  static int64_t NowInMicroseconds();
+
+  /// Records an event which started at @a start_us and ended now on the
+  /// current thread.
+  /// @param category and @a name must live until the process exits, e.g.
+  ///        string literals or strings returned by InternName().
+  static void AddCompleteEvent(const char* category,
+                               const char* name,
+                               int64_t start_us);
+
+ private:
+  TraceLog() = delete;
+
+  static std::atomic<bool> enabled_;
+};
+
+/// Records an event covering the lifetime of the object. Use it through the
+/// SHAKA_TRACE_EVENT macro.
+class ScopedTraceEvent {
+ public:
+  /// @param name is nullptr if tracing is disabled.
+  ScopedTraceEvent(const char* category, const char* name)
+      : category_(category),
+        name_(name),
+        start_us_(name ? TraceLog::NowInMicroseconds() : 0) {}
+
+  ~ScopedTraceEvent() {
+    if (name_)
+      TraceLog::AddCompleteEvent(category_, name_, start_us_);
+  }
+
+ private:
+  ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+  ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+  const char* const category_;
+  const char* const name_;
+  const int64_t start_us_;
+};
+
+}  // namespace shaka
+
+#define SHAKA_TRACE_EVENT_CONCAT_INTERNAL(a, b) a##b
+#define SHAKA_TRACE_EVENT_CONCAT(a, b) SHAKA_TRACE_EVENT_CONCAT_INTERNAL(a, b)
+
+/// Records a trace event for the rest of the enclosing scope. @a name is only
+/// evaluated when tracing is enabled. Both @a category and @a name must live
+/// until the process exits, see TraceLog::AddCompleteEvent().
+#define SHAKA_TRACE_EVENT(category, name)                                 \
+  ::shaka::ScopedTraceEvent SHAKA_TRACE_EVENT_CONCAT(trace_event_,        \
+                                                     __LINE__)(           \
+      category, ::shaka::TraceLog::IsEnabled() ? (name) : nullptr)
+
+#endif  // PACKAGER_TRACE_EVENT_H_
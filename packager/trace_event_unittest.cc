@@ -0,0 +1,175 @@
+// Copyright 2020 Google LLC. All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "packager/trace_event.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "packager/base/strings/stringprintf.h"
+#include "packager/base/threading/simple_thread.h"
+
+namespace shaka {
+namespace {
+
+size_t CountOccurrences(const std::string& str, const std::string& pattern) {
+  size_t count = 0;
+  for (size_t pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + pattern.size())) {
+    ++count;
+  }
+  return count;
+}
+
+class RecordEventsDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit RecordEventsDelegate(int num_events) : num_events_(num_events) {}
+
+  void Run() override {
+    for (int i = 0; i < num_events_; ++i) {
+      SHAKA_TRACE_EVENT("test", "ThreadEvent");
+    }
+  }
+
+ private:
+  const int num_events_;
+};
+
+}  // namespace
+
+TEST(TraceEventTest, Disabled) {
+  EXPECT_FALSE(TraceLog::IsEnabled());
+  {
+    SHAKA_TRACE_EVENT("test", "NotRecorded");
+  }
+  std::string json;
+  EXPECT_FALSE(TraceLog::StopTracing(&json));
+  EXPECT_TRUE(json.empty());
+}
+
+TEST(TraceEventTest, NameNotEvaluatedWhenDisabled) {
+  int evaluations = 0;
+  auto name = [&evaluations]() {
+    ++evaluations;
+    return "Name";
+  };
+  {
+    SHAKA_TRACE_EVENT("test", name());
+  }
+  EXPECT_EQ(0, evaluations);
+}
+
+TEST(TraceEventTest, RecordsEvents) {
+  ASSERT_TRUE(TraceLog::StartTracing());
+  EXPECT_TRUE(TraceLog::IsEnabled());
+  EXPECT_FALSE(TraceLog::StartTracing());
+  {
+    SHAKA_TRACE_EVENT("test", "Outer");
+    SHAKA_TRACE_EVENT("test", "Inner");
+  }
+  std::string json;
+  ASSERT_TRUE(TraceLog::StopTracing(&json));
+  EXPECT_FALSE(TraceLog::IsEnabled());
+
+  EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_EQ(1u, CountOccurrences(json, "\"name\":\"Outer\",\"cat\":\"test\","
+                                       "\"ph\":\"X\""));
+  EXPECT_EQ(1u, CountOccurrences(json, "\"name\":\"Inner\",\"cat\":\"test\","
+                                       "\"ph\":\"X\""));
+  // Inner is destructed, hence recorded, first.
+  EXPECT_LT(json.find("Inner"), json.find("Outer"));
+}
+
+TEST(TraceEventTest, MultipleThreads) {
+  const int kNumThreads = 4;
+  // More than a single chunk per thread.
+  const int kNumEventsPerThread = 3000;
+
+  ASSERT_TRUE(TraceLog::StartTracing());
+  RecordEventsDelegate delegate(kNumEventsPerThread);
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(new base::DelegateSimpleThread(
+        &delegate, base::StringPrintf("TraceThread%d", i)));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Join();
+  std::string json;
+  ASSERT_TRUE(TraceLog::StopTracing(&json));
+
+  EXPECT_EQ(static_cast<size_t>(kNumThreads * kNumEventsPerThread),
+            CountOccurrences(json, "\"name\":\"ThreadEvent\""));
+  EXPECT_EQ(static_cast<size_t>(kNumThreads),
+            CountOccurrences(json, "\"name\":\"thread_name\""));
+}
+
+TEST(TraceEventTest, RestartDiscardsPreviousEvents) {
+  ASSERT_TRUE(TraceLog::StartTracing());
+  {
+    SHAKA_TRACE_EVENT("test", "FirstSession");
+  }
+  ASSERT_TRUE(TraceLog::StopTracing(nullptr));
+
+  ASSERT_TRUE(TraceLog::StartTracing());
+  {
+    SHAKA_TRACE_EVENT("test", "SecondSession");
+  }
+  std::string json;
+  ASSERT_TRUE(TraceLog::StopTracing(&json));
+  EXPECT_EQ(0u, CountOccurrences(json, "FirstSession"));
+  EXPECT_EQ(1u, CountOccurrences(json, "SecondSession"));
+}
+
+TEST(TraceEventTest, RestartWhileThreadsRecord) {
+  const int kNumThreads = 4;
+  const int kNumEventsPerThread = 20000;
+  const int kNumSessions = 10;
+
+  // The buffers of the previous sessions are released by the threads while
+  // they keep recording.
+  RecordEventsDelegate delegate(kNumEventsPerThread);
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  ASSERT_TRUE(TraceLog::StartTracing());
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(new base::DelegateSimpleThread(
+        &delegate, base::StringPrintf("TraceThread%d", i)));
+    threads.back()->Start();
+  }
+  for (int i = 1; i < kNumSessions; ++i) {
+    std::string json;
+    ASSERT_TRUE(TraceLog::StopTracing(&json));
+    EXPECT_GE(static_cast<size_t>(kNumThreads * kNumEventsPerThread),
+              CountOccurrences(json, "\"name\":\"ThreadEvent\""));
+    ASSERT_TRUE(TraceLog::StartTracing());
+  }
+  for (auto& thread : threads)
+    thread->Join();
+  ASSERT_TRUE(TraceLog::StopTracing(nullptr));
+}
+
+TEST(TraceEventTest, EscapesNames) {
+  ASSERT_TRUE(TraceLog::StartTracing());
+  {
+    SHAKA_TRACE_EVENT("test", "Quote\"Backslash\\");
+  }
+  std::string json;
+  ASSERT_TRUE(TraceLog::StopTracing(&json));
+  EXPECT_EQ(1u,
+            CountOccurrences(
+                json, "\"name\":\"Quote\\\"Backslash\\\\\",\"cat\":\"test\""));
+}
+
+TEST(TraceEventTest, InternName) {
+  const char* name = TraceLog::InternName("Name");
+  EXPECT_STREQ("Name", name);
+  EXPECT_EQ(name, TraceLog::InternName(std::string("Name")));
+  EXPECT_NE(name, TraceLog::InternName("OtherName"));
+}
+
+}  // namespace shaka